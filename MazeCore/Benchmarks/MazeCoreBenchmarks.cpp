@@ -0,0 +1,123 @@
+#include "MazeCorePlanner.h"
+#include "MazeCoreSolvers.h"
+#include <benchmark/benchmark.h>
+
+using namespace MazeCore;
+
+namespace
+{
+    // Levels of a benchmark are generated with a fixed seed so runs compare against each other
+    FLevel MakeLevel(int64_t RoomsPerSide)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = static_cast<int32_t>(RoomsPerSide);
+        Params.NumDoors = 16;
+        Params.NumKeys = 8;
+        Params.LoopChance = 0.1f;
+        Params.Seed = 7;
+        return FLevel::Generate(Params);
+    }
+
+    void BM_GenerateLevel(benchmark::State& State)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = static_cast<int32_t>(State.range(0));
+        Params.NumDoors = 16;
+        Params.NumKeys = 8;
+        for (auto _ : State)
+        {
+            ++Params.Seed;
+            benchmark::DoNotOptimize(FLevel::Generate(Params));
+        }
+    }
+
+    void BM_ComputeDistances(benchmark::State& State)
+    {
+        const FLevel Level = MakeLevel(State.range(0));
+        FGridSearch Search;
+        std::vector<int32_t> Distances;
+        for (auto _ : State)
+        {
+            Search.ComputeDistances(Level, Level.GetAllDoors(), Level.Start, Distances);
+            benchmark::DoNotOptimize(Distances.data());
+        }
+        State.SetItemsProcessed(State.iterations() * Level.Grid.CountWalkable());
+    }
+
+    void BM_FindPath(benchmark::State& State)
+    {
+        const FLevel Level = MakeLevel(State.range(0));
+        FGridSearch Search;
+        std::vector<FCell> Path;
+        for (auto _ : State)
+        {
+            Path.clear();
+            benchmark::DoNotOptimize(Search.FindPath(Level, Level.GetAllDoors(), Level.Start, Level.Exits[0], Path));
+        }
+        State.counters["PathLength"] = static_cast<double>(Path.size());
+    }
+
+    void BM_SolveGreedy(benchmark::State& State)
+    {
+        const FLevel Level = MakeLevel(State.range(0));
+        FGridSearch Search;
+        FPlan Plan;
+        for (auto _ : State)
+        {
+            Plan = SolveGreedy(Level, Search);
+            benchmark::DoNotOptimize(Plan.Length);
+        }
+        State.counters["Solved"] = Plan.bSolved ? 1 : 0;
+        State.counters["PlanLength"] = Plan.Length;
+    }
+
+    // Levels with the most doors and keys the planner takes, RoomsPerSide from the argument
+    FLevel MakeFullLevel(int64_t RoomsPerSide)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = static_cast<int32_t>(RoomsPerSide);
+        Params.NumDoors = MaxDoors;
+        Params.NumKeys = MaxKeys;
+        Params.LoopChance = 0.1f;
+        Params.Seed = 7;
+        return FLevel::Generate(Params);
+    }
+
+    void BM_BuildPlanner(benchmark::State& State)
+    {
+        const FLevel Level = MakeFullLevel(State.range(0));
+        FKeyDoorPlanner Planner;
+        for (auto _ : State)
+        {
+            benchmark::DoNotOptimize(Planner.Build(Level));
+        }
+        State.counters["Anchors"] = Planner.GetNumAnchors();
+    }
+
+    // Argument 0 is RoomsPerSide, argument 1 selects the small (16 doors, 8 keys) or full level
+    void BM_KeyDoorPlanner(benchmark::State& State)
+    {
+        const FLevel Level = State.range(1) ? MakeFullLevel(State.range(0)) : MakeLevel(State.range(0));
+        FKeyDoorPlanner Planner;
+        Planner.Build(Level);
+        FPlan Plan;
+        for (auto _ : State)
+        {
+            Plan = Planner.Solve(Level.Start);
+            benchmark::DoNotOptimize(Plan.Length);
+        }
+        State.counters["Solved"] = Plan.bSolved ? 1 : 0;
+        State.counters["Optimal"] = Plan.bOptimal ? 1 : 0;
+        State.counters["PlanLength"] = Plan.Length;
+        State.counters["Expanded"] = Planner.GetStats().ExpandedStates;
+    }
+}
+
+BENCHMARK(BM_GenerateLevel)->Arg(16)->Arg(64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ComputeDistances)->Arg(16)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_FindPath)->Arg(16)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_SolveGreedy)->Arg(16)->Arg(64)->Arg(128)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_BuildPlanner)->Arg(32)->Arg(64)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_KeyDoorPlanner)->Args({ 16, 0 })->Args({ 64, 0 })->Args({ 32, 1 })->Args({ 64, 1 })->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+#include "MazeCoreGrid.h"
+#include "MazeCoreLevel.h"
+#include <gtest/gtest.h>
+
+using namespace MazeCore;
+
+TEST(MazeCoreGrid, StartsAsWalls)
+{
+    FGrid Grid(5, 3);
+    EXPECT_EQ(Grid.GetNumCells(), 15);
+    EXPECT_EQ(Grid.CountWalkable(), 0);
+
+    Grid.SetWalkable(FCell(4, 2), true);
+    EXPECT_TRUE(Grid.IsWalkable(FCell(4, 2)));
+    EXPECT_EQ(Grid.CountWalkable(), 1);
+}
+
+TEST(MazeCoreGrid, CellsOutsideAreNotWalkable)
+{
+    FGrid Grid(2, 2);
+    Grid.SetWalkable(FCell(0, 0), true);
+    EXPECT_FALSE(Grid.IsWalkable(FCell(-1, 0)));
+    EXPECT_FALSE(Grid.IsWalkable(FCell(0, 2)));
+    EXPECT_FALSE(Grid.IsWalkable(FCell(2, 0)));
+}
+
+TEST(MazeCoreGrid, IndexRoundTrip)
+{
+    const FGrid Grid(7, 4);
+    for (int32_t Index = 0; Index < Grid.GetNumCells(); ++Index)
+    {
+        EXPECT_EQ(Grid.ToIndex(Grid.ToCell(Index)), Index);
+    }
+}
+
+TEST(MazeCoreKeys, KeyOpensDoorSharingABit)
+{
+    EXPECT_TRUE(CanKeyOpenDoor(0b0110, 0b0100));
+    EXPECT_TRUE(CanKeyOpenDoor(-1, 1 << 31));
+    EXPECT_FALSE(CanKeyOpenDoor(0b0011, 0b1100));
+    EXPECT_FALSE(CanKeyOpenDoor(0, -1));
+}
+
+TEST(MazeCoreLevel, DoorsBlockUntilOpen)
+{
+    FLevel Level;
+    Level.Grid.Reset(3, 1);
+    for (int32_t X = 0; X < 3; ++X)
+    {
+        Level.Grid.SetWalkable(FCell(X, 0), true);
+    }
+    Level.Doors.push_back(FDoor{ { FCell(1, 0) }, 1 });
+    ASSERT_TRUE(Level.IndexDoors());
+
+    EXPECT_EQ(Level.GetDoorAt(FCell(1, 0)), 0);
+    EXPECT_EQ(Level.GetDoorAt(FCell(0, 0)), NoIndex);
+    EXPECT_FALSE(Level.IsPassable(FCell(1, 0), 0));
+    EXPECT_TRUE(Level.IsPassable(FCell(1, 0), Level.GetAllDoors()));
+}
+
+TEST(MazeCoreLevel, IndexDoorsRejectsBadDoors)
+{
+    FLevel Level;
+    Level.Grid.Reset(MaxDoors + 1, 1);
+    for (int32_t X = 0; X <= MaxDoors; ++X)
+    {
+        Level.Grid.SetWalkable(FCell(X, 0), true);
+        Level.Doors.push_back(FDoor{ { FCell(X, 0) }, 1 });
+    }
+    EXPECT_FALSE(Level.IndexDoors());
+
+    Level.Doors.pop_back();
+    EXPECT_TRUE(Level.IndexDoors());
+    EXPECT_EQ(Level.GetAllDoors(), ~FDoorSet(0));
+
+    Level.Grid.SetWalkable(FCell(0, 0), false);
+    EXPECT_FALSE(Level.IndexDoors());
+}
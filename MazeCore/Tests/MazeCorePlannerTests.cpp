@@ -0,0 +1,314 @@
+#include "MazeCorePlanner.h"
+#include <deque>
+#include <map>
+#include <gtest/gtest.h>
+
+using namespace MazeCore;
+
+namespace
+{
+    // Walk a plan step by step on the grid; returns its length, or NoIndex if a step is not possible
+    int32_t ReplayPlan(const FLevel& Level, const FPlan& Plan, int32_t CarriedKey = NoIndex)
+    {
+        std::vector<FCell> KeyCells;
+        for (const FKey& Key : Level.Keys)
+        {
+            KeyCells.push_back(Key.Cell);
+        }
+        if (CarriedKey != NoIndex)
+        {
+            KeyCells[CarriedKey] = FCell(NoIndex, NoIndex);
+        }
+
+        FGridSearch Search;
+        std::vector<int32_t> Distances;
+        FCell Position = Level.Start;
+        FDoorSet OpenDoors = 0;
+        int32_t Length = 0;
+        for (const FPlanStep& Step : Plan.Steps)
+        {
+            Search.ComputeDistances(Level, OpenDoors, Position, Distances);
+            if (!Level.Grid.IsValidCell(Step.Cell) || Distances[Level.Grid.ToIndex(Step.Cell)] == NoIndex)
+            {
+                return NoIndex;
+            }
+            Length += Distances[Level.Grid.ToIndex(Step.Cell)];
+            Position = Step.Cell;
+
+            switch (Step.Action)
+            {
+            case EPlanAction::PickUpKey:
+                if (KeyCells[Step.Index] != Position)
+                {
+                    return NoIndex;
+                }
+                if (CarriedKey != NoIndex)
+                {
+                    KeyCells[CarriedKey] = Position;
+                }
+                KeyCells[Step.Index] = FCell(NoIndex, NoIndex);
+                CarriedKey = Step.Index;
+                break;
+
+            case EPlanAction::OpenDoor:
+            {
+                bool bNextToDoor = false;
+                for (const FCell& Offset : CardinalOffsets)
+                {
+                    bNextToDoor |= Level.GetDoorAt(Position + Offset) == Step.Index;
+                }
+                if (!bNextToDoor || CarriedKey == NoIndex || !CanKeyOpenDoor(Level.Keys[CarriedKey].Signature, Level.Doors[Step.Index].Mask))
+                {
+                    return NoIndex;
+                }
+                OpenDoors |= FDoorSet(1) << Step.Index;
+                break;
+            }
+
+            case EPlanAction::ReachExit:
+                return Position == Level.Exits[Step.Index] ? Length : NoIndex;
+            }
+        }
+        return NoIndex;
+    }
+
+    // Shortest plan length by a search over every (cell, carried key, open doors, key cells) state, NoIndex if none
+    int32_t SolveExhaustively(const FLevel& Level)
+    {
+        const FGrid& Grid = Level.Grid;
+        const int32_t NumKeys = static_cast<int32_t>(Level.Keys.size());
+
+        // State: cell, carried key, open doors, then the cell of each key (NoIndex while carried)
+        using FState = std::vector<int64_t>;
+        std::map<FState, int32_t> Costs;
+        std::deque<std::pair<FState, int32_t>> Queue;
+
+        FState Start = { Grid.ToIndex(Level.Start), NoIndex, 0 };
+        for (const FKey& Key : Level.Keys)
+        {
+            Start.push_back(Grid.ToIndex(Key.Cell));
+        }
+
+        // Picking up keys and opening doors is free, walking a cell costs one
+        const auto Visit = [&](const FState& State, int32_t Cost, bool bFree)
+        {
+            const auto Found = Costs.find(State);
+            if (Found == Costs.end() || Cost < Found->second)
+            {
+                Costs[State] = Cost;
+                if (bFree)
+                {
+                    Queue.push_front(std::make_pair(State, Cost));
+                }
+                else
+                {
+                    Queue.push_back(std::make_pair(State, Cost));
+                }
+            }
+        };
+        Visit(Start, 0, true);
+
+        while (!Queue.empty())
+        {
+            const FState State = Queue.front().first;
+            const int32_t Cost = Queue.front().second;
+            Queue.pop_front();
+            if (Costs[State] != Cost)
+            {
+                continue;
+            }
+
+            const FCell Cell = Grid.ToCell(static_cast<int32_t>(State[0]));
+            const int32_t Carried = static_cast<int32_t>(State[1]);
+            const FDoorSet OpenDoors = static_cast<FDoorSet>(State[2]);
+            for (const FCell& Exit : Level.Exits)
+            {
+                if (Exit == Cell)
+                {
+                    return Cost;
+                }
+            }
+
+            for (int32_t Key = 0; Key < NumKeys; ++Key)
+            {
+                if (State[3 + Key] == State[0])
+                {
+                    FState Next = State;
+                    Next[1] = Key;
+                    Next[3 + Key] = NoIndex;
+                    if (Carried != NoIndex)
+                    {
+                        Next[3 + Carried] = State[0];
+                    }
+                    Visit(Next, Cost, true);
+                }
+            }
+
+            for (const FCell& Offset : CardinalOffsets)
+            {
+                const FCell Next = Cell + Offset;
+                const int32_t Door = Level.GetDoorAt(Next);
+                if (Door != NoIndex && !IsDoorOpen(OpenDoors, Door) && Carried != NoIndex && CanKeyOpenDoor(Level.Keys[Carried].Signature, Level.Doors[Door].Mask))
+                {
+                    FState Opened = State;
+                    Opened[2] = static_cast<int64_t>(OpenDoors | (FDoorSet(1) << Door));
+                    Visit(Opened, Cost, true);
+                }
+                if (Level.IsPassable(Next, OpenDoors))
+                {
+                    FState Moved = State;
+                    Moved[0] = Grid.ToIndex(Next);
+                    Visit(Moved, Cost + 1, false);
+                }
+            }
+        }
+        return NoIndex;
+    }
+
+    FLevel MakeSmallLevel(uint32_t Seed)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = 3 + Seed % 3;
+        Params.NumDoors = 1 + Seed % 4;
+        Params.NumKeys = 1 + Seed % 3;
+        Params.LoopChance = 0.3f;
+        Params.Seed = Seed;
+        FLevel Level = FLevel::Generate(Params);
+
+        // Generated levels keep their doors far from the start; put a few keys anywhere to mix things up
+        if (Seed % 2 == 0 && !Level.Keys.empty())
+        {
+            Level.Keys.back().Cell = Level.Start;
+        }
+        return Level;
+    }
+
+    // One corridor where the nearest keys are decoys: both open doors behind a door only the far key opens
+    //   E DB . DA . DX . S A B . . C
+    FLevel MakeDecoyLevel()
+    {
+        FLevel Level;
+        Level.Grid.Reset(13, 1);
+        for (int32_t X = 0; X < 13; ++X)
+        {
+            Level.Grid.SetWalkable(FCell(X, 0), true);
+        }
+        Level.Start = FCell(7, 0);
+        Level.Keys = { FKey{ FCell(8, 0), 1 }, FKey{ FCell(9, 0), 2 }, FKey{ FCell(12, 0), 4 } };
+        Level.Doors = { FDoor{ { FCell(3, 0) }, 1 }, FDoor{ { FCell(1, 0) }, 2 }, FDoor{ { FCell(5, 0) }, 4 } };
+        Level.Exits = { FCell(0, 0) };
+        Level.IndexDoors();
+        return Level;
+    }
+}
+
+TEST(MazeCorePlanner, MatchesExhaustiveSearch)
+{
+    FKeyDoorPlanner Planner;
+    for (uint32_t Seed = 1; Seed <= 60; ++Seed)
+    {
+        const FLevel Level = MakeSmallLevel(Seed);
+        ASSERT_TRUE(Planner.Build(Level)) << "seed " << Seed;
+
+        const FPlan Plan = Planner.Solve(Level.Start);
+        const int32_t Shortest = SolveExhaustively(Level);
+        ASSERT_EQ(Plan.bSolved, Shortest != NoIndex) << "seed " << Seed;
+        if (Plan.bSolved)
+        {
+            EXPECT_TRUE(Plan.bOptimal) << "seed " << Seed;
+            EXPECT_EQ(Plan.Length, Shortest) << "seed " << Seed;
+            EXPECT_EQ(ReplayPlan(Level, Plan), Plan.Length) << "seed " << Seed;
+        }
+    }
+}
+
+TEST(MazeCorePlanner, AvoidsDecoyKeys)
+{
+    const FLevel Level = MakeDecoyLevel();
+    FGridSearch Search;
+    EXPECT_FALSE(SolveGreedy(Level, Search).bSolved);
+
+    FKeyDoorPlanner Planner;
+    ASSERT_TRUE(Planner.Build(Level));
+    const FPlan Plan = Planner.Solve(Level.Start);
+    ASSERT_TRUE(Plan.bSolved);
+    EXPECT_TRUE(Plan.bOptimal);
+    EXPECT_EQ(Plan.Length, SolveExhaustively(Level));
+    EXPECT_EQ(ReplayPlan(Level, Plan), Plan.Length);
+    ASSERT_FALSE(Plan.Steps.empty());
+    EXPECT_EQ(Plan.Steps[0].Action, EPlanAction::PickUpKey);
+    EXPECT_EQ(Plan.Steps[0].Index, 2);
+}
+
+TEST(MazeCorePlanner, StartsWithCarriedKey)
+{
+    FLevel Level = MakeDecoyLevel();
+    FKeyDoorPlanner Planner;
+    ASSERT_TRUE(Planner.Build(Level));
+
+    // Carrying the far key saves the walk to it; its cell is left empty
+    const FPlan Plan = Planner.Solve(Level.Start, 2);
+    ASSERT_TRUE(Plan.bSolved);
+    EXPECT_EQ(ReplayPlan(Level, Plan, 2), Plan.Length);
+    EXPECT_LT(Plan.Length, Planner.Solve(Level.Start).Length);
+}
+
+TEST(MazeCorePlanner, UsesKeysOffTheLevel)
+{
+    FLevel Level = MakeDecoyLevel();
+    FKeyDoorPlanner Planner;
+    ASSERT_TRUE(Planner.Build(Level));
+    const int32_t CarriedLength = Planner.Solve(Level.Start, 2).Length;
+
+    // The far key is carried in from elsewhere, so only an agent holding it gets out
+    Level.Keys[2].Cell = FCell(NoIndex, NoIndex);
+    ASSERT_TRUE(Planner.Build(Level));
+    EXPECT_FALSE(Planner.Solve(Level.Start).bSolved);
+
+    const FPlan Plan = Planner.Solve(Level.Start, 2);
+    ASSERT_TRUE(Plan.bSolved);
+    EXPECT_EQ(Plan.Length, CarriedLength);
+    EXPECT_EQ(ReplayPlan(Level, Plan, 2), Plan.Length);
+}
+
+TEST(MazeCorePlanner, SolvesLargeLevels)
+{
+    FKeyDoorPlanner Planner;
+    FGridSearch Search;
+    for (uint32_t Seed = 1; Seed <= 10; ++Seed)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = 32;
+        Params.NumDoors = MaxDoors;
+        Params.NumKeys = MaxKeys;
+        Params.Seed = Seed;
+        const FLevel Level = FLevel::Generate(Params);
+        ASSERT_EQ(static_cast<int32_t>(Level.Doors.size()), MaxDoors);
+        ASSERT_TRUE(Planner.Build(Level));
+
+        // Generated levels can always be solved, even when the search runs out of budget
+        const FPlan Plan = Planner.Solve(Level.Start);
+        ASSERT_TRUE(Plan.bSolved) << "seed " << Seed;
+        EXPECT_EQ(Plan.bOptimal, !Planner.GetStats().bHitLimit);
+        EXPECT_EQ(ReplayPlan(Level, Plan), Plan.Length) << "seed " << Seed;
+
+        const FPlan Greedy = SolveGreedy(Level, Search);
+        if (Greedy.bSolved)
+        {
+            EXPECT_LE(Plan.Length, Greedy.Length) << "seed " << Seed;
+        }
+    }
+}
+
+TEST(MazeCorePlanner, RejectsBadLevels)
+{
+    FLevel Level = MakeDecoyLevel();
+    Level.Keys[0].Cell = FCell(3, 0);
+    FKeyDoorPlanner Planner;
+    EXPECT_FALSE(Planner.Build(Level));
+
+    Level = MakeDecoyLevel();
+    Level.Exits.clear();
+    ASSERT_TRUE(Planner.Build(Level));
+    EXPECT_FALSE(Planner.Solve(Level.Start).bSolved);
+}
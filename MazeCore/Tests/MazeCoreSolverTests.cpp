@@ -0,0 +1,174 @@
+#include "MazeCoreSolvers.h"
+#include <gtest/gtest.h>
+
+using namespace MazeCore;
+
+namespace
+{
+    // Open every door in index order with the key it needs, then walk to the exit; true if that works
+    bool SolveInDoorOrder(const FLevel& Level, FGridSearch& Search)
+    {
+        std::vector<FCell> KeyCells;
+        for (const FKey& Key : Level.Keys)
+        {
+            KeyCells.push_back(Key.Cell);
+        }
+
+        std::vector<int32_t> Distances;
+        FCell Position = Level.Start;
+        int32_t CarriedKey = NoIndex;
+        FDoorSet OpenDoors = 0;
+        for (int32_t Door = 0; Door < static_cast<int32_t>(Level.Doors.size()); ++Door)
+        {
+            Search.ComputeDistances(Level, OpenDoors, Position, Distances);
+
+            int32_t Key = CarriedKey;
+            if (Key == NoIndex || !CanKeyOpenDoor(Level.Keys[Key].Signature, Level.Doors[Door].Mask))
+            {
+                for (Key = 0; Key < static_cast<int32_t>(Level.Keys.size()); ++Key)
+                {
+                    if (Key != CarriedKey && CanKeyOpenDoor(Level.Keys[Key].Signature, Level.Doors[Door].Mask))
+                    {
+                        break;
+                    }
+                }
+                if (Key == static_cast<int32_t>(Level.Keys.size()) || Distances[Level.Grid.ToIndex(KeyCells[Key])] == NoIndex)
+                {
+                    return false;
+                }
+
+                Position = KeyCells[Key];
+                if (CarriedKey != NoIndex)
+                {
+                    KeyCells[CarriedKey] = Position;
+                }
+                CarriedKey = Key;
+            }
+            OpenDoors |= FDoorSet(1) << Door;
+        }
+
+        Search.ComputeDistances(Level, OpenDoors, Position, Distances);
+        return !Level.Exits.empty() && Distances[Level.Grid.ToIndex(Level.Exits[0])] != NoIndex;
+    }
+
+    // A corridor: start, door 0, key 1, door 1, exit, with key 0 behind the start
+    FLevel MakeCorridor()
+    {
+        FLevel Level;
+        Level.Grid.Reset(7, 1);
+        for (int32_t X = 0; X < 7; ++X)
+        {
+            Level.Grid.SetWalkable(FCell(X, 0), true);
+        }
+        Level.Start = FCell(1, 0);
+        Level.Keys = { FKey{ FCell(0, 0), 1 }, FKey{ FCell(3, 0), 2 } };
+        Level.Doors = { FDoor{ { FCell(2, 0) }, 1 }, FDoor{ { FCell(4, 0) }, 2 } };
+        Level.Exits = { FCell(6, 0) };
+        Level.IndexDoors();
+        return Level;
+    }
+}
+
+TEST(MazeCoreSearch, AStarMatchesBreadthFirst)
+{
+    FGridSearch Search;
+    std::vector<int32_t> Distances;
+    std::vector<FCell> Path;
+    for (uint32_t Seed = 1; Seed <= 20; ++Seed)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = 12;
+        Params.LoopChance = 0.2f;
+        Params.Seed = Seed;
+        const FLevel Level = FLevel::Generate(Params);
+
+        Search.ComputeDistances(Level, Level.GetAllDoors(), Level.Start, Distances);
+        for (int32_t Index = 0; Index < Level.Grid.GetNumCells(); Index += 7)
+        {
+            Path.clear();
+            const bool bFound = Search.FindPath(Level, Level.GetAllDoors(), Level.Start, Level.Grid.ToCell(Index), Path);
+            ASSERT_EQ(bFound, Distances[Index] != NoIndex) << "seed " << Seed << " cell " << Index;
+            if (!bFound)
+            {
+                continue;
+            }
+
+            ASSERT_EQ(static_cast<int32_t>(Path.size()), Distances[Index]);
+            FCell Previous = Level.Start;
+            for (const FCell& Cell : Path)
+            {
+                EXPECT_EQ(ManhattanDistance(Previous, Cell), 1);
+                EXPECT_TRUE(Level.IsPassable(Cell, Level.GetAllDoors()));
+                Previous = Cell;
+            }
+        }
+    }
+}
+
+TEST(MazeCoreSearch, ClosedDoorsBlockPaths)
+{
+    const FLevel Level = MakeCorridor();
+    FGridSearch Search;
+    std::vector<FCell> Path;
+    EXPECT_FALSE(Search.FindPath(Level, 0, Level.Start, Level.Exits[0], Path));
+    EXPECT_TRUE(Search.FindPath(Level, Level.GetAllDoors(), Level.Start, Level.Exits[0], Path));
+    EXPECT_EQ(Path.size(), 5u);
+}
+
+TEST(MazeCoreGenerate, SameSeedSameLevel)
+{
+    FLevelParams Params;
+    Params.Seed = 42;
+    const FLevel First = FLevel::Generate(Params);
+    const FLevel Second = FLevel::Generate(Params);
+    ASSERT_EQ(First.Keys.size(), Second.Keys.size());
+    for (size_t Key = 0; Key < First.Keys.size(); ++Key)
+    {
+        EXPECT_EQ(First.Keys[Key].Cell, Second.Keys[Key].Cell);
+    }
+    EXPECT_EQ(First.Exits, Second.Exits);
+}
+
+TEST(MazeCoreGenerate, LevelsAreSolvableInDoorOrder)
+{
+    FGridSearch Search;
+    for (uint32_t Seed = 1; Seed <= 100; ++Seed)
+    {
+        FLevelParams Params;
+        Params.RoomsPerSide = 8 + Seed % 10;
+        Params.NumDoors = 1 + Seed % 12;
+        Params.NumKeys = 1 + Seed % 5;
+        Params.Seed = Seed;
+        const FLevel Level = FLevel::Generate(Params);
+
+        ASSERT_EQ(static_cast<int32_t>(Level.Doors.size()), Params.NumDoors);
+        ASSERT_EQ(static_cast<int32_t>(Level.Keys.size()), Params.NumKeys);
+        ASSERT_EQ(Level.Exits.size(), 1u);
+        EXPECT_TRUE(SolveInDoorOrder(Level, Search)) << "seed " << Seed;
+    }
+}
+
+TEST(MazeCoreGreedy, SolvesCorridor)
+{
+    const FLevel Level = MakeCorridor();
+    FGridSearch Search;
+    const FPlan Plan = SolveGreedy(Level, Search);
+    ASSERT_TRUE(Plan.bSolved);
+
+    // Back for key 0, through door 0 to key 1, through door 1 to the exit
+    ASSERT_EQ(Plan.Steps.size(), 5u);
+    EXPECT_EQ(Plan.Steps[0].Action, EPlanAction::PickUpKey);
+    EXPECT_EQ(Plan.Steps[1].Action, EPlanAction::OpenDoor);
+    EXPECT_EQ(Plan.Steps[2].Action, EPlanAction::PickUpKey);
+    EXPECT_EQ(Plan.Steps[3].Action, EPlanAction::OpenDoor);
+    EXPECT_EQ(Plan.Steps[4].Action, EPlanAction::ReachExit);
+    EXPECT_EQ(Plan.Length, 1 + 1 + 2 + 0 + 3);
+}
+
+TEST(MazeCoreGreedy, FailsWithoutTheKey)
+{
+    FLevel Level = MakeCorridor();
+    Level.Keys.pop_back();
+    FGridSearch Search;
+    EXPECT_FALSE(SolveGreedy(Level, Search).bSolved);
+}
@@ -7,6 +7,8 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "DrawDebugHelpers.h"
 #include "Navigation/PathFollowingComponent.h"
+#include "MazeAgentMonitorSubsystem.h"
+#include "MazeAIStatusText.h"
 
 UBTService_ErrorDetection::UBTService_ErrorDetection()
 {
@@ -15,6 +17,16 @@ UBTService_ErrorDetection::UBTService_ErrorDetection()
     RandomDeviation = 0.1f;
 }
 
+void UBTService_ErrorDetection::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+    InitializeNodeMemory<FBTErrorDetectionMemory>(NodeMemory, InitType);
+}
+
+void UBTService_ErrorDetection::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+    CleanupNodeMemory<FBTErrorDetectionMemory>(NodeMemory, CleanupType);
+}
+
 void UBTService_ErrorDetection::TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
 {
     Super::TickNode(OwnerComp, NodeMemory, DeltaSeconds);
@@ -48,20 +60,17 @@ void UBTService_ErrorDetection::TickNode(UBehaviorTreeComponent& OwnerComp, uint
     // Get current location
     FVector CurrentLocation = ControlledPawn->GetActorLocation();
     
+    // Timers belong to this agent's tree instance, not to the shared node
+    FBTErrorDetectionMemory* Memory = CastInstanceNodeMemory<FBTErrorDetectionMemory>(NodeMemory);
+    
     // Check for navigation errors
-    CheckNavigationErrors(MazeAIController, CurrentLocation);
+    CheckNavigationErrors(MazeAIController, *Memory, CurrentLocation, DeltaSeconds);
     
     // Check for state-specific errors
     UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
     if (BlackboardComp)
     {
-        CheckStateErrors(MazeAIController, BlackboardComp);
-    }
-    
-    // Draw debug information if enabled
-    if (bDrawDebugInfo)
-    {
-        MazeAIController->DrawDebugInfo(Interval * 1.1f);
+        CheckStateErrors(MazeAIController, BlackboardComp, *Memory, DeltaSeconds);
     }
 }
 
@@ -71,28 +80,29 @@ FString UBTService_ErrorDetection::GetStaticDescription() const
                          StuckDistanceThreshold, MaxStuckTime, MaxPathFollowingTime);
 }
 
-bool UBTService_ErrorDetection::IsAIStuck(const AAIController* AIController, const FVector& CurrentLocation)
+bool UBTService_ErrorDetection::UpdateStuckTime(FBTErrorDetectionMemory& Memory, const FVector& CurrentLocation, bool bIsMoving, float DeltaSeconds) const
 {
     // First call, initialize last location
-    if (LastLocation.IsZero())
+    if (!Memory.bHasLastLocation)
     {
-        LastLocation = CurrentLocation;
-        StuckTime = 0.0f;
+        Memory.LastLocation = CurrentLocation;
+        Memory.bHasLastLocation = true;
+        Memory.StuckTime = 0.0f;
         return false;
     }
     
     // Check if AI has moved
-    float DistanceSquared = FVector::DistSquared(CurrentLocation, LastLocation);
+    const float DistanceSquared = FVector::DistSquared(CurrentLocation, Memory.LastLocation);
     if (DistanceSquared < StuckDistanceThreshold * StuckDistanceThreshold)
     {
         // AI hasn't moved much, increment stuck time
-        StuckTime += Interval;
+        Memory.StuckTime += DeltaSeconds;
         
         // Check if we're trying to move
-        if (AIController->GetPathFollowingComponent()->GetStatus() == EPathFollowingStatus::Moving)
+        if (bIsMoving)
         {
             // If stuck for too long while trying to move, report stuck
-            if (StuckTime >= MaxStuckTime)
+            if (Memory.StuckTime >= MaxStuckTime)
             {
                 return true;
             }
@@ -100,51 +110,88 @@ bool UBTService_ErrorDetection::IsAIStuck(const AAIController* AIController, con
         else
         {
             // If not trying to move, don't consider it stuck
-            StuckTime = 0.0f;
+            Memory.StuckTime = 0.0f;
         }
     }
     else
     {
         // AI is moving, reset stuck time
-        StuckTime = 0.0f;
+        Memory.StuckTime = 0.0f;
     }
     
     // Update last location
-    LastLocation = CurrentLocation;
+    Memory.LastLocation = CurrentLocation;
     
     return false;
 }
 
-void UBTService_ErrorDetection::CheckNavigationErrors(AMazeBlazeAIController* MazeAIController, const FVector& CurrentLocation)
+bool UBTService_ErrorDetection::UpdatePathFollowingTime(FBTErrorDetectionMemory& Memory, bool bIsMoving, float DeltaSeconds) const
 {
-    // Check if AI is stuck
-    if (IsAIStuck(MazeAIController, CurrentLocation))
+    if (!bIsMoving)
     {
-        MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
-                                      TEXT("AI appears to be stuck while moving"));
-        return;
+        // Reset timer if not moving
+        Memory.PathFollowingTimer = 0.0f;
+        return false;
+    }
+    
+    Memory.PathFollowingTimer += DeltaSeconds;
+    if (Memory.PathFollowingTimer > MaxPathFollowingTime)
+    {
+        // Reset timer
+        Memory.PathFollowingTimer = 0.0f;
+        return true;
+    }
+    return false;
+}
+
+bool UBTService_ErrorDetection::UpdateTimeInState(FBTErrorDetectionMemory& Memory, EAIState CurrentState, float DeltaSeconds) const
+{
+    // Check if state has changed
+    if (!Memory.bHasLastState || CurrentState != Memory.LastState)
+    {
+        // Reset time in state
+        Memory.TimeInState = 0.0f;
+        Memory.LastState = CurrentState;
+        Memory.bHasLastState = true;
+        return false;
     }
     
-    // Check path following status
-    if (MazeAIController->GetPathFollowingComponent()->GetStatus() == EPathFollowingStatus::Moving)
+    // Increment time in state
+    Memory.TimeInState += DeltaSeconds;
+    
+    // Check if we've been in the same state too long
+    if (Memory.TimeInState > MaxTaskExecutionTime)
     {
-        PathFollowingTimer += Interval;
+        // Reset time in state
+        Memory.TimeInState = 0.0f;
+        return true;
+    }
+    return false;
+}
+
+void UBTService_ErrorDetection::CheckNavigationErrors(AMazeBlazeAIController* MazeAIController, FBTErrorDetectionMemory& Memory, const FVector& CurrentLocation, float DeltaSeconds) const
+{
+    // Monitored agents get their stuck and path following timeouts from the agent monitor
+    const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(MazeAIController);
+    if (!AgentMonitor || !AgentMonitor->IsMonitored(MazeAIController))
+    {
+        const bool bIsMoving = MazeAIController->IsTryingToMove();
+        
+        // Check if AI is stuck
+        if (UpdateStuckTime(Memory, CurrentLocation, bIsMoving, DeltaSeconds))
+        {
+            MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
+                                          TEXT("AI appears to be stuck while moving"));
+            return;
+        }
         
         // If path following takes too long, report error
-        if (PathFollowingTimer > MaxPathFollowingTime)
+        if (UpdatePathFollowingTime(Memory, bIsMoving, DeltaSeconds))
         {
             MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
                                           TEXT("Path following taking too long"));
-            
-            // Reset timer
-            PathFollowingTimer = 0.0f;
         }
     }
-    else
-    {
-        // Reset timer if not moving
-        PathFollowingTimer = 0.0f;
-    }
     
     // Check if we're on a valid navigation mesh
     UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(MazeAIController->GetWorld());
@@ -159,33 +206,21 @@ void UBTService_ErrorDetection::CheckNavigationErrors(AMazeBlazeAIController* Ma
     }
 }
 
-void UBTService_ErrorDetection::CheckStateErrors(AMazeBlazeAIController* MazeAIController, UBlackboardComponent* BlackboardComp)
+void UBTService_ErrorDetection::CheckStateErrors(AMazeBlazeAIController* MazeAIController, UBlackboardComponent* BlackboardComp, FBTErrorDetectionMemory& Memory, float DeltaSeconds) const
 {
     // Get current state
     EAIState CurrentState = MazeAIController->GetCurrentState();
     
-    // Check if state has changed
-    if (CurrentState != LastState)
+    // Monitored agents get their state timeout and time in state from the agent monitor
+    const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(MazeAIController);
+    if (AgentMonitor && AgentMonitor->IsMonitored(MazeAIController))
     {
-        // Reset time in state
-        TimeInState = 0.0f;
-        LastState = CurrentState;
+        Memory.TimeInState = AgentMonitor->GetTimeInState(MazeAIController);
     }
-    else
+    else if (UpdateTimeInState(Memory, CurrentState, DeltaSeconds))
     {
-        // Increment time in state
-        TimeInState += Interval;
-        
-        // Check if we've been in the same state too long
-        if (TimeInState > MaxTaskExecutionTime)
-        {
-            MazeAIController->ReportAIError(EAIErrorType::TaskExecutionFailed, 
-                                          FString::Printf(TEXT("Stuck in state %s for too long"), 
-                                                        *UEnum::GetValueAsString(CurrentState)));
-            
-            // Reset time in state
-            TimeInState = 0.0f;
-        }
+        // We've been in the same state too long
+        MazeAIController->ReportAIError(EAIErrorType::TaskExecutionFailed, FMazeAIStatusText::GetStateTimeoutMessage(CurrentState));
     }
     
     // Check for state-specific errors
@@ -197,7 +232,7 @@ void UBTService_ErrorDetection::CheckStateErrors(AMazeBlazeAIController* MazeAIC
             if (!BlackboardComp->GetValueAsObject("VisibleKeys"))
             {
                 // If we've been seeking a key for a while but don't see one, report error
-                if (TimeInState > 5.0f)
+                if (Memory.TimeInState > 5.0f)
                 {
                     MazeAIController->ReportAIError(EAIErrorType::TaskExecutionFailed, 
                                                   TEXT("Seeking key but no key is visible"));
@@ -213,7 +248,7 @@ void UBTService_ErrorDetection::CheckStateErrors(AMazeBlazeAIController* MazeAIC
                 !BlackboardComp->GetValueAsObject("VisibleDoors"))
             {
                 // If we've been seeking a door for a while but don't have a key or don't see a door, report error
-                if (TimeInState > 5.0f)
+                if (Memory.TimeInState > 5.0f)
                 {
                     MazeAIController->ReportAIError(EAIErrorType::TaskExecutionFailed, 
                                                   TEXT("Seeking door but no key or door is available"));
@@ -8,9 +8,35 @@
 #include "MazeBlazeAIController.h"
 #include "BTService_ErrorDetection.generated.h"
 
+/**
+ * Per-agent error detection state, kept in the node memory of each behavior tree instance
+ */
+struct FBTErrorDetectionMemory
+{
+    // Time tracking for path following
+    float PathFollowingTimer = 0.0f;
+    
+    // Last known location for stuck detection
+    FVector LastLocation = FVector::ZeroVector;
+    bool bHasLastLocation = false;
+    
+    // Time at same location
+    float StuckTime = 0.0f;
+    
+    // Last known state
+    EAIState LastState = EAIState::Exploring;
+    bool bHasLastState = false;
+    
+    // Time in current state
+    float TimeInState = 0.0f;
+};
+
 /**
  * Behavior Tree service that continuously monitors for AI errors
  * This service should be attached to the root node of the behavior tree
+ *
+ * The node is shared by every agent running the tree, so all timers live in node memory. Agents
+ * registered with the agent monitor use its timers and thresholds instead of these.
  */
 UCLASS()
 class MAZEBLAZE_API UBTService_ErrorDetection : public UBTService
@@ -21,6 +47,9 @@ public:
     UBTService_ErrorDetection();
     
     virtual void TickNode(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+    virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTErrorDetectionMemory); }
+    virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+    virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
     virtual FString GetStaticDescription() const override;
     
  protected:
@@ -40,32 +69,19 @@ public:
     UPROPERTY(EditAnywhere, Category = "Error Detection")
     float StuckDistanceThreshold = 50.0f;
     
-    // Whether to draw debug information
-    UPROPERTY(EditAnywhere, Category = "Debug")
-    bool bDrawDebugInfo = true;
-    
 private:
-    // Time tracking for path following
-    float PathFollowingTimer = 0.0f;
-    
-    // Last known location for stuck detection
-    FVector LastLocation = FVector::ZeroVector;
+    // Advance an agent's stuck timer; true once it has tried to move without getting anywhere for MaxStuckTime
+    bool UpdateStuckTime(FBTErrorDetectionMemory& Memory, const FVector& CurrentLocation, bool bIsMoving, float DeltaSeconds) const;
     
-    // Time at same location
-    float StuckTime = 0.0f;
-    
-    // Last known state
-    EAIState LastState;
-    
-    // Time in current state
-    float TimeInState = 0.0f;
+    // Advance an agent's path following timer; true (and restarted) once a move has taken longer than MaxPathFollowingTime
+    bool UpdatePathFollowingTime(FBTErrorDetectionMemory& Memory, bool bIsMoving, float DeltaSeconds) const;
     
-    // Check if AI is stuck
-    bool IsAIStuck(const AAIController* AIController, const FVector& CurrentLocation);
+    // Advance an agent's time in its state; true (and restarted) once it has stayed longer than MaxTaskExecutionTime
+    bool UpdateTimeInState(FBTErrorDetectionMemory& Memory, EAIState CurrentState, float DeltaSeconds) const;
     
     // Check for navigation errors
-    void CheckNavigationErrors(AMazeBlazeAIController* MazeAIController, const FVector& CurrentLocation);
+    void CheckNavigationErrors(AMazeBlazeAIController* MazeAIController, FBTErrorDetectionMemory& Memory, const FVector& CurrentLocation, float DeltaSeconds) const;
     
     // Check for state-specific errors
-    void CheckStateErrors(AMazeBlazeAIController* MazeAIController, UBlackboardComponent* BlackboardComp);
+    void CheckStateErrors(AMazeBlazeAIController* MazeAIController, UBlackboardComponent* BlackboardComp, FBTErrorDetectionMemory& Memory, float DeltaSeconds) const;
 };
\ No newline at end of file
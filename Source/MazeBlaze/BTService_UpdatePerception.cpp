@@ -22,15 +22,16 @@ void UBTService_UpdatePerception::TickNode(UBehaviorTreeComponent& OwnerComp, ui
 		return;
 	}
 	
-	// If we're using our custom AI controller, update perception
+	// If we're using our custom AI controller, update perception if it has been invalidated
+	// Controllers time-sliced by the AI scheduler are updated there
 	AMazeBlazeAIController* MazeAIController = Cast<AMazeBlazeAIController>(AIController);
-	if (MazeAIController)
+	if (MazeAIController && !MazeAIController->IsUpdateScheduled())
 	{
-		MazeAIController->UpdatePerception();
+		MazeAIController->UpdatePerceptionIfNeeded();
 	}
 }
 
 FString UBTService_UpdatePerception::GetStaticDescription() const
 {
-	return FString::Printf(TEXT("Updates the AI's perception of keys, doors, and exits every %.1f seconds"), Interval);
+	return FString::Printf(TEXT("Updates the AI's perception of keys, doors, and exits every %.1f seconds when it is stale"), Interval);
 }
\ No newline at end of file
@@ -3,11 +3,15 @@
 #include "AIController.h"
 #include "NavigationSystem.h"
 #include "MazeBlazeAIController.h"
+#include "MazeAsyncNavigationSubsystem.h"
+#include "MazePathCacheSubsystem.h"
+#include "MazeFlowFieldSubsystem.h"
 #include "Navigation/PathFollowingComponent.h"
 
 UBTTask_MoveToTarget::UBTTask_MoveToTarget()
 {
 	NodeName = TEXT("Move To Target");
+	bNotifyTick = true;
 	
 	// Accept vectors as the blackboard key
 	BlackboardKey.AddVectorFilter(this, GET_MEMBER_NAME_CHECKED(UBTTask_MoveToTarget, BlackboardKey));
@@ -50,26 +54,168 @@ EBTNodeResult::Type UBTTask_MoveToTarget::ExecuteTask(UBehaviorTreeComponent& Ow
 		return EBTNodeResult::Succeeded;
 	}
 	
-	// Move to the target location
-	FAIMoveRequest MoveRequest;
-	MoveRequest.SetGoalLocation(TargetLocation);
-	MoveRequest.SetAcceptanceRadius(AcceptableRadius);
-	MoveRequest.SetUsePathfinding(bUsePathfinding);
-	MoveRequest.SetAllowPartialPath(bAllowPartialPath);
-	MoveRequest.SetProjectGoalLocation(bProjectGoalLocation);
+	// Agents sharing a target read one flow field instead of each finding a path
+	UMazeFlowFieldSubsystem* FlowFields = bUseFlowField && bUsePathfinding ? UMazeFlowFieldSubsystem::Get(AIController) : nullptr;
+	FVector Direction;
+	float RemainingDistance = 0.0f;
+	if (FlowFields && FlowFields->GetFlowDirection(TargetLocation, ControlledPawn->GetActorLocation(), Direction, RemainingDistance))
+	{
+		FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+		Memory->bFollowingFlowField = true;
+		Memory->SteeringTarget = TargetLocation;
+		ControlledPawn->AddMovementInput(Direction);
+		return EBTNodeResult::InProgress;
+	}
+	
+	// Strategies with a maze model of their own steer or route over it instead of querying the navmesh
+	AMazeBlazeAIController* MazeController = Cast<AMazeBlazeAIController>(AIController);
+	IMazeExplorationStrategy* Strategy = MazeController ? MazeController->GetExplorationStrategy() : nullptr;
+	if (bUsePathfinding && Strategy && Strategy->GetSteeringDirection(*MazeController, TargetLocation, Direction))
+	{
+		if (Direction.IsZero())
+		{
+			return EBTNodeResult::Succeeded;
+		}
+		
+		FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+		Memory->bSteeringByStrategy = true;
+		Memory->SteeringTarget = TargetLocation;
+		ControlledPawn->AddMovementInput(Direction);
+		return EBTNodeResult::InProgress;
+	}
+	
+	// Routing where the strategy does not steer, or its field is flat around the agent
+	if (bUsePathfinding && Strategy)
+	{
+		TArray<FVector> PathPoints;
+		if (Strategy->FindPathToTarget(*MazeController, TargetLocation, PathPoints)
+			&& StartMove(OwnerComp, TargetLocation, MakeShared<FNavigationPath, ESPMode::ThreadSafe>(PathPoints)))
+		{
+			return EBTNodeResult::InProgress;
+		}
+	}
+	
+	FVector GoalLocation = TargetLocation;
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(AIController->GetWorld());
+	FNavLocation ProjectedGoal;
+	if (bUsePathfinding && bProjectGoalLocation && NavSys && NavSys->ProjectPointToNavigation(TargetLocation, ProjectedGoal, INVALID_NAVEXTENT, nullptr))
+	{
+		GoalLocation = ProjectedGoal.Location;
+	}
+	
+	// Agents heading for the same exit or door share their navmesh paths, whether they were found on the workers or not
+	UMazePathCacheSubsystem* PathCache = bUsePathfinding ? UMazePathCacheSubsystem::Get(AIController) : nullptr;
+	if (PathCache)
+	{
+		TArray<FVector> PathPoints;
+		if (PathCache->FindPath(ControlledPawn->GetActorLocation(), GoalLocation, PathPoints) != EMazePathCacheHit::None
+			&& StartMove(OwnerComp, TargetLocation, MakeShared<FNavigationPath, ESPMode::ThreadSafe>(PathPoints)))
+		{
+			return EBTNodeResult::InProgress;
+		}
+	}
+	
+	// Navmesh paths are found on the workers; the task goes on when the path comes back
+	UMazeAsyncNavigationSubsystem* AsyncNavigation = bUsePathfinding ? UMazeAsyncNavigationSubsystem::Get(AIController) : nullptr;
+	if (AsyncNavigation)
+	{
+		FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+		Memory->PathQueryId = AsyncNavigation->RequestPath(AIController->GetNavAgentPropertiesRef(), ControlledPawn->GetActorLocation(), GoalLocation, bAllowPartialPath,
+			FMazeAsyncPathDelegate::CreateUObject(this, &UBTTask_MoveToTarget::HandlePathFound, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp), TargetLocation,
+				PathCache ? PathCache->GetVersion() : 0u));
+		if (Memory->PathQueryId != 0)
+		{
+			return EBTNodeResult::InProgress;
+		}
+	}
+	
+	const uint32 PathCacheVersion = PathCache ? PathCache->GetVersion() : 0;
 	
 	FNavPathSharedPtr NavPath;
-	AIController->MoveTo(MoveRequest, &NavPath);
+	const FPathFollowingRequestResult MoveResult = AIController->MoveTo(MakeMoveRequest(TargetLocation), &NavPath);
 	
 	// Check if we have a valid path
-	if (!NavPath || (NavPath->IsPartial() && !bAllowPartialPath))
+	if (MoveResult.Code == EPathFollowingRequestResult::Failed || !NavPath || (NavPath->IsPartial() && !bAllowPartialPath))
 	{
 		return EBTNodeResult::Failed;
 	}
+	if (MoveResult.Code == EPathFollowingRequestResult::AlreadyAtGoal)
+	{
+		return EBTNodeResult::Succeeded;
+	}
+	if (PathCache)
+	{
+		PathCache->AddPath(PathCacheVersion, *NavPath);
+	}
 	
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveResult.MoveId);
 	return EBTNodeResult::InProgress;
 }
 
+void UBTTask_MoveToTarget::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	// Navmesh moves end through the move finished message
+	FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+	if (!Memory->bFollowingFlowField && !Memory->bSteeringByStrategy)
+	{
+		return;
+	}
+	
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	APawn* ControlledPawn = AIController ? AIController->GetPawn() : nullptr;
+	if (!ControlledPawn)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	if (FVector::Dist(ControlledPawn->GetActorLocation(), Memory->SteeringTarget) <= AcceptableRadius)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+		return;
+	}
+	
+	FVector Direction;
+	if (Memory->bSteeringByStrategy)
+	{
+		// The strategy stops steering on its goal, or where its field goes flat and the tree should route again
+		AMazeBlazeAIController* MazeController = Cast<AMazeBlazeAIController>(AIController);
+		IMazeExplorationStrategy* Strategy = MazeController ? MazeController->GetExplorationStrategy() : nullptr;
+		if (!Strategy || !Strategy->GetSteeringDirection(*MazeController, Memory->SteeringTarget, Direction))
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+			return;
+		}
+		if (Direction.IsZero())
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+			return;
+		}
+		ControlledPawn->AddMovementInput(Direction);
+		return;
+	}
+	
+	UMazeFlowFieldSubsystem* FlowFields = UMazeFlowFieldSubsystem::Get(AIController);
+	float RemainingDistance = 0.0f;
+	if (!FlowFields || !FlowFields->GetFlowDirection(Memory->SteeringTarget, ControlledPawn->GetActorLocation(), Direction, RemainingDistance))
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	ControlledPawn->AddMovementInput(Direction);
+}
+
+EBTNodeResult::Type UBTTask_MoveToTarget::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+	if (UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(OwnerComp.GetOwner()))
+	{
+		AsyncNavigation->CancelQuery(Memory->PathQueryId);
+	}
+	Memory->PathQueryId = 0;
+	
+	return Super::AbortTask(OwnerComp, NodeMemory);
+}
+
 void UBTTask_MoveToTarget::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
 {
 	// Get the AI controller
@@ -79,11 +225,81 @@ void UBTTask_MoveToTarget::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uin
 		// Stop movement when the task is finished
 		AIController->StopMovement();
 	}
+	FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+	Memory->PathQueryId = 0;
+	Memory->bFollowingFlowField = false;
+	Memory->bSteeringByStrategy = false;
 	
 	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
 }
 
+void UBTTask_MoveToTarget::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTMoveToTargetMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_MoveToTarget::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTMoveToTargetMemory>(NodeMemory, CleanupType);
+}
+
+FAIMoveRequest UBTTask_MoveToTarget::MakeMoveRequest(const FVector& TargetLocation) const
+{
+	FAIMoveRequest MoveRequest;
+	MoveRequest.SetGoalLocation(TargetLocation);
+	MoveRequest.SetAcceptanceRadius(AcceptableRadius);
+	MoveRequest.SetUsePathfinding(bUsePathfinding);
+	MoveRequest.SetAllowPartialPath(bAllowPartialPath);
+	MoveRequest.SetProjectGoalLocation(bProjectGoalLocation);
+	return MoveRequest;
+}
+
+bool UBTTask_MoveToTarget::StartMove(UBehaviorTreeComponent& OwnerComp, const FVector& TargetLocation, FNavPathSharedPtr Path) const
+{
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	const FAIRequestID MoveId = AIController ? AIController->RequestMove(MakeMoveRequest(TargetLocation), Path) : FAIRequestID::InvalidRequest;
+	if (!MoveId.IsValid())
+	{
+		return false;
+	}
+	
+	// The path following component reports the end of the move to the brain component
+	WaitForMessage(OwnerComp, UBrainComponent::AIMessage_MoveFinished, MoveId);
+	return true;
+}
+
+void UBTTask_MoveToTarget::HandlePathFound(uint32 QueryId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr, FVector TargetLocation, uint32 PathCacheVersion)
+{
+	// Worth keeping for the other agents even if this one moved on
+	UMazePathCacheSubsystem* PathCache = UMazePathCacheSubsystem::Get(OwnerCompPtr.Get());
+	if (PathCache && Path.IsValid())
+	{
+		PathCache->AddPath(PathCacheVersion, *Path);
+	}
+	
+	UBehaviorTreeComponent* OwnerComp = OwnerCompPtr.Get();
+	if (!OwnerComp)
+	{
+		return;
+	}
+	
+	// The query belongs to the run of the task still waiting for it, or it is stale
+	uint8* NodeMemory = OwnerComp->GetNodeMemory(this, OwnerComp->FindInstanceContainingNode(this));
+	FBTMoveToTargetMemory* Memory = CastInstanceNodeMemory<FBTMoveToTargetMemory>(NodeMemory);
+	if (!Memory || Memory->PathQueryId != QueryId)
+	{
+		return;
+	}
+	Memory->PathQueryId = 0;
+	
+	if (!Path.IsValid() || !StartMove(*OwnerComp, TargetLocation, Path))
+	{
+		FinishLatentTask(*OwnerComp, EBTNodeResult::Failed);
+	}
+}
+
 FString UBTTask_MoveToTarget::GetStaticDescription() const
 {
-	return FString::Printf(TEXT("Move To Target: %s\nAcceptable Radius: %.1f"), *BlackboardKey.SelectedKeyName.ToString(), AcceptableRadius);
+	return FString::Printf(TEXT("Move To Target: %s\nAcceptable Radius: %.1f%s"), *BlackboardKey.SelectedKeyName.ToString(), AcceptableRadius,
+		bUseFlowField ? TEXT("\nFollows Flow Field") : TEXT(""));
 }
\ No newline at end of file
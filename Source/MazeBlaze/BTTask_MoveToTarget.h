@@ -2,10 +2,28 @@
 
 #include "CoreMinimal.h"
 #include "BehaviorTree/Tasks/BTTask_BlackboardBase.h"
+#include "AITypes.h"
+#include "NavigationData.h"
 #include "BTTask_MoveToTarget.generated.h"
 
+struct FBTMoveToTargetMemory
+{
+	// Async path query in flight, 0 when none
+	uint32 PathQueryId = 0;
+
+	// Steering along the shared flow field, or by the exploration strategy, to this location rather than a navmesh move
+	bool bFollowingFlowField = false;
+	bool bSteeringByStrategy = false;
+	FVector SteeringTarget = FVector::ZeroVector;
+};
+
 /**
  * Behavior Tree Task for moving to a target location
+ *
+ * Navmesh paths come from the shared path cache or are found on the async navigation workers,
+ * and the task finishes when the move does. With bUseFlowField the agent instead follows the flow
+ * field shared by every agent heading for the same cell, and strategies that steer by a shared
+ * field (PotentialField) steer the agent every tick.
  */
 UCLASS()
 class MAZEBLAZE_API UBTTask_MoveToTarget : public UBTTask_BlackboardBase
@@ -16,7 +34,12 @@ public:
 	UBTTask_MoveToTarget();
 	
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
 	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTMoveToTargetMemory); }
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual FString GetStaticDescription() const override;
 
 	// How close the AI needs to get to the target
@@ -34,4 +57,17 @@ public:
 	// Whether to project the target point to navigation
 	UPROPERTY(EditAnywhere, Category = "Movement")
 	bool bProjectGoalLocation = true;
+
+	// Whether to follow the shared flow field to the target, for targets many agents walk to
+	UPROPERTY(EditAnywhere, Category = "Movement")
+	bool bUseFlowField = false;
+
+private:
+	FAIMoveRequest MakeMoveRequest(const FVector& TargetLocation) const;
+
+	// Start moving along a path and wait for the move to finish; returns false if the move could not start
+	bool StartMove(UBehaviorTreeComponent& OwnerComp, const FVector& TargetLocation, FNavPathSharedPtr Path) const;
+
+	// Start the move along a path found on the workers; the path goes into the path cache if it was found on its current version
+	void HandlePathFound(uint32 QueryId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr, FVector TargetLocation, uint32 PathCacheVersion);
 };
\ No newline at end of file
@@ -2,11 +2,15 @@
 #include "BehaviorTree/BlackboardComponent.h"
 #include "AIController.h"
 #include "NavigationSystem.h"
-#include "Kismet/GameplayStatics.h"
+#include "Navigation/PathFollowingComponent.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeFlowFieldSubsystem.h"
 
 UBTTask_ReachExit::UBTTask_ReachExit()
 {
 	NodeName = TEXT("Reach Exit");
+	bNotifyTick = true;
+	bNotifyTaskFinished = true;
 }
 
 EBTNodeResult::Type UBTTask_ReachExit::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
@@ -25,13 +29,6 @@ EBTNodeResult::Type UBTTask_ReachExit::ExecuteTask(UBehaviorTreeComponent& Owner
 		return EBTNodeResult::Failed;
 	}
 	
-	// Get the exit location from the blackboard
-	FVector ExitLoc = BlackboardComp->GetValueAsVector(ExitLocation.SelectedKeyName);
-	if (ExitLoc.IsZero())
-	{
-		return EBTNodeResult::Failed;
-	}
-	
 	// Get the controlled pawn
 	APawn* ControlledPawn = AIController->GetPawn();
 	if (!ControlledPawn)
@@ -39,32 +36,23 @@ EBTNodeResult::Type UBTTask_ReachExit::ExecuteTask(UBehaviorTreeComponent& Owner
 		return EBTNodeResult::Failed;
 	}
 	
-	// Find the nearest exit actor
-	TArray<AActor*> FoundExits;
-	UGameplayStatics::GetAllActorsOfClass(AIController->GetWorld(), AMazeBlazeExit::StaticClass(), FoundExits);
-	
-	AMazeBlazeExit* NearestExit = nullptr;
-	float NearestDistance = MAX_FLT;
-	
-	for (AActor* Actor : FoundExits)
+	// Maze agents publish the exit they perceived or planned for; until they have one the tree goes back to exploring.
+	// Other controllers publish nothing and head for the nearest exit
+	const FVector ExitLoc = BlackboardComp->GetValueAsVector(ExitLocation.SelectedKeyName);
+	if (ExitLoc.IsZero() && Cast<AMazeBlazeAIController>(AIController))
 	{
-		AMazeBlazeExit* Exit = Cast<AMazeBlazeExit>(Actor);
-		if (Exit)
-		{
-			float Distance = FVector::Dist(ControlledPawn->GetActorLocation(), Exit->GetActorLocation());
-			if (Distance < NearestDistance)
-			{
-				NearestDistance = Distance;
-				NearestExit = Exit;
-			}
-		}
+		return EBTNodeResult::Failed;
 	}
 	
+	UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(AIController);
+	AMazeBlazeExit* NearestExit = Registry ? Registry->FindNearestExit(ExitLoc.IsZero() ? ControlledPawn->GetActorLocation() : ExitLoc) : nullptr;
 	if (!NearestExit)
 	{
 		return EBTNodeResult::Failed;
 	}
 	
+	const float NearestDistance = FVector::Dist(ControlledPawn->GetActorLocation(), NearestExit->GetActorLocation());
+	
 	// Cast to MazeBlazeCharacter
 	AMazeBlazeCharacter* Character = Cast<AMazeBlazeCharacter>(ControlledPawn);
 	if (!Character)
@@ -79,7 +67,6 @@ EBTNodeResult::Type UBTTask_ReachExit::ExecuteTask(UBehaviorTreeComponent& Owner
 	}
 	
 	// Check if we're close enough to interact
-	const float InteractionDistance = 200.0f; // Adjust as needed
 	if (NearestDistance <= InteractionDistance)
 	{
 		// Interact with the exit
@@ -87,18 +74,98 @@ EBTNodeResult::Type UBTTask_ReachExit::ExecuteTask(UBehaviorTreeComponent& Owner
 		return EBTNodeResult::Succeeded;
 	}
 	
+	FBTReachExitMemory* Memory = CastInstanceNodeMemory<FBTReachExitMemory>(NodeMemory);
+	Memory->Exit = NearestExit;
+	
+	// Every agent walking to this exit reads the same flow field, one cell lookup per frame
+	UMazeFlowFieldSubsystem* FlowFields = bUseFlowField ? UMazeFlowFieldSubsystem::Get(AIController) : nullptr;
+	FVector Direction;
+	float RemainingDistance = 0.0f;
+	if (FlowFields && FlowFields->GetFlowDirection(NearestExit->GetActorLocation(), ControlledPawn->GetActorLocation(), Direction, RemainingDistance))
+	{
+		Memory->bFollowingFlowField = true;
+		ControlledPawn->AddMovementInput(Direction);
+		return EBTNodeResult::InProgress;
+	}
+	
 	// Move to the exit
 	FNavLocation NavLocation;
 	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(AIController->GetWorld());
-	if (NavSys && NavSys->GetRandomPointInNavigableRadius(NearestExit->GetActorLocation(), 100.0f, NavLocation))
+	if (NavSys && NavSys->GetRandomPointInNavigableRadius(NearestExit->GetActorLocation(), 100.0f, NavLocation)
+		&& AIController->MoveToLocation(NavLocation.Location) != EPathFollowingRequestResult::Failed)
 	{
-		AIController->MoveToLocation(NavLocation.Location);
 		return EBTNodeResult::InProgress;
 	}
 	
 	return EBTNodeResult::Failed;
 }
 
+void UBTTask_ReachExit::TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds)
+{
+	FBTReachExitMemory* Memory = CastInstanceNodeMemory<FBTReachExitMemory>(NodeMemory);
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	APawn* ControlledPawn = AIController ? AIController->GetPawn() : nullptr;
+	AMazeBlazeExit* Exit = Memory->Exit.Get();
+	if (!ControlledPawn || !Exit)
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	
+	// Use the exit as soon as it is in reach
+	AMazeBlazeCharacter* Character = Cast<AMazeBlazeCharacter>(ControlledPawn);
+	if (Character && FVector::Dist(ControlledPawn->GetActorLocation(), Exit->GetActorLocation()) <= InteractionDistance)
+	{
+		Exit->InteractWith_Implementation(Character);
+		FinishLatentTask(OwnerComp, EBTNodeResult::Succeeded);
+		return;
+	}
+	
+	if (!Memory->bFollowingFlowField)
+	{
+		// A navmesh move that stopped short of the exit leaves the task nothing to wait for
+		if (AIController->GetMoveStatus() == EPathFollowingStatus::Idle)
+		{
+			FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		}
+		return;
+	}
+	
+	UMazeFlowFieldSubsystem* FlowFields = UMazeFlowFieldSubsystem::Get(AIController);
+	FVector Direction;
+	float RemainingDistance = 0.0f;
+	if (!FlowFields || !FlowFields->GetFlowDirection(Exit->GetActorLocation(), ControlledPawn->GetActorLocation(), Direction, RemainingDistance))
+	{
+		FinishLatentTask(OwnerComp, EBTNodeResult::Failed);
+		return;
+	}
+	ControlledPawn->AddMovementInput(Direction);
+}
+
+void UBTTask_ReachExit::OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult)
+{
+	FBTReachExitMemory* Memory = CastInstanceNodeMemory<FBTReachExitMemory>(NodeMemory);
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	if (AIController && !Memory->bFollowingFlowField && TaskResult == EBTNodeResult::Aborted)
+	{
+		AIController->StopMovement();
+	}
+	Memory->Exit.Reset();
+	Memory->bFollowingFlowField = false;
+	
+	Super::OnTaskFinished(OwnerComp, NodeMemory, TaskResult);
+}
+
+void UBTTask_ReachExit::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTReachExitMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_ReachExit::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTReachExitMemory>(NodeMemory, CleanupType);
+}
+
 FString UBTTask_ReachExit::GetStaticDescription() const
 {
 	return FString::Printf(TEXT("Reach Exit: %s"), *ExitLocation.SelectedKeyName.ToString());
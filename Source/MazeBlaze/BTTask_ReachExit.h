@@ -7,8 +7,20 @@
 #include "MazeBlazeAIController.h"
 #include "BTTask_ReachExit.generated.h"
 
+struct FBTReachExitMemory
+{
+	// Exit the task is walking to
+	TWeakObjectPtr<AMazeBlazeExit> Exit;
+
+	// Steering along the shared flow field rather than a navmesh move
+	bool bFollowingFlowField = false;
+};
+
 /**
  * Behavior Tree Task for reaching the maze exit
+ *
+ * Agents follow the flow field every agent heading for that exit shares, and fall back to a
+ * navmesh move when the maze grid is not available; the task interacts with the exit on arrival
  */
 UCLASS()
 class MAZEBLAZE_API UBTTask_ReachExit : public UBTTaskNode
@@ -19,8 +31,21 @@ public:
 	UBTTask_ReachExit();
 	
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual void TickTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, float DeltaSeconds) override;
+	virtual void OnTaskFinished(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTNodeResult::Type TaskResult) override;
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTReachExitMemory); }
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual FString GetStaticDescription() const override;
 
+	// How close the AI needs to get to the exit to use it
+	UPROPERTY(EditAnywhere, Category = "Movement", meta = (ClampMin = "0.0"))
+	float InteractionDistance = 200.0f;
+
+	// Whether to follow the shared flow field to the exit instead of finding a navmesh path
+	UPROPERTY(EditAnywhere, Category = "Movement")
+	bool bUseFlowField = true;
+
 	// The blackboard key that holds the exit location
 	UPROPERTY(EditAnywhere, Category = "Blackboard")
 	FBlackboardKeySelector ExitLocation;
@@ -3,6 +3,10 @@
 #include "AIController.h"
 #include "NavigationSystem.h"
 #include "MazeBlazeAIController.h"
+#include "MazeAsyncNavigationSubsystem.h"
+#include "MazeReachablePointSubsystem.h"
+#include "MazePathCacheSubsystem.h"
+#include "MazeDebugDrawSubsystem.h"
 #include "DrawDebugHelpers.h"
 
 UBTTask_SimpleExplore::UBTTask_SimpleExplore()
@@ -52,9 +56,37 @@ EBTNodeResult::Type UBTTask_SimpleExplore::ExecuteTask(UBehaviorTreeComponent& O
 	// Get the current pawn location
 	FVector CurrentLocation = ControlledPawn->GetActorLocation();
 	
+	// Normal exploration distance first, then double of it, then a very large radius as last resort
+	const float Radii[] = { MaxExplorationDistance, MaxExplorationDistance * 2.0f, 5000.0f };
+	
+	// A pre-sampled point is a lookup; a point right next to the pawn is only taken if there is no other
+	if (UMazeReachablePointSubsystem* PointPool = UMazeReachablePointSubsystem::Get(AIController))
+	{
+		for (const float Radius : Radii)
+		{
+			FVector Point;
+			if (PointPool->TakePoint(CurrentLocation, Radius, MaxExplorationDistance * 0.25f, Point))
+			{
+				return ExploreTo(OwnerComp, NodeMemory, Point);
+			}
+		}
+	}
+	
+	// Find the point on the workers and finish when it comes back
+	if (UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(AIController))
+	{
+		FBTSimpleExploreMemory* Memory = CastInstanceNodeMemory<FBTSimpleExploreMemory>(NodeMemory);
+		Memory->PointQueryId = AsyncNavigation->RequestReachablePoint(AIController->GetNavAgentPropertiesRef(), CurrentLocation, Radii,
+			FMazeAsyncPointDelegate::CreateUObject(this, &UBTTask_SimpleExplore::HandlePointFound, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp)));
+		if (Memory->PointQueryId != 0)
+		{
+			return EBTNodeResult::InProgress;
+		}
+	}
+	
 	// Find a random point in navigable radius
 	FNavLocation NavLocation;
-	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(AIController->GetWorld());
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(AIController->GetWorld());
 	if (!NavSys)
 	{
 		UE_LOG(LogTemp, Error, TEXT("SimpleExplore: No navigation system!"));
@@ -67,72 +99,135 @@ EBTNodeResult::Type UBTTask_SimpleExplore::ExecuteTask(UBehaviorTreeComponent& O
 	}
 	
 	// Try to find a random reachable point
-	bool bFoundPoint = false;
+	for (const float Radius : Radii)
+	{
+		if (NavSys->GetRandomReachablePointInRadius(CurrentLocation, Radius, NavLocation))
+		{
+			return ExploreTo(OwnerComp, NodeMemory, NavLocation.Location);
+		}
+		UE_LOG(LogTemp, Warning, TEXT("SimpleExplore: Could not find reachable point at distance %.1f"), Radius);
+	}
 	
-	// First attempt with normal exploration distance
-	bFoundPoint = NavSys->GetRandomReachablePointInRadius(CurrentLocation, MaxExplorationDistance, NavLocation);
+	return FailToFindPoint(OwnerComp);
+}
+
+EBTNodeResult::Type UBTTask_SimpleExplore::AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	FBTSimpleExploreMemory* Memory = CastInstanceNodeMemory<FBTSimpleExploreMemory>(NodeMemory);
+	if (UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(OwnerComp.GetOwner()))
+	{
+		AsyncNavigation->CancelQuery(Memory->PointQueryId);
+		AsyncNavigation->CancelQuery(Memory->PathQueryId);
+	}
+	Memory->PointQueryId = 0;
+	Memory->PathQueryId = 0;
 	
-	// If first attempt failed, try with a larger radius as fallback
-	if (!bFoundPoint)
+	return Super::AbortTask(OwnerComp, NodeMemory);
+}
+
+void UBTTask_SimpleExplore::InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const
+{
+	InitializeNodeMemory<FBTSimpleExploreMemory>(NodeMemory, InitType);
+}
+
+void UBTTask_SimpleExplore::CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const
+{
+	CleanupNodeMemory<FBTSimpleExploreMemory>(NodeMemory, CleanupType);
+}
+
+EBTNodeResult::Type UBTTask_SimpleExplore::ExploreTo(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const FVector& Point)
+{
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
+	APawn* ControlledPawn = AIController ? AIController->GetPawn() : nullptr;
+	if (!ControlledPawn || !BlackboardComp)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("SimpleExplore: Could not find reachable point at distance %.1f, trying larger radius"), 
-			MaxExplorationDistance);
-		
-		// Try with double the exploration distance
-		bFoundPoint = NavSys->GetRandomReachablePointInRadius(CurrentLocation, MaxExplorationDistance * 2.0f, NavLocation);
+		return EBTNodeResult::Failed;
+	}
+	AMazeBlazeAIController* MazeAIController = Cast<AMazeBlazeAIController>(AIController);
+	
+	// Set the exploration target in the blackboard
+	BlackboardComp->SetValueAsVector(ExplorationTarget.SelectedKeyName, Point);
+	
+	// If we're using our custom AI controller, update the current state
+	if (MazeAIController)
+	{
+		MazeAIController->SetCurrentState(EAIState::Exploring);
 		
-		// If still failed, try with a very large radius as last resort
-		if (!bFoundPoint)
+		// If we were in an error state, clear it
+		if (MazeAIController->IsInErrorState())
 		{
-			UE_LOG(LogTemp, Warning, TEXT("SimpleExplore: Still could not find reachable point, trying maximum radius"));
-			bFoundPoint = NavSys->GetRandomReachablePointInRadius(CurrentLocation, 5000.0f, NavLocation);
+			MazeAIController->TryRecoverFromError();
 		}
 	}
 	
-	if (bFoundPoint)
+	// Agents exploring towards the same area share their paths
+	UMazePathCacheSubsystem* PathCache = UMazePathCacheSubsystem::Get(AIController);
+	if (PathCache)
 	{
-		// Set the exploration target in the blackboard
-		BlackboardComp->SetValueAsVector(ExplorationTarget.SelectedKeyName, NavLocation.Location);
-		
-		// If we're using our custom AI controller, update the current state
-		if (MazeAIController)
+		TArray<FVector> PathPoints;
+		if (PathCache->FindPath(ControlledPawn->GetActorLocation(), Point, PathPoints) != EMazePathCacheHit::None)
 		{
-			MazeAIController->SetCurrentState(EAIState::Exploring);
-			
-			// If we were in an error state, clear it
-			if (MazeAIController->IsInErrorState())
-			{
-				MazeAIController->TryRecoverFromError();
-			}
+			return StartMove(OwnerComp, Point, MakeShared<FNavigationPath, ESPMode::ThreadSafe>(PathPoints));
 		}
-		
-		// Move to the exploration target
-		EPathFollowingRequestResult::Type MoveResult = AIController->MoveToLocation(NavLocation.Location);
-		
-		// Check if movement started successfully
-		if (MoveResult == EPathFollowingRequestResult::Failed)
+	}
+	
+	// The path is found on the workers and the move starts when it comes back
+	if (UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(AIController))
+	{
+		FBTSimpleExploreMemory* Memory = CastInstanceNodeMemory<FBTSimpleExploreMemory>(NodeMemory);
+		Memory->PathQueryId = AsyncNavigation->RequestPath(AIController->GetNavAgentPropertiesRef(), ControlledPawn->GetActorLocation(), Point, true,
+			FMazeAsyncPathDelegate::CreateUObject(this, &UBTTask_SimpleExplore::HandlePathFound, TWeakObjectPtr<UBehaviorTreeComponent>(&OwnerComp), Point,
+				PathCache ? PathCache->GetVersion() : 0u));
+		if (Memory->PathQueryId != 0)
 		{
-			UE_LOG(LogTemp, Error, TEXT("SimpleExplore: Failed to start movement!"));
-			
-			if (MazeAIController)
-			{
-				MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
-					TEXT("Failed to start movement to exploration point"));
-			}
-			
-			return EBTNodeResult::Failed;
+			return EBTNodeResult::InProgress;
 		}
-		
-		// Draw debug sphere to show the target point
-		DrawDebugSphere(AIController->GetWorld(), NavLocation.Location, 20.0f, 8, FColor::Blue, false, 3.0f);
-		
-		return EBTNodeResult::Succeeded;
 	}
 	
+	return StartMove(OwnerComp, Point, nullptr);
+}
+
+EBTNodeResult::Type UBTTask_SimpleExplore::StartMove(UBehaviorTreeComponent& OwnerComp, const FVector& Point, FNavPathSharedPtr Path) const
+{
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	if (!AIController)
+	{
+		return EBTNodeResult::Failed;
+	}
+	
+	// Move to the exploration target
+	bool bMoving = false;
+	if (Path.IsValid())
+	{
+		bMoving = AIController->RequestMove(FAIMoveRequest(Point), Path).IsValid();
+	}
+	else
+	{
+		bMoving = AIController->MoveToLocation(Point) != EPathFollowingRequestResult::Failed;
+	}
+	
+	// Check if movement started successfully
+	if (!bMoving)
+	{
+		return FailToStartMove(OwnerComp);
+	}
+	
+	// Draw debug sphere to show the target point
+	if (UMazeDebugDrawSubsystem::IsEnabled())
+	{
+		DrawDebugSphere(AIController->GetWorld(), Point, 20.0f, 8, FColor::Blue, false, 3.0f);
+	}
+	
+	return EBTNodeResult::Succeeded;
+}
+
+EBTNodeResult::Type UBTTask_SimpleExplore::FailToFindPoint(UBehaviorTreeComponent& OwnerComp) const
+{
 	// If we get here, all attempts to find a navigation point failed
 	UE_LOG(LogTemp, Error, TEXT("SimpleExplore: Failed to find ANY reachable point!"));
 	
-	if (MazeAIController)
+	if (AMazeBlazeAIController* MazeAIController = Cast<AMazeBlazeAIController>(OwnerComp.GetAIOwner()))
 	{
 		MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
 			TEXT("Could not find any reachable navigation points"));
@@ -141,6 +236,70 @@ EBTNodeResult::Type UBTTask_SimpleExplore::ExecuteTask(UBehaviorTreeComponent& O
 	return EBTNodeResult::Failed;
 }
 
+EBTNodeResult::Type UBTTask_SimpleExplore::FailToStartMove(UBehaviorTreeComponent& OwnerComp) const
+{
+	UE_LOG(LogTemp, Error, TEXT("SimpleExplore: Failed to start movement!"));
+	
+	if (AMazeBlazeAIController* MazeAIController = Cast<AMazeBlazeAIController>(OwnerComp.GetAIOwner()))
+	{
+		MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
+			TEXT("Failed to start movement to exploration point"));
+	}
+	
+	return EBTNodeResult::Failed;
+}
+
+void UBTTask_SimpleExplore::HandlePointFound(uint32 QueryId, bool bFound, const FVector& Point, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr)
+{
+	UBehaviorTreeComponent* OwnerComp = OwnerCompPtr.Get();
+	if (!OwnerComp)
+	{
+		return;
+	}
+	
+	// Only the query of the run still waiting for it finishes the task
+	uint8* NodeMemory = OwnerComp->GetNodeMemory(this, OwnerComp->FindInstanceContainingNode(this));
+	FBTSimpleExploreMemory* Memory = CastInstanceNodeMemory<FBTSimpleExploreMemory>(NodeMemory);
+	if (!Memory || Memory->PointQueryId != QueryId)
+	{
+		return;
+	}
+	Memory->PointQueryId = 0;
+	
+	const EBTNodeResult::Type Result = bFound ? ExploreTo(*OwnerComp, NodeMemory, Point) : FailToFindPoint(*OwnerComp);
+	if (Result != EBTNodeResult::InProgress)
+	{
+		FinishLatentTask(*OwnerComp, Result);
+	}
+}
+
+void UBTTask_SimpleExplore::HandlePathFound(uint32 QueryId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr, FVector Point, uint32 PathCacheVersion)
+{
+	// Worth keeping for the other agents even if this one moved on
+	UMazePathCacheSubsystem* PathCache = UMazePathCacheSubsystem::Get(OwnerCompPtr.Get());
+	if (PathCache && Path.IsValid())
+	{
+		PathCache->AddPath(PathCacheVersion, *Path);
+	}
+	
+	UBehaviorTreeComponent* OwnerComp = OwnerCompPtr.Get();
+	if (!OwnerComp)
+	{
+		return;
+	}
+	
+	// Only the query of the run still waiting for it finishes the task
+	uint8* NodeMemory = OwnerComp->GetNodeMemory(this, OwnerComp->FindInstanceContainingNode(this));
+	FBTSimpleExploreMemory* Memory = CastInstanceNodeMemory<FBTSimpleExploreMemory>(NodeMemory);
+	if (!Memory || Memory->PathQueryId != QueryId)
+	{
+		return;
+	}
+	Memory->PathQueryId = 0;
+	
+	FinishLatentTask(*OwnerComp, Path.IsValid() ? StartMove(*OwnerComp, Point, Path) : FailToStartMove(*OwnerComp));
+}
+
 FString UBTTask_SimpleExplore::GetStaticDescription() const
 {
 	return FString::Printf(TEXT("Simple Explore: Max Distance = %.1f"), MaxExplorationDistance);
@@ -5,8 +5,23 @@
 #include "MazeBlazeAIController.h"
 #include "BTTask_SimpleExplore.generated.h"
 
+// Memory of a running simple explore task
+struct FBTSimpleExploreMemory
+{
+	// Reachable point query on the async navigation subsystem, 0 if none
+	uint32 PointQueryId = 0;
+
+	// Path query to the chosen point, 0 if none
+	uint32 PathQueryId = 0;
+};
+
 /**
  * Behavior Tree Task for simple exploration of the maze
+ *
+ * The random reachable point is taken from the reachable point pool, or else found on the async
+ * navigation subsystem's workers and the task finishes latently when it comes back; it falls back
+ * to a synchronous query without either subsystem. The path to the point is taken from the path
+ * cache or found on the workers the same way.
  */
 UCLASS()
 class MAZEBLAZE_API UBTTask_SimpleExplore : public UBTTaskNode
@@ -17,6 +32,10 @@ public:
 	UBTTask_SimpleExplore();
 	
 	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual EBTNodeResult::Type AbortTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual uint16 GetInstanceMemorySize() const override { return sizeof(FBTSimpleExploreMemory); }
+	virtual void InitializeMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryInit::Type InitType) const override;
+	virtual void CleanupMemory(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, EBTMemoryClear::Type CleanupType) const override;
 	virtual FString GetStaticDescription() const override;
 
 	// The blackboard key to store the exploration target
@@ -26,4 +45,20 @@ public:
 	// Maximum exploration distance
 	UPROPERTY(EditAnywhere, Category = "Exploration", meta = (ClampMin = "100.0", ClampMax = "5000.0"))
 	float MaxExplorationDistance = 1000.0f;
+
+private:
+	// Store the exploration point and move to it, finishing latently while its path is found
+	EBTNodeResult::Type ExploreTo(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory, const FVector& Point);
+
+	// Start the move along a path; without one the path is found here
+	EBTNodeResult::Type StartMove(UBehaviorTreeComponent& OwnerComp, const FVector& Point, FNavPathSharedPtr Path) const;
+
+	// Report that no reachable point was found
+	EBTNodeResult::Type FailToFindPoint(UBehaviorTreeComponent& OwnerComp) const;
+
+	// Report that the move to the point could not start
+	EBTNodeResult::Type FailToStartMove(UBehaviorTreeComponent& OwnerComp) const;
+
+	void HandlePointFound(uint32 QueryId, bool bFound, const FVector& Point, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr);
+	void HandlePathFound(uint32 QueryId, FNavPathSharedPtr Path, TWeakObjectPtr<UBehaviorTreeComponent> OwnerCompPtr, FVector Point, uint32 PathCacheVersion);
 };
\ No newline at end of file
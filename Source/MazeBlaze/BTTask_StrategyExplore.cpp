@@ -0,0 +1,62 @@
+#include "BTTask_StrategyExplore.h"
+#include "BehaviorTree/BlackboardComponent.h"
+#include "AIController.h"
+#include "MazeBlazeAIController.h"
+#include "MazeFrontierExplorationComponent.h"
+#include "DrawDebugHelpers.h"
+
+UBTTask_StrategyExplore::UBTTask_StrategyExplore()
+{
+	NodeName = TEXT("Strategy Explore");
+}
+
+EBTNodeResult::Type UBTTask_StrategyExplore::ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory)
+{
+	AAIController* AIController = OwnerComp.GetAIOwner();
+	UBlackboardComponent* BlackboardComp = OwnerComp.GetBlackboardComponent();
+	if (!AIController || !BlackboardComp || !AIController->GetPawn())
+	{
+		// Simple Explore reports the missing pieces
+		return Super::ExecuteTask(OwnerComp, NodeMemory);
+	}
+	
+	// Explore with the agent's current strategy, whichever system it is switched to
+	AMazeBlazeAIController* MazeAIController = Cast<AMazeBlazeAIController>(AIController);
+	IMazeExplorationStrategy* Strategy = MazeAIController ? MazeAIController->GetExplorationStrategy() : nullptr;
+	TArray<FVector> RoutePoints;
+	if (!Strategy || !Strategy->ChooseExplorationRoute(*MazeAIController, RoutePoints))
+	{
+		return Super::ExecuteTask(OwnerComp, NodeMemory);
+	}
+	
+	BlackboardComp->SetValueAsVector(ExplorationTarget.SelectedKeyName, RoutePoints.Last());
+	MazeAIController->SetCurrentState(EAIState::Exploring);
+	
+	if (!IMazeExplorationStrategy::RequestRouteMove(*AIController, RoutePoints))
+	{
+		UE_LOG(LogTemp, Error, TEXT("StrategyExplore: Failed to start movement!"));
+		MazeAIController->ReportAIError(EAIErrorType::NavigationMissing, 
+			TEXT("Failed to start movement to exploration target"));
+		return EBTNodeResult::Failed;
+	}
+	
+	if (bDrawRoute)
+	{
+		if (UMazeFrontierExplorationComponent* Exploration = AIController->FindComponentByClass<UMazeFrontierExplorationComponent>())
+		{
+			Exploration->DrawDebugFrontiers(3.0f);
+		}
+		for (int32 Index = 1; Index < RoutePoints.Num(); ++Index)
+		{
+			DrawDebugLine(AIController->GetWorld(), RoutePoints[Index - 1], RoutePoints[Index], FColor::Purple, false, 3.0f);
+		}
+		DrawDebugSphere(AIController->GetWorld(), RoutePoints.Last(), 20.0f, 8, FColor::Orange, false, 3.0f);
+	}
+	
+	return EBTNodeResult::Succeeded;
+}
+
+FString UBTTask_StrategyExplore::GetStaticDescription() const
+{
+	return FString::Printf(TEXT("Strategy Explore (Simple Explore fallback: Max Distance = %.1f)"), MaxExplorationDistance);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "BTTask_SimpleExplore.h"
+#include "BTTask_StrategyExplore.generated.h"
+
+/**
+ * Behavior Tree Task that explores the maze with the agent's current exploration strategy,
+ * e.g. moving to the best frontier or walking a run of cells along the walls
+ * Falls back to Simple Explore when the strategy has no exploration target of its own,
+ * when the maze model it needs is not available or when nothing is left to explore
+ */
+UCLASS()
+class MAZEBLAZE_API UBTTask_StrategyExplore : public UBTTask_SimpleExplore
+{
+	GENERATED_BODY()
+
+public:
+	UBTTask_StrategyExplore();
+	
+	virtual EBTNodeResult::Type ExecuteTask(UBehaviorTreeComponent& OwnerComp, uint8* NodeMemory) override;
+	virtual FString GetStaticDescription() const override;
+
+	// Draw the route chosen for each move, and the frontier cells when exploring frontiers
+	UPROPERTY(EditAnywhere, Category = "Exploration")
+	bool bDrawRoute = false;
+};
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "MazeAISchedulerSubsystem.h"
+#include "MazeBlazeAIController.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+UMazeAISchedulerSubsystem* UMazeAISchedulerSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeAISchedulerSubsystem>() : nullptr;
+}
+
+void UMazeAISchedulerSubsystem::Deinitialize()
+{
+	Agents.Empty();
+	Schedules.Empty();
+	AgentIndices.Empty();
+	BoostedAgents.Empty();
+	NextAgentIndex = 0;
+
+	Super::Deinitialize();
+}
+
+bool UMazeAISchedulerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazeAISchedulerSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazeAISchedulerSubsystem, STATGROUP_Tickables);
+}
+
+bool UMazeAISchedulerSubsystem::RegisterController(AMazeBlazeAIController* Controller)
+{
+	if (!bEnabled || !Controller)
+	{
+		return false;
+	}
+
+	if (!AgentIndices.Contains(Controller))
+	{
+		FAgentSchedule Schedule;
+		Schedule.LastServicedTime = GetWorld()->GetTimeSeconds();
+
+		AgentIndices.Add(Controller, Agents.Add(Controller));
+		Schedules.Add(Schedule);
+	}
+
+	// New agents get their first update right away
+	BoostPriority(Controller);
+	return true;
+}
+
+void UMazeAISchedulerSubsystem::UnregisterController(AMazeBlazeAIController* Controller)
+{
+	int32 AgentIndex = INDEX_NONE;
+	if (!AgentIndices.RemoveAndCopyValue(Controller, AgentIndex))
+	{
+		return;
+	}
+
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	Schedules.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	if (Agents.IsValidIndex(AgentIndex))
+	{
+		AgentIndices.Add(Agents[AgentIndex], AgentIndex);
+	}
+
+	BoostedAgents.Remove(Controller);
+}
+
+void UMazeAISchedulerSubsystem::BoostPriority(AMazeBlazeAIController* Controller)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Controller))
+	{
+		FAgentSchedule& Schedule = Schedules[*AgentIndex];
+		if (!Schedule.bBoosted)
+		{
+			Schedule.bBoosted = true;
+			BoostedAgents.Add(Controller);
+		}
+	}
+}
+
+float UMazeAISchedulerSubsystem::GetAgentStaleness(const AMazeBlazeAIController* Controller) const
+{
+	const int32* AgentIndex = AgentIndices.Find(const_cast<AMazeBlazeAIController*>(Controller));
+	if (!AgentIndex)
+	{
+		return 0.0f;
+	}
+
+	return GetWorld()->GetTimeSeconds() - Schedules[*AgentIndex].LastServicedTime;
+}
+
+void UMazeAISchedulerSubsystem::Tick(float DeltaTime)
+{
+	const double StartTime = FPlatformTime::Seconds();
+	const double BudgetSeconds = FrameBudgetMs * 0.001;
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+
+	AgentsServicedLastFrame = 0;
+
+	// At least one agent is serviced every frame so a slow agent cannot stall the schedule
+	auto HasBudgetLeft = [this, StartTime, BudgetSeconds]()
+	{
+		return AgentsServicedLastFrame == 0 || FPlatformTime::Seconds() - StartTime < BudgetSeconds;
+	};
+
+	// Boosted agents first, in the order they were boosted; agents boosted while
+	// servicing this frame wait for the next one
+	const int32 NumBoosted = BoostedAgents.Num();
+	int32 NumBoostedServiced = 0;
+	while (NumBoostedServiced < NumBoosted && HasBudgetLeft())
+	{
+		if (const int32* AgentIndex = AgentIndices.Find(BoostedAgents[NumBoostedServiced]))
+		{
+			ServiceAgent(*AgentIndex, WorldTime);
+		}
+		NumBoostedServiced++;
+	}
+	BoostedAgents.RemoveAt(0, NumBoostedServiced, EAllowShrinking::No);
+
+	// Then round-robin over the agents that are due, resuming where the last frame stopped
+	for (int32 Visited = 0; Visited < Agents.Num() && HasBudgetLeft(); ++Visited)
+	{
+		if (NextAgentIndex >= Agents.Num())
+		{
+			NextAgentIndex = 0;
+		}
+
+		const int32 AgentIndex = NextAgentIndex++;
+		const FAgentSchedule& Schedule = Schedules[AgentIndex];
+		if (Schedule.LastServicedFrame != GFrameCounter && WorldTime - Schedule.LastServicedTime >= MinAgentInterval)
+		{
+			ServiceAgent(AgentIndex, WorldTime);
+		}
+	}
+
+	LastFrameTimeMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+	WorstFrameTimeMs = FMath::Max(WorstFrameTimeMs, LastFrameTimeMs);
+	if (LastFrameTimeMs > FrameBudgetMs)
+	{
+		BudgetOverruns++;
+	}
+
+	if (StatsLogInterval > 0.0f && Agents.Num() > 0 && WorldTime - LastStatsLogTime >= StatsLogInterval)
+	{
+		const FMazeAISchedulerStats Stats = GetStats();
+		UE_LOG(LogTemp, Log, TEXT("AI scheduler: %d agents, average staleness %.3fs, max staleness %.3fs, %d budget overruns (worst %.2f ms / %.2f ms)"),
+			   Stats.NumAgents, Stats.AverageStalenessSeconds, Stats.MaxStalenessSeconds, Stats.BudgetOverruns, Stats.WorstFrameTimeMs, FrameBudgetMs);
+		LastStatsLogTime = WorldTime;
+	}
+}
+
+void UMazeAISchedulerSubsystem::ServiceAgent(int32 AgentIndex, double WorldTime)
+{
+	AMazeBlazeAIController* Controller = Agents[AgentIndex];
+	FAgentSchedule& Schedule = Schedules[AgentIndex];
+
+	const double ElapsedSeconds = WorldTime - Schedule.LastServicedTime;
+	Schedule.StalenessSum += ElapsedSeconds;
+	Schedule.NumServices++;
+	Schedule.LastServicedTime = WorldTime;
+	Schedule.LastServicedFrame = GFrameCounter;
+	Schedule.bBoosted = false;
+	AgentsServicedLastFrame++;
+
+	if (Controller)
+	{
+		Controller->RunScheduledUpdate(ElapsedSeconds);
+	}
+}
+
+FMazeAISchedulerStats UMazeAISchedulerSubsystem::GetStats() const
+{
+	FMazeAISchedulerStats Stats;
+	Stats.NumAgents = Agents.Num();
+	Stats.AgentsServicedLastFrame = AgentsServicedLastFrame;
+	Stats.LastFrameTimeMs = LastFrameTimeMs;
+	Stats.WorstFrameTimeMs = WorstFrameTimeMs;
+	Stats.BudgetOverruns = BudgetOverruns;
+
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	double StalenessSum = 0.0;
+	int32 NumAgentsWithServices = 0;
+
+	for (const FAgentSchedule& Schedule : Schedules)
+	{
+		Stats.MaxStalenessSeconds = FMath::Max(Stats.MaxStalenessSeconds, static_cast<float>(WorldTime - Schedule.LastServicedTime));
+
+		// Average each agent separately so agents serviced more often don't dominate
+		if (Schedule.NumServices > 0)
+		{
+			StalenessSum += Schedule.StalenessSum / Schedule.NumServices;
+			NumAgentsWithServices++;
+		}
+	}
+
+	if (NumAgentsWithServices > 0)
+	{
+		Stats.AverageStalenessSeconds = StalenessSum / NumAgentsWithServices;
+	}
+
+	return Stats;
+}
+
+void UMazeAISchedulerSubsystem::ResetStats()
+{
+	for (FAgentSchedule& Schedule : Schedules)
+	{
+		Schedule.StalenessSum = 0.0;
+		Schedule.NumServices = 0;
+	}
+
+	WorstFrameTimeMs = 0.0;
+	BudgetOverruns = 0;
+}
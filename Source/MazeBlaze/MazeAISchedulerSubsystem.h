@@ -0,0 +1,138 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeAISchedulerSubsystem.generated.h"
+
+class AMazeBlazeAIController;
+
+// Budget and staleness statistics of the AI scheduler
+USTRUCT(BlueprintType)
+struct MAZEBLAZE_API FMazeAISchedulerStats
+{
+	GENERATED_BODY()
+
+	// Controllers currently registered with the scheduler
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	int32 NumAgents = 0;
+
+	// Controllers serviced during the last frame
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	int32 AgentsServicedLastFrame = 0;
+
+	// Time spent servicing controllers during the last frame
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	float LastFrameTimeMs = 0.0f;
+
+	// Frames that went over the budget since the last stats reset
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	int32 BudgetOverruns = 0;
+
+	// Worst frame time since the last stats reset
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	float WorstFrameTimeMs = 0.0f;
+
+	// Average time between two updates of the same controller
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	float AverageStalenessSeconds = 0.0f;
+
+	// Longest time any controller is currently waiting for an update
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Scheduler")
+	float MaxStalenessSeconds = 0.0f;
+};
+
+/**
+ * World subsystem that time-slices the periodic AI controller work (perception updates)
+ *
+ * Registered controllers are serviced round-robin under a fixed per-frame budget instead of
+ * all of them updating in the same frame. Controllers whose state just changed are boosted
+ * to the front of the queue so they react on the next frame.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeAISchedulerSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the scheduler for the world of the given object
+	static UMazeAISchedulerSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Add a controller to the schedule; returns false when scheduling is disabled
+	bool RegisterController(AMazeBlazeAIController* Controller);
+
+	// Remove a controller from the schedule
+	void UnregisterController(AMazeBlazeAIController* Controller);
+
+	// Service the controller before any round-robin work on the next frame
+	void BoostPriority(AMazeBlazeAIController* Controller);
+
+	// Time since the controller was last serviced, or zero if it is not scheduled
+	float GetAgentStaleness(const AMazeBlazeAIController* Controller) const;
+
+	// Current budget and staleness statistics
+	UFUNCTION(BlueprintCallable, Category = "AI|Scheduler")
+	FMazeAISchedulerStats GetStats() const;
+
+	// Reset the overrun counters and staleness averages
+	UFUNCTION(BlueprintCallable, Category = "AI|Scheduler")
+	void ResetStats();
+
+	// Whether controllers are time-sliced at all; when disabled every controller updates itself each tick
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Scheduler")
+	bool bEnabled = true;
+
+	// Time that may be spent servicing controllers each frame
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Scheduler", meta = (ClampMin = "0.01"))
+	float FrameBudgetMs = 1.0f;
+
+	// Controllers are not serviced more often than this unless boosted
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Scheduler", meta = (ClampMin = "0.0"))
+	float MinAgentInterval = 0.1f;
+
+	// Interval between statistics log lines; zero disables logging
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Scheduler", meta = (ClampMin = "0.0"))
+	float StatsLogInterval = 10.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Per-controller schedule data, parallel to Agents
+	struct FAgentSchedule
+	{
+		double LastServicedTime = 0.0;
+		double StalenessSum = 0.0;
+		int32 NumServices = 0;
+		uint64 LastServicedFrame = 0;
+		bool bBoosted = false;
+	};
+
+	// Run the scheduled work of one agent
+	void ServiceAgent(int32 AgentIndex, double WorldTime);
+
+	// Registered controllers
+	UPROPERTY()
+	TArray<AMazeBlazeAIController*> Agents;
+
+	TArray<FAgentSchedule> Schedules;
+
+	TMap<AMazeBlazeAIController*, int32> AgentIndices;
+
+	// Controllers waiting for a boosted update, in request order
+	TArray<AMazeBlazeAIController*> BoostedAgents;
+
+	// Next agent for the round-robin pass
+	int32 NextAgentIndex = 0;
+
+	// Frame statistics
+	int32 AgentsServicedLastFrame = 0;
+	double LastFrameTimeMs = 0.0;
+	double WorstFrameTimeMs = 0.0;
+	int32 BudgetOverruns = 0;
+	double LastStatsLogTime = 0.0;
+};
@@ -0,0 +1,91 @@
+#include "MazeAIStatusText.h"
+#include "MazeBlazeAIController.h"
+
+namespace
+{
+	const TCHAR* const StateNames[] =
+	{
+		TEXT("EAIState::Exploring"),
+		TEXT("EAIState::SeekingKey"),
+		TEXT("EAIState::SeekingDoor"),
+		TEXT("EAIState::GoingToExit")
+	};
+
+	const TCHAR* const ErrorTypeNames[] =
+	{
+		TEXT("EAIErrorType::None"),
+		TEXT("EAIErrorType::AssetMissing"),
+		TEXT("EAIErrorType::BlackboardInitFailed"),
+		TEXT("EAIErrorType::BehaviorTreeStartFailed"),
+		TEXT("EAIErrorType::NavigationMissing"),
+		TEXT("EAIErrorType::PerceptionError"),
+		TEXT("EAIErrorType::TaskExecutionFailed")
+	};
+
+	static_assert(UE_ARRAY_COUNT(StateNames) == FMazeAIStatusText::NumStates, "One name per EAIState value");
+	static_assert(UE_ARRAY_COUNT(ErrorTypeNames) == FMazeAIStatusText::NumErrorTypes, "One name per EAIErrorType value");
+
+	const TCHAR* const InvalidName = TEXT("Invalid");
+}
+
+const TCHAR* FMazeAIStatusText::GetStateName(EAIState State)
+{
+	const int32 Index = static_cast<int32>(State);
+	return Index < NumStates ? StateNames[Index] : InvalidName;
+}
+
+const TCHAR* FMazeAIStatusText::GetErrorTypeName(EAIErrorType ErrorType)
+{
+	const int32 Index = static_cast<int32>(ErrorType);
+	return Index < NumErrorTypes ? ErrorTypeNames[Index] : InvalidName;
+}
+
+FName FMazeAIStatusText::GetErrorTypeFName(EAIErrorType ErrorType)
+{
+	static const TArray<FName> Names = []()
+	{
+		TArray<FName> Result;
+		for (const TCHAR* Name : ErrorTypeNames)
+		{
+			Result.Emplace(Name);
+		}
+		return Result;
+	}();
+
+	const int32 Index = static_cast<int32>(ErrorType);
+	return Names.IsValidIndex(Index) ? Names[Index] : NAME_None;
+}
+
+const FString& FMazeAIStatusText::GetStateString(EAIState State)
+{
+	static const TArray<FString> Strings = []()
+	{
+		TArray<FString> Result;
+		for (const TCHAR* Name : StateNames)
+		{
+			Result.Emplace(Name);
+		}
+		return Result;
+	}();
+
+	static const FString Invalid(InvalidName);
+	const int32 Index = static_cast<int32>(State);
+	return Strings.IsValidIndex(Index) ? Strings[Index] : Invalid;
+}
+
+const FString& FMazeAIStatusText::GetStateTimeoutMessage(EAIState State)
+{
+	static const TArray<FString> Messages = []()
+	{
+		TArray<FString> Result;
+		for (const TCHAR* Name : StateNames)
+		{
+			Result.Add(FString::Printf(TEXT("Stuck in state %s for too long"), Name));
+		}
+		return Result;
+	}();
+
+	static const FString Invalid = FString::Printf(TEXT("Stuck in state %s for too long"), InvalidName);
+	const int32 Index = static_cast<int32>(State);
+	return Messages.IsValidIndex(Index) ? Messages[Index] : Invalid;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/StringBuilder.h"
+
+enum class EAIState : uint8;
+enum class EAIErrorType : uint8;
+
+// Inline builder for AI status text; the whole status of a controller fits without touching the heap
+using FMazeAIStatusTextBuilder = TStringBuilder<512>;
+
+/**
+ * Names of the AI state and error enums, from tables built at compile time
+ *
+ * The names are the ones UEnum::GetValueAsString returns (e.g. "EAIState::Exploring"), so logs and
+ * status text read the same as before, but looking one up neither walks the reflection data nor
+ * allocates a string.
+ */
+struct MAZEBLAZE_API FMazeAIStatusText
+{
+	// Values of each enum; the tables must be extended along with the enums
+	static constexpr int32 NumStates = 4;
+	static constexpr int32 NumErrorTypes = 7;
+
+	static const TCHAR* GetStateName(EAIState State);
+	static const TCHAR* GetErrorTypeName(EAIErrorType ErrorType);
+
+	// The same names, for callers that need an FName or FString; created on first use
+	static FName GetErrorTypeFName(EAIErrorType ErrorType);
+	static const FString& GetStateString(EAIState State);
+
+	// Error message for an agent that stayed in a state for too long
+	static const FString& GetStateTimeoutMessage(EAIState State);
+};
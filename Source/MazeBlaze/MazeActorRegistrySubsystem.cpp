@@ -0,0 +1,188 @@
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeBlazeKey.h"
+#include "MazeGameDoor.h"
+#include "MazeBlazeExit.h"
+#include "Engine/World.h"
+
+UMazeActorRegistrySubsystem* UMazeActorRegistrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeActorRegistrySubsystem>() : nullptr;
+}
+
+void UMazeActorRegistrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	KeyIndex.SetCellSize(SpatialHashCellSize);
+	DoorSignatureIndex.SetCellSize(SpatialHashCellSize);
+}
+
+void UMazeActorRegistrySubsystem::Deinitialize()
+{
+	KeyIndex.Reset();
+	DoorSignatureIndex.Reset();
+	KeysOnGround.Empty();
+	CarriedKeys.Empty();
+	ClosedDoors.Empty();
+	OpenDoors.Empty();
+	Exits.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMazeActorRegistrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMazeActorRegistrySubsystem::RegisterKey(AMazeBlazeKey* Key)
+{
+	if (!Key)
+	{
+		return;
+	}
+
+	if (Key->IsOnGround())
+	{
+		KeysOnGround.AddUnique(Key);
+		KeyIndex.Add(Key, Key->GetActorLocation(), Key->GetSignature());
+	}
+	else
+	{
+		CarriedKeys.AddUnique(Key);
+	}
+
+	OnMazeActorChanged.Broadcast(Key);
+}
+
+void UMazeActorRegistrySubsystem::UnregisterKey(AMazeBlazeKey* Key)
+{
+	KeysOnGround.RemoveSwap(Key);
+	CarriedKeys.RemoveSwap(Key);
+	KeyIndex.Remove(Key);
+
+	OnMazeActorChanged.Broadcast(Key);
+}
+
+void UMazeActorRegistrySubsystem::RegisterDoor(AMazeGameDoor* Door)
+{
+	if (!Door)
+	{
+		return;
+	}
+
+	DoorSignatureIndex.Add(Door, Door->GetActorLocation(), Door->GetMask(), !Door->IsOpen());
+
+	if (Door->IsOpen())
+	{
+		OpenDoors.AddUnique(Door);
+	}
+	else
+	{
+		ClosedDoors.AddUnique(Door);
+	}
+
+	OnMazeActorChanged.Broadcast(Door);
+}
+
+void UMazeActorRegistrySubsystem::UnregisterDoor(AMazeGameDoor* Door)
+{
+	ClosedDoors.RemoveSwap(Door);
+	OpenDoors.RemoveSwap(Door);
+	DoorSignatureIndex.Remove(Door);
+
+	OnMazeActorChanged.Broadcast(Door);
+}
+
+void UMazeActorRegistrySubsystem::RegisterExit(AMazeBlazeExit* Exit)
+{
+	if (!Exit)
+	{
+		return;
+	}
+
+	Exits.AddUnique(Exit);
+
+	OnMazeActorChanged.Broadcast(Exit);
+}
+
+void UMazeActorRegistrySubsystem::UnregisterExit(AMazeBlazeExit* Exit)
+{
+	Exits.RemoveSwap(Exit);
+
+	OnMazeActorChanged.Broadcast(Exit);
+}
+
+void UMazeActorRegistrySubsystem::NotifyKeyPickedUp(AMazeBlazeKey* Key)
+{
+	if (Key && KeysOnGround.RemoveSwap(Key) > 0)
+	{
+		CarriedKeys.AddUnique(Key);
+		KeyIndex.Remove(Key);
+
+		OnMazeActorChanged.Broadcast(Key);
+	}
+}
+
+void UMazeActorRegistrySubsystem::NotifyKeyDropped(AMazeBlazeKey* Key)
+{
+	if (Key && CarriedKeys.RemoveSwap(Key) > 0)
+	{
+		KeysOnGround.AddUnique(Key);
+		KeyIndex.Add(Key, Key->GetActorLocation(), Key->GetSignature());
+
+		OnMazeActorChanged.Broadcast(Key);
+	}
+}
+
+void UMazeActorRegistrySubsystem::NotifyDoorOpened(AMazeGameDoor* Door)
+{
+	if (Door && ClosedDoors.RemoveSwap(Door) > 0)
+	{
+		OpenDoors.AddUnique(Door);
+		DoorSignatureIndex.SetActive(Door, false);
+
+		OnMazeActorChanged.Broadcast(Door);
+	}
+}
+
+AMazeBlazeKey* UMazeActorRegistrySubsystem::FindNearestKey(const FVector& Location) const
+{
+	return KeyIndex.FindNearest(Location);
+}
+
+AMazeGameDoor* UMazeActorRegistrySubsystem::FindNearestMatchingDoor(const FVector& Location, const AMazeBlazeKey* Key) const
+{
+	if (!Key)
+	{
+		return nullptr;
+	}
+
+	// Only the closed doors in the buckets of the key's signature bits are searched, nearest cells first,
+	// which only yields doors MazeCore::CanKeyOpenDoor accepts for the key
+	return DoorSignatureIndex.FindNearestActiveMatching(Location, Key->GetSignature());
+}
+
+AMazeBlazeExit* UMazeActorRegistrySubsystem::FindNearestExit(const FVector& Location) const
+{
+	AMazeBlazeExit* NearestExit = nullptr;
+	float NearestDistanceSq = MAX_FLT;
+
+	for (AMazeBlazeExit* Exit : Exits)
+	{
+		if (!Exit)
+		{
+			continue;
+		}
+
+		const float DistanceSq = FVector::DistSquared(Location, Exit->GetActorLocation());
+		if (DistanceSq < NearestDistanceSq)
+		{
+			NearestDistanceSq = DistanceSq;
+			NearestExit = Exit;
+		}
+	}
+
+	return NearestExit;
+}
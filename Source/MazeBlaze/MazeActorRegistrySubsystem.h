@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeSpatialHash.h"
+#include "MazeSignatureIndex.h"
+#include "MazeActorRegistrySubsystem.generated.h"
+
+class AMazeBlazeKey;
+class AMazeGameDoor;
+class AMazeBlazeExit;
+
+// Broadcast when a maze actor is added, removed or changes state (key picked up/dropped, door opened)
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnMazeActorChanged, AActor* /*ChangedActor*/);
+
+/**
+ * World subsystem that keeps typed lists of the maze actors (keys, doors and exits)
+ *
+ * Actors register themselves on BeginPlay/EndPlay and report their state changes
+ * (key picked up or dropped, door opened), so AI queries never have to scan the world.
+ * Keys on the ground are also kept in a spatial hash for nearest queries, and closed doors
+ * in one spatial hash per mask bit, so the nearest door a key opens is searched outwards from
+ * the caller among compatible doors only.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeActorRegistrySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the registry for the world of the given object
+	static UMazeActorRegistrySubsystem* Get(const UObject* WorldContextObject);
+
+	// Called when the subsystem is created with its world
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+
+	// Called when the subsystem is torn down with its world
+	virtual void Deinitialize() override;
+
+	// Register/unregister maze actors
+	void RegisterKey(AMazeBlazeKey* Key);
+	void UnregisterKey(AMazeBlazeKey* Key);
+	void RegisterDoor(AMazeGameDoor* Door);
+	void UnregisterDoor(AMazeGameDoor* Door);
+	void RegisterExit(AMazeBlazeExit* Exit);
+	void UnregisterExit(AMazeBlazeExit* Exit);
+
+	// State change notifications
+	void NotifyKeyPickedUp(AMazeBlazeKey* Key);
+	void NotifyKeyDropped(AMazeBlazeKey* Key);
+	void NotifyDoorOpened(AMazeGameDoor* Door);
+
+	// Event fired whenever the registered maze state changes
+	FOnMazeActorChanged OnMazeActorChanged;
+
+	// Keys that are lying on the ground and can be picked up
+	UFUNCTION(BlueprintPure, Category = "Maze|Registry")
+	const TArray<AMazeBlazeKey*>& GetKeysOnGround() const { return KeysOnGround; }
+
+	// Keys currently carried by a character
+	UFUNCTION(BlueprintPure, Category = "Maze|Registry")
+	const TArray<AMazeBlazeKey*>& GetCarriedKeys() const { return CarriedKeys; }
+
+	// Doors that have not been opened yet
+	UFUNCTION(BlueprintPure, Category = "Maze|Registry")
+	const TArray<AMazeGameDoor*>& GetClosedDoors() const { return ClosedDoors; }
+
+	// All exits in the maze
+	UFUNCTION(BlueprintPure, Category = "Maze|Registry")
+	const TArray<AMazeBlazeExit*>& GetExits() const { return Exits; }
+
+	// Find the nearest key on the ground
+	UFUNCTION(BlueprintCallable, Category = "Maze|Registry")
+	AMazeBlazeKey* FindNearestKey(const FVector& Location) const;
+
+	// Find the nearest closed door that can be opened with the given key
+	UFUNCTION(BlueprintCallable, Category = "Maze|Registry")
+	AMazeGameDoor* FindNearestMatchingDoor(const FVector& Location, const AMazeBlazeKey* Key) const;
+
+	// Find the nearest exit
+	UFUNCTION(BlueprintCallable, Category = "Maze|Registry")
+	AMazeBlazeExit* FindNearestExit(const FVector& Location) const;
+
+	// Size of the spatial hash cells; should roughly match the maze corridor width
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Registry", meta = (ClampMin = "50.0"))
+	float SpatialHashCellSize = 400.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Keys currently on the ground
+	UPROPERTY()
+	TArray<AMazeBlazeKey*> KeysOnGround;
+
+	// Keys currently carried by a character
+	UPROPERTY()
+	TArray<AMazeBlazeKey*> CarriedKeys;
+
+	// Doors that are still closed
+	UPROPERTY()
+	TArray<AMazeGameDoor*> ClosedDoors;
+
+	// Doors that have been opened
+	UPROPERTY()
+	TArray<AMazeGameDoor*> OpenDoors;
+
+	// Exits
+	UPROPERTY()
+	TArray<AMazeBlazeExit*> Exits;
+
+	// Spatial index of KeysOnGround, masked by key signature
+	TMazeSpatialHash<AMazeBlazeKey*> KeyIndex;
+
+	// All doors bucketed per mask bit, with the closed (active) ones hashed by location per bit
+	TMazeSignatureIndex<AMazeGameDoor*> DoorSignatureIndex;
+};
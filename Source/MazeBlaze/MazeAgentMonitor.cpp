@@ -0,0 +1,99 @@
+#include "MazeAgentMonitor.h"
+
+int32 FMazeAgentMonitor::AddAgent(const FVector& Location, uint8 State)
+{
+	const int32 AgentIndex = Locations.Add(Location);
+	ReferenceLocations.Add(Location);
+	StuckTimes.Add(0.0f);
+	StateTimes.Add(0.0f);
+	PathFollowingTimes.Add(0.0f);
+	States.Add(State);
+	LastStates.Add(State);
+	Flags.Add(0);
+	return AgentIndex;
+}
+
+void FMazeAgentMonitor::RemoveAgentAtSwap(int32 AgentIndex)
+{
+	Locations.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	ReferenceLocations.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	StuckTimes.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	StateTimes.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	PathFollowingTimes.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	States.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	LastStates.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	Flags.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+}
+
+void FMazeAgentMonitor::ResetAgent(int32 AgentIndex, const FVector& Location)
+{
+	Locations[AgentIndex] = Location;
+	ReferenceLocations[AgentIndex] = Location;
+	StuckTimes[AgentIndex] = 0.0f;
+	StateTimes[AgentIndex] = 0.0f;
+	PathFollowingTimes[AgentIndex] = 0.0f;
+	LastStates[AgentIndex] = States[AgentIndex];
+}
+
+void FMazeAgentMonitor::Update(float DeltaSeconds, TArray<FMazeAgentMonitorEventRecord>& OutEvents)
+{
+	const float StuckDistanceSquared = FMath::Square(Settings.StuckDistance);
+	const int32 NumAgents = Locations.Num();
+
+	FVector* RESTRICT LocationData = Locations.GetData();
+	FVector* RESTRICT ReferenceData = ReferenceLocations.GetData();
+	float* RESTRICT StuckData = StuckTimes.GetData();
+	float* RESTRICT StateTimeData = StateTimes.GetData();
+	float* RESTRICT PathFollowingData = PathFollowingTimes.GetData();
+	const uint8* RESTRICT StateData = States.GetData();
+	uint8* RESTRICT LastStateData = LastStates.GetData();
+	const uint8* RESTRICT FlagData = Flags.GetData();
+
+	for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+	{
+		const uint8 AgentFlags = FlagData[Agent];
+		if (!(AgentFlags & ActiveFlag))
+		{
+			continue;
+		}
+		const bool bIsMoving = (AgentFlags & MovingFlag) != 0;
+
+		// Progress is measured from where the agent stopped, so slow creeping still counts as stuck
+		if (bIsMoving && FVector::DistSquared(LocationData[Agent], ReferenceData[Agent]) < StuckDistanceSquared)
+		{
+			StuckData[Agent] += DeltaSeconds;
+			if (StuckData[Agent] > Settings.MaxStuckTime)
+			{
+				OutEvents.Add({ Agent, EMazeAgentMonitorEvent::Stuck });
+				StuckData[Agent] = 0.0f;
+			}
+		}
+		else
+		{
+			StuckData[Agent] = 0.0f;
+			ReferenceData[Agent] = LocationData[Agent];
+		}
+
+		PathFollowingData[Agent] = bIsMoving ? PathFollowingData[Agent] + DeltaSeconds : 0.0f;
+		if (PathFollowingData[Agent] > Settings.MaxPathFollowingTime)
+		{
+			OutEvents.Add({ Agent, EMazeAgentMonitorEvent::PathFollowingTimeout });
+			PathFollowingData[Agent] = 0.0f;
+		}
+
+		if (StateData[Agent] != LastStateData[Agent])
+		{
+			LastStateData[Agent] = StateData[Agent];
+			StateTimeData[Agent] = 0.0f;
+		}
+		else
+		{
+			StateTimeData[Agent] += DeltaSeconds;
+			if (StateTimeData[Agent] > Settings.MaxTimeInState)
+			{
+				OutEvents.Add({ Agent, EMazeAgentMonitorEvent::StateTimeout });
+				StateTimeData[Agent] = 0.0f;
+			}
+		}
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Error raised by the agent monitor
+enum class EMazeAgentMonitorEvent : uint8
+{
+	// Tried to move without getting anywhere for MaxStuckTime
+	Stuck,
+
+	// Stayed in the same state for MaxTimeInState
+	StateTimeout,
+
+	// Followed one path or another without pause for MaxPathFollowingTime
+	PathFollowingTimeout
+};
+
+struct FMazeAgentMonitorEventRecord
+{
+	int32 AgentIndex = INDEX_NONE;
+	EMazeAgentMonitorEvent Event = EMazeAgentMonitorEvent::Stuck;
+};
+
+// Thresholds shared by every monitored agent
+struct FMazeAgentMonitorSettings
+{
+	// An agent trying to move that stays within this distance of where it stopped is stuck
+	float StuckDistance = 50.0f;
+	float MaxStuckTime = 3.0f;
+	float MaxTimeInState = 15.0f;
+	float MaxPathFollowingTime = 10.0f;
+};
+
+/**
+ * Stuck, state and path following timers of many agents, stored as parallel arrays
+ *
+ * The owner writes each agent's location, movement status and state once per frame, then one
+ * Update walks the arrays front to back and reports the agents that crossed a threshold. An
+ * event restarts the timer that raised it. Agents are addressed by index; removing one moves the
+ * last agent into its slot, like TArray::RemoveAtSwap.
+ */
+class MAZEBLAZE_API FMazeAgentMonitor
+{
+public:
+	FMazeAgentMonitorSettings Settings;
+
+	int32 Num() const { return Locations.Num(); }
+
+	// Add an agent at a location; returns its index
+	int32 AddAgent(const FVector& Location, uint8 State);
+
+	// Remove an agent; the last agent takes its index
+	void RemoveAgentAtSwap(int32 AgentIndex);
+
+	// Latest sample of an agent; inactive agents keep their timers until they are active again
+	void SetSample(int32 AgentIndex, const FVector& Location, bool bIsMoving, uint8 State, bool bIsActive = true)
+	{
+		Locations[AgentIndex] = Location;
+		States[AgentIndex] = State;
+		Flags[AgentIndex] = (bIsActive ? ActiveFlag : 0) | (bIsMoving ? MovingFlag : 0);
+	}
+
+	// Restart all timers of an agent from a location, e.g. after it recovered from an error
+	void ResetAgent(int32 AgentIndex, const FVector& Location);
+
+	// Advance every active agent's timers; events are appended to OutEvents in agent order
+	void Update(float DeltaSeconds, TArray<FMazeAgentMonitorEventRecord>& OutEvents);
+
+	float GetStuckTime(int32 AgentIndex) const { return StuckTimes[AgentIndex]; }
+	float GetTimeInState(int32 AgentIndex) const { return StateTimes[AgentIndex]; }
+	float GetPathFollowingTime(int32 AgentIndex) const { return PathFollowingTimes[AgentIndex]; }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Locations.GetAllocatedSize() + ReferenceLocations.GetAllocatedSize() + StuckTimes.GetAllocatedSize() + StateTimes.GetAllocatedSize()
+			+ PathFollowingTimes.GetAllocatedSize() + States.GetAllocatedSize() + LastStates.GetAllocatedSize() + Flags.GetAllocatedSize();
+	}
+
+private:
+	static constexpr uint8 ActiveFlag = 1 << 0;
+	static constexpr uint8 MovingFlag = 1 << 1;
+
+	// Per-agent data, one entry per agent in every array
+	TArray<FVector> Locations;
+
+	// Where the agent was when it last stopped making progress
+	TArray<FVector> ReferenceLocations;
+
+	TArray<float> StuckTimes;
+	TArray<float> StateTimes;
+	TArray<float> PathFollowingTimes;
+	TArray<uint8> States;
+	TArray<uint8> LastStates;
+	TArray<uint8> Flags;
+};
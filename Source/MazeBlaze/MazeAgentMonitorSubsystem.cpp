@@ -0,0 +1,142 @@
+#include "MazeAgentMonitorSubsystem.h"
+#include "MazeBlazeAIController.h"
+#include "MazeExplorationStrategy.h"
+#include "Engine/World.h"
+
+DECLARE_CYCLE_STAT(TEXT("Agent Monitor Update"), STAT_MazeAgentMonitorUpdate, STATGROUP_MazeExploration);
+
+UMazeAgentMonitorSubsystem* UMazeAgentMonitorSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeAgentMonitorSubsystem>() : nullptr;
+}
+
+void UMazeAgentMonitorSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Monitor.Settings.StuckDistance = StuckDistance;
+	Monitor.Settings.MaxStuckTime = MaxStuckTime;
+	Monitor.Settings.MaxTimeInState = MaxTimeInState;
+	Monitor.Settings.MaxPathFollowingTime = MaxPathFollowingTime;
+}
+
+void UMazeAgentMonitorSubsystem::Deinitialize()
+{
+	Monitor = FMazeAgentMonitor();
+	Agents.Empty();
+	AgentIndices.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMazeAgentMonitorSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazeAgentMonitorSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazeAgentMonitorSubsystem, STATGROUP_Tickables);
+}
+
+bool UMazeAgentMonitorSubsystem::RegisterController(AMazeBlazeAIController* Controller)
+{
+	if (!bEnabled || !Controller)
+	{
+		return false;
+	}
+
+	if (!AgentIndices.Contains(Controller))
+	{
+		const APawn* Pawn = Controller->GetPawn();
+		const int32 AgentIndex = Monitor.AddAgent(Pawn ? Pawn->GetActorLocation() : FVector::ZeroVector, static_cast<uint8>(Controller->GetCurrentState()));
+		Agents.Add(Controller);
+		AgentIndices.Add(Controller, AgentIndex);
+	}
+	return true;
+}
+
+void UMazeAgentMonitorSubsystem::UnregisterController(AMazeBlazeAIController* Controller)
+{
+	int32 AgentIndex = INDEX_NONE;
+	if (!AgentIndices.RemoveAndCopyValue(Controller, AgentIndex))
+	{
+		return;
+	}
+
+	Monitor.RemoveAgentAtSwap(AgentIndex);
+	Agents.RemoveAtSwap(AgentIndex, 1, EAllowShrinking::No);
+	if (Agents.IsValidIndex(AgentIndex))
+	{
+		AgentIndices.Add(Agents[AgentIndex], AgentIndex);
+	}
+}
+
+void UMazeAgentMonitorSubsystem::ResetAgent(const AMazeBlazeAIController* Controller)
+{
+	if (const int32* AgentIndex = AgentIndices.Find(Controller))
+	{
+		const APawn* Pawn = Controller->GetPawn();
+		Monitor.ResetAgent(*AgentIndex, Pawn ? Pawn->GetActorLocation() : FVector::ZeroVector);
+	}
+}
+
+float UMazeAgentMonitorSubsystem::GetStuckTime(const AMazeBlazeAIController* Controller) const
+{
+	const int32* AgentIndex = AgentIndices.Find(Controller);
+	return AgentIndex ? Monitor.GetStuckTime(*AgentIndex) : 0.0f;
+}
+
+float UMazeAgentMonitorSubsystem::GetTimeInState(const AMazeBlazeAIController* Controller) const
+{
+	const int32* AgentIndex = AgentIndices.Find(Controller);
+	return AgentIndex ? Monitor.GetTimeInState(*AgentIndex) : 0.0f;
+}
+
+void UMazeAgentMonitorSubsystem::Tick(float DeltaTime)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeAgentMonitorUpdate);
+
+	// Sample every agent; controllers in an error state recover on their own and keep their timers
+	for (int32 AgentIndex = 0; AgentIndex < Agents.Num(); ++AgentIndex)
+	{
+		AMazeBlazeAIController* Controller = Agents[AgentIndex];
+		const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		if (!Pawn || Controller->IsInErrorState())
+		{
+			Monitor.SetSample(AgentIndex, FVector::ZeroVector, false, 0, false);
+			continue;
+		}
+
+		const FVector Location = Pawn->GetActorLocation();
+		Monitor.SetSample(AgentIndex, Location, Controller->IsTryingToMove(), static_cast<uint8>(Controller->GetCurrentState()));
+
+		// Agents that are making progress leave a place to fall back to
+		if (Monitor.GetStuckTime(AgentIndex) <= 0.0f)
+		{
+			Controller->LastValidLocation = Location;
+		}
+	}
+
+	Events.Reset();
+	Monitor.Update(DeltaTime, Events);
+	if (Events.Num() == 0)
+	{
+		return;
+	}
+
+	// Handlers may unregister controllers, which moves others to new indices
+	PendingEvents.Reset();
+	for (const FMazeAgentMonitorEventRecord& Record : Events)
+	{
+		PendingEvents.Emplace(Agents[Record.AgentIndex], Record.Event);
+	}
+	for (const TPair<AMazeBlazeAIController*, EMazeAgentMonitorEvent>& Pending : PendingEvents)
+	{
+		if (IsValid(Pending.Key) && AgentIndices.Contains(Pending.Key))
+		{
+			Pending.Key->HandleMonitorEvent(Pending.Value);
+		}
+	}
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeAgentMonitor.h"
+#include "MazeAgentMonitorSubsystem.generated.h"
+
+class AMazeBlazeAIController;
+
+/**
+ * World subsystem that runs stuck, state timeout and path following timeout detection for every AI controller
+ *
+ * Each frame it samples the controllers' pawn locations and movement status into one
+ * FMazeAgentMonitor, updates all timers in a single pass and hands the events to the controllers.
+ * The controllers and the error detection service read their timers from here, so every check
+ * uses the same thresholds.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeAgentMonitorSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the agent monitor for the world of the given object
+	static UMazeAgentMonitorSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Start monitoring a controller; returns false when monitoring is disabled
+	bool RegisterController(AMazeBlazeAIController* Controller);
+
+	// Stop monitoring a controller
+	void UnregisterController(AMazeBlazeAIController* Controller);
+
+	bool IsMonitored(const AMazeBlazeAIController* Controller) const { return AgentIndices.Contains(Controller); }
+
+	// Every monitored controller, in no particular order
+	const TArray<AMazeBlazeAIController*>& GetControllers() const { return Agents; }
+
+	// Restart all timers of a controller, e.g. after it recovered from an error
+	void ResetAgent(const AMazeBlazeAIController* Controller);
+
+	// Timers of a controller, zero if it is not monitored
+	float GetStuckTime(const AMazeBlazeAIController* Controller) const;
+	float GetTimeInState(const AMazeBlazeAIController* Controller) const;
+
+	const FMazeAgentMonitorSettings& GetSettings() const { return Monitor.Settings; }
+
+	// Whether controllers are monitored here at all; when disabled the error detection service keeps its own timers
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Monitor")
+	bool bEnabled = true;
+
+	// A moving agent that stays within this distance for MaxStuckTime is stuck
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Monitor", meta = (ClampMin = "0.0"))
+	float StuckDistance = 50.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Monitor", meta = (ClampMin = "0.1"))
+	float MaxStuckTime = 3.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Monitor", meta = (ClampMin = "0.1"))
+	float MaxTimeInState = 15.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Monitor", meta = (ClampMin = "0.1"))
+	float MaxPathFollowingTime = 10.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Monitored controllers, parallel to the monitor's agents
+	UPROPERTY()
+	TArray<AMazeBlazeAIController*> Agents;
+
+	TMap<const AMazeBlazeAIController*, int32> AgentIndices;
+
+	FMazeAgentMonitor Monitor;
+
+	// Events of the last update, kept to reuse the allocation
+	TArray<FMazeAgentMonitorEventRecord> Events;
+	TArray<TPair<AMazeBlazeAIController*, EMazeAgentMonitorEvent>> PendingEvents;
+};
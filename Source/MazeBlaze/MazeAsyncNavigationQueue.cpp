@@ -0,0 +1,155 @@
+#include "MazeAsyncNavigationQueue.h"
+#include "MazeExplorationStrategy.h"
+
+DECLARE_CYCLE_STAT(TEXT("Async Nav Batch"), STAT_MazeAsyncNavBatch, STATGROUP_MazeExploration);
+DECLARE_CYCLE_STAT(TEXT("Async Nav Wait"), STAT_MazeAsyncNavWait, STATGROUP_MazeExploration);
+DECLARE_DWORD_COUNTER_STAT(TEXT("Async Nav Queries"), STAT_MazeAsyncNavQueries, STATGROUP_MazeExploration);
+
+uint32 FMazeAsyncNavigationQueue::Add(FMazeAsyncNavigationQuery&& Query)
+{
+	// Zero is kept for "no query"
+	Query.Id = NextQueryId++;
+	if (NextQueryId == 0)
+	{
+		NextQueryId = 1;
+	}
+
+	PendingQueries.Add(MoveTemp(Query));
+	return PendingQueries.Last().Id;
+}
+
+void FMazeAsyncNavigationQueue::Cancel(uint32 QueryId)
+{
+	if (QueryId == 0)
+	{
+		return;
+	}
+
+	const int32 PendingIndex = PendingQueries.IndexOfByPredicate([QueryId](const FMazeAsyncNavigationQuery& Query) { return Query.Id == QueryId; });
+	if (PendingIndex != INDEX_NONE)
+	{
+		PendingQueries.RemoveAt(PendingIndex);
+		return;
+	}
+
+	for (FMazeAsyncNavigationQuery& Query : BatchQueries)
+	{
+		if (Query.Id == QueryId)
+		{
+			Query.bCancelled = true;
+			return;
+		}
+	}
+}
+
+void FMazeAsyncNavigationQueue::RunQuery(FMazeAsyncNavigationQuery& Query)
+{
+	if (!Query.NavData)
+	{
+		return;
+	}
+
+	if (Query.bPathQuery)
+	{
+		FPathFindingQuery PathQuery(nullptr, *Query.NavData, Query.Start, Query.End, Query.Filter);
+		PathQuery.SetAllowPartialPaths(Query.bAllowPartialPath);
+
+		const FPathFindingResult Result = Query.NavData->FindPath(Query.AgentProperties, PathQuery);
+		if (Result.IsSuccessful() && Result.Path.IsValid() && (Query.bAllowPartialPath || !Result.IsPartial()))
+		{
+			Query.Path = Result.Path;
+		}
+		return;
+	}
+
+	for (const float Radius : Query.Radii)
+	{
+		FNavLocation Location;
+		if (Query.NavData->GetRandomReachablePointInRadius(Query.Start, Radius, Location, Query.Filter))
+		{
+			Query.Point = Location.Location;
+			Query.bFound = true;
+			return;
+		}
+	}
+}
+
+void FMazeAsyncNavigationQueue::Launch(int32 MaxQueries, int32 QueriesPerTask)
+{
+	if (PendingQueries.Num() == 0)
+	{
+		return;
+	}
+
+	// A batch that is still out is finished first
+	Complete();
+
+	const int32 NumQueries = FMath::Min(PendingQueries.Num(), FMath::Max(MaxQueries, 1));
+	BatchQueries.Reserve(NumQueries);
+	for (int32 Index = 0; Index < NumQueries; ++Index)
+	{
+		FMazeAsyncNavigationQuery& Query = BatchQueries.Add_GetRef(MoveTemp(PendingQueries[Index]));
+		Query.NavData = Query.NavDataPtr.Get();
+		Query.Filter = Query.NavData ? Query.NavData->GetDefaultQueryFilter() : nullptr;
+	}
+	PendingQueries.RemoveAt(0, NumQueries, EAllowShrinking::No);
+	INC_DWORD_STAT_BY(STAT_MazeAsyncNavQueries, NumQueries);
+
+	// The array is not resized again until the tasks are done, so they can hold on to its elements
+	FMazeAsyncNavigationQuery* Queries = BatchQueries.GetData();
+	const int32 TaskSize = FMath::Max(QueriesPerTask, 1);
+	for (int32 First = 0; First < NumQueries; First += TaskSize)
+	{
+		const int32 Last = FMath::Min(First + TaskSize, NumQueries);
+		BatchTasks.Add(FFunctionGraphTask::CreateAndDispatchWhenReady([Queries, First, Last]()
+		{
+			SCOPE_CYCLE_COUNTER(STAT_MazeAsyncNavBatch);
+			for (int32 Index = First; Index < Last; ++Index)
+			{
+				RunQuery(Queries[Index]);
+			}
+		}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask));
+	}
+}
+
+void FMazeAsyncNavigationQueue::Wait()
+{
+	if (BatchTasks.Num() > 0)
+	{
+		SCOPE_CYCLE_COUNTER(STAT_MazeAsyncNavWait);
+		FTaskGraphInterface::Get().WaitUntilTasksComplete(BatchTasks, ENamedThreads::GameThread);
+		BatchTasks.Reset();
+	}
+}
+
+void FMazeAsyncNavigationQueue::Complete()
+{
+	Wait();
+
+	// Delegates may queue new queries (into PendingQueries) or cancel the ones not delivered yet
+	for (int32 Index = 0; Index < BatchQueries.Num(); ++Index)
+	{
+		FMazeAsyncNavigationQuery& Query = BatchQueries[Index];
+		if (Query.bCancelled)
+		{
+			continue;
+		}
+
+		if (Query.bPathQuery)
+		{
+			Query.OnPathComplete.ExecuteIfBound(Query.Id, Query.Path);
+		}
+		else
+		{
+			Query.OnPointComplete.ExecuteIfBound(Query.Id, Query.bFound, Query.Point);
+		}
+	}
+	BatchQueries.Reset();
+}
+
+void FMazeAsyncNavigationQueue::Reset()
+{
+	Wait();
+	BatchQueries.Empty();
+	PendingQueries.Empty();
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "NavigationData.h"
+
+// Result of a path query: the path, or null if there is none
+DECLARE_DELEGATE_TwoParams(FMazeAsyncPathDelegate, uint32 /*QueryId*/, FNavPathSharedPtr /*Path*/);
+
+// Result of a reachable point query
+DECLARE_DELEGATE_ThreeParams(FMazeAsyncPointDelegate, uint32 /*QueryId*/, bool /*bFound*/, const FVector& /*Point*/);
+
+// A navmesh path or random reachable point query
+struct FMazeAsyncNavigationQuery
+{
+	uint32 Id = 0;
+	bool bPathQuery = false;
+	bool bAllowPartialPath = false;
+
+	// Set on the game thread only, never read by the workers
+	bool bCancelled = false;
+
+	FNavAgentProperties AgentProperties;
+	FVector Start = FVector::ZeroVector;
+	FVector End = FVector::ZeroVector;
+	TArray<float, TInlineAllocator<4>> Radii;
+
+	// Resolved on the game thread when the batch is launched; a query without navigation data finds nothing
+	TWeakObjectPtr<const ANavigationData> NavDataPtr;
+	const ANavigationData* NavData = nullptr;
+	FSharedConstNavQueryFilter Filter;
+
+	// Written by the worker
+	FNavPathSharedPtr Path;
+	FVector Point = FVector::ZeroVector;
+	bool bFound = false;
+
+	FMazeAsyncPathDelegate OnPathComplete;
+	FMazeAsyncPointDelegate OnPointComplete;
+};
+
+/**
+ * Queue of navigation queries run in batches on task graph workers
+ *
+ * Queries wait in request order until Launch sends at most a given number of them to the workers;
+ * Complete waits for the batch and calls the delegates of its queries on the game thread. Only
+ * the game thread calls the queue, and the navigation data must not change while a batch runs.
+ */
+class MAZEBLAZE_API FMazeAsyncNavigationQueue
+{
+public:
+	~FMazeAsyncNavigationQueue() { Reset(); }
+
+	// Queue a query and return its id, never 0
+	uint32 Add(FMazeAsyncNavigationQuery&& Query);
+
+	// Drop a query so its delegate is not called; does nothing for finished or unknown queries
+	void Cancel(uint32 QueryId);
+
+	// Send up to MaxQueries waiting queries to the workers, QueriesPerTask to a task. A batch still out is completed first
+	void Launch(int32 MaxQueries, int32 QueriesPerTask);
+
+	// Wait for the workers to finish the batch
+	void Wait();
+
+	// Wait for the batch and call the delegates of its queries
+	void Complete();
+
+	// Wait for the batch and drop every query without calling its delegate
+	void Reset();
+
+	// Queries waiting for a batch, and queries of the batch on the workers
+	int32 GetNumPending() const { return PendingQueries.Num(); }
+	int32 GetNumRunning() const { return BatchQueries.Num(); }
+
+private:
+	// Run one query on a worker thread
+	static void RunQuery(FMazeAsyncNavigationQuery& Query);
+
+	// Queries made since the last batch was launched, in request order
+	TArray<FMazeAsyncNavigationQuery> PendingQueries;
+
+	// Queries on the workers; the game thread only sets their bCancelled flags until the tasks are done
+	TArray<FMazeAsyncNavigationQuery> BatchQueries;
+	FGraphEventArray BatchTasks;
+
+	uint32 NextQueryId = 1;
+};
@@ -0,0 +1,99 @@
+#include "MazeAsyncNavigationSubsystem.h"
+#include "NavigationSystem.h"
+#include "Engine/World.h"
+#include "UObject/UObjectGlobals.h"
+
+UMazeAsyncNavigationSubsystem* UMazeAsyncNavigationSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeAsyncNavigationSubsystem>() : nullptr;
+}
+
+void UMazeAsyncNavigationSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	WorldTickStartHandle = FWorldDelegates::OnWorldTickStart.AddUObject(this, &UMazeAsyncNavigationSubsystem::HandleWorldTickStart);
+	WorldPostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddUObject(this, &UMazeAsyncNavigationSubsystem::HandleWorldPostActorTick);
+
+	// Garbage collection may destroy navigation data, so it waits for the workers to be done with it
+	PreGarbageCollectHandle = FCoreUObjectDelegates::GetPreGarbageCollectDelegate().AddUObject(this, &UMazeAsyncNavigationSubsystem::WaitForBatch);
+}
+
+void UMazeAsyncNavigationSubsystem::Deinitialize()
+{
+	FWorldDelegates::OnWorldTickStart.Remove(WorldTickStartHandle);
+	FWorldDelegates::OnWorldPostActorTick.Remove(WorldPostActorTickHandle);
+	FCoreUObjectDelegates::GetPreGarbageCollectDelegate().Remove(PreGarbageCollectHandle);
+
+	// The world is going away: nobody is left to take the results
+	Queue.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UMazeAsyncNavigationSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+uint32 UMazeAsyncNavigationSubsystem::RequestPath(const FNavAgentProperties& AgentProperties, const FVector& From, const FVector& To, bool bAllowPartialPath, FMazeAsyncPathDelegate OnComplete)
+{
+	FMazeAsyncNavigationQuery Query;
+	Query.bPathQuery = true;
+	Query.bAllowPartialPath = bAllowPartialPath;
+	Query.AgentProperties = AgentProperties;
+	Query.Start = From;
+	Query.End = To;
+	Query.OnPathComplete = MoveTemp(OnComplete);
+	return AddQuery(MoveTemp(Query));
+}
+
+uint32 UMazeAsyncNavigationSubsystem::RequestReachablePoint(const FNavAgentProperties& AgentProperties, const FVector& Origin, TArrayView<const float> Radii, FMazeAsyncPointDelegate OnComplete)
+{
+	FMazeAsyncNavigationQuery Query;
+	Query.AgentProperties = AgentProperties;
+	Query.Start = Origin;
+	Query.Radii.Append(Radii.GetData(), Radii.Num());
+	Query.OnPointComplete = MoveTemp(OnComplete);
+	return AddQuery(MoveTemp(Query));
+}
+
+uint32 UMazeAsyncNavigationSubsystem::AddQuery(FMazeAsyncNavigationQuery&& Query)
+{
+	const UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	const ANavigationData* NavData = NavSys ? NavSys->GetNavDataForProps(Query.AgentProperties, Query.Start) : nullptr;
+	if (!NavData)
+	{
+		return 0;
+	}
+
+	Query.NavDataPtr = NavData;
+	return Queue.Add(MoveTemp(Query));
+}
+
+void UMazeAsyncNavigationSubsystem::CancelQuery(uint32 QueryId)
+{
+	Queue.Cancel(QueryId);
+}
+
+void UMazeAsyncNavigationSubsystem::WaitForBatch()
+{
+	Queue.Wait();
+}
+
+void UMazeAsyncNavigationSubsystem::HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		Queue.Complete();
+	}
+}
+
+void UMazeAsyncNavigationSubsystem::HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds)
+{
+	if (World == GetWorld())
+	{
+		Queue.Launch(MaxQueriesPerFrame, QueriesPerTask);
+	}
+}
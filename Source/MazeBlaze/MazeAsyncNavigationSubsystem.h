@@ -0,0 +1,71 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeAsyncNavigationQueue.h"
+#include "MazeAsyncNavigationSubsystem.generated.h"
+
+/**
+ * World subsystem that answers navmesh path and random reachable point queries on worker threads
+ *
+ * Queries made during a frame are batched and, once the actors have ticked, split into task
+ * graph tasks that run while the game thread finishes the frame. The navmesh is only changed by
+ * the navigation system's tick inside the world tick, so it is read-only while a batch runs: the
+ * batch is waited for when the next world tick starts (or before garbage collection) and its
+ * results are delivered on the game thread then, a frame after the request. At most
+ * MaxQueriesPerFrame queries go into a batch, so many agents recovering at once spread their
+ * queries over a few frames instead of stalling one.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeAsyncNavigationSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the async navigation subsystem for the world of the given object
+	static UMazeAsyncNavigationSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Find a path on the navigation data of an agent. OnComplete runs on the game thread unless the
+	// query is cancelled first. Returns the query id, or 0 if there is no navigation data
+	uint32 RequestPath(const FNavAgentProperties& AgentProperties, const FVector& From, const FVector& To, bool bAllowPartialPath, FMazeAsyncPathDelegate OnComplete);
+
+	// Find a random point reachable from Origin, trying each radius in turn until one gives a point
+	uint32 RequestReachablePoint(const FNavAgentProperties& AgentProperties, const FVector& Origin, TArrayView<const float> Radii, FMazeAsyncPointDelegate OnComplete);
+
+	// Drop a query so its delegate is not called; does nothing for finished or unknown queries
+	void CancelQuery(uint32 QueryId);
+
+	// Queries waiting for a batch, and queries of the batch on the workers
+	int32 GetNumPendingQueries() const { return Queue.GetNumPending(); }
+	int32 GetNumRunningQueries() const { return Queue.GetNumRunning(); }
+
+	// Queries sent to the workers each frame; the rest wait for the next frames
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|AsyncNavigation", meta = (ClampMin = "1"))
+	int32 MaxQueriesPerFrame = 64;
+
+	// Queries run by one task graph task
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|AsyncNavigation", meta = (ClampMin = "1"))
+	int32 QueriesPerTask = 8;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Queue a query on the navigation data of its agent; returns its id, or 0 if there is no navigation data
+	uint32 AddQuery(FMazeAsyncNavigationQuery&& Query);
+
+	// Wait for the workers to finish the batch
+	void WaitForBatch();
+
+	void HandleWorldTickStart(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+	void HandleWorldPostActorTick(UWorld* World, ELevelTick TickType, float DeltaSeconds);
+
+	FMazeAsyncNavigationQueue Queue;
+
+	FDelegateHandle WorldTickStartHandle;
+	FDelegateHandle WorldPostActorTickHandle;
+	FDelegateHandle PreGarbageCollectHandle;
+};
@@ -20,7 +20,7 @@ public class MazeBlaze : ModuleRules
 			"UMG" 
 		});
 
-		PrivateDependencyModuleNames.AddRange(new string[] {  });
+		PrivateDependencyModuleNames.AddRange(new string[] { "MazeCore", "Json" });
 
 		// Slate UI is required for UMG
 		PrivateDependencyModuleNames.AddRange(new string[] { "Slate", "SlateCore" });
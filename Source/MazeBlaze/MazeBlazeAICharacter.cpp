@@ -6,6 +6,7 @@
 #include "MazeBlazeExit.h"
 #include "MazeBlazeGameInstance.h"
 #include "AIController.h"
+#include "MazeBlazeAIController.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Components/StaticMeshComponent.h"
@@ -44,8 +45,10 @@ void AMazeBlazeAICharacter::BeginPlay()
 	// Initialize AI character
 	InitializeAICharacter();
 
-	// Bind to the key pickup event
+	// Bind to the key pickup, door and exit events
 	OnPickupKey.AddDynamic(this, &AMazeBlazeAICharacter::OnKeyCollected);
+	OnOpenDoor.AddDynamic(this, &AMazeBlazeAICharacter::OnDoorOpened);
+	OnReachExit.AddDynamic(this, &AMazeBlazeAICharacter::OnReachedExit);
 }
 
 // Called every frame
@@ -57,9 +60,31 @@ void AMazeBlazeAICharacter::Tick(float DeltaTime)
 	if (bIsControlledByAI && !bReachedExit)
 	{
 		TimeTaken += DeltaTime;
+		UpdateVisitedCells();
 	}
 }
 
+void AMazeBlazeAICharacter::UpdateVisitedCells()
+{
+	const FVector Location = GetActorLocation();
+	const FIntPoint Cell(FMath::FloorToInt(Location.X / BacktrackingCellSize), FMath::FloorToInt(Location.Y / BacktrackingCellSize));
+	if (Cell == CurrentCell)
+	{
+		return;
+	}
+
+	// Stepping back and forth over a cell border is not backtracking
+	bool bAlreadyVisited = false;
+	VisitedCells.Add(Cell, &bAlreadyVisited);
+	if (bAlreadyVisited && Cell != PreviousCell)
+	{
+		BacktrackingInstances++;
+	}
+
+	PreviousCell = CurrentCell;
+	CurrentCell = Cell;
+}
+
 void AMazeBlazeAICharacter::InitializeAICharacter()
 {
 	// Get the game instance to check AI settings
@@ -77,7 +102,7 @@ void AMazeBlazeAICharacter::InitializeAICharacter()
 		
 		// Log the AI exploration system being used
 		EAIExplorationSystem ExplorationSystem = GameInstance->GetAIExplorationSystem();
-		UE_LOG(LogTemp, Display, TEXT("MazeBlazeAICharacter: Using exploration system: %d"), static_cast<int32>(ExplorationSystem));
+		UE_LOG(LogTemp, Display, TEXT("MazeBlazeAICharacter: Using exploration system: %s"), *UEnum::GetDisplayValueAsText(ExplorationSystem).ToString());
 		
 		// Make sure we have an AI controller
 		AAIController* AIController = Cast<AAIController>(GetController());
@@ -88,6 +113,12 @@ void AMazeBlazeAICharacter::InitializeAICharacter()
 		else
 		{
 			UE_LOG(LogTemp, Display, TEXT("MazeBlazeAICharacter: AI controller found"));
+			
+			// The controller's strategy is what the explore and move tasks dispatch to
+			if (AMazeBlazeAIController* MazeController = Cast<AMazeBlazeAIController>(AIController))
+			{
+				MazeController->SetExplorationSystem(ExplorationSystem);
+			}
 		}
 	}
 	else
@@ -63,6 +63,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void SetCurrentPath(const TArray<FVector>& NewPath);
 
+	// Metrics of the run so far
+	int32 GetKeysCollected() const { return KeysCollected; }
+	int32 GetDoorsOpened() const { return DoorsOpened; }
+	int32 GetBacktrackingInstances() const { return BacktrackingInstances; }
+	float GetTimeTaken() const { return TimeTaken; }
+	bool HasReachedExit() const { return bReachedExit; }
+
 	// Delegate for key pickup events
 	UPROPERTY(BlueprintAssignable, Category = "AI Events")
 	FOnPickupKey OnKeyPickedUp;
@@ -107,4 +114,16 @@ protected:
 	// Whether the AI has reached the exit
 	UPROPERTY(BlueprintReadOnly, Category = "AI")
 	bool bReachedExit;
+
+	// Size of the grid cells used to notice the AI walking back into a part of the maze it already visited
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "AI Metrics", meta = (ClampMin = "10.0"))
+	float BacktrackingCellSize = 200.0f;
+
+private:
+	// Count a backtracking instance when the pawn enters a visited cell other than the one it just left
+	void UpdateVisitedCells();
+
+	TSet<FIntPoint> VisitedCells;
+	FIntPoint CurrentCell = FIntPoint(MAX_int32, MAX_int32);
+	FIntPoint PreviousCell = FIntPoint(MAX_int32, MAX_int32);
 };
\ No newline at end of file
@@ -5,9 +5,17 @@
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
 #include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
-#include "Perception/AISenseConfig_Sight.h"
-#include "Kismet/GameplayStatics.h"
 #include "MazeBlazeGameInstance.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeAISchedulerSubsystem.h"
+#include "MazeAgentMonitorSubsystem.h"
+#include "MazeAIStatusText.h"
+#include "MazeErrorTelemetrySubsystem.h"
+#include "MazeKeyDoorPlannerSubsystem.h"
+#include "MazeAsyncNavigationSubsystem.h"
+#include "MazePathCacheSubsystem.h"
+#include "MazeReachablePointSubsystem.h"
+#include "MazeFrontierExplorationComponent.h"
 #include "NavigationSystem.h"
 #include "DrawDebugHelpers.h"
 
@@ -20,6 +28,37 @@ const FName AMazeBlazeAIController::CurrentKeyKey = TEXT("CurrentKey");
 const FName AMazeBlazeAIController::ExitLocationKey = TEXT("ExitLocation");
 const FName AMazeBlazeAIController::SelfActorKey = TEXT("SelfActor");
 
+namespace
+{
+	// Radii tried in turn for a random point when navigation has to be recovered
+	const float NavigationRecoveryRadii[] = { 500.0f, 1000.0f, 2000.0f };
+	
+	// Nearest perceived actor that passes the filter
+	template<typename ActorType, typename PredicateType>
+	ActorType* FindNearestPerceived(const TArray<ActorType*>& Actors, const FVector& Location, PredicateType&& Predicate)
+	{
+		ActorType* NearestActor = nullptr;
+		float NearestDistanceSq = MAX_FLT;
+		
+		for (ActorType* Actor : Actors)
+		{
+			if (!Actor || !Predicate(Actor))
+			{
+				continue;
+			}
+			
+			const float DistanceSq = FVector::DistSquared(Location, Actor->GetActorLocation());
+			if (DistanceSq < NearestDistanceSq)
+			{
+				NearestDistanceSq = DistanceSq;
+				NearestActor = Actor;
+			}
+		}
+		
+		return NearestActor;
+	}
+}
+
 AMazeBlazeAIController::AMazeBlazeAIController()
 {
 	// Create behavior tree component
@@ -28,6 +67,13 @@ AMazeBlazeAIController::AMazeBlazeAIController()
 	// Create blackboard component
 	BlackboardComponent = CreateDefaultSubobject<UBlackboardComponent>(TEXT("BlackboardComponent"));
 	
+	// Create perception component (AAIController does not create one by default)
+	SetPerceptionComponent(*CreateDefaultSubobject<UAIPerceptionComponent>(TEXT("PerceptionComponent")));
+	SightConfig = nullptr;
+	
+	// Create frontier exploration memory (idle until the frontier explorer uses it)
+	FrontierExploration = CreateDefaultSubobject<UMazeFrontierExplorationComponent>(TEXT("FrontierExploration"));
+	
 	// Enable tick
 	PrimaryActorTick.bCanEverTick = true;
 	PrimaryActorTick.bStartWithTickEnabled = true;
@@ -37,14 +83,17 @@ AMazeBlazeAIController::AMazeBlazeAIController()
 	LastErrorMessage = TEXT("");
 	TimeSinceLastRecoveryAttempt = 0.0f;
 	
-	// Initialize stuck detection
-	PreviousLocation = FVector::ZeroVector;
-	StuckTime = 0.0f;
+	// Initialize recovery location
 	LastValidLocation = FVector::ZeroVector;
 	
-	// Initialize state tracking
-	TimeInCurrentState = 0.0f;
-	LastState = EAIState::Exploring;
+	// Initialize event-driven perception
+	bPerceptionDirty = true;
+	LastPerceptionUpdateTime = 0.0f;
+	PerceptionStatsWindowStart = 0.0f;
+	SkippedPerceptionUpdatesInWindow = 0;
+	SkippedPerceptionUpdatesPerSecond = 0;
+	bUpdatesScheduled = false;
+	RecoveryQueryId = 0;
 }
 
 void AMazeBlazeAIController::BeginPlay()
@@ -53,6 +102,69 @@ void AMazeBlazeAIController::BeginPlay()
 	
 	// Setup perception system
 	SetupPerceptionSystem();
+	
+	// Recompute perception when perceived targets change
+	if (PerceptionComponent)
+	{
+		PerceptionComponent->OnTargetPerceptionUpdated.AddUniqueDynamic(this, &AMazeBlazeAIController::HandleTargetPerceptionUpdated);
+	}
+	
+	// Recompute perception when keys are picked up or dropped and doors are opened
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &AMazeBlazeAIController::HandleMazeActorChanged);
+	}
+	
+	// Let the scheduler spread perception updates across frames
+	if (UMazeAISchedulerSubsystem* Scheduler = UMazeAISchedulerSubsystem::Get(this))
+	{
+		bUpdatesScheduled = Scheduler->RegisterController(this);
+	}
+	
+	// Stuck and state timeouts are detected for all agents at once
+	if (UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this))
+	{
+		AgentMonitor->RegisterController(this);
+	}
+	
+	// The debug view of all agents is drawn in one batch when enabled
+	if (UMazeDebugDrawSubsystem* DebugDraw = UMazeDebugDrawSubsystem::Get(this))
+	{
+		DebugDraw->RegisterController(this);
+	}
+}
+
+void AMazeBlazeAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+	MazeActorChangedHandle.Reset();
+	
+	if (UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(this))
+	{
+		AsyncNavigation->CancelQuery(RecoveryQueryId);
+	}
+	RecoveryQueryId = 0;
+	
+	if (UMazeAISchedulerSubsystem* Scheduler = UMazeAISchedulerSubsystem::Get(this))
+	{
+		Scheduler->UnregisterController(this);
+	}
+	bUpdatesScheduled = false;
+	
+	if (UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this))
+	{
+		AgentMonitor->UnregisterController(this);
+	}
+	
+	if (UMazeDebugDrawSubsystem* DebugDraw = UMazeDebugDrawSubsystem::Get(this))
+	{
+		DebugDraw->UnregisterController(this);
+	}
+	
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMazeBlazeAIController::OnPossess(APawn* InPawn)
@@ -63,16 +175,29 @@ void AMazeBlazeAIController::OnPossess(APawn* InPawn)
 	CurrentErrorState = EAIErrorType::None;
 	LastErrorMessage = TEXT("");
 	TimeSinceLastRecoveryAttempt = 0.0f;
-	StuckTime = 0.0f;
-	TimeInCurrentState = 0.0f;
+	ResetMonitorTimers();
 	
 	// Initialize location tracking
 	if (InPawn)
 	{
-		PreviousLocation = InPawn->GetActorLocation();
 		LastValidLocation = InPawn->GetActorLocation();
 	}
 	
+	// Our own key pickups invalidate perception immediately
+	if (AMazeBlazeCharacter* MazeCharacter = Cast<AMazeBlazeCharacter>(InPawn))
+	{
+		MazeCharacter->OnPickupKey.AddUniqueDynamic(this, &AMazeBlazeAIController::HandlePawnPickedUpKey);
+	}
+	MarkPerceptionDirty();
+	
+	// Use the game's exploration system unless this agent was switched to another one
+	if (!ExplorationStrategy)
+	{
+		const UMazeBlazeGameInstance* GameInstance = GetWorld()->GetGameInstance<UMazeBlazeGameInstance>();
+		ExplorationStrategy = IMazeExplorationStrategy::Create(GameInstance ? GameInstance->GetAIExplorationSystem() : EAIExplorationSystem::Frontier);
+	}
+	ExplorationStrategy->Activate(*this);
+	
 	// Initialize blackboard
 	if (!BlackboardAsset || !BehaviorTreeAsset)
 	{
@@ -92,7 +217,6 @@ void AMazeBlazeAIController::OnPossess(APawn* InPawn)
 	
 	// Set initial state to exploring
 	SetCurrentState(EAIState::Exploring);
-	LastState = EAIState::Exploring;
 	
 	// Run behavior tree
 	if (!RunBehaviorTree(BehaviorTreeAsset))
@@ -106,11 +230,24 @@ void AMazeBlazeAIController::OnPossess(APawn* InPawn)
 		   *InPawn->GetName());
 	
 	// Draw initial debug info
-	DrawDebugInfo(5.0f);
+	if (UMazeDebugDrawSubsystem::IsEnabled())
+	{
+		DrawDebugInfo(5.0f);
+	}
 }
 
 void AMazeBlazeAIController::OnUnPossess()
 {
+	if (AMazeBlazeCharacter* MazeCharacter = Cast<AMazeBlazeCharacter>(GetPawn()))
+	{
+		MazeCharacter->OnPickupKey.RemoveDynamic(this, &AMazeBlazeAIController::HandlePawnPickedUpKey);
+	}
+	
+	if (ExplorationStrategy && GetPawn())
+	{
+		ExplorationStrategy->Deactivate(*this);
+	}
+	
 	Super::OnUnPossess();
 	
 	// Stop behavior tree
@@ -138,55 +275,73 @@ void AMazeBlazeAIController::Tick(float DeltaTime)
 	}
 	else
 	{
-		// Check if AI is stuck
-		if (IsAIStuck())
-		{
-			StuckTime += DeltaTime;
-			
-			// If stuck for too long, report error and try to recover
-			if (StuckTime > MaxStuckTime)
-			{
-				ReportAIError(EAIErrorType::NavigationMissing, TEXT("AI appears to be stuck"));
-				ResetAIState();
-				StuckTime = 0.0f;
-			}
-		}
-		else
-		{
-			// Reset stuck timer if moving
-			StuckTime = 0.0f;
-			
-			// Store current location as valid if we're moving normally
-			StoreValidLocation();
-		}
+		// Stuck and state timeouts come from the agent monitor through HandleMonitorEvent
 		
-		// Track time in current state
-		EAIState CurrentState = GetCurrentState();
-		if (CurrentState == LastState)
+		// Update perception data when it has been invalidated or is too old
+		if (!bUpdatesScheduled)
 		{
-			TimeInCurrentState += DeltaTime;
-			
-			// If in the same state for too long, consider it an error
-			if (TimeInCurrentState > MaxTimeInState)
-			{
-				ReportAIError(EAIErrorType::TaskExecutionFailed, 
-					FString::Printf(TEXT("Stuck in state %s for too long"), 
-					*UEnum::GetValueAsString(CurrentState)));
-				ResetAIState();
-			}
-		}
-		else
-		{
-			// Reset timer when state changes
-			TimeInCurrentState = 0.0f;
-			LastState = CurrentState;
+			UpdatePerceptionIfNeeded();
 		}
 		
-		// Update perception data every tick when not in error state
-		UpdatePerception();
-		
-		// Draw debug information
-		DrawDebugInfo();
+		// Debug information is drawn by the debug draw subsystem
+	}
+}
+
+void AMazeBlazeAIController::RunScheduledUpdate(float ElapsedSeconds)
+{
+	// Error recovery keeps running from Tick
+	if (!GetPawn() || IsInErrorState())
+	{
+		return;
+	}
+	
+	UpdatePerceptionIfNeeded();
+}
+
+void AMazeBlazeAIController::HandleMonitorEvent(EMazeAgentMonitorEvent Event)
+{
+	if (IsInErrorState())
+	{
+		return;
+	}
+	
+	switch (Event)
+	{
+		case EMazeAgentMonitorEvent::Stuck:
+			// Stuck for too long, report error and try to recover
+			ReportAIError(EAIErrorType::NavigationMissing, TEXT("AI appears to be stuck"));
+			ResetAIState();
+			break;
+			
+		case EMazeAgentMonitorEvent::StateTimeout:
+			// In the same state for too long, consider it an error
+			ReportAIError(EAIErrorType::TaskExecutionFailed, FMazeAIStatusText::GetStateTimeoutMessage(GetCurrentState()));
+			ResetAIState();
+			break;
+			
+		case EMazeAgentMonitorEvent::PathFollowingTimeout:
+			ReportAIError(EAIErrorType::NavigationMissing, TEXT("Path following taking too long"));
+			break;
+	}
+}
+
+float AMazeBlazeAIController::GetStuckTime() const
+{
+	const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this);
+	return AgentMonitor ? AgentMonitor->GetStuckTime(this) : 0.0f;
+}
+
+float AMazeBlazeAIController::GetTimeInCurrentState() const
+{
+	const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this);
+	return AgentMonitor ? AgentMonitor->GetTimeInState(this) : 0.0f;
+}
+
+void AMazeBlazeAIController::ResetMonitorTimers()
+{
+	if (UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this))
+	{
+		AgentMonitor->ResetAgent(this);
 	}
 }
 
@@ -205,52 +360,100 @@ void AMazeBlazeAIController::SetCurrentState(EAIState NewState)
 {
 	if (BlackboardComponent)
 	{
+		// State transitions change which perception results are relevant
+		if (GetCurrentState() != NewState)
+		{
+			MarkPerceptionDirty();
+			
+			// React to the new state on the next frame instead of waiting for our turn
+			if (bUpdatesScheduled)
+			{
+				if (UMazeAISchedulerSubsystem* Scheduler = UMazeAISchedulerSubsystem::Get(this))
+				{
+					Scheduler->BoostPriority(this);
+				}
+			}
+		}
+		
 		BlackboardComponent->SetValueAsEnum(CurrentStateKey, static_cast<uint8>(NewState));
 	}
 }
 
-AMazeBlazeKey* AMazeBlazeAIController::FindNearestKey()
+bool AMazeBlazeAIController::IsTryingToMove() const
 {
-	TArray<AActor*> FoundKeys;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AMazeBlazeKey::StaticClass(), FoundKeys);
+	const APawn* ControlledPawn = GetPawn();
+	if (!ControlledPawn)
+	{
+		return false;
+	}
 	
-	if (FoundKeys.Num() == 0)
+	// Agents steered along a flow or potential field move by input instead of path following
+	const UPathFollowingComponent* PathFollowing = GetPathFollowingComponent();
+	return (PathFollowing && PathFollowing->GetStatus() == EPathFollowingStatus::Moving)
+		|| !ControlledPawn->GetLastMovementInputVector().IsNearlyZero();
+}
+
+void AMazeBlazeAIController::SetExplorationSystem(EAIExplorationSystem NewSystem)
+{
+	if (ExplorationStrategy && ExplorationStrategy->GetSystem() == NewSystem)
 	{
-		return nullptr;
+		return;
+	}
+	
+	SetExplorationStrategy(IMazeExplorationStrategy::Create(NewSystem));
+}
+
+void AMazeBlazeAIController::SetExplorationStrategy(TUniquePtr<IMazeExplorationStrategy> NewStrategy)
+{
+	check(NewStrategy.IsValid());
+	
+	// The old strategy lets go of the pawn before the new one takes it over
+	if (ExplorationStrategy && GetPawn())
+	{
+		ExplorationStrategy->Deactivate(*this);
+	}
+	ExplorationStrategy = MoveTemp(NewStrategy);
+	if (GetPawn())
+	{
+		ExplorationStrategy->Activate(*this);
+	}
+	
+	UE_LOG(LogTemp, Log, TEXT("%s now explores with %s"), *GetName(), *UEnum::GetDisplayValueAsText(ExplorationStrategy->GetSystem()).ToString());
+}
+
+EAIExplorationSystem AMazeBlazeAIController::GetExplorationSystem() const
+{
+	if (ExplorationStrategy)
+	{
+		return ExplorationStrategy->GetSystem();
 	}
 	
+	const UMazeBlazeGameInstance* GameInstance = GetWorld() ? GetWorld()->GetGameInstance<UMazeBlazeGameInstance>() : nullptr;
+	return GameInstance ? GameInstance->GetAIExplorationSystem() : EAIExplorationSystem::Frontier;
+}
+
+AMazeBlazeKey* AMazeBlazeAIController::FindNearestKey()
+{
 	APawn* ControlledPawn = GetPawn();
 	if (!ControlledPawn)
 	{
 		return nullptr;
 	}
 	
-	const FVector PawnLocation = ControlledPawn->GetActorLocation();
-	AMazeBlazeKey* NearestKey = nullptr;
-	float NearestDistance = MAX_FLT;
+	// Keys that have been picked up (including our own) are not on the ground
+	if (bUseSightPerception)
+	{
+		return FindNearestPerceived(PerceivedKeys, ControlledPawn->GetActorLocation(),
+			[](const AMazeBlazeKey* Key) { return Key->IsOnGround(); });
+	}
 	
-	for (AActor* Actor : FoundKeys)
+	UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this);
+	if (!Registry)
 	{
-		AMazeBlazeKey* Key = Cast<AMazeBlazeKey>(Actor);
-		if (Key)
-		{
-			// Skip keys that are not on the ground (already picked up)
-			AMazeBlazeCharacter* MazeCharacter = Cast<AMazeBlazeCharacter>(ControlledPawn);
-			if (MazeCharacter && MazeCharacter->GetCarriedKey() == Key)
-			{
-				continue;
-			}
-			
-			const float Distance = FVector::Dist(PawnLocation, Key->GetActorLocation());
-			if (Distance < NearestDistance)
-			{
-				NearestDistance = Distance;
-				NearestKey = Key;
-			}
-		}
+		return nullptr;
 	}
 	
-	return NearestKey;
+	return Registry->FindNearestKey(ControlledPawn->GetActorLocation());
 }
 
 AMazeGameDoor* AMazeBlazeAIController::FindMatchingDoor(AMazeBlazeKey* Key)
@@ -260,53 +463,43 @@ AMazeGameDoor* AMazeBlazeAIController::FindMatchingDoor(AMazeBlazeKey* Key)
 		return nullptr;
 	}
 	
-	TArray<AActor*> FoundDoors;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AMazeGameDoor::StaticClass(), FoundDoors);
-	
-	if (FoundDoors.Num() == 0)
-	{
-		return nullptr;
-	}
-	
 	APawn* ControlledPawn = GetPawn();
 	if (!ControlledPawn)
 	{
 		return nullptr;
 	}
 	
-	const FVector PawnLocation = ControlledPawn->GetActorLocation();
-	AMazeGameDoor* NearestMatchingDoor = nullptr;
-	float NearestDistance = MAX_FLT;
+	if (bUseSightPerception)
+	{
+		return FindNearestPerceived(PerceivedDoors, ControlledPawn->GetActorLocation(),
+			[Key](const AMazeGameDoor* Door) { return !Door->IsOpen() && Door->CanBeOpenedByKey(Key); });
+	}
 	
-	for (AActor* Actor : FoundDoors)
+	UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this);
+	if (!Registry)
 	{
-		AMazeGameDoor* Door = Cast<AMazeGameDoor>(Actor);
-		if (Door && !Door->IsOpen() && Door->CanBeOpenedByKey(Key))
-		{
-			const float Distance = FVector::Dist(PawnLocation, Door->GetActorLocation());
-			if (Distance < NearestDistance)
-			{
-				NearestDistance = Distance;
-				NearestMatchingDoor = Door;
-			}
-		}
+		return nullptr;
 	}
 	
-	return NearestMatchingDoor;
+	return Registry->FindNearestMatchingDoor(ControlledPawn->GetActorLocation(), Key);
 }
 
 AMazeBlazeExit* AMazeBlazeAIController::FindExit()
 {
-	TArray<AActor*> FoundExits;
-	UGameplayStatics::GetAllActorsOfClass(GetWorld(), AMazeBlazeExit::StaticClass(), FoundExits);
-	
-	if (FoundExits.Num() == 0)
+	APawn* ControlledPawn = GetPawn();
+	if (!ControlledPawn)
 	{
 		return nullptr;
 	}
 	
-	// Just return the first exit found
-	return Cast<AMazeBlazeExit>(FoundExits[0]);
+	if (bUseSightPerception)
+	{
+		return FindNearestPerceived(PerceivedExits, ControlledPawn->GetActorLocation(),
+			[](const AMazeBlazeExit*) { return true; });
+	}
+	
+	UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this);
+	return Registry ? Registry->FindNearestExit(ControlledPawn->GetActorLocation()) : nullptr;
 }
 
 void AMazeBlazeAIController::UpdatePerception()
@@ -337,47 +530,51 @@ void AMazeBlazeAIController::UpdatePerception()
 		AMazeBlazeKey* CarriedKey = MazeCharacter->GetCarriedKey();
 		BlackboardComponent->SetValueAsObject(CurrentKeyKey, CarriedKey);
 		
-		// Find nearest key if not carrying one
-		if (!CarriedKey)
+		// Follow the key/door plan, or else head for the nearest targets
+		if (!bUseKeyDoorPlanner || !ApplyKeyDoorPlan(CarriedKey))
 		{
-			AMazeBlazeKey* NearestKey = FindNearestKey();
-			BlackboardComponent->SetValueAsObject(VisibleKeysKey, NearestKey);
-			
-			if (NearestKey)
+			// Find nearest key if not carrying one
+			if (!CarriedKey)
 			{
-				// If we see a key and we're exploring, switch to seeking key
-				if (GetCurrentState() == EAIState::Exploring)
+				AMazeBlazeKey* NearestKey = FindNearestKey();
+				BlackboardComponent->SetValueAsObject(VisibleKeysKey, NearestKey);
+				
+				if (NearestKey)
 				{
-					SetCurrentState(EAIState::SeekingKey);
-					BlackboardComponent->SetValueAsVector(CurrentTargetKey, NearestKey->GetActorLocation());
+					// If we see a key and we're exploring, switch to seeking key
+					if (GetCurrentState() == EAIState::Exploring)
+					{
+						SetCurrentState(EAIState::SeekingKey);
+						BlackboardComponent->SetValueAsVector(CurrentTargetKey, NearestKey->GetActorLocation());
+					}
 				}
 			}
-		}
-		else
-		{
-			// If carrying a key, find a matching door
-			AMazeGameDoor* MatchingDoor = FindMatchingDoor(CarriedKey);
-			BlackboardComponent->SetValueAsObject(VisibleDoorsKey, MatchingDoor);
-			
-			if (MatchingDoor)
+			else
 			{
-				// If we see a matching door, switch to seeking door
-				SetCurrentState(EAIState::SeekingDoor);
-				BlackboardComponent->SetValueAsVector(CurrentTargetKey, MatchingDoor->GetActorLocation());
+				// If carrying a key, find a matching door
+				AMazeGameDoor* MatchingDoor = FindMatchingDoor(CarriedKey);
+				BlackboardComponent->SetValueAsObject(VisibleDoorsKey, MatchingDoor);
+				
+				if (MatchingDoor)
+				{
+					// If we see a matching door, switch to seeking door
+					SetCurrentState(EAIState::SeekingDoor);
+					BlackboardComponent->SetValueAsVector(CurrentTargetKey, MatchingDoor->GetActorLocation());
+				}
 			}
-		}
-		
-		// Check for exit
-		AMazeBlazeExit* Exit = FindExit();
-		if (Exit)
-		{
-			BlackboardComponent->SetValueAsVector(ExitLocationKey, Exit->GetActorLocation());
 			
-			// If we're not carrying a key and there are no visible keys, go to exit
-			if (!CarriedKey && !BlackboardComponent->GetValueAsObject(VisibleKeysKey))
+			// Check for exit
+			AMazeBlazeExit* Exit = FindExit();
+			if (Exit)
 			{
-				SetCurrentState(EAIState::GoingToExit);
-				BlackboardComponent->SetValueAsVector(CurrentTargetKey, Exit->GetActorLocation());
+				BlackboardComponent->SetValueAsVector(ExitLocationKey, Exit->GetActorLocation());
+				
+				// If we're not carrying a key and there are no visible keys, go to exit
+				if (!CarriedKey && !BlackboardComponent->GetValueAsObject(VisibleKeysKey))
+				{
+					SetCurrentState(EAIState::GoingToExit);
+					BlackboardComponent->SetValueAsVector(CurrentTargetKey, Exit->GetActorLocation());
+				}
 			}
 		}
 		
@@ -387,6 +584,10 @@ void AMazeBlazeAIController::UpdatePerception()
 			CurrentErrorState = EAIErrorType::None;
 			LastErrorMessage = TEXT("");
 		}
+		
+		// Perception is up to date until the next event or staleness timeout
+		bPerceptionDirty = false;
+		LastPerceptionUpdateTime = GetWorld()->GetTimeSeconds();
 	}
 	catch (const std::exception& e)
 	{
@@ -401,6 +602,124 @@ void AMazeBlazeAIController::UpdatePerception()
 	}
 }
 
+bool AMazeBlazeAIController::ApplyKeyDoorPlan(AMazeBlazeKey* CarriedKey)
+{
+	UMazeKeyDoorPlannerSubsystem* Planner = UMazeKeyDoorPlannerSubsystem::Get(this);
+	FMazeKeyDoorPlanStep Step;
+	if (!Planner || !Planner->FindNextStep(GetPawn()->GetActorLocation(), CarriedKey, Step))
+	{
+		return false;
+	}
+	
+	// Only the target of the step is published, so the behavior tree cannot take a shortcut the plan ruled out
+	AMazeBlazeKey* Key = Step.Action == MazeCore::EPlanAction::PickUpKey ? Cast<AMazeBlazeKey>(Step.Target) : nullptr;
+	AMazeGameDoor* Door = Step.Action == MazeCore::EPlanAction::OpenDoor ? Cast<AMazeGameDoor>(Step.Target) : nullptr;
+	const bool bReachExit = Step.Action == MazeCore::EPlanAction::ReachExit;
+	BlackboardComponent->SetValueAsObject(VisibleKeysKey, Key);
+	BlackboardComponent->SetValueAsObject(VisibleDoorsKey, Door);
+	BlackboardComponent->SetValueAsVector(ExitLocationKey, bReachExit ? Step.Target->GetActorLocation() : FVector::ZeroVector);
+	BlackboardComponent->SetValueAsVector(CurrentTargetKey, Step.Target->GetActorLocation());
+	SetCurrentState(Key ? EAIState::SeekingKey : Door ? EAIState::SeekingDoor : EAIState::GoingToExit);
+	return true;
+}
+
+void AMazeBlazeAIController::MarkPerceptionDirty()
+{
+	bPerceptionDirty = true;
+}
+
+bool AMazeBlazeAIController::UpdatePerceptionIfNeeded()
+{
+	const float CurrentTime = GetWorld()->GetTimeSeconds();
+	
+	// Publish the skipped recompute count once per second
+	if (CurrentTime - PerceptionStatsWindowStart >= 1.0f)
+	{
+		SkippedPerceptionUpdatesPerSecond = SkippedPerceptionUpdatesInWindow;
+		SkippedPerceptionUpdatesInWindow = 0;
+		PerceptionStatsWindowStart = CurrentTime;
+	}
+	
+	if (!bPerceptionDirty && CurrentTime - LastPerceptionUpdateTime < MaxPerceptionStaleness)
+	{
+		SkippedPerceptionUpdatesInWindow++;
+		return false;
+	}
+	
+	UpdatePerception();
+	return true;
+}
+
+void AMazeBlazeAIController::HandlePawnPickedUpKey(AMazeBlazeKey* Key)
+{
+	MarkPerceptionDirty();
+}
+
+void AMazeBlazeAIController::HandleTargetPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus)
+{
+	// Maze actors don't move on their own, so once seen they are remembered
+	// even after losing sight of them
+	if (!Actor || !Stimulus.WasSuccessfullySensed())
+	{
+		return;
+	}
+	
+	const int32 NumPerceived = PerceivedKeys.Num() + PerceivedDoors.Num() + PerceivedExits.Num();
+	
+	if (AMazeBlazeKey* Key = Cast<AMazeBlazeKey>(Actor))
+	{
+		if (Key->IsOnGround())
+		{
+			PerceivedKeys.AddUnique(Key);
+		}
+	}
+	else if (AMazeGameDoor* Door = Cast<AMazeGameDoor>(Actor))
+	{
+		if (!Door->IsOpen())
+		{
+			PerceivedDoors.AddUnique(Door);
+		}
+	}
+	else if (AMazeBlazeExit* Exit = Cast<AMazeBlazeExit>(Actor))
+	{
+		PerceivedExits.AddUnique(Exit);
+	}
+	
+	// Other pawns and already known actors don't change what the AI is after
+	if (PerceivedKeys.Num() + PerceivedDoors.Num() + PerceivedExits.Num() != NumPerceived)
+	{
+		MarkPerceptionDirty();
+	}
+}
+
+void AMazeBlazeAIController::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	// Forget keys that were picked up and doors that were opened; they have to be seen again
+	if (AMazeBlazeKey* Key = Cast<AMazeBlazeKey>(ChangedActor))
+	{
+		if (!Key->IsOnGround() || Key->IsActorBeingDestroyed())
+		{
+			PerceivedKeys.RemoveSwap(Key);
+		}
+	}
+	else if (AMazeGameDoor* Door = Cast<AMazeGameDoor>(ChangedActor))
+	{
+		if (Door->IsOpen() || Door->IsActorBeingDestroyed())
+		{
+			PerceivedDoors.RemoveSwap(Door);
+		}
+	}
+	else if (AMazeBlazeExit* Exit = Cast<AMazeBlazeExit>(ChangedActor))
+	{
+		if (Exit->IsActorBeingDestroyed())
+		{
+			PerceivedExits.RemoveSwap(Exit);
+		}
+	}
+	
+	MarkPerceptionDirty();
+}
+
 void AMazeBlazeAIController::InteractWithObject(AActor* InteractableObject)
 {
 	if (!InteractableObject)
@@ -434,14 +753,24 @@ void AMazeBlazeAIController::InteractWithObject(AActor* InteractableObject)
 
 void AMazeBlazeAIController::SetupPerceptionSystem()
 {
-	// Create sight config
-	UAISenseConfig_Sight* SightConfig = NewObject<UAISenseConfig_Sight>(this);
+	if (!PerceptionComponent)
+	{
+		ReportAIError(EAIErrorType::PerceptionError, TEXT("No perception component to configure"));
+		return;
+	}
+	
+	// Create sight config once; error recovery re-applies it
+	if (!SightConfig)
+	{
+		SightConfig = NewObject<UAISenseConfig_Sight>(this);
+	}
+	
 	if (SightConfig)
 	{
 		// Configure sight parameters
-		SightConfig->SightRadius = 1500.0f;
-		SightConfig->LoseSightRadius = 2000.0f;
-		SightConfig->PeripheralVisionAngleDegrees = 90.0f;
+		SightConfig->SightRadius = SightRadius;
+		SightConfig->LoseSightRadius = FMath::Max(LoseSightRadius, SightRadius);
+		SightConfig->PeripheralVisionAngleDegrees = PeripheralVisionAngleDegrees;
 		SightConfig->SetMaxAge(5.0f);
 		SightConfig->AutoSuccessRangeFromLastSeenLocation = 900.0f;
 		SightConfig->DetectionByAffiliation.bDetectEnemies = true;
@@ -464,12 +793,16 @@ void AMazeBlazeAIController::ReportAIError(EAIErrorType ErrorType, const FString
 	CurrentErrorState = ErrorType;
 	LastErrorMessage = ErrorMessage;
 	
-	// Log the error
-	UE_LOG(LogTemp, Error, TEXT("AI Error: %s - %s"), 
-		   *UEnum::GetValueAsString(CurrentErrorState), *ErrorMessage);
+	// Log the error, unless the telemetry collects it and logs a summary
+	UMazeErrorTelemetrySubsystem* Telemetry = UMazeErrorTelemetrySubsystem::Get(this);
+	if (!Telemetry || !Telemetry->RecordEvent(this, ErrorType, EMazeErrorTelemetryEvent::Reported))
+	{
+		UE_LOG(LogTemp, Error, TEXT("AI Error: %s - %s"), 
+			   FMazeAIStatusText::GetErrorTypeName(CurrentErrorState), *ErrorMessage);
+	}
 	
 	// Visual debugging
-	if (GetPawn())
+	if (GetPawn() && UMazeDebugDrawSubsystem::IsEnabled())
 	{
 		// Draw debug sphere at AI location to indicate error
 		DrawDebugSphere(GetWorld(), GetPawn()->GetActorLocation(), 100.0f, 12, 
@@ -477,7 +810,7 @@ void AMazeBlazeAIController::ReportAIError(EAIErrorType ErrorType, const FString
 		
 		// Draw debug string above the AI
 		DrawDebugString(GetWorld(), GetPawn()->GetActorLocation() + FVector(0, 0, 100), 
-					*UEnum::GetValueAsString(CurrentErrorState),
+					FMazeAIStatusText::GetErrorTypeName(CurrentErrorState),
 					nullptr, FColor::Red, 5.0f, true);
 	}
 }
@@ -487,18 +820,17 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 	bool bRecovered = false;
 	
 	// Log recovery attempt
-	UE_LOG(LogTemp, Warning, TEXT("Attempting to recover from error: %s - %s"), 
-		   *UEnum::GetValueAsString(CurrentErrorState), *LastErrorMessage);
+	UE_LOG(LogTemp, Verbose, TEXT("Attempting to recover from error: %s - %s"), 
+		   FMazeAIStatusText::GetErrorTypeName(CurrentErrorState), *LastErrorMessage);
 	
 	// Reset stuck detection timers regardless of error type
-	StuckTime = 0.0f;
-	TimeInCurrentState = 0.0f;
+	ResetMonitorTimers();
 	
 	switch (CurrentErrorState)
 	{
 		case EAIErrorType::AssetMissing:
 			// Can't recover from missing assets at runtime
-			UE_LOG(LogTemp, Warning, TEXT("Cannot recover from missing assets at runtime"));
+			UE_LOG(LogTemp, Verbose, TEXT("Cannot recover from missing assets at runtime"));
 			break;
 			
 		case EAIErrorType::BlackboardInitFailed:
@@ -524,58 +856,22 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 			break;
 			
 		case EAIErrorType::NavigationMissing:
-			// First try to use last valid location if available
+			// First try to use last valid location if available; a random point is tried if no path leads back there
 			if (!LastValidLocation.IsZero() && GetPawn())
 			{
 				// Stop current movement
 				StopMovement();
 				
-				// Set target to last valid location
-				if (BlackboardComponent)
-				{
-					BlackboardComponent->SetValueAsVector(CurrentTargetKey, LastValidLocation);
-				}
-				
-				// Move with a larger acceptance radius for recovery
-				EPathFollowingRequestResult::Type MoveResult = MoveToLocation(LastValidLocation, 200.0f);
-				bRecovered = (MoveResult != EPathFollowingRequestResult::Failed);
+				bRecovered = MoveToRecoveryPoint(LastValidLocation, true);
 				
-				UE_LOG(LogTemp, Warning, TEXT("Recovery: Moving to last valid location: %s"), 
+				UE_LOG(LogTemp, Verbose, TEXT("Recovery: Moving to last valid location: %s"), 
 					   bRecovered ? TEXT("Success") : TEXT("Failed"));
 			}
 			
-			// If that fails or no valid location, try random point
+			// If that fails or no valid location, try random points with increasing radius
 			if (!bRecovered && GetPawn())
 			{
-				FNavLocation NavLocation;
-				UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
-				
-				// Try with increasing radius until we find a valid point
-				for (float Radius = 500.0f; Radius <= 3000.0f; Radius *= 2.0f)
-				{
-					if (NavSys && NavSys->GetRandomReachablePointInRadius(
-						GetPawn()->GetActorLocation(), Radius, NavLocation))
-					{
-						// Set a new exploration target
-						if (BlackboardComponent)
-						{
-							BlackboardComponent->SetValueAsVector(CurrentTargetKey, NavLocation.Location);
-							SetCurrentState(EAIState::Exploring);
-						}
-						
-						// Try to move to the new location
-						EPathFollowingRequestResult::Type MoveResult = MoveToLocation(NavLocation.Location, 200.0f);
-						bRecovered = (MoveResult != EPathFollowingRequestResult::Failed);
-						
-						UE_LOG(LogTemp, Warning, TEXT("Recovery: Moving to random point (radius %.0f): %s"), 
-							   Radius, bRecovered ? TEXT("Success") : TEXT("Failed"));
-						
-						if (bRecovered)
-						{
-							break; // Exit the loop if we found a valid point
-						}
-					}
-				}
+				bRecovered = MoveToRandomReachablePoint(NavigationRecoveryRadii);
 			}
 			break;
 			
@@ -584,6 +880,9 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 			if (PerceptionComponent)
 			{
 				PerceptionComponent->ForgetAll();
+				PerceivedKeys.Reset();
+				PerceivedDoors.Reset();
+				PerceivedExits.Reset();
 				SetupPerceptionSystem();
 				
 				// Force update perception
@@ -605,15 +904,23 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 			break;
 	}
 	
+	// Recovery outcomes go to the telemetry like the errors themselves
+	UMazeErrorTelemetrySubsystem* Telemetry = UMazeErrorTelemetrySubsystem::Get(this);
+	const bool bRecorded = Telemetry && CurrentErrorState != EAIErrorType::None && Telemetry->RecordEvent(this, CurrentErrorState,
+		bRecovered ? EMazeErrorTelemetryEvent::Recovered : EMazeErrorTelemetryEvent::RecoveryFailed);
+	
 	if (bRecovered)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("AI recovered from error: %s"), 
-			   *UEnum::GetValueAsString(CurrentErrorState));
+		if (!bRecorded)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("AI recovered from error: %s"), 
+				   FMazeAIStatusText::GetErrorTypeName(CurrentErrorState));
+		}
 		CurrentErrorState = EAIErrorType::None;
 		LastErrorMessage = TEXT("");
 		
 		// Visual feedback for recovery
-		if (GetPawn())
+		if (GetPawn() && UMazeDebugDrawSubsystem::IsEnabled())
 		{
 			DrawDebugSphere(GetWorld(), GetPawn()->GetActorLocation(), 100.0f, 12, 
 						FColor::Green, false, 2.0f, 0, 2.0f);
@@ -624,11 +931,14 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 	}
 	else
 	{
-		UE_LOG(LogTemp, Error, TEXT("AI failed to recover from error: %s"), 
-			   *UEnum::GetValueAsString(CurrentErrorState));
+		if (!bRecorded)
+		{
+			UE_LOG(LogTemp, Error, TEXT("AI failed to recover from error: %s"), 
+				   FMazeAIStatusText::GetErrorTypeName(CurrentErrorState));
+		}
 		
 		// Visual feedback for failed recovery
-		if (GetPawn())
+		if (GetPawn() && UMazeDebugDrawSubsystem::IsEnabled())
 		{
 			DrawDebugSphere(GetWorld(), GetPawn()->GetActorLocation(), 120.0f, 12, 
 						FColor::Red, false, 2.0f, 0, 3.0f);
@@ -643,12 +953,17 @@ bool AMazeBlazeAIController::TryRecoverFromError()
 
 FString AMazeBlazeAIController::GetDebugStatusText() const
 {
-	FString StatusText;
-	
+	FMazeAIStatusTextBuilder StatusText;
+	AppendDebugStatusText(StatusText);
+	return FString(StatusText.ToView());
+}
+
+void AMazeBlazeAIController::AppendDebugStatusText(FStringBuilderBase& StatusText) const
+{
 	// Add current state
-	StatusText += FString::Printf(TEXT("State: %s (%.1fs)\n"), 
-					*UEnum::GetValueAsString(GetCurrentState()),
-					TimeInCurrentState);
+	StatusText.Appendf(TEXT("State: %s (%.1fs)\n"), 
+					FMazeAIStatusText::GetStateName(GetCurrentState()),
+					GetTimeInCurrentState());
 	
 	// Add current target if available
 	if (BlackboardComponent)
@@ -656,35 +971,88 @@ FString AMazeBlazeAIController::GetDebugStatusText() const
 		FVector CurrentTarget = BlackboardComponent->GetValueAsVector(CurrentTargetKey);
 		if (!CurrentTarget.IsZero())
 		{
-			StatusText += FString::Printf(TEXT("Target: (%.0f, %.0f, %.0f)\n"), 
+			StatusText.Appendf(TEXT("Target: (%.0f, %.0f, %.0f)\n"), 
 						CurrentTarget.X, CurrentTarget.Y, CurrentTarget.Z);
 		}
 		
 		// Add key status
 		UObject* CurrentKey = BlackboardComponent->GetValueAsObject(CurrentKeyKey);
-		StatusText += FString::Printf(TEXT("Has Key: %s\n"), 
-					CurrentKey ? TEXT("Yes") : TEXT("No"));
+		StatusText << TEXT("Has Key: ") << (CurrentKey ? TEXT("Yes") : TEXT("No")) << TEXT("\n");
+	}
+	
+	// Add perception update statistics
+	StatusText.Appendf(TEXT("Perception skipped: %d/s\n"), SkippedPerceptionUpdatesPerSecond);
+	
+	// Add time since the scheduler last serviced us
+	if (bUpdatesScheduled)
+	{
+		if (const UMazeAISchedulerSubsystem* Scheduler = UMazeAISchedulerSubsystem::Get(this))
+		{
+			StatusText.Appendf(TEXT("Scheduled: %.2fs since update\n"), Scheduler->GetAgentStaleness(this));
+		}
+	}
+	
+	// Add what the sight sense has reported so far
+	if (bUseSightPerception)
+	{
+		StatusText.Appendf(TEXT("Perceived: %d keys, %d doors, %d exits\n"), 
+					PerceivedKeys.Num(), PerceivedDoors.Num(), PerceivedExits.Num());
 	}
 	
 	// Add stuck information
-	if (StuckTime > 0.0f)
+	const float StuckTime = GetStuckTime();
+	const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this);
+	if (StuckTime > 0.0f && AgentMonitor)
 	{
-		StatusText += FString::Printf(TEXT("Stuck: %.1fs / %.1fs\n"), 
-					StuckTime, MaxStuckTime);
+		StatusText.Appendf(TEXT("Stuck: %.1fs / %.1fs\n"), 
+					StuckTime, AgentMonitor->GetSettings().MaxStuckTime);
 	}
 	
 	// Add error information if any
 	if (IsInErrorState())
 	{
-		StatusText += FString::Printf(TEXT("ERROR: %s\n%s"), 
-					*UEnum::GetValueAsString(CurrentErrorState),
-					*LastErrorMessage);
+		StatusText << TEXT("ERROR: ") << FMazeAIStatusText::GetErrorTypeName(CurrentErrorState)
+					<< TEXT("\n") << LastErrorMessage;
 	}
-	
-	return StatusText;
 }
 
 bool AMazeBlazeAIController::IsAIStuck()
+{
+	return GetPawn() && GetStuckTime() > 0.0f;
+}
+
+void AMazeBlazeAIController::ResetAIState()
+{
+	// Stop current movement
+	StopMovement();
+	
+	// Reset timers
+	ResetMonitorTimers();
+	
+	// Reset state to exploring
+	SetCurrentState(EAIState::Exploring);
+	
+	// Try to find a new navigation point
+	if (GetPawn() && !LastValidLocation.IsZero())
+	{
+		// First try to move back to last valid location
+		MoveToRecoveryPoint(LastValidLocation);
+	}
+	else
+	{
+		// If no valid location stored, try to find a random point
+		static const float ResetRadii[] = { 1000.0f };
+		MoveToRandomReachablePoint(ResetRadii);
+	}
+	
+	// If we have a behavior tree component, restart it
+	if (BehaviorTreeComponent && BehaviorTreeAsset)
+	{
+		BehaviorTreeComponent->RestartTree();
+	}
+}
+
+bool AMazeBlazeAIController::MoveToRandomReachablePoint(TArrayView<const float> Radii)
 {
 	APawn* ControlledPawn = GetPawn();
 	if (!ControlledPawn)
@@ -692,137 +1060,223 @@ bool AMazeBlazeAIController::IsAIStuck()
 		return false;
 	}
 	
-	FVector CurrentLocation = ControlledPawn->GetActorLocation();
-	
-	// If this is the first check, initialize previous location
-	if (PreviousLocation.IsZero())
+	UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(this);
+	if (AsyncNavigation)
 	{
-		PreviousLocation = CurrentLocation;
-		return false;
+		AsyncNavigation->CancelQuery(RecoveryQueryId);
+		RecoveryQueryId = 0;
 	}
 	
-	// Check if the AI has moved significantly
-	bool bIsStuck = FVector::DistSquared(CurrentLocation, PreviousLocation) < (StuckThreshold * StuckThreshold);
+	// A pre-sampled point costs no navmesh query at all
+	if (UMazeReachablePointSubsystem* PointPool = UMazeReachablePointSubsystem::Get(this))
+	{
+		for (const float Radius : Radii)
+		{
+			FVector Point;
+			if (PointPool->TakePoint(ControlledPawn->GetActorLocation(), Radius, 0.0f, Point))
+			{
+				return MoveToRecoveryPoint(Point);
+			}
+		}
+	}
 	
-	// Only consider stuck if we're trying to move
-	if (bIsStuck && GetPathFollowingComponent()->GetStatus() == EPathFollowingStatus::Moving)
+	// Many agents recovering in the same frame would stall the game thread, so the point is found on the workers
+	if (AsyncNavigation)
 	{
-		// We're stuck
-		return true;
+		RecoveryQueryId = AsyncNavigation->RequestReachablePoint(GetNavAgentPropertiesRef(), ControlledPawn->GetActorLocation(), Radii,
+			FMazeAsyncPointDelegate::CreateUObject(this, &AMazeBlazeAIController::HandleRecoveryPointFound));
+		if (RecoveryQueryId != 0)
+		{
+			return true;
+		}
 	}
 	
-	// Update previous location for next check
-	PreviousLocation = CurrentLocation;
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld());
+	for (const float Radius : Radii)
+	{
+		FNavLocation NavLocation;
+		if (NavSys && NavSys->GetRandomReachablePointInRadius(ControlledPawn->GetActorLocation(), Radius, NavLocation))
+		{
+			return StartRecoveryMove(NavLocation.Location, nullptr);
+		}
+	}
 	return false;
 }
 
-void AMazeBlazeAIController::ResetAIState()
+void AMazeBlazeAIController::HandleRecoveryPointFound(uint32 QueryId, bool bFound, const FVector& Point)
 {
-	// Stop current movement
-	StopMovement();
+	if (QueryId != RecoveryQueryId)
+	{
+		return;
+	}
+	RecoveryQueryId = 0;
 	
-	// Reset timers
-	StuckTime = 0.0f;
-	TimeInCurrentState = 0.0f;
+	if (!bFound || !MoveToRecoveryPoint(Point))
+	{
+		ReportAIError(EAIErrorType::NavigationMissing, TEXT("Could not find a reachable point to recover to"));
+	}
+}
+
+bool AMazeBlazeAIController::MoveToRecoveryPoint(const FVector& Point, bool bFallBackToRandomPoint)
+{
+	APawn* ControlledPawn = GetPawn();
+	if (!ControlledPawn)
+	{
+		return false;
+	}
 	
-	// Reset state to exploring
-	SetCurrentState(EAIState::Exploring);
+	UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(this);
+	if (AsyncNavigation)
+	{
+		AsyncNavigation->CancelQuery(RecoveryQueryId);
+		RecoveryQueryId = 0;
+	}
 	
-	// Try to find a new navigation point
-	if (GetPawn() && !LastValidLocation.IsZero())
+	// Agents recovering towards the same place share their paths
+	UMazePathCacheSubsystem* PathCache = UMazePathCacheSubsystem::Get(this);
+	if (PathCache)
 	{
-		// First try to move back to last valid location
-		if (BlackboardComponent)
+		TArray<FVector> PathPoints;
+		if (PathCache->FindPath(ControlledPawn->GetActorLocation(), Point, PathPoints) != EMazePathCacheHit::None
+			&& StartRecoveryMove(Point, MakeShared<FNavigationPath, ESPMode::ThreadSafe>(PathPoints)))
 		{
-			BlackboardComponent->SetValueAsVector(CurrentTargetKey, LastValidLocation);
-			MoveToLocation(LastValidLocation, 200.0f); // Larger acceptance radius for recovery
+			return true;
 		}
 	}
-	else
+	
+	// The path to the point is found on the workers too
+	if (AsyncNavigation)
 	{
-		// If no valid location stored, try to find a random point
-		FNavLocation NavLocation;
-		UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent(GetWorld());
-		if (NavSys && GetPawn())
+		RecoveryQueryId = AsyncNavigation->RequestPath(GetNavAgentPropertiesRef(), ControlledPawn->GetActorLocation(), Point, true,
+			FMazeAsyncPathDelegate::CreateUObject(this, &AMazeBlazeAIController::HandleRecoveryPathFound, Point,
+				PathCache ? PathCache->GetVersion() : 0u, bFallBackToRandomPoint));
+		if (RecoveryQueryId != 0)
 		{
-			if (NavSys->GetRandomReachablePointInRadius(
-				GetPawn()->GetActorLocation(), 1000.0f, NavLocation))
-			{
-				if (BlackboardComponent)
-				{
-					BlackboardComponent->SetValueAsVector(CurrentTargetKey, NavLocation.Location);
-				}
-				MoveToLocation(NavLocation.Location, 200.0f);
-			}
+			return true;
 		}
 	}
+	return StartRecoveryMove(Point, nullptr);
+}
+
+void AMazeBlazeAIController::HandleRecoveryPathFound(uint32 QueryId, FNavPathSharedPtr Path, FVector Point, uint32 PathCacheVersion, bool bFallBackToRandomPoint)
+{
+	// Worth keeping for the other agents even if this one moved on
+	UMazePathCacheSubsystem* PathCache = UMazePathCacheSubsystem::Get(this);
+	if (PathCache && Path.IsValid())
+	{
+		PathCache->AddPath(PathCacheVersion, *Path);
+	}
 	
-	// If we have a behavior tree component, restart it
-	if (BehaviorTreeComponent && BehaviorTreeAsset)
+	if (QueryId != RecoveryQueryId)
 	{
-		BehaviorTreeComponent->RestartTree();
+		return;
+	}
+	RecoveryQueryId = 0;
+	
+	if (Path.IsValid() && StartRecoveryMove(Point, Path))
+	{
+		return;
+	}
+	if (!bFallBackToRandomPoint || !MoveToRandomReachablePoint(NavigationRecoveryRadii))
+	{
+		ReportAIError(EAIErrorType::NavigationMissing, TEXT("Could not move to the recovery point"));
+	}
+}
+
+bool AMazeBlazeAIController::StartRecoveryMove(const FVector& Point, FNavPathSharedPtr Path)
+{
+	if (BlackboardComponent)
+	{
+		BlackboardComponent->SetValueAsVector(CurrentTargetKey, Point);
 	}
+	SetCurrentState(EAIState::Exploring);
+	
+	// Larger acceptance radius for recovery; without a path one is found here
+	bool bMoving = false;
+	if (Path.IsValid())
+	{
+		FAIMoveRequest MoveRequest(Point);
+		MoveRequest.SetAcceptanceRadius(200.0f);
+		bMoving = RequestMove(MoveRequest, Path).IsValid();
+	}
+	else
+	{
+		bMoving = MoveToLocation(Point, 200.0f) != EPathFollowingRequestResult::Failed;
+	}
+	
+	UE_LOG(LogTemp, Verbose, TEXT("Recovery: Moving to recovery point: %s"), bMoving ? TEXT("Success") : TEXT("Failed"));
+	return bMoving;
 }
 
 void AMazeBlazeAIController::DrawDebugInfo(float Duration)
 {
+#if ENABLE_DRAW_DEBUG
 	APawn* ControlledPawn = GetPawn();
 	if (!ControlledPawn || !GetWorld())
 	{
 		return;
 	}
 	
-	FVector PawnLocation = ControlledPawn->GetActorLocation();
-	FVector PawnForward = ControlledPawn->GetActorForwardVector();
-	
 	// Draw current state
-	FString StateText = UEnum::GetValueAsString(GetCurrentState());
-	DrawDebugString(GetWorld(), PawnLocation + FVector(0, 0, 100), *StateText,
-		nullptr, FColor::White, Duration);
+	DrawDebugString(GetWorld(), ControlledPawn->GetActorLocation() + FVector(0, 0, 100),
+		FMazeAIStatusText::GetStateString(GetCurrentState()), nullptr, FColor::White, Duration);
+	
+	TArray<FBatchedLine> Lines;
+	AppendDebugLines(Lines, Duration, UMazeDebugDrawSubsystem::EDetail::Full);
+	UMazeDebugDrawSubsystem::SubmitLines(GetWorld(), Lines, Duration);
+#endif
+}
+
+void AMazeBlazeAIController::AppendDebugLines(TArray<FBatchedLine>& Lines, float Duration, UMazeDebugDrawSubsystem::EDetail Detail) const
+{
+#if ENABLE_DRAW_DEBUG
+	const APawn* ControlledPawn = GetPawn();
+	if (!ControlledPawn)
+	{
+		return;
+	}
+	
+	const FVector PawnLocation = ControlledPawn->GetActorLocation();
+	const bool bFullDetail = Detail == UMazeDebugDrawSubsystem::EDetail::Full;
 	
 	// Draw path to target if available
 	if (BlackboardComponent)
 	{
-		FVector TargetLocation = BlackboardComponent->GetValueAsVector(CurrentTargetKey);
+		const FVector TargetLocation = BlackboardComponent->GetValueAsVector(CurrentTargetKey);
 		if (!TargetLocation.IsZero())
 		{
-			// Draw line to target
-			DrawDebugLine(GetWorld(), PawnLocation, TargetLocation, 
-				FColor::Green, false, Duration, 0, 2.0f);
-			
-			// Draw sphere at target
-			DrawDebugSphere(GetWorld(), TargetLocation, 50.0f, 12, 
-				FColor::Green, false, Duration);
+			UMazeDebugDrawSubsystem::AddLine(Lines, PawnLocation, TargetLocation, FColor::Green, Duration, 2.0f);
+			if (bFullDetail)
+			{
+				UMazeDebugDrawSubsystem::AddSphere(Lines, TargetLocation, 50.0f, 12, FColor::Green, Duration);
+			}
 		}
 	}
 	
 	// Draw last valid location if available
-	if (!LastValidLocation.IsZero())
+	if (bFullDetail && !LastValidLocation.IsZero())
 	{
-		DrawDebugSphere(GetWorld(), LastValidLocation, 30.0f, 8, 
-			FColor::Blue, false, Duration);
+		UMazeDebugDrawSubsystem::AddSphere(Lines, LastValidLocation, 30.0f, 8, FColor::Blue, Duration);
 	}
 	
 	// Draw stuck indicator if stuck
+	const float StuckTime = GetStuckTime();
 	if (StuckTime > 0.0f)
 	{
 		// Size increases with stuck time
-		float Size = FMath::Lerp(50.0f, 100.0f, FMath::Min(StuckTime / MaxStuckTime, 1.0f));
-		DrawDebugSphere(GetWorld(), PawnLocation, Size, 12, 
-			FColor::Yellow, false, Duration);
+		const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this);
+		const float MaxStuckTime = AgentMonitor ? AgentMonitor->GetSettings().MaxStuckTime : 1.0f;
+		const float Size = FMath::Lerp(50.0f, 100.0f, FMath::Min(StuckTime / MaxStuckTime, 1.0f));
+		UMazeDebugDrawSubsystem::AddSphere(Lines, PawnLocation, Size, bFullDetail ? 12 : 6, FColor::Yellow, Duration);
 	}
 	
-	// Draw perception cone
-	if (PerceptionComponent)
+	// Draw sight cone; PeripheralVisionAngleDegrees is measured from the forward vector
+	if (bFullDetail && PerceptionComponent)
 	{
-		const float SightRadius = 1500.0f; // Match the sight radius from SetupPerceptionSystem
-		const float HalfAngle = 45.0f; // Half of PeripheralVisionAngleDegrees
-		
-		// Draw sight cone
-		DrawDebugCone(GetWorld(), PawnLocation, PawnForward, SightRadius,
-			FMath::DegreesToRadians(HalfAngle), FMath::DegreesToRadians(HalfAngle),
-			12, FColor::Cyan, false, Duration);
+		UMazeDebugDrawSubsystem::AddCone(Lines, PawnLocation, ControlledPawn->GetActorForwardVector(), SightRadius,
+			FMath::DegreesToRadians(PeripheralVisionAngleDegrees), 12, FColor::Cyan, Duration);
 	}
+#endif
 }
 
 void AMazeBlazeAIController::StoreValidLocation()
@@ -834,7 +1288,7 @@ void AMazeBlazeAIController::StoreValidLocation()
 	}
 	
 	// Only store location if we're not in an error state and not stuck
-	if (!IsInErrorState() && StuckTime <= 0.0f)
+	if (!IsInErrorState() && GetStuckTime() <= 0.0f)
 	{
 		LastValidLocation = ControlledPawn->GetActorLocation();
 	}
@@ -3,11 +3,15 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "Perception/AIPerceptionComponent.h"
+#include "Perception/AISenseConfig_Sight.h"
 #include "BehaviorTree/BehaviorTreeComponent.h"
 #include "BehaviorTree/BlackboardComponent.h"
 #include "MazeBlazeKey.h"
 #include "MazeGameDoor.h"
 #include "MazeBlazeExit.h"
+#include "MazeExplorationStrategy.h"
+#include "MazeAgentMonitor.h"
+#include "MazeDebugDrawSubsystem.h"
 #include "MazeBlazeAIController.generated.h"
 
 // Enum to define AI states
@@ -45,6 +49,7 @@ enum class EAIErrorType : uint8
  */
 // Forward declaration
 class UBTService_ErrorDetection;
+class UMazeFrontierExplorationComponent;
 
 UCLASS()
 class MAZEBLAZE_API AMazeBlazeAIController : public AAIController
@@ -54,6 +59,9 @@ class MAZEBLAZE_API AMazeBlazeAIController : public AAIController
 	// Allow BTService_ErrorDetection to access protected members
 	friend class UBTService_ErrorDetection;
 
+	// The agent monitor records the last valid location while we make progress
+	friend class UMazeAgentMonitorSubsystem;
+
 public:
 	// Constructor
 	AMazeBlazeAIController();
@@ -61,6 +69,9 @@ public:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	// Called when the controller is removed from the world
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	// Called when this controller possesses a pawn
 	virtual void OnPossess(APawn* InPawn) override;
 
@@ -86,6 +97,9 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void SetCurrentState(EAIState NewState);
 
+	// Whether the pawn is following a path or was steered by movement input in its last update
+	bool IsTryingToMove() const;
+
 	// Find the nearest key in the maze
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	AMazeBlazeKey* FindNearestKey();
@@ -102,6 +116,53 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void UpdatePerception();
 
+	// Mark perception data as stale so the next UpdatePerceptionIfNeeded recomputes it
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	void MarkPerceptionDirty();
+
+	// Update perception only if it was marked dirty or is older than MaxPerceptionStaleness
+	// Returns true if perception was recomputed
+	UFUNCTION(BlueprintCallable, Category = "AI")
+	bool UpdatePerceptionIfNeeded();
+
+	// Maximum time perception data may go without a recompute when no events arrive
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Perception", meta = (ClampMin = "0.0"))
+	float MaxPerceptionStaleness = 1.0f;
+
+	// Only react to keys, doors and exits reported by the sight sense
+	// When disabled the AI knows every maze actor through the actor registry
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Perception")
+	bool bUseSightPerception = true;
+
+	// Choose keys, doors and the exit from the shortest key/door plan of the whole maze instead of the nearest ones
+	// The planner knows every maze actor through the registry; the nearest targets are used when it finds no plan
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Planning")
+	bool bUseKeyDoorPlanner = false;
+
+	// Sight sense parameters
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Perception", meta = (ClampMin = "0.0"))
+	float SightRadius = 1500.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Perception", meta = (ClampMin = "0.0"))
+	float LoseSightRadius = 2000.0f;
+
+	UPROPERTY(EditDefaultsOnly, Category = "AI|Perception", meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float PeripheralVisionAngleDegrees = 90.0f;
+
+	// Number of perception recomputes skipped during the last second
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "AI|Debug")
+	int32 SkippedPerceptionUpdatesPerSecond;
+
+	// Periodic work run by the AI scheduler: perception update
+	// ElapsedSeconds is the time since the previous scheduled update
+	void RunScheduledUpdate(float ElapsedSeconds);
+
+	// Stuck and timeout events raised by the agent monitor
+	void HandleMonitorEvent(EMazeAgentMonitorEvent Event);
+
+	// Whether the periodic work is time-sliced by the AI scheduler instead of run every tick
+	bool IsUpdateScheduled() const { return bUpdatesScheduled; }
+
 	// Interact with an object implementing the interactable interface
 	UFUNCTION(BlueprintCallable, Category = "AI")
 	void InteractWithObject(AActor* InteractableObject);
@@ -109,6 +170,20 @@ public:
 	// Get the blackboard component
 	UBlackboardComponent* GetBlackboardComp() const { return BlackboardComponent; }
 
+	// Switch this agent to another exploration system; the running behavior tree uses it from its next task
+	UFUNCTION(BlueprintCallable, Category = "AI|Exploration")
+	void SetExplorationSystem(EAIExplorationSystem NewSystem);
+
+	// Exploration system of this agent's current strategy
+	UFUNCTION(BlueprintPure, Category = "AI|Exploration")
+	EAIExplorationSystem GetExplorationSystem() const;
+
+	// Strategy the explore and move tasks dispatch to; null until a pawn is possessed
+	IMazeExplorationStrategy* GetExplorationStrategy() const { return ExplorationStrategy.Get(); }
+
+	// Hand the pawn over to another strategy; the old one is deactivated and the new one activated if a pawn is possessed
+	void SetExplorationStrategy(TUniquePtr<IMazeExplorationStrategy> NewStrategy);
+
 	//
 	// Error Handling System
 	//
@@ -137,7 +212,10 @@ public:
 	UFUNCTION(BlueprintPure, Category = "AI|Debug")
 	FString GetDebugStatusText() const;
 	
-	// Check if the AI is stuck by comparing current and previous locations
+	// Append the debug status text to a builder, without allocating when the builder has room
+	void AppendDebugStatusText(FStringBuilderBase& StatusText) const;
+	
+	// Check if the AI is trying to move without making progress, as seen by the agent monitor
 	UFUNCTION(BlueprintCallable, Category = "AI|Debug")
 	bool IsAIStuck();
 	
@@ -145,10 +223,13 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "AI|Debug")
 	void ResetAIState();
 	
-	// Draw debug information to visualize AI state and path
+	// Draw debug information to visualize AI state and path once; MazeBlaze.AI.DebugDraw draws it every frame
 	UFUNCTION(BlueprintCallable, Category = "AI|Debug")
 	void DrawDebugInfo(float Duration = 0.0f);
 	
+	// Add the debug view of this controller as lines, for the debug draw subsystem to submit in one batch
+	void AppendDebugLines(TArray<FBatchedLine>& Lines, float Duration, UMazeDebugDrawSubsystem::EDetail Detail) const;
+	
 	// Store current location as a valid location for recovery
 	UFUNCTION(BlueprintCallable, Category = "AI|Debug")
 	void StoreValidLocation();
@@ -162,11 +243,60 @@ protected:
 	UPROPERTY(VisibleAnywhere, Category = "AI")
 	UBlackboardComponent* BlackboardComponent;
 
+	// Occupancy map used by frontier-based exploration
+	UPROPERTY(VisibleAnywhere, Category = "AI")
+	UMazeFrontierExplorationComponent* FrontierExploration;
+
 	// We're using the perception component from the parent class (AAIController)
 
+	// Sight sense configuration applied to the perception component
+	UPROPERTY()
+	UAISenseConfig_Sight* SightConfig;
+
+	// Maze actors reported by the sight sense; keys are forgotten once picked up
+	// and doors once opened, the registry state is still checked when choosing targets
+	UPROPERTY()
+	TArray<AMazeBlazeKey*> PerceivedKeys;
+
+	UPROPERTY()
+	TArray<AMazeGameDoor*> PerceivedDoors;
+
+	UPROPERTY()
+	TArray<AMazeBlazeExit*> PerceivedExits;
+
 	// Setup perception system
 	void SetupPerceptionSystem();
 
+	// Timers kept by the agent monitor, zero when it does not monitor us
+	float GetStuckTime() const;
+	float GetTimeInCurrentState() const;
+
+	// Restart the agent monitor timers after a reset or recovery
+	void ResetMonitorTimers();
+
+	// Perception events that invalidate the blackboard perception data
+	UFUNCTION()
+	void HandlePawnPickedUpKey(AMazeBlazeKey* Key);
+
+	UFUNCTION()
+	void HandleTargetPerceptionUpdated(AActor* Actor, FAIStimulus Stimulus);
+
+	void HandleMazeActorChanged(AActor* ChangedActor);
+
+	// Write the first step of the key/door plan to the blackboard; returns false if there is no plan
+	bool ApplyKeyDoorPlan(AMazeBlazeKey* CarriedKey);
+
+	// Move to a random point reachable within the first radius that has one, taken from the point pool or
+	// found on the async navigation workers when there are any. Returns false if no point was found or the query could not start
+	bool MoveToRandomReachablePoint(TArrayView<const float> Radii);
+	void HandleRecoveryPointFound(uint32 QueryId, bool bFound, const FVector& Point);
+
+	// Move to a point over a cached path, or one found on the async navigation workers when there are any.
+	// With bFallBackToRandomPoint a random reachable point is tried if no path leads there
+	bool MoveToRecoveryPoint(const FVector& Point, bool bFallBackToRandomPoint = false);
+	void HandleRecoveryPathFound(uint32 QueryId, FNavPathSharedPtr Path, FVector Point, uint32 PathCacheVersion, bool bFallBackToRandomPoint);
+	bool StartRecoveryMove(const FVector& Point, FNavPathSharedPtr Path);
+
 	// Blackboard key names
 	static const FName CurrentTargetKey;
 	static const FName CurrentStateKey;
@@ -183,27 +313,30 @@ private:
 	// Maximum time between recovery attempts
 	const float RecoveryAttemptInterval = 5.0f;
 	
-	// Previous location for stuck detection
-	FVector PreviousLocation;
+	// Last valid location for recovery
+	FVector LastValidLocation;
 	
-	// Time at same location for stuck detection
-	float StuckTime;
+	// Whether perception data needs to be recomputed
+	bool bPerceptionDirty;
 	
-	// Threshold for considering AI stuck (in units)
-	const float StuckThreshold = 50.0f;
+	// World time of the last perception recompute
+	float LastPerceptionUpdateTime;
 	
-	// Maximum time allowed to be stuck before recovery
-	const float MaxStuckTime = 3.0f;
+	// Start of the current one-second window for the skipped update counter
+	float PerceptionStatsWindowStart;
 	
-	// Last valid location for recovery
-	FVector LastValidLocation;
+	// Recomputes skipped in the current window
+	int32 SkippedPerceptionUpdatesInWindow;
+	
+	// Subscription to the maze actor registry
+	FDelegateHandle MazeActorChangedHandle;
 	
-	// Time in current state
-	float TimeInCurrentState;
+	// Whether the AI scheduler runs perception updates
+	bool bUpdatesScheduled;
 	
-	// Last state for tracking state changes
-	EAIState LastState;
+	// Async query of the point MoveToRandomReachablePoint moves to, then of the path to it; 0 when none
+	uint32 RecoveryQueryId;
 	
-	// Maximum time allowed in one state
-	const float MaxTimeInState = 15.0f;
+	// Exploration strategy, created from the game's exploration system on the first possession
+	TUniquePtr<IMazeExplorationStrategy> ExplorationStrategy;
 };
\ No newline at end of file
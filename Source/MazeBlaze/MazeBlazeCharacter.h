@@ -7,7 +7,11 @@
 #include "MazeBlazeCharacter.generated.h"
 
 class AMazeBlazeKey;
+class AMazeGameDoor;
+class AMazeBlazeExit;
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnPickupKey, AMazeBlazeKey*, Key);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnOpenDoor, AMazeGameDoor*, Door);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnReachExit, AMazeBlazeExit*, Exit);
 
 
 UCLASS(config = Game)
@@ -48,6 +52,14 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = MazeGameCharacter)
 	FOnPickupKey OnPickupKey;
 
+	// Broadcast by a door this character opened
+	UPROPERTY(BlueprintAssignable, Category = MazeGameCharacter)
+	FOnOpenDoor OnOpenDoor;
+
+	// Broadcast by an exit this character reached
+	UPROPERTY(BlueprintAssignable, Category = MazeGameCharacter)
+	FOnReachExit OnReachExit;
+
 protected:
 
 	UPROPERTY()
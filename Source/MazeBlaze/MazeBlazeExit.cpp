@@ -1,7 +1,11 @@
 #include "MazeBlazeExit.h"
 #include "MazeBlazeCharacter.h"
+#include "MazeBlazeExitPolicyInterface.h"
 #include "Components/BoxComponent.h"
 #include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameModeBase.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "Perception/AISense_Sight.h"
 
 AMazeBlazeExit::AMazeBlazeExit()
 {
@@ -9,6 +13,34 @@ AMazeBlazeExit::AMazeBlazeExit()
 	Box->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	Box->SetCollisionResponseToAllChannels(ECollisionResponse::ECR_Overlap);
 	RootComponent = Box;
+
+	StimuliSource = CreateDefaultSubobject<UAIPerceptionStimuliSourceComponent>(TEXT("StimuliSource"));
+	StimuliSource->RegisterForSense(UAISense_Sight::StaticClass());
+}
+
+void AMazeBlazeExit::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->RegisterExit(this);
+	}
+
+	if (StimuliSource)
+	{
+		StimuliSource->RegisterWithPerceptionSystem();
+	}
+}
+
+void AMazeBlazeExit::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->UnregisterExit(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMazeBlazeExit::OnFinalLevelExit_Implementation()
@@ -31,6 +63,17 @@ void AMazeBlazeExit::InteractWith_Implementation(AMazeBlazeCharacter* Character)
 	{
 		return;
 	}
+
+	Character->OnReachExit.Broadcast(this);
+
+	// The game mode may keep the level loaded, e.g. until every agent of a simulation is out
+	AGameModeBase* GameMode = GetWorld()->GetAuthGameMode();
+	if (GameMode && GameMode->Implements<UMazeBlazeExitPolicyInterface>()
+		&& !IMazeBlazeExitPolicyInterface::Execute_ShouldTravelOnExit(GameMode, Character))
+	{
+		return;
+	}
+
 	if (bIsFinalLevel)
 	{
 		OnFinalLevelExit();
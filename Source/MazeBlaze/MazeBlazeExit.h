@@ -1,6 +1,7 @@
 #pragma once
 #include "MazeBlazeInteractableInterface.h"
 #include "Components/BoxComponent.h"
+#include "Perception/AIPerceptionStimuliSourceComponent.h"
 #include "MazeBlazeExit.generated.h"
 
 UCLASS()
@@ -12,6 +13,9 @@ public:
 
 	AMazeBlazeExit();
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = MazeGameExit)
 	void OnFinalLevelExit();
 	virtual void OnFinalLevelExit_Implementation();
@@ -31,4 +35,8 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameExit)
 	UBoxComponent* Box;
 
+	// Makes the exit visible to the AI sight sense
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameExit)
+	UAIPerceptionStimuliSourceComponent* StimuliSource;
+
 };
@@ -0,0 +1,6 @@
+#include "MazeBlazeExitPolicyInterface.h"
+
+bool IMazeBlazeExitPolicyInterface::ShouldTravelOnExit_Implementation(const AMazeBlazeCharacter*) const
+{
+	return true;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "UObject/Interface.h"
+#include "MazeBlazeExitPolicyInterface.generated.h"
+
+class AMazeBlazeCharacter;
+
+// Implemented by game modes that decide what reaching an exit does to the level
+UINTERFACE(BlueprintType)
+class UMazeBlazeExitPolicyInterface : public UInterface
+{
+	GENERATED_BODY()
+};
+
+class MAZEBLAZE_API IMazeBlazeExitPolicyInterface
+{
+	GENERATED_BODY()
+
+public:
+
+	// Whether a character reaching an exit finishes the level or travels to the next one
+	UFUNCTION(BlueprintCallable, BlueprintNativeEvent, Category = MazeGameExit)
+	bool ShouldTravelOnExit(const AMazeBlazeCharacter* Character) const;
+	virtual bool ShouldTravelOnExit_Implementation(const AMazeBlazeCharacter* Character) const;
+};
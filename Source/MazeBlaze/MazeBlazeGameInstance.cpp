@@ -1,4 +1,6 @@
 ﻿#include "MazeBlazeGameInstance.h"
+#include "MazeBlazeAIController.h"
+#include "EngineUtils.h"
 
 UMazeBlazeGameInstance::UMazeBlazeGameInstance()
 {
@@ -22,6 +24,15 @@ bool UMazeBlazeGameInstance::GetPlayAsAI() const
 void UMazeBlazeGameInstance::SetAIExplorationSystem(EAIExplorationSystem NewSystem)
 {
 	AIExplorationSystem = NewSystem;
+	
+	// Agents already in the maze swap strategies without restarting their behavior trees
+	if (UWorld* World = GetWorld())
+	{
+		for (TActorIterator<AMazeBlazeAIController> It(World); It; ++It)
+		{
+			It->SetExplorationSystem(NewSystem);
+		}
+	}
 }
 
 EAIExplorationSystem UMazeBlazeGameInstance::GetAIExplorationSystem() const
@@ -1,5 +1,7 @@
 #include "MazeBlazeKey.h"
 #include "MazeBlazeCharacter.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "Perception/AISense_Sight.h"
 
 
 AMazeBlazeKey::AMazeBlazeKey()
@@ -18,6 +20,34 @@ AMazeBlazeKey::AMazeBlazeKey()
 	Mesh->SetupAttachment(RootComponent);
 
 	RotatingMovement = CreateDefaultSubobject<URotatingMovementComponent>(TEXT("Rotation"));
+
+	StimuliSource = CreateDefaultSubobject<UAIPerceptionStimuliSourceComponent>(TEXT("StimuliSource"));
+	StimuliSource->RegisterForSense(UAISense_Sight::StaticClass());
+}
+
+void AMazeBlazeKey::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->RegisterKey(this);
+	}
+
+	if (StimuliSource && bIsOnGround)
+	{
+		StimuliSource->RegisterWithPerceptionSystem();
+	}
+}
+
+void AMazeBlazeKey::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->UnregisterKey(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void AMazeBlazeKey::InteractWith_Implementation(AMazeBlazeCharacter* Character)
@@ -63,10 +93,26 @@ const FName& AMazeBlazeKey::GetKeyName() const
 	return Name;
 }
 
+bool AMazeBlazeKey::IsOnGround() const
+{
+	return bIsOnGround;
+}
+
 void AMazeBlazeKey::PickUp_Implementation()
 {
 	bIsOnGround = false;
 	SetActorHiddenInGame(true);
+
+	// A carried key can no longer be seen lying around
+	if (StimuliSource)
+	{
+		StimuliSource->UnregisterFromPerceptionSystem();
+	}
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->NotifyKeyPickedUp(this);
+	}
 }
 
 void AMazeBlazeKey::DropDownAt_Implementation(const FVector& Location)
@@ -74,6 +120,16 @@ void AMazeBlazeKey::DropDownAt_Implementation(const FVector& Location)
 	SetActorLocation(Location);
 	bIsOnGround = true;
 	SetActorHiddenInGame(false);
+
+	if (StimuliSource)
+	{
+		StimuliSource->RegisterWithPerceptionSystem();
+	}
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->NotifyKeyDropped(this);
+	}
 }
 
 
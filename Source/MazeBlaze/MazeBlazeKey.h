@@ -4,6 +4,7 @@
 #include "MazeGameDoor.h"
 #include "Components/SphereComponent.h"
 #include "GameFramework/RotatingMovementComponent.h"
+#include "Perception/AIPerceptionStimuliSourceComponent.h"
 #include "MazeBlazeKey.generated.h"
 
 UCLASS()
@@ -15,6 +16,9 @@ public:
 
 	AMazeBlazeKey();
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	virtual void InteractWith_Implementation(AMazeBlazeCharacter* Character) override;
 	virtual bool CanInteractWith_Implementation(const AMazeBlazeCharacter* Character) const override;
 	virtual void GetInteractionPoints_Implementation(TArray<FVector>& OutInteractionPoints) const override;
@@ -28,6 +32,9 @@ public:
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = MazeGameKey)
 	const FName& GetKeyName() const;
 
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = MazeGameKey)
+	bool IsOnGround() const;
+
 	UFUNCTION(BlueprintNativeEvent, Category = MazeGameKey)
 	void PickUp();
 	virtual void PickUp_Implementation();
@@ -47,6 +54,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameKey)
 	URotatingMovementComponent* RotatingMovement;
 
+	// Makes the key visible to the AI sight sense while it is on the ground
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameKey)
+	UAIPerceptionStimuliSourceComponent* StimuliSource;
+
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = MazeGameKey)
 	int32 Signature = 0;
 
@@ -0,0 +1,220 @@
+#include "MazeDebugDrawSubsystem.h"
+#include "MazeBlazeAIController.h"
+#include "MazeAIStatusText.h"
+#include "MazeExplorationStrategy.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "DrawDebugHelpers.h"
+
+DECLARE_CYCLE_STAT(TEXT("Debug Draw"), STAT_MazeDebugDraw, STATGROUP_MazeExploration);
+
+#if ENABLE_DRAW_DEBUG
+static TAutoConsoleVariable<int32> CVarMazeAIDebugDraw(
+	TEXT("MazeBlaze.AI.DebugDraw"),
+	0,
+	TEXT("Per-frame debug view of the AI controllers\n")
+	TEXT("0: off\n")
+	TEXT("1: agents near the camera, fewer primitives further away\n")
+	TEXT("2: every agent in full detail"),
+	ECVF_Cheat);
+
+static TAutoConsoleVariable<float> CVarMazeAIDebugDrawDistance(
+	TEXT("MazeBlaze.AI.DebugDrawDistance"),
+	3000.0f,
+	TEXT("Agents within this distance of the camera are drawn in full detail, within twice this distance with fewer primitives"),
+	ECVF_Cheat);
+#endif
+
+UMazeDebugDrawSubsystem* UMazeDebugDrawSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeDebugDrawSubsystem>() : nullptr;
+}
+
+bool UMazeDebugDrawSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+#if ENABLE_DRAW_DEBUG
+	return Super::ShouldCreateSubsystem(Outer);
+#else
+	return false;
+#endif
+}
+
+void UMazeDebugDrawSubsystem::Deinitialize()
+{
+	Agents.Empty();
+	FrameLines.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMazeDebugDrawSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazeDebugDrawSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazeDebugDrawSubsystem, STATGROUP_Tickables);
+}
+
+bool UMazeDebugDrawSubsystem::IsTickable() const
+{
+	return IsEnabled() && Agents.Num() > 0;
+}
+
+void UMazeDebugDrawSubsystem::RegisterController(AMazeBlazeAIController* Controller)
+{
+	if (Controller)
+	{
+		Agents.AddUnique(Controller);
+	}
+}
+
+void UMazeDebugDrawSubsystem::UnregisterController(AMazeBlazeAIController* Controller)
+{
+	Agents.RemoveSwap(Controller, EAllowShrinking::No);
+}
+
+bool UMazeDebugDrawSubsystem::IsEnabled()
+{
+#if ENABLE_DRAW_DEBUG
+	return CVarMazeAIDebugDraw.GetValueOnGameThread() > 0;
+#else
+	return false;
+#endif
+}
+
+void UMazeDebugDrawSubsystem::AddLine(TArray<FBatchedLine>& Lines, const FVector& Start, const FVector& End, const FColor& Color, float Duration, float Thickness)
+{
+	Lines.Emplace(Start, End, FLinearColor(Color), Duration, Thickness, SDPG_World);
+}
+
+void UMazeDebugDrawSubsystem::AddSphere(TArray<FBatchedLine>& Lines, const FVector& Center, float Radius, int32 Segments, const FColor& Color, float Duration)
+{
+	// Three great circles, which reads as a sphere at a fraction of DrawDebugSphere's lines
+	const float AngleStep = 2.0f * PI / FMath::Max(Segments, 4);
+	FVector PreviousXY = Center + FVector(Radius, 0.0f, 0.0f);
+	FVector PreviousXZ = PreviousXY;
+	FVector PreviousYZ = Center + FVector(0.0f, Radius, 0.0f);
+	for (int32 Segment = 1; Segment <= FMath::Max(Segments, 4); ++Segment)
+	{
+		float Sin = 0.0f;
+		float Cos = 0.0f;
+		FMath::SinCos(&Sin, &Cos, Segment * AngleStep);
+
+		const FVector NextXY = Center + FVector(Cos, Sin, 0.0f) * Radius;
+		const FVector NextXZ = Center + FVector(Cos, 0.0f, Sin) * Radius;
+		const FVector NextYZ = Center + FVector(0.0f, Cos, Sin) * Radius;
+		AddLine(Lines, PreviousXY, NextXY, Color, Duration);
+		AddLine(Lines, PreviousXZ, NextXZ, Color, Duration);
+		AddLine(Lines, PreviousYZ, NextYZ, Color, Duration);
+		PreviousXY = NextXY;
+		PreviousXZ = NextXZ;
+		PreviousYZ = NextYZ;
+	}
+}
+
+void UMazeDebugDrawSubsystem::AddCone(TArray<FBatchedLine>& Lines, const FVector& Origin, const FVector& Direction, float Length, float HalfAngleRadians, int32 Segments, const FColor& Color, float Duration)
+{
+	const FVector Forward = Direction.GetSafeNormal();
+	FVector Right;
+	FVector Up;
+	Forward.FindBestAxisVectors(Right, Up);
+
+	// Rim at the end of the cone and a line from the origin to every other rim point
+	const int32 NumSegments = FMath::Max(Segments, 4);
+	const float RimRadius = Length * FMath::Sin(HalfAngleRadians);
+	const FVector RimCenter = Origin + Forward * Length * FMath::Cos(HalfAngleRadians);
+	FVector Previous = RimCenter + Right * RimRadius;
+	for (int32 Segment = 1; Segment <= NumSegments; ++Segment)
+	{
+		float Sin = 0.0f;
+		float Cos = 0.0f;
+		FMath::SinCos(&Sin, &Cos, Segment * 2.0f * PI / NumSegments);
+
+		const FVector Next = RimCenter + (Right * Cos + Up * Sin) * RimRadius;
+		AddLine(Lines, Previous, Next, Color, Duration);
+		if (Segment % 2 == 0)
+		{
+			AddLine(Lines, Origin, Next, Color, Duration);
+		}
+		Previous = Next;
+	}
+}
+
+void UMazeDebugDrawSubsystem::SubmitLines(UWorld* World, const TArray<FBatchedLine>& Lines, float Duration)
+{
+	if (!World || Lines.Num() == 0)
+	{
+		return;
+	}
+
+	// Lines that outlive the frame go to the persistent batcher, like DrawDebugLine does
+	ULineBatchComponent* LineBatcher = Duration > 0.0f ? World->PersistentLineBatcher : World->LineBatcher;
+	if (LineBatcher)
+	{
+		LineBatcher->DrawLines(Lines);
+	}
+}
+
+bool UMazeDebugDrawSubsystem::GetDetailForDistance(float DistanceSquared, EDetail& OutDetail) const
+{
+#if ENABLE_DRAW_DEBUG
+	if (CVarMazeAIDebugDraw.GetValueOnGameThread() >= 2)
+	{
+		OutDetail = EDetail::Full;
+		return true;
+	}
+
+	const float FullDetailDistance = CVarMazeAIDebugDrawDistance.GetValueOnGameThread();
+	if (DistanceSquared <= FMath::Square(FullDetailDistance))
+	{
+		OutDetail = EDetail::Full;
+		return true;
+	}
+	if (DistanceSquared <= FMath::Square(FullDetailDistance * 2.0f))
+	{
+		OutDetail = EDetail::Reduced;
+		return true;
+	}
+#endif
+	return false;
+}
+
+void UMazeDebugDrawSubsystem::Tick(float DeltaTime)
+{
+#if ENABLE_DRAW_DEBUG
+	SCOPE_CYCLE_COUNTER(STAT_MazeDebugDraw);
+
+	UWorld* World = GetWorld();
+	FVector CameraLocation = FVector::ZeroVector;
+	FRotator CameraRotation;
+	if (APlayerController* PlayerController = World->GetFirstPlayerController())
+	{
+		PlayerController->GetPlayerViewPoint(CameraLocation, CameraRotation);
+	}
+
+	FrameLines.Reset();
+	for (const AMazeBlazeAIController* Controller : Agents)
+	{
+		const APawn* Pawn = Controller ? Controller->GetPawn() : nullptr;
+		EDetail Detail;
+		if (Pawn && GetDetailForDistance(FVector::DistSquared(Pawn->GetActorLocation(), CameraLocation), Detail))
+		{
+			Controller->AppendDebugLines(FrameLines, 0.0f, Detail);
+
+			// Text is not a line primitive, so only nearby agents get their state label
+			if (Detail == EDetail::Full)
+			{
+				DrawDebugString(World, Pawn->GetActorLocation() + FVector(0.0f, 0.0f, 100.0f),
+					FMazeAIStatusText::GetStateString(Controller->GetCurrentState()), nullptr, FColor::White, 0.0f);
+			}
+		}
+	}
+
+	NumLinesLastFrame = FrameLines.Num();
+	SubmitLines(World, FrameLines, 0.0f);
+#endif
+}
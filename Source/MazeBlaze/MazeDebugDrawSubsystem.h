@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Components/LineBatchComponent.h"
+#include "MazeDebugDrawSubsystem.generated.h"
+
+class AMazeBlazeAIController;
+
+/**
+ * World subsystem that draws the debug view of every AI controller in one line batch per frame
+ *
+ * Controllers add their primitives as lines to a shared array, which goes to the world's line
+ * batcher in a single submission. Drawing is off unless MazeBlaze.AI.DebugDraw is set, and agents
+ * far from the camera are drawn with fewer primitives or not at all. The subsystem is not created
+ * in builds without debug drawing (Shipping), and the drawing code compiles out there.
+ */
+UCLASS()
+class MAZEBLAZE_API UMazeDebugDrawSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Level of detail of one agent's debug view
+	enum class EDetail : uint8
+	{
+		// Agent marker and stuck indicator only
+		Reduced,
+
+		// Everything, including the state label and the sight cone
+		Full
+	};
+
+	// Get the debug draw subsystem for the world of the given object; null in builds without debug drawing
+	static UMazeDebugDrawSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+	virtual bool IsTickable() const override;
+
+	// Add a controller to the per-frame debug view
+	void RegisterController(AMazeBlazeAIController* Controller);
+
+	// Remove a controller from the per-frame debug view
+	void UnregisterController(AMazeBlazeAIController* Controller);
+
+	// Whether the per-frame debug view is enabled by MazeBlaze.AI.DebugDraw
+	static bool IsEnabled();
+
+	// Primitives as batched lines
+	static void AddLine(TArray<FBatchedLine>& Lines, const FVector& Start, const FVector& End, const FColor& Color, float Duration, float Thickness = 0.0f);
+	static void AddSphere(TArray<FBatchedLine>& Lines, const FVector& Center, float Radius, int32 Segments, const FColor& Color, float Duration);
+	static void AddCone(TArray<FBatchedLine>& Lines, const FVector& Origin, const FVector& Direction, float Length, float HalfAngleRadians, int32 Segments, const FColor& Color, float Duration);
+
+	// Submit lines to the line batcher used by DrawDebugLine for the same duration
+	static void SubmitLines(UWorld* World, const TArray<FBatchedLine>& Lines, float Duration);
+
+	// Primitives drawn in the last frame
+	int32 GetNumLinesLastFrame() const { return NumLinesLastFrame; }
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Level of detail for an agent at a distance from the camera, or false when it is not drawn
+	bool GetDetailForDistance(float DistanceSquared, EDetail& OutDetail) const;
+
+	// Controllers drawn each frame
+	UPROPERTY()
+	TArray<AMazeBlazeAIController*> Agents;
+
+	// Lines of the current frame, kept to reuse the allocation
+	TArray<FBatchedLine> FrameLines;
+
+	int32 NumLinesLastFrame = 0;
+};
@@ -0,0 +1,235 @@
+#include "MazeErrorTelemetry.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformFileManager.h"
+#include "GenericPlatform/GenericPlatformFile.h"
+#include "HAL/PlatformProcess.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+
+namespace
+{
+	// Records popped from the ring per write
+	constexpr int32 RecordsPerWrite = 1024;
+
+	// Bytes of one serialized record
+	constexpr int64 RecordSize = sizeof(double) + 3 * sizeof(float) + sizeof(uint32) + 2 * sizeof(uint8);
+}
+
+FArchive& operator<<(FArchive& Ar, FMazeErrorTelemetryRecord& Record)
+{
+	uint8 Event = static_cast<uint8>(Record.Event);
+	Ar << Record.Timestamp;
+	Ar << Record.Location.X << Record.Location.Y << Record.Location.Z;
+	Ar << Record.AgentId;
+	Ar << Record.ErrorType;
+	Ar << Event;
+	Record.Event = static_cast<EMazeErrorTelemetryEvent>(Event);
+	return Ar;
+}
+
+FMazeErrorRecordRing::FMazeErrorRecordRing(int32 InCapacity)
+{
+	const int32 Capacity = FMath::RoundUpToPowerOfTwo(FMath::Max(InCapacity, 2));
+	Records.SetNum(Capacity);
+	Mask = Capacity - 1;
+}
+
+int32 FMazeErrorRecordRing::Num() const
+{
+	return static_cast<int32>(FPlatformAtomics::AtomicRead(&Head) - FPlatformAtomics::AtomicRead(&Tail));
+}
+
+bool FMazeErrorRecordRing::Push(const FMazeErrorTelemetryRecord& Record)
+{
+	const int64 CurrentHead = FPlatformAtomics::AtomicRead_Relaxed(&Head);
+	if (CurrentHead - FPlatformAtomics::AtomicRead(&Tail) >= Records.Num())
+	{
+		return false;
+	}
+
+	// Publish the head only after the record is in its slot
+	Records[CurrentHead & Mask] = Record;
+	FPlatformAtomics::AtomicStore(&Head, CurrentHead + 1);
+	return true;
+}
+
+int32 FMazeErrorRecordRing::Pop(TArray<FMazeErrorTelemetryRecord>& OutRecords, int32 MaxRecords)
+{
+	const int64 CurrentTail = FPlatformAtomics::AtomicRead_Relaxed(&Tail);
+	const int32 NumRecords = static_cast<int32>(FMath::Min<int64>(FPlatformAtomics::AtomicRead(&Head) - CurrentTail, MaxRecords));
+	for (int32 Index = 0; Index < NumRecords; ++Index)
+	{
+		OutRecords.Add(Records[(CurrentTail + Index) & Mask]);
+	}
+
+	// Free the slots only after the records were copied out
+	FPlatformAtomics::AtomicStore(&Tail, CurrentTail + NumRecords);
+	return NumRecords;
+}
+
+FMazeErrorTelemetry::FMazeErrorTelemetry(int32 RingCapacity)
+	: Ring(RingCapacity)
+{
+}
+
+FMazeErrorTelemetry::~FMazeErrorTelemetry()
+{
+	StopFlushing();
+}
+
+void FMazeErrorTelemetry::Record(const FMazeErrorTelemetryRecord& Record)
+{
+	if (Record.ErrorType < FMazeAIStatusText::NumErrorTypes)
+	{
+		++Counts[static_cast<int32>(Record.Event)][Record.ErrorType];
+	}
+
+	if (Thread && !Ring.Push(Record))
+	{
+		++NumDropped;
+	}
+}
+
+int32 FMazeErrorTelemetry::GetCount(EMazeErrorTelemetryEvent Event, uint8 ErrorType) const
+{
+	return ErrorType < FMazeAIStatusText::NumErrorTypes ? Counts[static_cast<int32>(Event)][ErrorType] : 0;
+}
+
+int32 FMazeErrorTelemetry::GetTotalCount(EMazeErrorTelemetryEvent Event) const
+{
+	int32 Total = 0;
+	for (const int32 Count : Counts[static_cast<int32>(Event)])
+	{
+		Total += Count;
+	}
+	return Total;
+}
+
+bool FMazeErrorTelemetry::StartFlushing(const FString& FilePath, float FlushIntervalSeconds)
+{
+	StopFlushing();
+
+	// Without threads the ring would only fill up
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		return false;
+	}
+
+	IPlatformFile& PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+	PlatformFile.CreateDirectoryTree(*FPaths::GetPath(FilePath));
+	File.Reset(PlatformFile.OpenWrite(*FilePath));
+	if (!File)
+	{
+		return false;
+	}
+
+	uint32 Magic = FileMagic;
+	uint32 Version = FileVersion;
+	WriteBuffer.Reset();
+	FMemoryWriter Writer(WriteBuffer);
+	Writer << Magic << Version;
+	File->Write(WriteBuffer.GetData(), WriteBuffer.Num());
+
+	FlushIntervalMs = static_cast<uint32>(FMath::Max(FlushIntervalSeconds, 0.01f) * 1000.0f);
+	FPlatformAtomics::AtomicStore(&bStopRequested, 0);
+	WakeEvent = FPlatformProcess::GetSynchEventFromPool();
+	Thread = FRunnableThread::Create(this, TEXT("MazeErrorTelemetry"), 0, TPri_BelowNormal);
+	if (!Thread)
+	{
+		FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+		WakeEvent = nullptr;
+		File.Reset();
+		return false;
+	}
+	return true;
+}
+
+void FMazeErrorTelemetry::StopFlushing()
+{
+	if (!Thread)
+	{
+		return;
+	}
+
+	Stop();
+	Thread->WaitForCompletion();
+	delete Thread;
+	Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+	WakeEvent = nullptr;
+	File.Reset();
+}
+
+uint32 FMazeErrorTelemetry::Run()
+{
+	while (!FPlatformAtomics::AtomicRead(&bStopRequested))
+	{
+		WakeEvent->Wait(FlushIntervalMs);
+		WritePendingRecords();
+	}
+
+	// Records pushed before the stop request
+	WritePendingRecords();
+	return 0;
+}
+
+void FMazeErrorTelemetry::Stop()
+{
+	FPlatformAtomics::AtomicStore(&bStopRequested, 1);
+	if (WakeEvent)
+	{
+		WakeEvent->Trigger();
+	}
+}
+
+void FMazeErrorTelemetry::WritePendingRecords()
+{
+	for (;;)
+	{
+		PendingRecords.Reset();
+		if (Ring.Pop(PendingRecords, RecordsPerWrite) == 0)
+		{
+			break;
+		}
+
+		WriteBuffer.Reset();
+		FMemoryWriter Writer(WriteBuffer);
+		for (FMazeErrorTelemetryRecord& Record : PendingRecords)
+		{
+			Writer << Record;
+		}
+		File->Write(WriteBuffer.GetData(), WriteBuffer.Num());
+		FPlatformAtomics::InterlockedAdd(&NumWritten, PendingRecords.Num());
+	}
+	File->Flush();
+}
+
+bool FMazeErrorTelemetry::LoadFile(const FString& FilePath, TArray<FMazeErrorTelemetryRecord>& OutRecords)
+{
+	TArray<uint8> Data;
+	if (!FFileHelper::LoadFileToArray(Data, *FilePath))
+	{
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Reader.IsError() || Magic != FileMagic || Version != FileVersion)
+	{
+		return false;
+	}
+
+	OutRecords.Reset();
+	OutRecords.Reserve(static_cast<int32>((Reader.TotalSize() - Reader.Tell()) / RecordSize));
+	while (Reader.TotalSize() - Reader.Tell() >= RecordSize)
+	{
+		Reader << OutRecords.AddDefaulted_GetRef();
+	}
+	return true;
+}
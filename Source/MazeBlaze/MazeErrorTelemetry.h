@@ -0,0 +1,141 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "MazeAIStatusText.h"
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+// What happened to an agent's error
+enum class EMazeErrorTelemetryEvent : uint8
+{
+	// The agent reported an error
+	Reported,
+
+	// A recovery attempt brought the agent out of the error
+	Recovered,
+
+	// A recovery attempt left the agent in the error
+	RecoveryFailed
+};
+
+// One error event of one agent; written to the telemetry file as 26 bytes
+struct FMazeErrorTelemetryRecord
+{
+	// World time of the event
+	double Timestamp = 0.0;
+
+	// Pawn location at the time of the event
+	FVector3f Location = FVector3f::ZeroVector;
+
+	uint32 AgentId = 0;
+	uint8 ErrorType = 0;
+	EMazeErrorTelemetryEvent Event = EMazeErrorTelemetryEvent::Reported;
+
+	friend FArchive& operator<<(FArchive& Ar, FMazeErrorTelemetryRecord& Record);
+};
+
+/**
+ * Fixed-size ring of telemetry records shared by one producer thread and one consumer thread
+ *
+ * Neither side takes a lock: the producer only moves the head and the consumer only moves the
+ * tail. When the ring is full the producer drops the record rather than waiting.
+ */
+class MAZEBLAZE_API FMazeErrorRecordRing
+{
+public:
+	// Capacity is rounded up to a power of two
+	explicit FMazeErrorRecordRing(int32 InCapacity);
+
+	int32 GetCapacity() const { return Records.Num(); }
+
+	// Records waiting for the consumer
+	int32 Num() const;
+
+	// Producer only; returns false when the ring is full
+	bool Push(const FMazeErrorTelemetryRecord& Record);
+
+	// Consumer only; appends up to MaxRecords records to OutRecords and returns how many
+	int32 Pop(TArray<FMazeErrorTelemetryRecord>& OutRecords, int32 MaxRecords = MAX_int32);
+
+private:
+	TArray<FMazeErrorTelemetryRecord> Records;
+	int64 Mask = 0;
+
+	// Total records pushed and popped; the slot of a record is its count masked by the capacity
+	volatile int64 Head = 0;
+	volatile int64 Tail = 0;
+};
+
+/**
+ * Error telemetry of all agents: counts per error type, and a record of every event in a file
+ *
+ * The thread that reports errors (the game thread) updates the counts and pushes a compact record
+ * into the ring. A background thread drains the ring every flush interval and appends the records
+ * to a binary file, so reporting an error never waits on file I/O. The file starts with
+ * FileMagic and FileVersion, followed by the records.
+ */
+class MAZEBLAZE_API FMazeErrorTelemetry : public FRunnable
+{
+public:
+	static constexpr uint32 FileMagic = 0x52455A4D; // "MZER"
+	static constexpr uint32 FileVersion = 1;
+
+	explicit FMazeErrorTelemetry(int32 RingCapacity = 8192);
+	virtual ~FMazeErrorTelemetry() override;
+
+	// Count an event and queue it for the file; called from one thread only
+	void Record(const FMazeErrorTelemetryRecord& Record);
+
+	// Events counted since construction
+	int32 GetCount(EMazeErrorTelemetryEvent Event, uint8 ErrorType) const;
+	int32 GetTotalCount(EMazeErrorTelemetryEvent Event) const;
+
+	// Records that did not fit in the ring and were left out of the file
+	int64 GetNumDropped() const { return NumDropped; }
+
+	// Records written to the file so far
+	int64 GetNumWritten() const { return FPlatformAtomics::AtomicRead(&NumWritten); }
+
+	// Start a thread that appends the records to a new file every interval; false if the file cannot be opened
+	bool StartFlushing(const FString& FilePath, float FlushIntervalSeconds);
+
+	// Stop the thread after writing the records still in the ring
+	void StopFlushing();
+
+	bool IsFlushing() const { return Thread != nullptr; }
+
+	// Read back a telemetry file
+	static bool LoadFile(const FString& FilePath, TArray<FMazeErrorTelemetryRecord>& OutRecords);
+
+	//~ Begin FRunnable Interface
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+	//~ End FRunnable Interface
+
+private:
+	static constexpr int32 NumEvents = 3;
+
+	// Drain the ring into the file; flusher thread only
+	void WritePendingRecords();
+
+	FMazeErrorRecordRing Ring;
+
+	// Counts per event and error type; producer only
+	int32 Counts[NumEvents][FMazeAIStatusText::NumErrorTypes] = {};
+	int64 NumDropped = 0;
+
+	// Flusher thread state
+	FRunnableThread* Thread = nullptr;
+	FEvent* WakeEvent = nullptr;
+	TUniquePtr<IFileHandle> File;
+	uint32 FlushIntervalMs = 1000;
+	volatile int32 bStopRequested = 0;
+	volatile int64 NumWritten = 0;
+
+	// Reused by the flusher thread
+	TArray<FMazeErrorTelemetryRecord> PendingRecords;
+	TArray<uint8> WriteBuffer;
+};
@@ -0,0 +1,135 @@
+#include "MazeErrorTelemetrySubsystem.h"
+#include "Engine/World.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+UMazeErrorTelemetrySubsystem* UMazeErrorTelemetrySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeErrorTelemetrySubsystem>() : nullptr;
+}
+
+void UMazeErrorTelemetrySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!bEnabled)
+	{
+		return;
+	}
+
+	Telemetry = MakeUnique<FMazeErrorTelemetry>(RingCapacity);
+	if (bWriteToFile)
+	{
+		FilePath = FPaths::Combine(FPaths::ProjectLogDir(), FString::Printf(TEXT("MazeAIErrors-%s.mazeerr"), *FDateTime::Now().ToString()));
+		if (!Telemetry->StartFlushing(FilePath, FlushInterval))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MazeErrorTelemetry: Cannot write %s, errors are only counted"), *FilePath);
+			FilePath.Empty();
+		}
+	}
+}
+
+void UMazeErrorTelemetrySubsystem::Deinitialize()
+{
+	if (Telemetry && !FilePath.IsEmpty())
+	{
+		Telemetry->StopFlushing();
+		UE_LOG(LogTemp, Log, TEXT("MazeErrorTelemetry: Wrote %lld error records to %s (%lld dropped)"),
+			   Telemetry->GetNumWritten(), *FilePath, Telemetry->GetNumDropped());
+	}
+	Telemetry.Reset();
+	FilePath.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMazeErrorTelemetrySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazeErrorTelemetrySubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazeErrorTelemetrySubsystem, STATGROUP_Tickables);
+}
+
+bool UMazeErrorTelemetrySubsystem::RecordEvent(const AMazeBlazeAIController* Controller, EAIErrorType ErrorType, EMazeErrorTelemetryEvent Event)
+{
+	// The ring takes no lock on the producer side, so a second producer thread would corrupt it
+	check(IsInGameThread());
+
+	if (!Telemetry || !Controller)
+	{
+		return false;
+	}
+
+	FMazeErrorTelemetryRecord Record;
+	Record.Timestamp = GetWorld()->GetTimeSeconds();
+	Record.AgentId = Controller->GetUniqueID();
+	Record.ErrorType = static_cast<uint8>(ErrorType);
+	Record.Event = Event;
+	if (const APawn* Pawn = Controller->GetPawn())
+	{
+		Record.Location = FVector3f(Pawn->GetActorLocation());
+	}
+
+	Telemetry->Record(Record);
+	return true;
+}
+
+int32 UMazeErrorTelemetrySubsystem::GetErrorCount(EAIErrorType ErrorType) const
+{
+	return Telemetry ? Telemetry->GetCount(EMazeErrorTelemetryEvent::Reported, static_cast<uint8>(ErrorType)) : 0;
+}
+
+int32 UMazeErrorTelemetrySubsystem::GetRecoveryCount(EAIErrorType ErrorType, bool bSucceeded) const
+{
+	const EMazeErrorTelemetryEvent Event = bSucceeded ? EMazeErrorTelemetryEvent::Recovered : EMazeErrorTelemetryEvent::RecoveryFailed;
+	return Telemetry ? Telemetry->GetCount(Event, static_cast<uint8>(ErrorType)) : 0;
+}
+
+FMazeErrorTelemetryStats UMazeErrorTelemetrySubsystem::GetStats() const
+{
+	FMazeErrorTelemetryStats Stats;
+	if (Telemetry)
+	{
+		Stats.ErrorsReported = Telemetry->GetTotalCount(EMazeErrorTelemetryEvent::Reported);
+		Stats.Recoveries = Telemetry->GetTotalCount(EMazeErrorTelemetryEvent::Recovered);
+		Stats.FailedRecoveries = Telemetry->GetTotalCount(EMazeErrorTelemetryEvent::RecoveryFailed);
+		Stats.RecordsWritten = Telemetry->GetNumWritten();
+		Stats.RecordsDropped = Telemetry->GetNumDropped();
+	}
+	return Stats;
+}
+
+void UMazeErrorTelemetrySubsystem::Tick(float DeltaTime)
+{
+	const double WorldTime = GetWorld()->GetTimeSeconds();
+	if (!Telemetry || SummaryLogInterval <= 0.0f || WorldTime - LastSummaryLogTime < SummaryLogInterval)
+	{
+		return;
+	}
+	const double Elapsed = WorldTime - LastSummaryLogTime;
+	LastSummaryLogTime = WorldTime;
+
+	// One line for all errors since the last summary, instead of one per error
+	TStringBuilder<256> NewErrors;
+	for (int32 ErrorType = 0; ErrorType < FMazeAIStatusText::NumErrorTypes; ++ErrorType)
+	{
+		const int32 Count = Telemetry->GetCount(EMazeErrorTelemetryEvent::Reported, static_cast<uint8>(ErrorType));
+		if (Count > LoggedErrorCounts[ErrorType])
+		{
+			NewErrors.Appendf(TEXT("%s%s x%d"), NewErrors.Len() > 0 ? TEXT(", ") : TEXT(""),
+				FMazeAIStatusText::GetErrorTypeName(static_cast<EAIErrorType>(ErrorType)), Count - LoggedErrorCounts[ErrorType]);
+			LoggedErrorCounts[ErrorType] = Count;
+		}
+	}
+
+	if (NewErrors.Len() > 0)
+	{
+		const FMazeErrorTelemetryStats Stats = GetStats();
+		UE_LOG(LogTemp, Warning, TEXT("AI errors in the last %.0fs: %s (%d total, %d recovered, %d failed recoveries, %lld records dropped)"),
+			   Elapsed, NewErrors.ToString(), Stats.ErrorsReported, Stats.Recoveries, Stats.FailedRecoveries, Stats.RecordsDropped);
+	}
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeBlazeAIController.h"
+#include "MazeErrorTelemetry.h"
+#include "MazeErrorTelemetrySubsystem.generated.h"
+
+// Error totals of all agents since the world started
+USTRUCT(BlueprintType)
+struct MAZEBLAZE_API FMazeErrorTelemetryStats
+{
+	GENERATED_BODY()
+
+	// Errors reported by any agent
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Telemetry")
+	int32 ErrorsReported = 0;
+
+	// Recovery attempts that brought an agent out of its error
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Telemetry")
+	int32 Recoveries = 0;
+
+	// Recovery attempts that left an agent in its error
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Telemetry")
+	int32 FailedRecoveries = 0;
+
+	// Records written to the telemetry file
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Telemetry")
+	int64 RecordsWritten = 0;
+
+	// Records left out of the file because the flusher fell behind
+	UPROPERTY(BlueprintReadOnly, Category = "AI|Telemetry")
+	int64 RecordsDropped = 0;
+};
+
+/**
+ * World subsystem that collects the errors and recoveries of every AI controller
+ *
+ * Controllers hand their error events here instead of logging each one. The events are counted
+ * per error type for the query functions and written by a background thread to a binary file in
+ * the project log directory (see FMazeErrorTelemetry); the log gets one summary line per interval.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeErrorTelemetrySubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the error telemetry for the world of the given object
+	static UMazeErrorTelemetrySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Record an error event of a controller; returns false when telemetry is disabled and the caller should log it instead.
+	// Game thread only: the game thread is the single producer of the telemetry ring
+	bool RecordEvent(const AMazeBlazeAIController* Controller, EAIErrorType ErrorType, EMazeErrorTelemetryEvent Event);
+
+	// Errors of one type reported by any agent
+	UFUNCTION(BlueprintCallable, Category = "AI|Telemetry")
+	int32 GetErrorCount(EAIErrorType ErrorType) const;
+
+	// Recovery attempts from one error type that succeeded or failed
+	UFUNCTION(BlueprintCallable, Category = "AI|Telemetry")
+	int32 GetRecoveryCount(EAIErrorType ErrorType, bool bSucceeded) const;
+
+	// Totals over all error types
+	UFUNCTION(BlueprintCallable, Category = "AI|Telemetry")
+	FMazeErrorTelemetryStats GetStats() const;
+
+	// File the records are written to, empty when nothing is written
+	const FString& GetFilePath() const { return FilePath; }
+
+	// Whether error events are collected here at all; when disabled controllers log every error
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Telemetry")
+	bool bEnabled = true;
+
+	// Whether the records are written to a file
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Telemetry")
+	bool bWriteToFile = true;
+
+	// Records the game thread can queue ahead of the flusher before they are dropped
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Telemetry", meta = (ClampMin = "64"))
+	int32 RingCapacity = 8192;
+
+	// Interval between writes of the flusher thread
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Telemetry", meta = (ClampMin = "0.01"))
+	float FlushInterval = 1.0f;
+
+	// Interval between summary log lines while errors occur; zero disables logging
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Telemetry", meta = (ClampMin = "0.0"))
+	float SummaryLogInterval = 10.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	TUniquePtr<FMazeErrorTelemetry> Telemetry;
+
+	FString FilePath;
+
+	// Reported errors per type at the last summary line
+	int32 LoggedErrorCounts[FMazeAIStatusText::NumErrorTypes] = {};
+	double LastSummaryLogTime = 0.0;
+};
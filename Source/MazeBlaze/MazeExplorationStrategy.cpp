@@ -0,0 +1,283 @@
+#include "MazeExplorationStrategy.h"
+#include "MazeBlazeAIController.h"
+#include "MazeBlazeCharacter.h"
+#include "MazeBlazeKey.h"
+#include "MazeFrontierExplorationComponent.h"
+#include "MazeTopologySubsystem.h"
+#include "MazePotentialFieldSubsystem.h"
+#include "MazeWallFollowingSubsystem.h"
+#include "MazeVisibilityGraphSubsystem.h"
+#include "NavigationSystem.h"
+#include "Navigation/PathFollowingComponent.h"
+
+DECLARE_CYCLE_STAT(TEXT("Strategy Switch"), STAT_MazeStrategySwitch, STATGROUP_MazeExploration);
+
+namespace
+{
+	// Explores towards the nearest reachable frontier of the controller's occupancy map
+	class FMazeFrontierStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::Frontier; }
+
+	protected:
+		virtual bool ChooseExplorationRouteImpl(AMazeBlazeAIController& Controller, TArray<FVector>& OutPoints) override
+		{
+			UMazeFrontierExplorationComponent* Exploration = Controller.FindComponentByClass<UMazeFrontierExplorationComponent>();
+			if (!Exploration)
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FrontierStrategy: %s has no frontier exploration component"), *Controller.GetName());
+				return false;
+			}
+
+			FVector FrontierLocation;
+			if (!Exploration->ChooseTarget(FrontierLocation))
+			{
+				// Everything reachable has been seen; simple exploration keeps wandering so newly opened areas are found
+				UE_LOG(LogTemp, Log, TEXT("FrontierStrategy: No reachable frontier left for %s"), *Controller.GetName());
+				return false;
+			}
+
+			// Frontier cells come from the occupancy grid; snap them onto the navmesh
+			FNavLocation NavLocation(FrontierLocation);
+			UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(Controller.GetWorld());
+			if (NavSys && !NavSys->ProjectPointToNavigation(FrontierLocation, NavLocation, FVector(Exploration->CellSize, Exploration->CellSize, 200.0f)))
+			{
+				UE_LOG(LogTemp, Warning, TEXT("FrontierStrategy: Frontier is off the navmesh"));
+				return false;
+			}
+
+			OutPoints.Add(NavLocation.Location);
+			return true;
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(FrontierStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(FrontierStrategy_Path, STATGROUP_MazeExploration); }
+	};
+
+	// Routes over the junction graph of the maze topology
+	class FMazeGraphStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::GraphBased; }
+
+	protected:
+		virtual bool FindPathToTargetImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints) override
+		{
+			UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(&Controller);
+			return Topology && Topology->FindPath(Controller.GetPawn()->GetActorLocation(), TargetLocation, OutPoints);
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(GraphStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(GraphStrategy_Path, STATGROUP_MazeExploration); }
+	};
+
+	// Routes with hierarchical A* over the maze sectors
+	class FMazeHierarchicalStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::HierarchicalAStar; }
+
+	protected:
+		virtual bool FindPathToTargetImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints) override
+		{
+			UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(&Controller);
+			return Topology && Topology->FindHierarchicalPath(Controller.GetPawn()->GetActorLocation(), TargetLocation, OutPoints);
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(HierarchicalStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(HierarchicalStrategy_Path, STATGROUP_MazeExploration); }
+	};
+
+	// Steers down the potential field of the current goal; other agents bend the way around them
+	class FMazePotentialFieldStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::PotentialField; }
+
+	protected:
+		virtual void OnDeactivated(AMazeBlazeAIController& Controller) override
+		{
+			if (UMazePotentialFieldSubsystem* PotentialField = UMazePotentialFieldSubsystem::Get(&Controller))
+			{
+				PotentialField->UnregisterAgent(Controller.GetPawn());
+			}
+		}
+
+		// Agents walk the descent direction sampled for all of them in one batch per tick
+		virtual bool GetSteeringDirectionImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, FVector& OutDirection) override
+		{
+			UMazePotentialFieldSubsystem* PotentialField = UMazePotentialFieldSubsystem::Get(&Controller);
+			EMazePotentialGoal Goal;
+			int32 KeySignature = 0;
+			if (!PotentialField || !GetGoal(Controller, Goal, KeySignature))
+			{
+				return false;
+			}
+			return PotentialField->GetSteeringDirection(Controller.GetPawn(), Goal, KeySignature, OutDirection);
+		}
+
+		// Where steering stopped short, e.g. in a local minimum around other agents, descend the cells instead
+		virtual bool FindPathToTargetImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints) override
+		{
+			UMazePotentialFieldSubsystem* PotentialField = UMazePotentialFieldSubsystem::Get(&Controller);
+			EMazePotentialGoal Goal;
+			int32 KeySignature = 0;
+			if (!PotentialField || !GetGoal(Controller, Goal, KeySignature))
+			{
+				return false;
+			}
+			return PotentialField->FindDescentPoints(Controller.GetPawn(), Goal, KeySignature, OutPoints);
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(PotentialFieldStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(PotentialFieldStrategy_Path, STATGROUP_MazeExploration); }
+
+	private:
+		// Field layer for the controller's current state
+		static bool GetGoal(AMazeBlazeAIController& Controller, EMazePotentialGoal& OutGoal, int32& OutKeySignature)
+		{
+			const AMazeBlazeCharacter* MazeCharacter = Cast<AMazeBlazeCharacter>(Controller.GetPawn());
+			const AMazeBlazeKey* CarriedKey = MazeCharacter ? MazeCharacter->GetCarriedKey() : nullptr;
+
+			switch (Controller.GetCurrentState())
+			{
+			case EAIState::SeekingKey:
+				OutGoal = EMazePotentialGoal::Keys;
+				return true;
+			case EAIState::SeekingDoor:
+				OutGoal = EMazePotentialGoal::Doors;
+				OutKeySignature = CarriedKey ? CarriedKey->GetSignature() : 0;
+				return CarriedKey != nullptr;
+			case EAIState::GoingToExit:
+				OutGoal = EMazePotentialGoal::Exits;
+				return true;
+			default:
+				// Exploration targets are arbitrary points with no field of their own
+				if (UMazePotentialFieldSubsystem* PotentialField = UMazePotentialFieldSubsystem::Get(&Controller))
+				{
+					PotentialField->UnregisterAgent(Controller.GetPawn());
+				}
+				return false;
+			}
+		}
+	};
+
+	// Explores by following walls with a memory of the visited cells
+	class FMazeWallFollowingStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::WallFollowing; }
+
+	protected:
+		virtual void OnDeactivated(AMazeBlazeAIController& Controller) override
+		{
+			if (UMazeWallFollowingSubsystem* WallFollowing = UMazeWallFollowingSubsystem::Get(&Controller))
+			{
+				WallFollowing->UnregisterAgent(Controller.GetPawn());
+			}
+		}
+
+		virtual bool ChooseExplorationRouteImpl(AMazeBlazeAIController& Controller, TArray<FVector>& OutPoints) override
+		{
+			UMazeWallFollowingSubsystem* WallFollowing = UMazeWallFollowingSubsystem::Get(&Controller);
+			if (!WallFollowing || !WallFollowing->ChooseRoute(Controller.GetPawn(), OutPoints))
+			{
+				UE_LOG(LogTemp, Verbose, TEXT("WallFollowingStrategy: No wall to follow for %s"), *Controller.GetName());
+				return false;
+			}
+			return true;
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(WallFollowingStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(WallFollowingStrategy_Path, STATGROUP_MazeExploration); }
+	};
+
+	// Routes in straight runs between wall corners over the prebuilt corner graph
+	class FMazeVisibilityGraphStrategy : public IMazeExplorationStrategy
+	{
+	public:
+		virtual EAIExplorationSystem GetSystem() const override { return EAIExplorationSystem::VisibilityGraph; }
+
+	protected:
+		virtual bool FindPathToTargetImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints) override
+		{
+			UMazeVisibilityGraphSubsystem* VisibilityGraph = UMazeVisibilityGraphSubsystem::Get(&Controller);
+			return VisibilityGraph && VisibilityGraph->FindPath(Controller.GetPawn()->GetActorLocation(), TargetLocation, OutPoints);
+		}
+
+		virtual TStatId GetExploreStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(VisibilityGraphStrategy_Explore, STATGROUP_MazeExploration); }
+		virtual TStatId GetPathStatId() const override { RETURN_QUICK_DECLARE_CYCLE_STAT(VisibilityGraphStrategy_Path, STATGROUP_MazeExploration); }
+	};
+}
+
+TUniquePtr<IMazeExplorationStrategy> IMazeExplorationStrategy::Create(EAIExplorationSystem System)
+{
+	switch (System)
+	{
+	case EAIExplorationSystem::GraphBased:
+		return MakeUnique<FMazeGraphStrategy>();
+	case EAIExplorationSystem::HierarchicalAStar:
+		return MakeUnique<FMazeHierarchicalStrategy>();
+	case EAIExplorationSystem::PotentialField:
+		return MakeUnique<FMazePotentialFieldStrategy>();
+	case EAIExplorationSystem::WallFollowing:
+		return MakeUnique<FMazeWallFollowingStrategy>();
+	case EAIExplorationSystem::VisibilityGraph:
+		return MakeUnique<FMazeVisibilityGraphStrategy>();
+	default:
+		return MakeUnique<FMazeFrontierStrategy>();
+	}
+}
+
+void IMazeExplorationStrategy::Activate(AMazeBlazeAIController& Controller)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeStrategySwitch);
+	OnActivated(Controller);
+}
+
+void IMazeExplorationStrategy::Deactivate(AMazeBlazeAIController& Controller)
+{
+	SCOPE_CYCLE_COUNTER(STAT_MazeStrategySwitch);
+	OnDeactivated(Controller);
+}
+
+bool IMazeExplorationStrategy::ChooseExplorationRoute(AMazeBlazeAIController& Controller, TArray<FVector>& OutPoints)
+{
+	FScopeCycleCounter CycleCounter(GetExploreStatId());
+	OutPoints.Reset();
+	return Controller.GetPawn() && ChooseExplorationRouteImpl(Controller, OutPoints) && OutPoints.Num() > 0;
+}
+
+bool IMazeExplorationStrategy::FindPathToTarget(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints)
+{
+	FScopeCycleCounter CycleCounter(GetPathStatId());
+	OutPoints.Reset();
+	return Controller.GetPawn() && FindPathToTargetImpl(Controller, TargetLocation, OutPoints) && OutPoints.Num() > 0;
+}
+
+bool IMazeExplorationStrategy::GetSteeringDirection(AMazeBlazeAIController& Controller, const FVector& TargetLocation, FVector& OutDirection)
+{
+	FScopeCycleCounter CycleCounter(GetPathStatId());
+	OutDirection = FVector::ZeroVector;
+	return Controller.GetPawn() && GetSteeringDirectionImpl(Controller, TargetLocation, OutDirection);
+}
+
+bool IMazeExplorationStrategy::RequestRouteMove(AAIController& Controller, const TArray<FVector>& RoutePoints)
+{
+	if (RoutePoints.Num() == 0)
+	{
+		return false;
+	}
+
+	if (RoutePoints.Num() == 1)
+	{
+		return Controller.MoveToLocation(RoutePoints[0]) != EPathFollowingRequestResult::Failed;
+	}
+
+	// A route is already a path along open corridor, so no navmesh query is needed
+	FAIMoveRequest MoveRequest(RoutePoints.Last());
+	MoveRequest.SetUsePathfinding(false);
+	FNavPathSharedPtr RoutePath = MakeShared<FNavigationPath, ESPMode::ThreadSafe>(RoutePoints);
+	return Controller.RequestMove(MoveRequest, RoutePath).IsValid();
+}
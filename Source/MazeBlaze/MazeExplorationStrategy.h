@@ -0,0 +1,61 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "MazeBlazeGameInstance.h"
+
+class AAIController;
+class AMazeBlazeAIController;
+
+DECLARE_STATS_GROUP(TEXT("MazeExploration"), STATGROUP_MazeExploration, STATCAT_Advanced);
+
+/**
+ * How an agent explores the maze and routes to its targets; one implementation per EAIExplorationSystem
+ *
+ * Every AI controller owns a strategy made by Create and may swap it at any time: the explore and
+ * move tasks ask the controller for its current strategy each time they run, so the behavior tree
+ * keeps running across a swap. The public calls time the implementation under cycle stats of the
+ * strategy's own (stat MazeExploration, and CPU events in Insights), so the call count and average
+ * of each strategy give its cost per agent decision.
+ */
+class MAZEBLAZE_API IMazeExplorationStrategy
+{
+public:
+	virtual ~IMazeExplorationStrategy() = default;
+
+	// New strategy for an exploration system
+	static TUniquePtr<IMazeExplorationStrategy> Create(EAIExplorationSystem System);
+
+	virtual EAIExplorationSystem GetSystem() const = 0;
+
+	// An agent with a pawn starts or stops using the strategy
+	void Activate(AMazeBlazeAIController& Controller);
+	void Deactivate(AMazeBlazeAIController& Controller);
+
+	// Where to explore next: a route starting at the agent, or a single point to reach over the navmesh.
+	// Returns false when the strategy has nothing to offer and simple exploration should be used
+	bool ChooseExplorationRoute(AMazeBlazeAIController& Controller, TArray<FVector>& OutPoints);
+
+	// Route from the agent to a target as a list of points (both ends included).
+	// Returns false when the strategy has no maze model of its own and the navmesh should be used
+	bool FindPathToTarget(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints);
+
+	// Direction to walk in this frame towards a target, for strategies that steer every agent along a shared
+	// field instead of handing out routes. Returns false when the strategy does not steer the agent here;
+	// a zero direction means the agent has arrived
+	bool GetSteeringDirection(AMazeBlazeAIController& Controller, const FVector& TargetLocation, FVector& OutDirection);
+
+	// Start moving along a route from ChooseExplorationRoute; returns false if the move could not start
+	static bool RequestRouteMove(AAIController& Controller, const TArray<FVector>& RoutePoints);
+
+protected:
+	virtual void OnActivated(AMazeBlazeAIController& Controller) {}
+	virtual void OnDeactivated(AMazeBlazeAIController& Controller) {}
+	virtual bool ChooseExplorationRouteImpl(AMazeBlazeAIController& Controller, TArray<FVector>& OutPoints) { return false; }
+	virtual bool FindPathToTargetImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, TArray<FVector>& OutPoints) { return false; }
+	virtual bool GetSteeringDirectionImpl(AMazeBlazeAIController& Controller, const FVector& TargetLocation, FVector& OutDirection) { return false; }
+
+	// Cycle stats the explore and path calls are counted under; steering counts as a path call
+	virtual TStatId GetExploreStatId() const = 0;
+	virtual TStatId GetPathStatId() const = 0;
+};
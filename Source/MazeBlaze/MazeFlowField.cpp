@@ -0,0 +1,245 @@
+#include "MazeFlowField.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformAtomics.h"
+
+const FIntPoint FMazeFlowField::NeighbourOffsets[8] =
+{
+	FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1),
+	FIntPoint(1, 1), FIntPoint(-1, 1), FIntPoint(1, -1), FIntPoint(-1, -1)
+};
+
+namespace
+{
+	// Frontier cells expanded by one parallel task
+	constexpr int32 FrontierChunkSize = 256;
+}
+
+void FMazeFlowField::Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable, TConstArrayView<FIntPoint> InGoals)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Walkable = InWalkable;
+	Goals = InGoals;
+	Distance.Init(Unreachable, Width * Height);
+	Directions.Init(NoDirection, Width * Height);
+	NumLevels = 0;
+	NumParallelLevels = 0;
+
+	TArray<int32> Seeds;
+	for (const FIntPoint& Goal : Goals)
+	{
+		if (IsWalkableIndex(Goal.X, Goal.Y) && Distance[Goal.Y * Width + Goal.X] != 0)
+		{
+			Distance[Goal.Y * Width + Goal.X] = 0;
+			Seeds.Add(Goal.Y * Width + Goal.X);
+		}
+	}
+
+	Propagate(Seeds);
+	ComputeDirections(0, Height - 1);
+}
+
+void FMazeFlowField::SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	if (!bWalkable)
+	{
+		// Distances can grow anywhere behind a closed cell; there is no cheaper way than starting over
+		for (const FIntPoint& Cell : Cells)
+		{
+			if (IsValidCell(Cell))
+			{
+				Walkable[Cell.Y * Width + Cell.X] = false;
+			}
+		}
+		const TArray<FIntPoint> CurrentGoals = Goals;
+		const TBitArray<> CurrentWalkable = Walkable;
+		Build(Width, Height, CurrentWalkable, CurrentGoals);
+		return;
+	}
+
+	NumLevels = 0;
+	NumParallelLevels = 0;
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (IsValidCell(Cell))
+		{
+			Walkable[Cell.Y * Width + Cell.X] = true;
+		}
+	}
+
+	// An opened cell starts one step past its best neighbour; the wavefront takes it from there
+	TArray<int32> Seeds;
+	int32 MinY = MAX_int32;
+	int32 MaxY = INDEX_NONE;
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (!IsValidCell(Cell))
+		{
+			continue;
+		}
+
+		const int32 Index = Cell.Y * Width + Cell.X;
+		int32 Best = Goals.Contains(Cell) ? 0 : Distance[Index];
+		for (int32 Direction = 0; Direction < 4; ++Direction)
+		{
+			const FIntPoint Neighbour = Cell + NeighbourOffsets[Direction];
+			if (IsWalkableIndex(Neighbour.X, Neighbour.Y) && Distance[Neighbour.Y * Width + Neighbour.X] != Unreachable)
+			{
+				Best = FMath::Min(Best, Distance[Neighbour.Y * Width + Neighbour.X] + 1);
+			}
+		}
+
+		MinY = FMath::Min(MinY, Cell.Y);
+		MaxY = FMath::Max(MaxY, Cell.Y);
+		if (Best < Distance[Index])
+		{
+			Distance[Index] = Best;
+			Seeds.Add(Index);
+		}
+	}
+
+	Propagate(Seeds);
+
+	// Seeds now holds every cell the wavefront lowered; their neighbours may have a better direction too
+	for (const int32 Index : Seeds)
+	{
+		MinY = FMath::Min(MinY, Index / Width);
+		MaxY = FMath::Max(MaxY, Index / Width);
+	}
+	if (MaxY != INDEX_NONE)
+	{
+		ComputeDirections(FMath::Max(MinY - 1, 0), FMath::Min(MaxY + 1, Height - 1));
+	}
+}
+
+void FMazeFlowField::Propagate(TArray<int32>& Seeds)
+{
+	// Seeds join the wavefront at their own level, lowest first
+	TArray<TPair<int32, int32>> SortedSeeds;
+	SortedSeeds.Reserve(Seeds.Num());
+	for (const int32 Index : Seeds)
+	{
+		SortedSeeds.Add(TPair<int32, int32>(Distance[Index], Index));
+	}
+	SortedSeeds.Sort([](const TPair<int32, int32>& A, const TPair<int32, int32>& B) { return A.Key < B.Key; });
+
+	// Every cell the wavefront reaches is handed back through Seeds
+	Seeds.Reset();
+
+	TArray<int32> Frontier;
+	TArray<TArray<int32>> ChunkFrontiers;
+	int32 NextSeed = 0;
+	int32 Level = 0;
+	while (Frontier.Num() > 0 || NextSeed < SortedSeeds.Num())
+	{
+		if (Frontier.Num() == 0)
+		{
+			Level = SortedSeeds[NextSeed].Key;
+		}
+
+		// Seeds at this level that nothing lowered in the meantime
+		while (NextSeed < SortedSeeds.Num() && SortedSeeds[NextSeed].Key <= Level)
+		{
+			if (Distance[SortedSeeds[NextSeed].Value] == SortedSeeds[NextSeed].Key)
+			{
+				Frontier.Add(SortedSeeds[NextSeed].Value);
+			}
+			++NextSeed;
+		}
+		Seeds.Append(Frontier);
+
+		const int32 NextLevel = Level + 1;
+		const int32 NumChunks = FMath::DivideAndRoundUp(Frontier.Num(), FrontierChunkSize);
+		const bool bParallel = Frontier.Num() >= MinParallelFrontier;
+		if (ChunkFrontiers.Num() < NumChunks)
+		{
+			ChunkFrontiers.SetNum(NumChunks);
+		}
+
+		ParallelFor(NumChunks, [this, &Frontier, &ChunkFrontiers, NextLevel](int32 Chunk)
+		{
+			TArray<int32>& Next = ChunkFrontiers[Chunk];
+			Next.Reset();
+			const int32 Last = FMath::Min((Chunk + 1) * FrontierChunkSize, Frontier.Num());
+			for (int32 Position = Chunk * FrontierChunkSize; Position < Last; ++Position)
+			{
+				const int32 Index = Frontier[Position];
+				const int32 X = Index % Width;
+				const int32 Y = Index / Width;
+				for (int32 Direction = 0; Direction < 4; ++Direction)
+				{
+					const int32 NeighbourX = X + NeighbourOffsets[Direction].X;
+					const int32 NeighbourY = Y + NeighbourOffsets[Direction].Y;
+					if (!IsWalkableIndex(NeighbourX, NeighbourY))
+					{
+						continue;
+					}
+
+					// Only one frontier cell wins a neighbour, so it is queued once
+					int32* NeighbourDistance = &Distance[NeighbourY * Width + NeighbourX];
+					const int32 Old = FPlatformAtomics::AtomicRead_Relaxed(NeighbourDistance);
+					if (Old > NextLevel && FPlatformAtomics::InterlockedCompareExchange(NeighbourDistance, NextLevel, Old) == Old)
+					{
+						Next.Add(NeighbourY * Width + NeighbourX);
+					}
+				}
+			}
+		}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+
+		++NumLevels;
+		NumParallelLevels += bParallel ? 1 : 0;
+
+		Frontier.Reset();
+		for (int32 Chunk = 0; Chunk < NumChunks; ++Chunk)
+		{
+			Frontier.Append(ChunkFrontiers[Chunk]);
+		}
+		Level = NextLevel;
+	}
+}
+
+void FMazeFlowField::ComputeDirections(int32 MinY, int32 MaxY)
+{
+	const int32 NumRows = MaxY - MinY + 1;
+	if (NumRows <= 0)
+	{
+		return;
+	}
+
+	const bool bParallel = NumRows * Width >= MinParallelFrontier * 4;
+	ParallelFor(NumRows, [this, MinY](int32 Row)
+	{
+		const int32 Y = MinY + Row;
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 Index = Y * Width + X;
+			Directions[Index] = NoDirection;
+			if (!Walkable[Index] || Distance[Index] == Unreachable || Distance[Index] == 0)
+			{
+				continue;
+			}
+
+			// A diagonal step saves a cell when it lands two closer; corners are never cut
+			int32 BestDistance = Distance[Index];
+			for (int32 Direction = 0; Direction < 8; ++Direction)
+			{
+				const FIntPoint& Offset = NeighbourOffsets[Direction];
+				if (!IsWalkableIndex(X + Offset.X, Y + Offset.Y))
+				{
+					continue;
+				}
+				if (Direction >= 4 && (!IsWalkableIndex(X + Offset.X, Y) || !IsWalkableIndex(X, Y + Offset.Y)))
+				{
+					continue;
+				}
+
+				const int32 NeighbourDistance = Distance[(Y + Offset.Y) * Width + X + Offset.X];
+				if (NeighbourDistance < BestDistance)
+				{
+					BestDistance = NeighbourDistance;
+					Directions[Index] = uint8(Direction);
+				}
+			}
+		}
+	}, bParallel ? EParallelForFlags::None : EParallelForFlags::ForceSingleThread);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+/**
+ * Flow field towards a set of goal cells over a walkability grid
+ *
+ * The integration field holds the walking distance (4-connected) from every cell to the nearest
+ * goal. It is filled by a level-synchronous wavefront: each level's frontier is split over task
+ * graph workers, which claim neighbours with an atomic compare-and-swap, so big open areas are
+ * expanded in parallel while narrow corridors stay on one thread. Every cell then stores the
+ * neighbour (8-connected, no corner cutting) that is closest to the goal, so an agent following
+ * the field reads one byte per step. Opening cells only lowers distances, so it restarts the
+ * wavefront from the opened cells instead of from the goals.
+ */
+class MAZEBLAZE_API FMazeFlowField
+{
+public:
+	// Distance of blocked cells and of cells no goal can be reached from
+	static constexpr int32 Unreachable = MAX_int32;
+
+	// Direction of goal cells and of cells with no way to a goal
+	static constexpr uint8 NoDirection = 0xFF;
+
+	// Fill the field for a walkability mask indexed Y * Width + X
+	void Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable, TConstArrayView<FIntPoint> InGoals);
+
+	// Change the walkability of some cells; opened cells update the field incrementally, closed cells rebuild it
+	void SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	// Walking distance to the nearest goal in cells, or Unreachable
+	int32 GetDistance(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) ? Distance[Cell.Y * Width + Cell.X] : Unreachable;
+	}
+
+	// Neighbour to step to from a cell; false on a goal cell or when no goal can be reached
+	bool GetNextCell(const FIntPoint& Cell, FIntPoint& OutNext) const
+	{
+		if (!IsValidCell(Cell) || Directions[Cell.Y * Width + Cell.X] == NoDirection)
+		{
+			return false;
+		}
+		OutNext = Cell + NeighbourOffsets[Directions[Cell.Y * Width + Cell.X]];
+		return true;
+	}
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	const TArray<FIntPoint>& GetGoals() const { return Goals; }
+
+	// Wavefront levels expanded by the last build or update, and how many of them ran on several threads
+	int32 GetNumLevels() const { return NumLevels; }
+	int32 GetNumParallelLevels() const { return NumParallelLevels; }
+
+	// Bytes used by the field
+	SIZE_T GetAllocatedSize() const
+	{
+		return sizeof(*this) + Distance.GetAllocatedSize() + Directions.GetAllocatedSize() + Walkable.GetAllocatedSize() + Goals.GetAllocatedSize();
+	}
+
+	// Frontiers smaller than this are expanded on the calling thread
+	int32 MinParallelFrontier = 512;
+
+	// The 8 neighbour offsets, cardinal ones first
+	static const FIntPoint NeighbourOffsets[8];
+
+private:
+	// Expand the wavefront from seed cells whose distance is already set, lowering every distance it reaches
+	void Propagate(TArray<int32>& Seeds);
+
+	// Pick the best neighbour of every walkable cell in rows [MinY, MaxY]
+	void ComputeDirections(int32 MinY, int32 MaxY);
+
+	bool IsWalkableIndex(int32 X, int32 Y) const
+	{
+		return X >= 0 && Y >= 0 && X < Width && Y < Height && Walkable[Y * Width + X];
+	}
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TBitArray<> Walkable;
+	TArray<FIntPoint> Goals;
+
+	// Integration field and best neighbour per cell, indexed Y * Width + X
+	TArray<int32> Distance;
+	TArray<uint8> Directions;
+
+	int32 NumLevels = 0;
+	int32 NumParallelLevels = 0;
+};
@@ -0,0 +1,139 @@
+#include "MazeFlowFieldSubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "MazeExplorationStrategy.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("FlowField Build"), STAT_MazeFlowFieldBuild, STATGROUP_MazeExploration);
+DECLARE_CYCLE_STAT(TEXT("FlowField Update"), STAT_MazeFlowFieldUpdate, STATGROUP_MazeExploration);
+
+UMazeFlowFieldSubsystem* UMazeFlowFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeFlowFieldSubsystem>() : nullptr;
+}
+
+void UMazeFlowFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazeFlowFieldSubsystem::HandleTopologyChanged);
+	}
+}
+
+void UMazeFlowFieldSubsystem::Deinitialize()
+{
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+	Fields.Empty();
+
+	Super::Deinitialize();
+}
+
+bool UMazeFlowFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+const FMazeFlowField* UMazeFlowFieldSubsystem::FindField(const FVector& Goal)
+{
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	FIntPoint GoalCell;
+	if (!Topology || !Topology->EnsureGraph() || !Topology->FindWalkableCell(Goal, GoalCell))
+	{
+		return nullptr;
+	}
+	return FindFieldForCell(GoalCell);
+}
+
+FMazeFlowField* UMazeFlowFieldSubsystem::FindFieldForCell(const FIntPoint& GoalCell)
+{
+	const uint64 Frame = GFrameCounter;
+	if (FFieldEntry* Entry = Fields.Find(GoalCell))
+	{
+		Entry->LastUsedFrame = Frame;
+		return Entry->Field.Get();
+	}
+
+	const UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Topology || !Topology->IsGraphBuilt())
+	{
+		return nullptr;
+	}
+
+	// Make room by dropping the goal nobody walked to for the longest time
+	if (Fields.Num() >= MaxFields)
+	{
+		FIntPoint Oldest = GoalCell;
+		uint64 OldestFrame = MAX_uint64;
+		for (const TPair<FIntPoint, FFieldEntry>& Pair : Fields)
+		{
+			if (Pair.Value.LastUsedFrame < OldestFrame)
+			{
+				OldestFrame = Pair.Value.LastUsedFrame;
+				Oldest = Pair.Key;
+			}
+		}
+		Fields.Remove(Oldest);
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeFlowFieldBuild);
+	const double StartTime = FPlatformTime::Seconds();
+
+	const FMazeTopologyGraph& Graph = Topology->GetGraph();
+	FFieldEntry& Entry = Fields.Add(GoalCell);
+	Entry.Field = MakeUnique<FMazeFlowField>();
+	Entry.Field->MinParallelFrontier = MinParallelFrontier;
+	Entry.Field->Build(Graph.GetWidth(), Graph.GetHeight(), Graph.GetWalkable(), MakeArrayView(&GoalCell, 1));
+	Entry.LastUsedFrame = Frame;
+
+	UE_LOG(LogTemp, Verbose, TEXT("MazeFlowField: Built field to (%d, %d) on %dx%d grid in %d levels (%d parallel) in %.2f ms"),
+		GoalCell.X, GoalCell.Y, Graph.GetWidth(), Graph.GetHeight(), Entry.Field->GetNumLevels(), Entry.Field->GetNumParallelLevels(),
+		(FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return Entry.Field.Get();
+}
+
+bool UMazeFlowFieldSubsystem::GetFlowDirection(const FVector& Goal, const FVector& Location, FVector& OutDirection, float& OutRemainingDistance)
+{
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	FIntPoint GoalCell;
+	FIntPoint Cell;
+	if (!Topology || !Topology->EnsureGraph() || !Topology->FindWalkableCell(Goal, GoalCell) || !Topology->FindWalkableCell(Location, Cell))
+	{
+		return false;
+	}
+
+	const FMazeFlowField* Field = FindFieldForCell(GoalCell);
+	const int32 CellDistance = Field ? Field->GetDistance(Cell) : FMazeFlowField::Unreachable;
+	if (CellDistance == FMazeFlowField::Unreachable)
+	{
+		return false;
+	}
+
+	// Head for the centre of the next cell, or for the goal itself once in its cell
+	FIntPoint NextCell;
+	const FVector Target = Field->GetNextCell(Cell, NextCell) ? Topology->GetCellLocation(NextCell) : Goal;
+	OutDirection = (Target - Location).GetSafeNormal2D();
+	OutRemainingDistance = CellDistance * Topology->CellSize + FVector::Dist2D(Location, Target);
+	return !OutDirection.IsNearlyZero();
+}
+
+void UMazeFlowFieldSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	// A rebuilt grid may have another size; fields are built again on the next request
+	if (Cells.Num() == 0)
+	{
+		Fields.Empty();
+		return;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeFlowFieldUpdate);
+	for (TPair<FIntPoint, FFieldEntry>& Pair : Fields)
+	{
+		Pair.Value.Field->SetCellsWalkable(Cells, bWalkable);
+	}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeFlowField.h"
+#include "MazeFlowFieldSubsystem.generated.h"
+
+/**
+ * World subsystem that shares one flow field per goal between every agent heading there
+ *
+ * Fields are built on the topology subsystem's grid the first time an agent asks for a goal and
+ * kept for the most recently used goals, so a crowd walking to the exit costs one wavefront
+ * instead of a path query per agent. Doors opening are forwarded to every field as opened cells
+ * and update it incrementally; a rebuilt topology drops the fields.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeFlowFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the flow field subsystem for the world of the given object
+	static UMazeFlowFieldSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Direction to walk from Location towards Goal (unit length, in the XY plane) and the walking distance left;
+	// false if there is no grid, Location is off it or the goal cannot be reached from there
+	bool GetFlowDirection(const FVector& Goal, const FVector& Location, FVector& OutDirection, float& OutRemainingDistance);
+
+	// Field towards a goal, built if needed; null if the topology grid is not available
+	const FMazeFlowField* FindField(const FVector& Goal);
+
+	int32 GetNumFields() const { return Fields.Num(); }
+
+	// Goals whose fields are kept; the least recently used field is dropped for a new goal
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|FlowField", meta = (ClampMin = "1"))
+	int32 MaxFields = 8;
+
+	// Wavefront frontiers smaller than this are expanded on the game thread
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|FlowField", meta = (ClampMin = "1"))
+	int32 MinParallelFrontier = 512;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FFieldEntry
+	{
+		TUniquePtr<FMazeFlowField> Field;
+		uint64 LastUsedFrame = 0;
+	};
+
+	// Field for a goal cell, built if needed
+	FMazeFlowField* FindFieldForCell(const FIntPoint& GoalCell);
+
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Fields keyed by goal cell
+	TMap<FIntPoint, FFieldEntry> Fields;
+
+	FDelegateHandle TopologyChangedHandle;
+};
@@ -0,0 +1,144 @@
+#include "MazeFrontierExplorationComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+
+UMazeFrontierExplorationComponent::UMazeFrontierExplorationComponent()
+{
+	// Ticking is enabled the first time the map is used
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+	PrimaryComponentTick.TickInterval = 0.1f;
+
+	LastSensedCell = FIntPoint::ZeroValue;
+	bHasSensed = false;
+}
+
+void UMazeFrontierExplorationComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	UpdateMap();
+}
+
+APawn* UMazeFrontierExplorationComponent::GetAgentPawn() const
+{
+	if (const AController* Controller = Cast<AController>(GetOwner()))
+	{
+		return Controller->GetPawn();
+	}
+	return Cast<APawn>(GetOwner());
+}
+
+bool UMazeFrontierExplorationComponent::UpdateMap()
+{
+	APawn* Pawn = GetAgentPawn();
+	UWorld* World = GetWorld();
+	if (!Pawn || !World)
+	{
+		return false;
+	}
+
+	const FVector AgentLocation = Pawn->GetActorLocation();
+
+	if (!Grid.IsInitialized())
+	{
+		Grid.Initialize(AgentLocation, CellSize, GridSize, GridSize);
+		Explorer.Reset();
+		SetComponentTickEnabled(true);
+	}
+
+	// Only sense again once the agent reaches a new cell
+	const FIntPoint AgentCell = Grid.WorldToCell(AgentLocation);
+	if (bHasSensed && AgentCell == LastSensedCell)
+	{
+		return false;
+	}
+	LastSensedCell = AgentCell;
+	bHasSensed = true;
+
+	// Walls are static geometry, closed doors are dynamic; open doors have no collision
+	FCollisionObjectQueryParams ObjectParams;
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldStatic);
+	ObjectParams.AddObjectTypesToQuery(ECC_WorldDynamic);
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MazeFrontierSensor), false, Pawn);
+
+	int32 NumChanged = 0;
+	for (int32 RayIndex = 0; RayIndex < NumSensorRays; ++RayIndex)
+	{
+		const float Angle = 2.0f * PI * RayIndex / NumSensorRays;
+		const FVector Direction(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+		const FVector RayEnd = AgentLocation + Direction * SensorRange;
+
+		FHitResult Hit;
+		if (World->LineTraceSingleByObjectType(Hit, AgentLocation, RayEnd, ObjectParams, QueryParams))
+		{
+			// Nudge the impact point into the wall so the blocked cell is the wall's, not the corridor's
+			const FIntPoint HitCell = Grid.WorldToCell(Hit.ImpactPoint + Direction * 1.0f);
+			NumChanged += Grid.IntegrateRay(AgentCell, HitCell, true);
+		}
+		else
+		{
+			NumChanged += Grid.IntegrateRay(AgentCell, Grid.WorldToCell(RayEnd), false);
+		}
+	}
+
+	return NumChanged > 0;
+}
+
+bool UMazeFrontierExplorationComponent::ChooseTarget(FVector& OutTarget)
+{
+	UpdateMap();
+
+	APawn* Pawn = GetAgentPawn();
+	if (!Pawn || !Grid.IsInitialized())
+	{
+		return false;
+	}
+
+	Explorer.Params.MinClusterSize = MinClusterSize;
+	Explorer.Params.GainWeight = GainWeight;
+	Explorer.Params.DistanceWeight = DistanceWeight;
+	Explorer.Params.TargetHysteresis = TargetHysteresis;
+
+	const FVector AgentLocation = Pawn->GetActorLocation();
+	FIntPoint TargetCell;
+	if (!Explorer.SelectTarget(Grid, Grid.WorldToCell(AgentLocation), TargetCell))
+	{
+		return false;
+	}
+
+	OutTarget = Grid.CellToWorld(TargetCell, AgentLocation.Z);
+	return true;
+}
+
+void UMazeFrontierExplorationComponent::ResetMap()
+{
+	Grid = FMazeOccupancyGrid();
+	Explorer.Reset();
+	bHasSensed = false;
+	SetComponentTickEnabled(false);
+}
+
+void UMazeFrontierExplorationComponent::DrawDebugFrontiers(float Duration) const
+{
+	APawn* Pawn = GetAgentPawn();
+	if (!Pawn || !GetWorld() || !Grid.IsInitialized())
+	{
+		return;
+	}
+
+	const float Z = Pawn->GetActorLocation().Z;
+	const FVector Extent(Grid.GetCellSize() * 0.4f, Grid.GetCellSize() * 0.4f, 5.0f);
+
+	for (TConstSetBitIterator<> It(Grid.GetFrontierBits()); It; ++It)
+	{
+		DrawDebugSolidBox(GetWorld(), Grid.CellToWorld(Grid.ToCell(It.GetIndex()), Z), Extent, FColor(255, 160, 0, 96), false, Duration);
+	}
+
+	if (Explorer.HasTarget())
+	{
+		DrawDebugSphere(GetWorld(), Grid.CellToWorld(Explorer.GetCurrentTarget(), Z), 40.0f, 8, FColor::Orange, false, Duration);
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "MazeOccupancyGrid.h"
+#include "MazeFrontierExplorer.h"
+#include "MazeFrontierExplorationComponent.generated.h"
+
+/**
+ * Per-agent memory for frontier-based exploration
+ *
+ * Owns the agent's occupancy grid and updates it incrementally with a fan of line traces
+ * every time the pawn enters a new cell. The grid is created lazily on first use and the
+ * component only ticks from then on, so it costs nothing in the other exploration modes.
+ * Can be attached to an AI controller (the controlled pawn is used) or to a pawn.
+ */
+UCLASS(ClassGroup = AI, meta = (BlueprintSpawnableComponent))
+class MAZEBLAZE_API UMazeFrontierExplorationComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMazeFrontierExplorationComponent();
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	// Sense the surroundings if the agent moved to a new cell; returns true if the map changed
+	UFUNCTION(BlueprintCallable, Category = "Exploration|Frontier")
+	bool UpdateMap();
+
+	// Choose the next frontier to explore; false when there is no reachable frontier left
+	UFUNCTION(BlueprintCallable, Category = "Exploration|Frontier")
+	bool ChooseTarget(FVector& OutTarget);
+
+	// Forget everything explored so far
+	UFUNCTION(BlueprintCallable, Category = "Exploration|Frontier")
+	void ResetMap();
+
+	// Number of cells seen free so far
+	UFUNCTION(BlueprintPure, Category = "Exploration|Frontier")
+	int32 GetNumExploredCells() const { return Grid.GetNumFreeCells(); }
+
+	// Draw the frontier cells and the current target
+	UFUNCTION(BlueprintCallable, Category = "Exploration|Frontier")
+	void DrawDebugFrontiers(float Duration = 0.0f) const;
+
+	const FMazeOccupancyGrid& GetGrid() const { return Grid; }
+
+	// Size of a grid cell; should be well below the maze corridor width
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "10.0"))
+	float CellSize = 100.0f;
+
+	// Number of cells along each side of the grid, centred on the first sensed location
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "8"))
+	int32 GridSize = 256;
+
+	// Length of the sensor rays
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "0.0"))
+	float SensorRange = 1500.0f;
+
+	// Number of sensor rays cast in a circle around the agent
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "4"))
+	int32 NumSensorRays = 32;
+
+	// Frontier clustering and target selection
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "1"))
+	int32 MinClusterSize = 3;
+
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "0.0"))
+	float GainWeight = 1.0f;
+
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "0.0"))
+	float DistanceWeight = 0.5f;
+
+	UPROPERTY(EditAnywhere, Category = "Exploration|Frontier", meta = (ClampMin = "0.0"))
+	float TargetHysteresis = 5.0f;
+
+private:
+	// The pawn whose surroundings are mapped
+	APawn* GetAgentPawn() const;
+
+	FMazeOccupancyGrid Grid;
+	FMazeFrontierExplorer Explorer;
+
+	// Cell of the last sensor sweep
+	FIntPoint LastSensedCell;
+	bool bHasSensed;
+};
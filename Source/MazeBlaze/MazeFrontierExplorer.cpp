@@ -0,0 +1,211 @@
+#include "MazeFrontierExplorer.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	const FIntPoint NeighbourOffsets[] = {
+		FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1),
+		FIntPoint(1, 1), FIntPoint(1, -1), FIntPoint(-1, 1), FIntPoint(-1, -1) };
+}
+
+void FMazeFrontierExplorer::Reset()
+{
+	Distances.Reset();
+	VisitedCells.Reset();
+	ClusterLabels.Reset();
+	LabelledCells.Reset();
+	FloodStack.Reset();
+	Clusters.Reset();
+	bHasTarget = false;
+}
+
+bool FMazeFrontierExplorer::SelectTarget(const FMazeOccupancyGrid& Grid, const FIntPoint& AgentCell, FIntPoint& OutTarget)
+{
+	if (Distances.Num() != Grid.GetNumCells())
+	{
+		Reset();
+		Distances.Init(INDEX_NONE, Grid.GetNumCells());
+		ClusterLabels.Init(INDEX_NONE, Grid.GetNumCells());
+	}
+
+	ComputeDistances(Grid, AgentCell);
+	BuildClusters(Grid);
+
+	const FMazeFrontierCluster* BestCluster = nullptr;
+	bool bBestIsLarge = false;
+
+	for (const FMazeFrontierCluster& Cluster : Clusters)
+	{
+		// Small clusters are mostly sensor noise along walls; only use them as a last resort
+		const bool bIsLarge = Cluster.Size >= Params.MinClusterSize;
+		if (!BestCluster || (bIsLarge && !bBestIsLarge) || (bIsLarge == bBestIsLarge && Cluster.Score > BestCluster->Score))
+		{
+			BestCluster = &Cluster;
+			bBestIsLarge = bIsLarge;
+		}
+	}
+
+	bHasTarget = BestCluster != nullptr;
+	if (bHasTarget)
+	{
+		CurrentTarget = BestCluster->GoalCell;
+		OutTarget = CurrentTarget;
+	}
+
+	return bHasTarget;
+}
+
+bool FMazeFrontierExplorer::FindPath(const FMazeOccupancyGrid& Grid, const FIntPoint& Target, TArray<FIntPoint>& OutPath) const
+{
+	OutPath.Reset();
+
+	if (!Grid.IsValidCell(Target) || !Distances.IsValidIndex(Grid.ToIndex(Target)) || Distances[Grid.ToIndex(Target)] == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// Walk back down the distance field from the target to the agent
+	FIntPoint Cell = Target;
+	int32 Distance = Distances[Grid.ToIndex(Cell)];
+	while (Distance > 0)
+	{
+		OutPath.Add(Cell);
+
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Neighbour = Cell + Offset;
+			if (Grid.IsValidCell(Neighbour) && Distances[Grid.ToIndex(Neighbour)] == Distance - 1)
+			{
+				Cell = Neighbour;
+				break;
+			}
+		}
+		--Distance;
+	}
+
+	Algo::Reverse(OutPath);
+	return true;
+}
+
+void FMazeFrontierExplorer::ComputeDistances(const FMazeOccupancyGrid& Grid, const FIntPoint& AgentCell)
+{
+	for (const int32 Index : VisitedCells)
+	{
+		Distances[Index] = INDEX_NONE;
+	}
+	VisitedCells.Reset();
+
+	if (!Grid.IsValidCell(AgentCell))
+	{
+		return;
+	}
+
+	// The agent cell itself may not be known yet (e.g. standing next to a wall)
+	Distances[Grid.ToIndex(AgentCell)] = 0;
+	VisitedCells.Add(Grid.ToIndex(AgentCell));
+
+	// VisitedCells doubles as the BFS queue
+	for (int32 Head = 0; Head < VisitedCells.Num(); ++Head)
+	{
+		const int32 Index = VisitedCells[Head];
+		const FIntPoint Cell = Grid.ToCell(Index);
+		const int32 NextDistance = Distances[Index] + 1;
+
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Neighbour = Cell + Offset;
+			if (Grid.GetState(Neighbour) != EMazeCellState::Free)
+			{
+				continue;
+			}
+
+			const int32 NeighbourIndex = Grid.ToIndex(Neighbour);
+			if (Distances[NeighbourIndex] == INDEX_NONE)
+			{
+				Distances[NeighbourIndex] = NextDistance;
+				VisitedCells.Add(NeighbourIndex);
+			}
+		}
+	}
+}
+
+void FMazeFrontierExplorer::BuildClusters(const FMazeOccupancyGrid& Grid)
+{
+	for (const int32 Index : LabelledCells)
+	{
+		ClusterLabels[Index] = INDEX_NONE;
+	}
+	LabelledCells.Reset();
+	Clusters.Reset();
+	int32 NumLabels = 0;
+
+	const TBitArray<>& FrontierBits = Grid.GetFrontierBits();
+	const int32 TargetIndex = bHasTarget && Grid.IsValidCell(CurrentTarget) ? Grid.ToIndex(CurrentTarget) : INDEX_NONE;
+
+	for (TConstSetBitIterator<> It(FrontierBits); It; ++It)
+	{
+		const int32 SeedIndex = It.GetIndex();
+		if (ClusterLabels[SeedIndex] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		// Flood fill the 8-connected frontier cells of this cluster
+		const int32 Label = NumLabels++;
+		FMazeFrontierCluster Cluster;
+		Cluster.Distance = MAX_int32;
+		bool bContainsTarget = false;
+
+		ClusterLabels[SeedIndex] = Label;
+		LabelledCells.Add(SeedIndex);
+		FloodStack.Reset();
+		FloodStack.Add(SeedIndex);
+
+		while (FloodStack.Num() > 0)
+		{
+			const int32 Index = FloodStack.Pop(EAllowShrinking::No);
+			const FIntPoint Cell = Grid.ToCell(Index);
+			Cluster.Size++;
+			bContainsTarget |= Index == TargetIndex;
+
+			// The agent's own cell is never a goal, it would not make the agent move
+			if (Distances[Index] > 0 && Distances[Index] < Cluster.Distance)
+			{
+				Cluster.Distance = Distances[Index];
+				Cluster.GoalCell = Cell;
+			}
+
+			for (const FIntPoint& Offset : NeighbourOffsets)
+			{
+				const FIntPoint Neighbour = Cell + Offset;
+				if (!Grid.IsFrontier(Neighbour))
+				{
+					continue;
+				}
+
+				const int32 NeighbourIndex = Grid.ToIndex(Neighbour);
+				if (ClusterLabels[NeighbourIndex] == INDEX_NONE)
+				{
+					ClusterLabels[NeighbourIndex] = Label;
+					LabelledCells.Add(NeighbourIndex);
+					FloodStack.Add(NeighbourIndex);
+				}
+			}
+		}
+
+		// Clusters the agent cannot reach through known free space are not candidates
+		if (Cluster.Distance == MAX_int32)
+		{
+			continue;
+		}
+
+		Cluster.Score = Params.GainWeight * Cluster.Size - Params.DistanceWeight * Cluster.Distance;
+		if (bContainsTarget)
+		{
+			Cluster.Score += Params.TargetHysteresis;
+		}
+		Clusters.Add(Cluster);
+	}
+}
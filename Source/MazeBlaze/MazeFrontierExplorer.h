@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MazeOccupancyGrid.h"
+
+// A connected group of frontier cells
+struct FMazeFrontierCluster
+{
+	// Reachable frontier cell of the cluster closest to the agent
+	FIntPoint GoalCell = FIntPoint::ZeroValue;
+
+	// Number of frontier cells, used as the expected information gain
+	int32 Size = 0;
+
+	// Path length in cells from the agent to GoalCell
+	int32 Distance = 0;
+
+	float Score = 0.0f;
+};
+
+// Tuning of the frontier target selection
+struct FMazeFrontierParams
+{
+	// Clusters smaller than this are only used when nothing bigger is reachable
+	int32 MinClusterSize = 3;
+
+	// Score = GainWeight * Size - DistanceWeight * Distance
+	float GainWeight = 1.0f;
+	float DistanceWeight = 0.5f;
+
+	// Score bonus for the cluster of the current target, so the agent doesn't flip between targets
+	float TargetHysteresis = 5.0f;
+};
+
+/**
+ * Frontier-based exploration over an occupancy grid
+ *
+ * Frontier cells are grouped into 8-connected clusters, a breadth-first search over known
+ * free cells gives the path cost to each cluster, and the cluster with the best
+ * gain/cost score becomes the next exploration target.
+ */
+class MAZEBLAZE_API FMazeFrontierExplorer
+{
+public:
+	FMazeFrontierExplorer() = default;
+	explicit FMazeFrontierExplorer(const FMazeFrontierParams& InParams) : Params(InParams) {}
+
+	FMazeFrontierParams Params;
+
+	// Pick the best frontier cell to explore from AgentCell; false when no frontier is reachable
+	bool SelectTarget(const FMazeOccupancyGrid& Grid, const FIntPoint& AgentCell, FIntPoint& OutTarget);
+
+	// Path from the agent cell of the last SelectTarget call to a reachable cell (agent cell excluded)
+	bool FindPath(const FMazeOccupancyGrid& Grid, const FIntPoint& Target, TArray<FIntPoint>& OutPath) const;
+
+	// Clusters found by the last SelectTarget call
+	const TArray<FMazeFrontierCluster>& GetClusters() const { return Clusters; }
+
+	bool HasTarget() const { return bHasTarget; }
+	const FIntPoint& GetCurrentTarget() const { return CurrentTarget; }
+
+	// Forget the current target and search buffers (e.g. when the grid is reinitialised)
+	void Reset();
+
+private:
+	// Breadth-first search over free cells from the agent
+	void ComputeDistances(const FMazeOccupancyGrid& Grid, const FIntPoint& AgentCell);
+
+	// Group frontier cells into clusters and score them
+	void BuildClusters(const FMazeOccupancyGrid& Grid);
+
+	// Path length per cell, INDEX_NONE when not reached; only the visited cells are reset between searches
+	TArray<int32> Distances;
+	TArray<int32> VisitedCells;
+
+	// Cluster label per cell, INDEX_NONE when unlabelled
+	TArray<int32> ClusterLabels;
+	TArray<int32> LabelledCells;
+	TArray<int32> FloodStack;
+
+	TArray<FMazeFrontierCluster> Clusters;
+
+	FIntPoint CurrentTarget = FIntPoint::ZeroValue;
+	bool bHasTarget = false;
+};
@@ -1,6 +1,9 @@
 #include "MazeGameDoor.h"
 #include "MazeBlazeCharacter.h"
 #include "MazeBlazeKey.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeCoreTypes.h"
+#include "Perception/AISense_Sight.h"
 
 AMazeGameDoor::AMazeGameDoor()
 {
@@ -24,6 +27,34 @@ AMazeGameDoor::AMazeGameDoor()
 
 	InteractionPointB = CreateDefaultSubobject<USceneComponent>(TEXT("InteractionPointB"));
 	InteractionPointB->SetupAttachment(RootComponent);
+
+	StimuliSource = CreateDefaultSubobject<UAIPerceptionStimuliSourceComponent>(TEXT("StimuliSource"));
+	StimuliSource->RegisterForSense(UAISense_Sight::StaticClass());
+}
+
+void AMazeGameDoor::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->RegisterDoor(this);
+	}
+
+	if (StimuliSource && !bIsOpen)
+	{
+		StimuliSource->RegisterWithPerceptionSystem();
+	}
+}
+
+void AMazeGameDoor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->UnregisterDoor(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 bool AMazeGameDoor::IsOpen() const
@@ -31,14 +62,18 @@ bool AMazeGameDoor::IsOpen() const
 	return bIsOpen;
 }
 
+int32 AMazeGameDoor::GetMask() const
+{
+	return Mask;
+}
+
 bool AMazeGameDoor::CanBeOpenedByKey(const AMazeBlazeKey* Key) const
 {
 	if (!Key)
 	{
 		return false;
 	}
-	const int32 Signature = Key->GetSignature();
-	return Signature & Mask;
+	return MazeCore::CanKeyOpenDoor(Key->GetSignature(), Mask);
 }
 
 void AMazeGameDoor::GetInteractionPoints_Implementation(TArray<FVector>& OutInteractionPoints) const
@@ -81,5 +116,18 @@ void AMazeGameDoor::InteractWith_Implementation(AMazeBlazeCharacter* Character)
 		Mesh->SetCollisionEnabled(ECollisionEnabled::NoCollision);
 		Mesh->SetVisibility(false);
 	}
+
+	// Open doors are no longer of interest to the AI
+	if (StimuliSource)
+	{
+		StimuliSource->UnregisterFromPerceptionSystem();
+	}
+
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->NotifyDoorOpened(this);
+	}
+
+	Character->OnOpenDoor.Broadcast(this);
 }
 
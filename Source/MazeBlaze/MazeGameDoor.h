@@ -2,6 +2,7 @@
 #include "MazeBlazeCharacter.h"
 #include "MazeBlazeInteractableInterface.h"
 #include "Components/BoxComponent.h"
+#include "Perception/AIPerceptionStimuliSourceComponent.h"
 #include "MazeGameDoor.generated.h"
 
 UCLASS()
@@ -13,12 +14,18 @@ public:
 
 	AMazeGameDoor();
 
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = MazeGameDoor)
 	bool IsOpen() const;
 
 	UFUNCTION(BlueprintCallable, BlueprintPure, Category = MazeGameDoor)
 	bool CanBeOpenedByKey(const AMazeBlazeKey* Key) const;
 
+	UFUNCTION(BlueprintCallable, BlueprintPure, Category = MazeGameDoor)
+	int32 GetMask() const;
+
 	virtual void GetInteractionPoints_Implementation(TArray<FVector>& OutInteractionPoints) const override;
 	virtual bool CanInteractWith_Implementation(const AMazeBlazeCharacter* Character) const override;
 	virtual void InteractWith_Implementation(AMazeBlazeCharacter* Character) override;
@@ -37,6 +44,10 @@ protected:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameDoor)
 	USceneComponent* InteractionPointB;
 
+	// Makes the door visible to the AI sight sense while it is closed
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = MazeGameDoor)
+	UAIPerceptionStimuliSourceComponent* StimuliSource;
+
 	UPROPERTY()
 	bool bIsOpen = false;
 
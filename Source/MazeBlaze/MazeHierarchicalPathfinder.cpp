@@ -0,0 +1,510 @@
+#include "MazeHierarchicalPathfinder.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	// Border runs at least this long get an entrance at each end instead of one in the middle
+	const int32 LongRunLength = 6;
+
+	struct FOpenEntrance
+	{
+		int32 Entrance;
+		int32 Cost;
+		int32 Estimate;
+	};
+
+	struct FOpenEntrancePredicate
+	{
+		bool operator()(const FOpenEntrance& A, const FOpenEntrance& B) const
+		{
+			return A.Estimate < B.Estimate;
+		}
+	};
+}
+
+void FMazeHierarchicalPathfinder::Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable, int32 InSectorSize)
+{
+	check(InWalkable.Num() == InWidth * InHeight);
+
+	Width = InWidth;
+	Height = InHeight;
+	Walkable = InWalkable;
+	SectorSize = FMath::Max(InSectorSize, 2);
+	SectorsX = FMath::DivideAndRoundUp(Width, SectorSize);
+	SectorsY = FMath::DivideAndRoundUp(Height, SectorSize);
+
+	Entrances.Reset();
+	FreeEntrances.Reset();
+	SectorEntrances.Reset();
+	SectorEntrances.SetNum(SectorsX * SectorsY);
+	BorderEntrances.Reset();
+	BorderEntrances.SetNum(SectorsX * SectorsY * 2);
+	PathCache.Reset();
+	ResetCacheStats();
+
+	LocalDistance.Init(INDEX_NONE, SectorSize * SectorSize);
+	LocalParent.SetNumUninitialized(SectorSize * SectorSize);
+	LocalVisited.Reset();
+	SearchCost.Reset();
+	SearchParent.Reset();
+	SearchTouched.Reset();
+
+	for (int32 Border = 0; Border < BorderEntrances.Num(); ++Border)
+	{
+		BuildBorder(Border);
+	}
+	for (int32 Sector = 0; Sector < SectorEntrances.Num(); ++Sector)
+	{
+		BuildSectorEdges(Sector);
+	}
+}
+
+void FMazeHierarchicalPathfinder::SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	TArray<int32, TInlineAllocator<8>> ChangedSectors;
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (IsValidCell(Cell))
+		{
+			Walkable[Cell.Y * Width + Cell.X] = bWalkable;
+			ChangedSectors.AddUnique(GetSector(Cell));
+		}
+	}
+
+	// Entrances on the borders of a changed sector may move, which changes the neighbour's costs too
+	TArray<int32, TInlineAllocator<32>> Borders;
+	TArray<int32, TInlineAllocator<32>> SectorsToRebuild(ChangedSectors);
+	for (const int32 Sector : ChangedSectors)
+	{
+		const int32 SectorX = Sector % SectorsX;
+		const int32 SectorY = Sector / SectorsX;
+
+		if (SectorX + 1 < SectorsX)
+		{
+			Borders.AddUnique(Sector * 2);
+			SectorsToRebuild.AddUnique(Sector + 1);
+		}
+		if (SectorY + 1 < SectorsY)
+		{
+			Borders.AddUnique(Sector * 2 + 1);
+			SectorsToRebuild.AddUnique(Sector + SectorsX);
+		}
+		if (SectorX > 0)
+		{
+			Borders.AddUnique((Sector - 1) * 2);
+			SectorsToRebuild.AddUnique(Sector - 1);
+		}
+		if (SectorY > 0)
+		{
+			Borders.AddUnique((Sector - SectorsX) * 2 + 1);
+			SectorsToRebuild.AddUnique(Sector - SectorsX);
+		}
+	}
+
+	for (const int32 Sector : SectorsToRebuild)
+	{
+		ClearSectorEdges(Sector);
+	}
+	for (const int32 Border : Borders)
+	{
+		RemoveBorder(Border);
+	}
+	for (const int32 Border : Borders)
+	{
+		BuildBorder(Border);
+	}
+	for (const int32 Sector : SectorsToRebuild)
+	{
+		BuildSectorEdges(Sector);
+	}
+}
+
+int32 FMazeHierarchicalPathfinder::FindPath(const FIntPoint& From, const FIntPoint& To, TArray<FIntPoint>* OutCells)
+{
+	if (OutCells)
+	{
+		OutCells->Reset();
+	}
+
+	if (!IsWalkable(From) || !IsWalkable(To))
+	{
+		return INDEX_NONE;
+	}
+	if (From == To)
+	{
+		return 0;
+	}
+
+	const int32 FromSector = GetSector(From);
+	const int32 ToSector = GetSector(To);
+	int32 BestCost = MAX_int32;
+	int32 BestEntrance = INDEX_NONE;
+
+	// Connect the start to the entrances of its sector; a path inside the sector is a candidate too
+	SearchSector(FromSector, From);
+	if (FromSector == ToSector && GetSearchDistance(To) != INDEX_NONE)
+	{
+		BestCost = GetSearchDistance(To);
+	}
+
+	TArray<int32, TInlineAllocator<32>> StartCosts;
+	for (const int32 Entrance : SectorEntrances[FromSector])
+	{
+		StartCosts.Add(GetSearchDistance(Entrances[Entrance].Cell));
+	}
+
+	TArray<int32, TInlineAllocator<32>> GoalCosts;
+	SearchSector(ToSector, To);
+	for (const int32 Entrance : SectorEntrances[ToSector])
+	{
+		GoalCosts.Add(GetSearchDistance(Entrances[Entrance].Cell));
+	}
+
+	if (SearchCost.Num() != Entrances.Num())
+	{
+		SearchCost.Init(INDEX_NONE, Entrances.Num());
+		SearchParent.SetNumUninitialized(Entrances.Num());
+		SearchTouched.Reset();
+	}
+
+	TArray<FOpenEntrance, TInlineAllocator<64>> OpenList;
+	auto Relax = [&](int32 Entrance, int32 Cost, int32 Parent)
+	{
+		if (SearchCost[Entrance] != INDEX_NONE && SearchCost[Entrance] <= Cost)
+		{
+			return;
+		}
+		if (SearchCost[Entrance] == INDEX_NONE)
+		{
+			SearchTouched.Add(Entrance);
+		}
+		SearchCost[Entrance] = Cost;
+		SearchParent[Entrance] = Parent;
+
+		const FIntPoint& Cell = Entrances[Entrance].Cell;
+		const int32 Estimate = Cost + FMath::Abs(Cell.X - To.X) + FMath::Abs(Cell.Y - To.Y);
+		OpenList.HeapPush(FOpenEntrance{ Entrance, Cost, Estimate }, FOpenEntrancePredicate());
+	};
+
+	for (int32 Index = 0; Index < StartCosts.Num(); ++Index)
+	{
+		if (StartCosts[Index] != INDEX_NONE)
+		{
+			Relax(SectorEntrances[FromSector][Index], StartCosts[Index], INDEX_NONE);
+		}
+	}
+
+	while (OpenList.Num() > 0)
+	{
+		FOpenEntrance Open;
+		OpenList.HeapPop(Open, FOpenEntrancePredicate(), EAllowShrinking::No);
+
+		if (Open.Estimate >= BestCost)
+		{
+			break;
+		}
+		if (Open.Cost != SearchCost[Open.Entrance])
+		{
+			continue;
+		}
+
+		if (Entrances[Open.Entrance].Sector == ToSector)
+		{
+			const int32 GoalIndex = SectorEntrances[ToSector].Find(Open.Entrance);
+			if (GoalCosts[GoalIndex] != INDEX_NONE && Open.Cost + GoalCosts[GoalIndex] < BestCost)
+			{
+				BestCost = Open.Cost + GoalCosts[GoalIndex];
+				BestEntrance = Open.Entrance;
+			}
+		}
+
+		for (const FAbstractEdge& Edge : Entrances[Open.Entrance].Edges)
+		{
+			Relax(Edge.Entrance, Open.Cost + Edge.Cost, Open.Entrance);
+		}
+	}
+
+	if (OutCells && BestCost != MAX_int32)
+	{
+		if (BestEntrance == INDEX_NONE)
+		{
+			SearchSector(FromSector, From);
+			AppendSearchPath(To, *OutCells);
+		}
+		else
+		{
+			TArray<int32, TInlineAllocator<64>> Chain;
+			for (int32 Entrance = BestEntrance; Entrance != INDEX_NONE; Entrance = SearchParent[Entrance])
+			{
+				Chain.Add(Entrance);
+			}
+			Algo::Reverse(Chain);
+
+			SearchSector(FromSector, From);
+			AppendSearchPath(Entrances[Chain[0]].Cell, *OutCells);
+
+			// Crossing a border is a single step, moving inside a sector uses the cached refinement
+			for (int32 Index = 1; Index < Chain.Num(); ++Index)
+			{
+				if (Entrances[Chain[Index - 1]].Sector == Entrances[Chain[Index]].Sector)
+				{
+					AppendEntrancePath(Chain[Index - 1], Chain[Index], *OutCells);
+				}
+				else
+				{
+					OutCells->Add(Entrances[Chain[Index]].Cell);
+				}
+			}
+
+			SearchSector(ToSector, Entrances[BestEntrance].Cell);
+			AppendSearchPath(To, *OutCells);
+		}
+	}
+
+	for (const int32 Entrance : SearchTouched)
+	{
+		SearchCost[Entrance] = INDEX_NONE;
+	}
+	SearchTouched.Reset();
+
+	return BestCost == MAX_int32 ? INDEX_NONE : BestCost;
+}
+
+void FMazeHierarchicalPathfinder::GetSectorBounds(int32 Sector, FIntPoint& OutMin, FIntPoint& OutMax) const
+{
+	OutMin = FIntPoint((Sector % SectorsX) * SectorSize, (Sector / SectorsX) * SectorSize);
+	OutMax = FIntPoint(FMath::Min(OutMin.X + SectorSize, Width), FMath::Min(OutMin.Y + SectorSize, Height));
+}
+
+void FMazeHierarchicalPathfinder::BuildBorder(int32 Border)
+{
+	const int32 Sector = Border / 2;
+	const bool bEastBorder = Border % 2 == 0;
+
+	FIntPoint Min;
+	FIntPoint Max;
+	GetSectorBounds(Sector, Min, Max);
+
+	int32 OtherSector;
+	FIntPoint First;
+	FIntPoint Along;
+	FIntPoint Across;
+	int32 Length;
+	if (bEastBorder)
+	{
+		if (Sector % SectorsX + 1 >= SectorsX)
+		{
+			return;
+		}
+		OtherSector = Sector + 1;
+		First = FIntPoint(Max.X - 1, Min.Y);
+		Along = FIntPoint(0, 1);
+		Across = FIntPoint(1, 0);
+		Length = Max.Y - Min.Y;
+	}
+	else
+	{
+		if (Sector / SectorsX + 1 >= SectorsY)
+		{
+			return;
+		}
+		OtherSector = Sector + SectorsX;
+		First = FIntPoint(Min.X, Max.Y - 1);
+		Along = FIntPoint(1, 0);
+		Across = FIntPoint(0, 1);
+		Length = Max.X - Min.X;
+	}
+
+	auto AddTransition = [&](int32 Offset)
+	{
+		const FIntPoint Inner = First + Along * Offset;
+		const int32 InnerEntrance = AddEntrance(Inner, Sector, Border);
+		const int32 OuterEntrance = AddEntrance(Inner + Across, OtherSector, Border);
+		Entrances[InnerEntrance].Edges.Add(FAbstractEdge{ OuterEntrance, 1 });
+		Entrances[OuterEntrance].Edges.Add(FAbstractEdge{ InnerEntrance, 1 });
+	};
+
+	// One transition per run of cells open on both sides of the border
+	int32 RunStart = INDEX_NONE;
+	for (int32 Offset = 0; Offset <= Length; ++Offset)
+	{
+		const FIntPoint Inner = First + Along * Offset;
+		const bool bOpen = Offset < Length && IsWalkable(Inner) && IsWalkable(Inner + Across);
+		if (bOpen && RunStart == INDEX_NONE)
+		{
+			RunStart = Offset;
+		}
+		else if (!bOpen && RunStart != INDEX_NONE)
+		{
+			const int32 RunLength = Offset - RunStart;
+			if (RunLength < LongRunLength)
+			{
+				AddTransition(RunStart + RunLength / 2);
+			}
+			else
+			{
+				AddTransition(RunStart);
+				AddTransition(Offset - 1);
+			}
+			RunStart = INDEX_NONE;
+		}
+	}
+}
+
+void FMazeHierarchicalPathfinder::RemoveBorder(int32 Border)
+{
+	for (const int32 Entrance : BorderEntrances[Border])
+	{
+		FEntrance& Removed = Entrances[Entrance];
+		SectorEntrances[Removed.Sector].RemoveSingleSwap(Entrance, EAllowShrinking::No);
+		Removed.Edges.Reset();
+		Removed.bAlive = false;
+		FreeEntrances.Add(Entrance);
+	}
+	BorderEntrances[Border].Reset();
+}
+
+void FMazeHierarchicalPathfinder::BuildSectorEdges(int32 Sector)
+{
+	const TArray<int32>& SectorList = SectorEntrances[Sector];
+	for (const int32 From : SectorList)
+	{
+		SearchSector(Sector, Entrances[From].Cell);
+		for (const int32 To : SectorList)
+		{
+			const int32 Distance = GetSearchDistance(Entrances[To].Cell);
+			if (To != From && Distance != INDEX_NONE)
+			{
+				Entrances[From].Edges.Add(FAbstractEdge{ To, Distance });
+			}
+		}
+	}
+}
+
+void FMazeHierarchicalPathfinder::ClearSectorEdges(int32 Sector)
+{
+	const TArray<int32>& SectorList = SectorEntrances[Sector];
+	for (const int32 From : SectorList)
+	{
+		for (const int32 To : SectorList)
+		{
+			PathCache.Remove(MakeCacheKey(From, To));
+		}
+
+		Entrances[From].Edges.RemoveAll([this, Sector](const FAbstractEdge& Edge)
+		{
+			return Entrances[Edge.Entrance].Sector == Sector;
+		});
+	}
+}
+
+int32 FMazeHierarchicalPathfinder::AddEntrance(const FIntPoint& Cell, int32 Sector, int32 Border)
+{
+	const int32 Index = FreeEntrances.Num() > 0 ? FreeEntrances.Pop(EAllowShrinking::No) : Entrances.AddDefaulted();
+	FEntrance& Entrance = Entrances[Index];
+	Entrance.Cell = Cell;
+	Entrance.Sector = Sector;
+	Entrance.Border = Border;
+	Entrance.Edges.Reset();
+	Entrance.bAlive = true;
+
+	SectorEntrances[Sector].Add(Index);
+	BorderEntrances[Border].Add(Index);
+	return Index;
+}
+
+void FMazeHierarchicalPathfinder::SearchSector(int32 Sector, const FIntPoint& From) const
+{
+	for (const int32 LocalIndex : LocalVisited)
+	{
+		LocalDistance[LocalIndex] = INDEX_NONE;
+	}
+	LocalVisited.Reset();
+
+	FIntPoint Max;
+	GetSectorBounds(Sector, SearchMin, Max);
+	SearchStart = From;
+
+	const int32 StartIndex = (From.Y - SearchMin.Y) * SectorSize + From.X - SearchMin.X;
+	LocalDistance[StartIndex] = 0;
+	LocalParent[StartIndex] = INDEX_NONE;
+	LocalVisited.Add(StartIndex);
+
+	// LocalVisited doubles as the BFS queue
+	for (int32 Head = 0; Head < LocalVisited.Num(); ++Head)
+	{
+		const int32 LocalIndex = LocalVisited[Head];
+		const FIntPoint Cell(SearchMin.X + LocalIndex % SectorSize, SearchMin.Y + LocalIndex / SectorSize);
+
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Next = Cell + Offset;
+			if (Next.X < SearchMin.X || Next.Y < SearchMin.Y || Next.X >= Max.X || Next.Y >= Max.Y || !Walkable[Next.Y * Width + Next.X])
+			{
+				continue;
+			}
+
+			const int32 NextIndex = (Next.Y - SearchMin.Y) * SectorSize + Next.X - SearchMin.X;
+			if (LocalDistance[NextIndex] == INDEX_NONE)
+			{
+				LocalDistance[NextIndex] = LocalDistance[LocalIndex] + 1;
+				LocalParent[NextIndex] = LocalIndex;
+				LocalVisited.Add(NextIndex);
+			}
+		}
+	}
+}
+
+int32 FMazeHierarchicalPathfinder::GetSearchDistance(const FIntPoint& Cell) const
+{
+	const FIntPoint Local = Cell - SearchMin;
+	if (Local.X < 0 || Local.Y < 0 || Local.X >= SectorSize || Local.Y >= SectorSize)
+	{
+		return INDEX_NONE;
+	}
+	return LocalDistance[Local.Y * SectorSize + Local.X];
+}
+
+void FMazeHierarchicalPathfinder::AppendSearchPath(const FIntPoint& To, TArray<FIntPoint>& OutCells) const
+{
+	const int32 FirstAppended = OutCells.Num();
+	for (int32 LocalIndex = (To.Y - SearchMin.Y) * SectorSize + To.X - SearchMin.X; LocalParent[LocalIndex] != INDEX_NONE; LocalIndex = LocalParent[LocalIndex])
+	{
+		OutCells.Add(FIntPoint(SearchMin.X + LocalIndex % SectorSize, SearchMin.Y + LocalIndex / SectorSize));
+	}
+	TArrayView<FIntPoint> Appended = MakeArrayView(OutCells).Slice(FirstAppended, OutCells.Num() - FirstAppended);
+	Algo::Reverse(Appended);
+}
+
+void FMazeHierarchicalPathfinder::AppendEntrancePath(int32 From, int32 To, TArray<FIntPoint>& OutCells)
+{
+	if (const TArray<FIntPoint>* Cached = PathCache.Find(MakeCacheKey(From, To)))
+	{
+		++CacheHits;
+		OutCells.Append(*Cached);
+		return;
+	}
+
+	// The same corridor walked the other way round
+	if (const TArray<FIntPoint>* Reversed = PathCache.Find(MakeCacheKey(To, From)))
+	{
+		++CacheHits;
+		for (int32 Index = Reversed->Num() - 2; Index >= 0; --Index)
+		{
+			OutCells.Add((*Reversed)[Index]);
+		}
+		if (Reversed->Num() > 0)
+		{
+			OutCells.Add(Entrances[To].Cell);
+		}
+		return;
+	}
+
+	++CacheMisses;
+	SearchSector(Entrances[From].Sector, Entrances[From].Cell);
+	TArray<FIntPoint>& Path = PathCache.Add(MakeCacheKey(From, To));
+	AppendSearchPath(Entrances[To].Cell, Path);
+	OutCells.Append(Path);
+}
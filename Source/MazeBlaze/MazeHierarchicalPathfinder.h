@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+/**
+ * Hierarchical A* (HPA*) over a walkability grid
+ *
+ * The grid is cut into square sectors. Every run of open cells along a border between two
+ * sectors gets an entrance on each side, and entrances of the same sector are linked with their
+ * precomputed in-sector distances. Paths are searched on this abstract graph and then refined
+ * into cells with in-sector searches; refined entrance-to-entrance paths are cached. Changing
+ * cells only rebuilds the sectors touching them.
+ */
+class MAZEBLAZE_API FMazeHierarchicalPathfinder
+{
+public:
+	struct FAbstractEdge
+	{
+		int32 Entrance = INDEX_NONE;
+		int32 Cost = 0;
+	};
+
+	struct FEntrance
+	{
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		int32 Sector = INDEX_NONE;
+		int32 Border = INDEX_NONE;
+		TArray<FAbstractEdge, TInlineAllocator<8>> Edges;
+		bool bAlive = false;
+	};
+
+	// Build sectors, entrances and in-sector costs from a walkability mask indexed Y * Width + X
+	void Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable, int32 InSectorSize = 16);
+
+	// Change the walkability of some cells and rebuild only the sectors around them
+	void SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Cell path from From to To (From excluded, To included)
+	// Returns the path length in steps, or INDEX_NONE if there is none
+	int32 FindPath(const FIntPoint& From, const FIntPoint& To, TArray<FIntPoint>* OutCells = nullptr);
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	bool IsWalkable(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) && Walkable[Cell.Y * Width + Cell.X];
+	}
+
+	int32 GetSectorSize() const { return SectorSize; }
+	int32 GetNumSectors() const { return SectorsX * SectorsY; }
+	int32 GetNumEntrances() const { return Entrances.Num() - FreeEntrances.Num(); }
+	const TArray<FEntrance>& GetEntrances() const { return Entrances; }
+
+	// Refined entrance-to-entrance paths currently cached, and cache use since the last reset
+	int32 GetNumCachedPaths() const { return PathCache.Num(); }
+	int32 GetCacheHits() const { return CacheHits; }
+	int32 GetCacheMisses() const { return CacheMisses; }
+	void ResetCacheStats() { CacheHits = 0; CacheMisses = 0; }
+
+private:
+	int32 GetSector(const FIntPoint& Cell) const { return (Cell.Y / SectorSize) * SectorsX + Cell.X / SectorSize; }
+
+	// Cell range [Min, Max) covered by a sector
+	void GetSectorBounds(int32 Sector, FIntPoint& OutMin, FIntPoint& OutMax) const;
+
+	// Borders are numbered Sector * 2 for the east border and Sector * 2 + 1 for the south border
+	void BuildBorder(int32 Border);
+	void RemoveBorder(int32 Border);
+	void BuildSectorEdges(int32 Sector);
+	void ClearSectorEdges(int32 Sector);
+
+	int32 AddEntrance(const FIntPoint& Cell, int32 Sector, int32 Border);
+
+	// Breadth-first search from a cell restricted to its sector
+	void SearchSector(int32 Sector, const FIntPoint& From) const;
+
+	// Distance to a cell of the last searched sector, or INDEX_NONE if it was not reached
+	int32 GetSearchDistance(const FIntPoint& Cell) const;
+
+	// Append the path to a cell reached by the last sector search (start excluded, cell included)
+	void AppendSearchPath(const FIntPoint& To, TArray<FIntPoint>& OutCells) const;
+
+	// Refined path between two entrances of the same sector, from the cache when possible
+	void AppendEntrancePath(int32 From, int32 To, TArray<FIntPoint>& OutCells);
+
+	static uint64 MakeCacheKey(int32 From, int32 To) { return (uint64(uint32(From)) << 32) | uint32(To); }
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 SectorSize = 16;
+	int32 SectorsX = 0;
+	int32 SectorsY = 0;
+	TBitArray<> Walkable;
+
+	TArray<FEntrance> Entrances;
+	TArray<int32> FreeEntrances;
+	TArray<TArray<int32>> SectorEntrances;
+	TArray<TArray<int32>> BorderEntrances;
+
+	// Refined cells between two entrances of a sector, keyed by (from, to) entrance pair
+	TMap<uint64, TArray<FIntPoint>> PathCache;
+	int32 CacheHits = 0;
+	int32 CacheMisses = 0;
+
+	// Sector search scratch, indexed by cell offset inside the sector
+	mutable FIntPoint SearchMin = FIntPoint::ZeroValue;
+	mutable FIntPoint SearchStart = FIntPoint::ZeroValue;
+	mutable TArray<int32> LocalDistance;
+	mutable TArray<int32> LocalParent;
+	mutable TArray<int32> LocalVisited;
+
+	// Abstract search scratch, reset through the touched list after each search
+	TArray<int32> SearchCost;
+	TArray<int32> SearchParent;
+	TArray<int32> SearchTouched;
+};
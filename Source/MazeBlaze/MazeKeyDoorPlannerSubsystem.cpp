@@ -0,0 +1,218 @@
+#include "MazeKeyDoorPlannerSubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeExplorationStrategy.h"
+#include "MazeBlazeKey.h"
+#include "MazeGameDoor.h"
+#include "MazeBlazeExit.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("KeyDoorPlanner Build"), STAT_MazeKeyDoorPlannerBuild, STATGROUP_MazeExploration);
+DECLARE_CYCLE_STAT(TEXT("KeyDoorPlanner Solve"), STAT_MazeKeyDoorPlannerSolve, STATGROUP_MazeExploration);
+
+UMazeKeyDoorPlannerSubsystem* UMazeKeyDoorPlannerSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeKeyDoorPlannerSubsystem>() : nullptr;
+}
+
+void UMazeKeyDoorPlannerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazeKeyDoorPlannerSubsystem::HandleTopologyChanged);
+	}
+	if (UMazeActorRegistrySubsystem* Registry = Collection.InitializeDependency<UMazeActorRegistrySubsystem>())
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &UMazeKeyDoorPlannerSubsystem::HandleMazeActorChanged);
+	}
+}
+
+void UMazeKeyDoorPlannerSubsystem::Deinitialize()
+{
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+
+	Planner = MazeCore::FKeyDoorPlanner();
+	Level = MazeCore::FLevel();
+	KeyActors.Empty();
+	DoorActors.Empty();
+	ExitActors.Empty();
+	bLevelDirty = true;
+	bLevelValid = false;
+
+	Super::Deinitialize();
+}
+
+bool UMazeKeyDoorPlannerSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+void UMazeKeyDoorPlannerSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	bLevelDirty = true;
+}
+
+void UMazeKeyDoorPlannerSubsystem::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	bLevelDirty = true;
+}
+
+bool UMazeKeyDoorPlannerSubsystem::EnsureLevel()
+{
+	if (!bLevelDirty)
+	{
+		return bLevelValid;
+	}
+	bLevelDirty = false;
+	bLevelValid = false;
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this);
+	if (!Topology || !Registry || !Topology->EnsureGraph())
+	{
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeKeyDoorPlannerBuild);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// Closed doors block their cells in the topology grid; the level has them walkable and covered by a door
+	const FMazeTopologyGraph& Graph = Topology->GetGraph();
+	const int32 Width = Graph.GetWidth();
+	Level = MazeCore::FLevel();
+	Level.Grid.Reset(Width, Graph.GetHeight());
+	for (TConstSetBitIterator<> It(Graph.GetWalkable()); It; ++It)
+	{
+		Level.Grid.SetWalkable(MazeCore::FCell(It.GetIndex() % Width, It.GetIndex() / Width), true);
+	}
+
+	KeyActors.Reset();
+	DoorActors.Reset();
+	ExitActors.Reset();
+	for (const TPair<const AMazeGameDoor*, TArray<FIntPoint>>& Pair : Topology->GetClosedDoorCells())
+	{
+		if (!Pair.Key || Pair.Value.Num() == 0)
+		{
+			continue;
+		}
+
+		MazeCore::FDoor& Door = Level.Doors.emplace_back();
+		Door.Mask = Pair.Key->GetMask();
+		for (const FIntPoint& Cell : Pair.Value)
+		{
+			Level.Grid.SetWalkable(MazeCore::FCell(Cell.X, Cell.Y), true);
+			Door.Cells.push_back(MazeCore::FCell(Cell.X, Cell.Y));
+		}
+		DoorActors.Add(const_cast<AMazeGameDoor*>(Pair.Key));
+	}
+	if (!Level.IndexDoors())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MazeKeyDoorPlanner: %d closed doors, the planner takes at most %d"), static_cast<int32>(Level.Doors.size()), MazeCore::MaxDoors);
+		return false;
+	}
+
+	// Keys on the ground get the cell they lie on, carried keys none
+	TSet<FIntPoint> KeyCells;
+	for (AMazeBlazeKey* Key : Registry->GetKeysOnGround())
+	{
+		FIntPoint Cell;
+		if (!Key || !Topology->FindWalkableCell(Key->GetActorLocation(), Cell) || Level.GetDoorAt(MazeCore::FCell(Cell.X, Cell.Y)) != MazeCore::NoIndex)
+		{
+			continue;
+		}
+
+		bool bCellTaken = false;
+		KeyCells.Add(Cell, &bCellTaken);
+		if (bCellTaken)
+		{
+			// The planner keeps one key per cell; the other one is left out until the first is picked up
+			continue;
+		}
+		Level.Keys.push_back(MazeCore::FKey{ MazeCore::FCell(Cell.X, Cell.Y), Key->GetSignature() });
+		KeyActors.Add(Key);
+	}
+	for (AMazeBlazeKey* Key : Registry->GetCarriedKeys())
+	{
+		if (Key)
+		{
+			Level.Keys.push_back(MazeCore::FKey{ MazeCore::FCell(MazeCore::NoIndex, MazeCore::NoIndex), Key->GetSignature() });
+			KeyActors.Add(Key);
+		}
+	}
+
+	for (AMazeBlazeExit* Exit : Registry->GetExits())
+	{
+		FIntPoint Cell;
+		if (Exit && Topology->FindWalkableCell(Exit->GetActorLocation(), Cell))
+		{
+			Level.Exits.push_back(MazeCore::FCell(Cell.X, Cell.Y));
+			ExitActors.Add(Exit);
+		}
+	}
+
+	if (!Planner.Build(Level))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MazeKeyDoorPlanner: Could not build a plan graph for %d keys (at most %d) and %d doors"),
+			static_cast<int32>(Level.Keys.size()), MazeCore::MaxKeys, static_cast<int32>(Level.Doors.size()));
+		return false;
+	}
+
+	UE_LOG(LogTemp, Verbose, TEXT("MazeKeyDoorPlanner: Built %d anchors for %d keys, %d doors and %d exits in %.2f ms"),
+		Planner.GetNumAnchors(), static_cast<int32>(Level.Keys.size()), static_cast<int32>(Level.Doors.size()), static_cast<int32>(Level.Exits.size()), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	bLevelValid = true;
+	return true;
+}
+
+bool UMazeKeyDoorPlannerSubsystem::FindNextStep(const FVector& From, const AMazeBlazeKey* CarriedKey, FMazeKeyDoorPlanStep& OutStep)
+{
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	FIntPoint FromCell;
+	if (!Topology || !EnsureLevel() || !Topology->FindWalkableCell(From, FromCell))
+	{
+		return false;
+	}
+
+	const int32 CarriedIndex = CarriedKey ? KeyActors.IndexOfByPredicate([CarriedKey](const TWeakObjectPtr<AMazeBlazeKey>& Key) { return Key.Get() == CarriedKey; }) : INDEX_NONE;
+	if (CarriedKey && CarriedIndex == INDEX_NONE)
+	{
+		// Picked up since the last build without a registry notification
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeKeyDoorPlannerSolve);
+	Planner.MaxExpandedStates = MaxExpandedStates;
+	const MazeCore::FPlan Plan = Planner.Solve(MazeCore::FCell(FromCell.X, FromCell.Y), CarriedIndex);
+	if (!Plan.bSolved || Plan.Steps.empty())
+	{
+		return false;
+	}
+
+	const MazeCore::FPlanStep& Step = Plan.Steps[0];
+	OutStep.Action = Step.Action;
+	OutStep.PlanLength = Plan.Length;
+	OutStep.bOptimal = Plan.bOptimal;
+	switch (Step.Action)
+	{
+	case MazeCore::EPlanAction::PickUpKey:
+		OutStep.Target = KeyActors[Step.Index].Get();
+		break;
+	case MazeCore::EPlanAction::OpenDoor:
+		OutStep.Target = DoorActors[Step.Index].Get();
+		break;
+	case MazeCore::EPlanAction::ReachExit:
+		OutStep.Target = ExitActors[Step.Index].Get();
+		break;
+	}
+	return OutStep.Target != nullptr;
+}
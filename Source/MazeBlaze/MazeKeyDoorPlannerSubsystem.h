@@ -0,0 +1,79 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeCorePlanner.h"
+#include "MazeKeyDoorPlannerSubsystem.generated.h"
+
+class AMazeBlazeKey;
+class AMazeGameDoor;
+class AMazeBlazeExit;
+
+// First step of a key/door plan
+struct FMazeKeyDoorPlanStep
+{
+	MazeCore::EPlanAction Action = MazeCore::EPlanAction::ReachExit;
+
+	// Key to pick up, door to open or exit to reach
+	AActor* Target = nullptr;
+
+	// Length of the whole plan in grid cells, and whether it is proven to be the shortest
+	int32 PlanLength = 0;
+	bool bOptimal = false;
+};
+
+/**
+ * World subsystem that plans the order of key pickups, door openings and the way to the exit
+ *
+ * The topology subsystem's grid, with its closed doors, and the registry's keys and exits are
+ * turned into a MazeCore level, and MazeCore::FKeyDoorPlanner searches it for the shortest plan
+ * instead of walking to the nearest key and the nearest matching door. The level is rebuilt on
+ * the first query after the topology or the registry changes; keys carried by characters stay
+ * in it without a cell, so an agent can plan with the key in its hand.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeKeyDoorPlannerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the planner subsystem for the world of the given object
+	static UMazeKeyDoorPlannerSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Rebuild the level if the maze changed since the last build; returns false if there is no level to plan in
+	bool EnsureLevel();
+
+	// First step of the shortest plan from a location for an agent carrying a key (or none)
+	bool FindNextStep(const FVector& From, const AMazeBlazeKey* CarriedKey, FMazeKeyDoorPlanStep& OutStep);
+
+	const MazeCore::FKeyDoorPlanner& GetPlanner() const { return Planner; }
+
+	// States the search may expand before settling for its quick subgoal plan; bounds the time of a plan
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|KeyDoorPlanner", meta = (ClampMin = "0"))
+	int32 MaxExpandedStates = 512;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+	void HandleMazeActorChanged(AActor* ChangedActor);
+
+	MazeCore::FKeyDoorPlanner Planner;
+	MazeCore::FLevel Level;
+
+	// Maze actors indexed like the level's keys, doors and exits
+	TArray<TWeakObjectPtr<AMazeBlazeKey>> KeyActors;
+	TArray<TWeakObjectPtr<AMazeGameDoor>> DoorActors;
+	TArray<TWeakObjectPtr<AMazeBlazeExit>> ExitActors;
+
+	// Whether the level has to be rebuilt before the next plan, and whether the last build succeeded
+	bool bLevelDirty = true;
+	bool bLevelValid = false;
+
+	FDelegateHandle TopologyChangedHandle;
+	FDelegateHandle MazeActorChangedHandle;
+};
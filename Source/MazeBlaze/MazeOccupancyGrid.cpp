@@ -0,0 +1,104 @@
+#include "MazeOccupancyGrid.h"
+
+void FMazeOccupancyGrid::Initialize(const FVector& Center, float InCellSize, int32 InWidth, int32 InHeight)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	Width = FMath::Max(InWidth, 0);
+	Height = FMath::Max(InHeight, 0);
+	Origin = Center - FVector(Width * CellSize * 0.5f, Height * CellSize * 0.5f, 0.0f);
+
+	Cells.Reset();
+	Cells.SetNumZeroed(Width * Height);
+	Frontier.Init(false, Width * Height);
+
+	NumFrontier = 0;
+	NumFree = 0;
+	NumBlocked = 0;
+}
+
+FIntPoint FMazeOccupancyGrid::WorldToCell(const FVector& Location) const
+{
+	return FIntPoint(
+		FMath::FloorToInt32((Location.X - Origin.X) / CellSize),
+		FMath::FloorToInt32((Location.Y - Origin.Y) / CellSize));
+}
+
+FVector FMazeOccupancyGrid::CellToWorld(const FIntPoint& Cell, float Z) const
+{
+	return FVector(Origin.X + (Cell.X + 0.5f) * CellSize, Origin.Y + (Cell.Y + 0.5f) * CellSize, Z);
+}
+
+bool FMazeOccupancyGrid::SetState(const FIntPoint& Cell, EMazeCellState State)
+{
+	if (!IsValidCell(Cell))
+	{
+		return false;
+	}
+
+	EMazeCellState& CurrentState = Cells[ToIndex(Cell)];
+	if (CurrentState == State)
+	{
+		return false;
+	}
+
+	NumFree += (State == EMazeCellState::Free) - (CurrentState == EMazeCellState::Free);
+	NumBlocked += (State == EMazeCellState::Blocked) - (CurrentState == EMazeCellState::Blocked);
+	CurrentState = State;
+
+	// Only this cell and its neighbours can gain or lose the frontier flag
+	UpdateFrontier(Cell);
+	UpdateFrontier(Cell + FIntPoint(1, 0));
+	UpdateFrontier(Cell + FIntPoint(-1, 0));
+	UpdateFrontier(Cell + FIntPoint(0, 1));
+	UpdateFrontier(Cell + FIntPoint(0, -1));
+	return true;
+}
+
+int32 FMazeOccupancyGrid::IntegrateRay(const FIntPoint& From, const FIntPoint& To, bool bEndBlocked)
+{
+	int32 NumChanged = 0;
+
+	TraceCells(From, To, [this, &To, bEndBlocked, &NumChanged](const FIntPoint& Cell)
+	{
+		if (!IsValidCell(Cell))
+		{
+			return false;
+		}
+
+		const bool bBlocked = bEndBlocked && Cell == To;
+		NumChanged += SetState(Cell, bBlocked ? EMazeCellState::Blocked : EMazeCellState::Free) ? 1 : 0;
+		return true;
+	});
+
+	return NumChanged;
+}
+
+void FMazeOccupancyGrid::UpdateFrontier(const FIntPoint& Cell)
+{
+	if (!IsValidCell(Cell))
+	{
+		return;
+	}
+
+	const int32 Index = ToIndex(Cell);
+	bool bIsFrontier = false;
+
+	if (Cells[Index] == EMazeCellState::Free)
+	{
+		const FIntPoint Neighbours[] = { Cell + FIntPoint(1, 0), Cell + FIntPoint(-1, 0), Cell + FIntPoint(0, 1), Cell + FIntPoint(0, -1) };
+		for (const FIntPoint& Neighbour : Neighbours)
+		{
+			if (IsValidCell(Neighbour) && Cells[ToIndex(Neighbour)] == EMazeCellState::Unknown)
+			{
+				bIsFrontier = true;
+				break;
+			}
+		}
+	}
+
+	if (Frontier[Index] != bIsFrontier)
+	{
+		Frontier[Index] = bIsFrontier;
+		NumFrontier += bIsFrontier ? 1 : -1;
+	}
+}
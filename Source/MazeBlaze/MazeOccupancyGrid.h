@@ -0,0 +1,124 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+// What an agent knows about a cell of its occupancy grid
+enum class EMazeCellState : uint8
+{
+	Unknown,
+	Free,
+	Blocked
+};
+
+/**
+ * 2D occupancy grid built from an agent's line-of-sight observations
+ *
+ * Cells start unknown and are marked free or blocked as sensor rays pass through them.
+ * Frontier cells (free cells next to unknown space) are tracked incrementally whenever
+ * a cell changes, so explorers never have to rescan the whole grid to find them.
+ */
+class MAZEBLAZE_API FMazeOccupancyGrid
+{
+public:
+	// Allocate an all-unknown grid of Width x Height cells centred on Center
+	void Initialize(const FVector& Center, float InCellSize, int32 InWidth, int32 InHeight);
+
+	bool IsInitialized() const { return Width > 0 && Height > 0; }
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumCells() const { return Cells.Num(); }
+	float GetCellSize() const { return CellSize; }
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	int32 ToIndex(const FIntPoint& Cell) const { return Cell.Y * Width + Cell.X; }
+	FIntPoint ToCell(int32 Index) const { return FIntPoint(Index % Width, Index / Width); }
+
+	// Conversion between world locations and cells (cell centres)
+	FIntPoint WorldToCell(const FVector& Location) const;
+	FVector CellToWorld(const FIntPoint& Cell, float Z = 0.0f) const;
+
+	// State of a cell; cells outside the grid are unknown
+	EMazeCellState GetState(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) ? Cells[ToIndex(Cell)] : EMazeCellState::Unknown;
+	}
+
+	// Set the state of a cell, returns true if it changed
+	bool SetState(const FIntPoint& Cell, EMazeCellState State);
+
+	// Mark the cells along a sensor ray; the last cell is blocked if the ray hit something
+	// Returns the number of cells that changed
+	int32 IntegrateRay(const FIntPoint& From, const FIntPoint& To, bool bEndBlocked);
+
+	bool IsFrontier(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) && Frontier[ToIndex(Cell)];
+	}
+
+	// Frontier flags indexed like the cells
+	const TBitArray<>& GetFrontierBits() const { return Frontier; }
+
+	int32 GetNumFrontierCells() const { return NumFrontier; }
+	int32 GetNumFreeCells() const { return NumFree; }
+	int32 GetNumBlockedCells() const { return NumBlocked; }
+
+	// Visit the cells on a 4-connected line from From to To (both included)
+	// Func returns false to stop the walk early
+	template<typename FuncType>
+	static void TraceCells(const FIntPoint& From, const FIntPoint& To, FuncType&& Func)
+	{
+		const int32 NumX = FMath::Abs(To.X - From.X);
+		const int32 NumY = FMath::Abs(To.Y - From.Y);
+		const int32 StepX = To.X > From.X ? 1 : -1;
+		const int32 StepY = To.Y > From.Y ? 1 : -1;
+
+		FIntPoint Cell = From;
+		if (!Func(Cell))
+		{
+			return;
+		}
+
+		// Step along whichever axis the ideal line crosses first, never diagonally,
+		// so a ray cannot slip between two diagonal wall cells
+		for (int32 IX = 0, IY = 0; IX < NumX || IY < NumY;)
+		{
+			if (static_cast<int64>(1 + 2 * IX) * NumY < static_cast<int64>(1 + 2 * IY) * NumX)
+			{
+				Cell.X += StepX;
+				++IX;
+			}
+			else
+			{
+				Cell.Y += StepY;
+				++IY;
+			}
+
+			if (!Func(Cell))
+			{
+				return;
+			}
+		}
+	}
+
+private:
+	// Recompute the frontier flag of a cell
+	void UpdateFrontier(const FIntPoint& Cell);
+
+	FVector Origin = FVector::ZeroVector;
+	float CellSize = 100.0f;
+	int32 Width = 0;
+	int32 Height = 0;
+
+	TArray<EMazeCellState> Cells;
+	TBitArray<> Frontier;
+
+	int32 NumFrontier = 0;
+	int32 NumFree = 0;
+	int32 NumBlocked = 0;
+};
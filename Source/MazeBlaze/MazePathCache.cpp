@@ -0,0 +1,235 @@
+#include "MazePathCache.h"
+
+namespace
+{
+	// Cached paths a suffix or prefix lookup looks at; bounds the cost of a miss
+	constexpr int32 MaxReuseCandidates = 16;
+}
+
+void FMazePathCache::Configure(float InCellSize, int32 InMaxEntries, float InReuseTolerance)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	InvCellSize = 1.0f / CellSize;
+	MaxEntries = FMath::Max(InMaxEntries, 1);
+	ReuseTolerance = FMath::Max(InReuseTolerance, 0.0f);
+
+	Entries.Reset();
+	FreeEntries.Reset();
+	Lookup.Reset();
+	EntriesByGoal.Reset();
+	EntriesByStart.Reset();
+	Head = INDEX_NONE;
+	Tail = INDEX_NONE;
+	PointBytes = 0;
+}
+
+EMazePathCacheHit FMazePathCache::Find(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	const FIntPoint StartCell = ToCell(Start);
+	const FIntPoint GoalCell = ToCell(Goal);
+	if (const int32* Found = Lookup.Find(FKey{ StartCell, GoalCell, Version }))
+	{
+		const FEntry& Entry = Entries[*Found];
+		Unlink(*Found);
+		LinkFront(*Found);
+
+		// The cached ends are somewhere in the same cells
+		OutPoints = Entry.Points;
+		OutPoints[0] = Start;
+		OutPoints.Last() = Goal;
+		++Counters.ExactHits;
+		return EMazePathCacheHit::Exact;
+	}
+
+	if (ReuseFrom(EntriesByGoal.Find(GoalCell), Start, Goal, true, OutPoints))
+	{
+		++Counters.SuffixHits;
+		Add(Start, Goal, Version, OutPoints);
+		return EMazePathCacheHit::Suffix;
+	}
+	if (ReuseFrom(EntriesByStart.Find(StartCell), Start, Goal, false, OutPoints))
+	{
+		++Counters.PrefixHits;
+		Add(Start, Goal, Version, OutPoints);
+		return EMazePathCacheHit::Prefix;
+	}
+
+	++Counters.Misses;
+	return EMazePathCacheHit::None;
+}
+
+bool FMazePathCache::ReuseFrom(const TArray<int32>* Candidates, const FVector& Start, const FVector& Goal, bool bSuffix, TArray<FVector>& OutPoints)
+{
+	if (!Candidates)
+	{
+		return false;
+	}
+
+	const float ToleranceSq = FMath::Square(ReuseTolerance);
+	const int32 FirstCandidate = FMath::Max(Candidates->Num() - MaxReuseCandidates, 0);
+	for (int32 Candidate = Candidates->Num() - 1; Candidate >= FirstCandidate; --Candidate)
+	{
+		const int32 Index = (*Candidates)[Candidate];
+		const TArray<FVector>& Points = Entries[Index].Points;
+
+		// The segment the new start (or goal) lies on; the rest of the path past it (or before it) is reused
+		const FVector& Target = bSuffix ? Start : Goal;
+		for (int32 Segment = 0; Segment + 1 < Points.Num(); ++Segment)
+		{
+			if (FMath::PointDistToSegmentSquared(Target, Points[Segment], Points[Segment + 1]) > ToleranceSq)
+			{
+				continue;
+			}
+
+			OutPoints.Reset();
+			if (bSuffix)
+			{
+				OutPoints.Add(Start);
+				OutPoints.Append(Points.GetData() + Segment + 1, Points.Num() - Segment - 2);
+				OutPoints.Add(Goal);
+			}
+			else
+			{
+				OutPoints.Add(Start);
+				OutPoints.Append(Points.GetData() + 1, Segment);
+				OutPoints.Add(Goal);
+			}
+
+			Unlink(Index);
+			LinkFront(Index);
+			return true;
+		}
+	}
+	return false;
+}
+
+void FMazePathCache::Add(const FVector& Start, const FVector& Goal, uint32 InVersion, TConstArrayView<FVector> Points)
+{
+	if (InVersion != Version || Points.Num() < 2)
+	{
+		return;
+	}
+
+	const FKey Key{ ToCell(Start), ToCell(Goal), Version };
+	if (const int32* Found = Lookup.Find(Key))
+	{
+		// Another agent found a path for the same cells; the newer one wins
+		FEntry& Entry = Entries[*Found];
+		PointBytes -= Entry.Points.GetAllocatedSize();
+		Entry.Points.Reset();
+		Entry.Points.Append(Points.GetData(), Points.Num());
+		PointBytes += Entry.Points.GetAllocatedSize();
+		Unlink(*Found);
+		LinkFront(*Found);
+		return;
+	}
+
+	while (Lookup.Num() >= MaxEntries && Tail != INDEX_NONE)
+	{
+		RemoveEntry(Tail);
+		++Counters.Evictions;
+	}
+
+	const int32 Index = FreeEntries.Num() > 0 ? FreeEntries.Pop(EAllowShrinking::No) : Entries.AddDefaulted();
+	FEntry& Entry = Entries[Index];
+	Entry.Key = Key;
+	Entry.Points.Append(Points.GetData(), Points.Num());
+	PointBytes += Entry.Points.GetAllocatedSize();
+
+	Lookup.Add(Key, Index);
+	EntriesByGoal.FindOrAdd(Key.Goal).Add(Index);
+	EntriesByStart.FindOrAdd(Key.Start).Add(Index);
+	LinkFront(Index);
+}
+
+void FMazePathCache::Invalidate()
+{
+	const int32 NumDropped = Lookup.Num();
+	Configure(CellSize, MaxEntries, ReuseTolerance);
+	++Version;
+	Counters.Invalidations += NumDropped;
+}
+
+SIZE_T FMazePathCache::GetAllocatedSize() const
+{
+	SIZE_T Bytes = sizeof(*this) + Entries.GetAllocatedSize() + FreeEntries.GetAllocatedSize() + Lookup.GetAllocatedSize()
+		+ EntriesByGoal.GetAllocatedSize() + EntriesByStart.GetAllocatedSize() + PointBytes;
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : EntriesByGoal)
+	{
+		Bytes += Pair.Value.GetAllocatedSize();
+	}
+	for (const TPair<FIntPoint, TArray<int32>>& Pair : EntriesByStart)
+	{
+		Bytes += Pair.Value.GetAllocatedSize();
+	}
+	return Bytes;
+}
+
+void FMazePathCache::LinkFront(int32 Index)
+{
+	FEntry& Entry = Entries[Index];
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = Head;
+	if (Head != INDEX_NONE)
+	{
+		Entries[Head].Prev = Index;
+	}
+	Head = Index;
+	if (Tail == INDEX_NONE)
+	{
+		Tail = Index;
+	}
+}
+
+void FMazePathCache::Unlink(int32 Index)
+{
+	FEntry& Entry = Entries[Index];
+	if (Entry.Prev != INDEX_NONE)
+	{
+		Entries[Entry.Prev].Next = Entry.Next;
+	}
+	else
+	{
+		Head = Entry.Next;
+	}
+	if (Entry.Next != INDEX_NONE)
+	{
+		Entries[Entry.Next].Prev = Entry.Prev;
+	}
+	else
+	{
+		Tail = Entry.Prev;
+	}
+	Entry.Prev = INDEX_NONE;
+	Entry.Next = INDEX_NONE;
+}
+
+void FMazePathCache::RemoveEntry(int32 Index)
+{
+	Unlink(Index);
+
+	FEntry& Entry = Entries[Index];
+	Lookup.Remove(Entry.Key);
+	if (TArray<int32>* ByGoal = EntriesByGoal.Find(Entry.Key.Goal))
+	{
+		ByGoal->RemoveSingle(Index);
+		if (ByGoal->Num() == 0)
+		{
+			EntriesByGoal.Remove(Entry.Key.Goal);
+		}
+	}
+	if (TArray<int32>* ByStart = EntriesByStart.Find(Entry.Key.Start))
+	{
+		ByStart->RemoveSingle(Index);
+		if (ByStart->Num() == 0)
+		{
+			EntriesByStart.Remove(Entry.Key.Start);
+		}
+	}
+
+	PointBytes -= Entry.Points.GetAllocatedSize();
+	Entry.Points.Empty();
+	FreeEntries.Add(Index);
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// How a cached path answered a lookup
+enum class EMazePathCacheHit : uint8
+{
+	None,
+
+	// A path between the same start and goal cells
+	Exact,
+
+	// The end of a path to the same goal cell that passes by the start
+	Suffix,
+
+	// The beginning of a path from the same start cell that passes by the goal
+	Prefix
+};
+
+// Lookups answered and entries dropped since the last reset
+struct FMazePathCacheCounters
+{
+	int64 ExactHits = 0;
+	int64 SuffixHits = 0;
+	int64 PrefixHits = 0;
+	int64 Misses = 0;
+	int64 Evictions = 0;
+	int64 Invalidations = 0;
+
+	int64 GetHits() const { return ExactHits + SuffixHits + PrefixHits; }
+};
+
+/**
+ * Least recently used cache of path corner points, keyed by quantised start cell, goal cell and navmesh version
+ *
+ * Agents heading for the same exit or door from nearby places get the same path. A lookup that
+ * misses the exact key reuses the end of a path to the same goal cell when the start lies on one
+ * of its segments, or the beginning of a path from the same start cell when the goal does; the
+ * reused part is stored under its own key. Invalidate bumps the version, so paths found on the
+ * old navmesh and added late are dropped.
+ */
+class MAZEBLAZE_API FMazePathCache
+{
+public:
+	// Set the cell size of the keys, the number of paths kept and how close a start or goal must be
+	// to a cached segment to reuse it; drops every path
+	void Configure(float InCellSize, int32 InMaxEntries, float InReuseTolerance);
+
+	// Path from Start to Goal; the first point is Start and the last one Goal
+	EMazePathCacheHit Find(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints);
+
+	// Store a path found on the navmesh of the given version; paths of an older version are dropped
+	void Add(const FVector& Start, const FVector& Goal, uint32 InVersion, TConstArrayView<FVector> Points);
+
+	// Drop every path and move to the next navmesh version
+	void Invalidate();
+
+	FIntPoint ToCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+	}
+
+	uint32 GetVersion() const { return Version; }
+	int32 Num() const { return Lookup.Num(); }
+	int32 GetMaxEntries() const { return MaxEntries; }
+
+	// Bytes used by the cache, the stored points included
+	SIZE_T GetAllocatedSize() const;
+
+	const FMazePathCacheCounters& GetCounters() const { return Counters; }
+	void ResetCounters() { Counters = FMazePathCacheCounters(); }
+
+private:
+	struct FKey
+	{
+		FIntPoint Start;
+		FIntPoint Goal;
+		uint32 Version = 0;
+
+		bool operator==(const FKey& Other) const
+		{
+			return Start == Other.Start && Goal == Other.Goal && Version == Other.Version;
+		}
+
+		friend uint32 GetTypeHash(const FKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Start), GetTypeHash(Key.Goal)), Key.Version);
+		}
+	};
+
+	struct FEntry
+	{
+		FKey Key;
+		TArray<FVector> Points;
+
+		// Neighbours in the recency list, most recent first
+		int32 Prev = INDEX_NONE;
+		int32 Next = INDEX_NONE;
+	};
+
+	// Reuse the end (bSuffix) or the beginning of one of the candidate paths; the most recent are tried first
+	bool ReuseFrom(const TArray<int32>* Candidates, const FVector& Start, const FVector& Goal, bool bSuffix, TArray<FVector>& OutPoints);
+
+	void LinkFront(int32 Index);
+	void Unlink(int32 Index);
+	void RemoveEntry(int32 Index);
+
+	float CellSize = 100.0f;
+	float InvCellSize = 1.0f / 100.0f;
+	int32 MaxEntries = 1024;
+	float ReuseTolerance = 50.0f;
+	uint32 Version = 0;
+
+	// Entry slots; freed slots are reused
+	TArray<FEntry> Entries;
+	TArray<int32> FreeEntries;
+	TMap<FKey, int32> Lookup;
+
+	// Entries by goal cell (for suffix reuse) and by start cell (for prefix reuse), oldest first
+	TMap<FIntPoint, TArray<int32>> EntriesByGoal;
+	TMap<FIntPoint, TArray<int32>> EntriesByStart;
+
+	// Most and least recently used entries
+	int32 Head = INDEX_NONE;
+	int32 Tail = INDEX_NONE;
+
+	// Bytes allocated by the points of every entry
+	SIZE_T PointBytes = 0;
+
+	FMazePathCacheCounters Counters;
+};
@@ -0,0 +1,141 @@
+#include "MazePathCacheSubsystem.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeExplorationStrategy.h"
+#include "MazeGameDoor.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "Engine/World.h"
+
+DECLARE_DWORD_COUNTER_STAT(TEXT("PathCache Hits"), STAT_MazePathCacheHits, STATGROUP_MazeExploration);
+DECLARE_DWORD_COUNTER_STAT(TEXT("PathCache Misses"), STAT_MazePathCacheMisses, STATGROUP_MazeExploration);
+DECLARE_MEMORY_STAT(TEXT("PathCache Memory"), STAT_MazePathCacheMemory, STATGROUP_MazeExploration);
+
+UMazePathCacheSubsystem* UMazePathCacheSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazePathCacheSubsystem>() : nullptr;
+}
+
+void UMazePathCacheSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeActorRegistrySubsystem* Registry = Collection.InitializeDependency<UMazeActorRegistrySubsystem>())
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &UMazePathCacheSubsystem::HandleMazeActorChanged);
+	}
+
+	Cache.Configure(CellSize, MaxEntries, ReuseTolerance);
+}
+
+void UMazePathCacheSubsystem::Deinitialize()
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+	if (UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UMazePathCacheSubsystem::HandleNavigationGenerationFinished);
+	}
+
+	Cache.Configure(CellSize, MaxEntries, ReuseTolerance);
+	SET_MEMORY_STAT(STAT_MazePathCacheMemory, 0);
+
+	Super::Deinitialize();
+}
+
+void UMazePathCacheSubsystem::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The navigation system is created after the subsystems are initialized
+	if (UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(&InWorld))
+	{
+		NavSys->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UMazePathCacheSubsystem::HandleNavigationGenerationFinished);
+	}
+}
+
+bool UMazePathCacheSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+EMazePathCacheHit UMazePathCacheSubsystem::FindPath(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints)
+{
+	const EMazePathCacheHit Hit = Cache.Find(Start, Goal, OutPoints);
+	if (Hit != EMazePathCacheHit::None)
+	{
+		INC_DWORD_STAT(STAT_MazePathCacheHits);
+	}
+	else
+	{
+		INC_DWORD_STAT(STAT_MazePathCacheMisses);
+	}
+	return Hit;
+}
+
+void UMazePathCacheSubsystem::AddPath(uint32 Version, const FNavigationPath& Path)
+{
+	// A partial path does not reach its goal, so it cannot stand in for another agent's path there
+	const TArray<FNavPathPoint>& PathPoints = Path.GetPathPoints();
+	if (!Path.IsValid() || Path.IsPartial() || PathPoints.Num() < 2)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<32>> Points;
+	Points.Reserve(PathPoints.Num());
+	for (const FNavPathPoint& PathPoint : PathPoints)
+	{
+		Points.Add(PathPoint.Location);
+	}
+	Cache.Add(Points[0], Points.Last(), Version, Points);
+	SET_MEMORY_STAT(STAT_MazePathCacheMemory, Cache.GetAllocatedSize());
+}
+
+void UMazePathCacheSubsystem::Invalidate()
+{
+	Cache.Invalidate();
+	SET_MEMORY_STAT(STAT_MazePathCacheMemory, Cache.GetAllocatedSize());
+}
+
+FMazePathCacheStats UMazePathCacheSubsystem::GetStats() const
+{
+	const FMazePathCacheCounters& Counters = Cache.GetCounters();
+
+	FMazePathCacheStats Stats;
+	Stats.NumEntries = Cache.Num();
+	Stats.MaxEntries = Cache.GetMaxEntries();
+	Stats.MemoryKB = Cache.GetAllocatedSize() / 1024.0f;
+	Stats.ExactHits = Counters.ExactHits;
+	Stats.SuffixHits = Counters.SuffixHits;
+	Stats.PrefixHits = Counters.PrefixHits;
+	Stats.Misses = Counters.Misses;
+	Stats.Evictions = Counters.Evictions;
+	Stats.Invalidations = Counters.Invalidations;
+
+	const int64 Lookups = Counters.GetHits() + Counters.Misses;
+	Stats.HitRate = Lookups > 0 ? float(double(Counters.GetHits()) / Lookups) : 0.0f;
+	return Stats;
+}
+
+void UMazePathCacheSubsystem::ResetStats()
+{
+	Cache.ResetCounters();
+}
+
+void UMazePathCacheSubsystem::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	// A door opening makes shorter paths possible anywhere behind it
+	const AMazeGameDoor* Door = Cast<AMazeGameDoor>(ChangedActor);
+	if (Door && Door->IsOpen())
+	{
+		Invalidate();
+	}
+}
+
+void UMazePathCacheSubsystem::HandleNavigationGenerationFinished(ANavigationData* NavData)
+{
+	Invalidate();
+}
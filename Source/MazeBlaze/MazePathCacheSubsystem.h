@@ -0,0 +1,117 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazePathCache.h"
+#include "MazePathCacheSubsystem.generated.h"
+
+class ANavigationData;
+struct FNavigationPath;
+
+// Hit rate and memory statistics of the path cache
+USTRUCT(BlueprintType)
+struct MAZEBLAZE_API FMazePathCacheStats
+{
+	GENERATED_BODY()
+
+	// Paths currently cached, and the most that are kept
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int32 NumEntries = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int32 MaxEntries = 0;
+
+	// Memory used by the cache, the cached points included
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	float MemoryKB = 0.0f;
+
+	// Lookups answered by an exact key, by the end of a path to the same goal and by the beginning of a path from the same start
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 ExactHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 SuffixHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 PrefixHits = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 Misses = 0;
+
+	// Share of the lookups answered from the cache
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	float HitRate = 0.0f;
+
+	// Paths dropped to make room, and paths dropped because doors opened or the navmesh was rebuilt
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 Evictions = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Maze|PathCache")
+	int64 Invalidations = 0;
+};
+
+/**
+ * World subsystem that shares a least recently used cache of navmesh paths between all agents
+ *
+ * Agents going to the exit or to the same door from nearby cells reuse one path instead of each
+ * querying the navmesh. Paths are keyed by quantised start and goal cells and the navmesh version,
+ * which moves on whenever a door opens or the navigation data finishes rebuilding.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazePathCacheSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the path cache subsystem for the world of the given object
+	static UMazePathCacheSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+
+	// Cached path from Start to Goal as corner points, starting at Start and ending at Goal
+	EMazePathCacheHit FindPath(const FVector& Start, const FVector& Goal, TArray<FVector>& OutPoints);
+
+	// Cache a complete path found on the navmesh of the given version
+	void AddPath(uint32 Version, const FNavigationPath& Path);
+
+	// Version to hand back with a path found later, so paths found before a door opened are not cached
+	uint32 GetVersion() const { return Cache.GetVersion(); }
+
+	// Drop every path
+	UFUNCTION(BlueprintCallable, Category = "Maze|PathCache")
+	void Invalidate();
+
+	UFUNCTION(BlueprintCallable, Category = "Maze|PathCache")
+	FMazePathCacheStats GetStats() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Maze|PathCache")
+	void ResetStats();
+
+	// Side of the cells starts and goals are quantised to
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PathCache", meta = (ClampMin = "10.0"))
+	float CellSize = 100.0f;
+
+	// Paths kept before the least recently used ones are dropped
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PathCache", meta = (ClampMin = "1"))
+	int32 MaxEntries = 2048;
+
+	// Distance from a cached segment within which a start or goal reuses part of the path
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PathCache", meta = (ClampMin = "0.0"))
+	float ReuseTolerance = 50.0f;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleMazeActorChanged(AActor* ChangedActor);
+
+	// Bound to the navigation system's dynamic delegate
+	UFUNCTION()
+	void HandleNavigationGenerationFinished(ANavigationData* NavData);
+
+	FMazePathCache Cache;
+
+	FDelegateHandle MazeActorChangedHandle;
+};
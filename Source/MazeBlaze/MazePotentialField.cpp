@@ -0,0 +1,554 @@
+#include "MazePotentialField.h"
+#include "Math/VectorRegister.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	// Call Function(MinY, MaxY) for every run of set bits
+	template <typename FunctionType>
+	void ForEachRowSpan(const TBitArray<>& Rows, FunctionType&& Function)
+	{
+		int32 SpanMin = INDEX_NONE;
+		int32 SpanMax = INDEX_NONE;
+		for (TConstSetBitIterator<> It(Rows); It; ++It)
+		{
+			const int32 Row = It.GetIndex();
+			if (Row != SpanMax + 1 || SpanMin == INDEX_NONE)
+			{
+				if (SpanMin != INDEX_NONE)
+				{
+					Function(SpanMin, SpanMax);
+				}
+				SpanMin = Row;
+			}
+			SpanMax = Row;
+		}
+		if (SpanMin != INDEX_NONE)
+		{
+			Function(SpanMin, SpanMax);
+		}
+	}
+}
+
+void FMazePotentialField::Initialize(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable)
+{
+	check(InWidth >= 2 && InHeight >= 2);
+	check(InWalkable.Num() == InWidth * InHeight);
+
+	Width = InWidth;
+	Height = InHeight;
+	Walkable = InWalkable;
+
+	const int32 NumCells = Width * Height;
+	StaticPotential.Init(0.0f, NumCells);
+	GoalPotential.Init(BlockedPotential, NumCells);
+	AgentPotential.Init(0.0f, NumCells);
+	TotalPotential.Init(BlockedPotential, NumCells);
+	GradientX.Init(0.0f, NumCells);
+	GradientY.Init(0.0f, NumCells);
+	AgentPositions.Reset();
+	DirtyRows.Init(false, Height);
+	GradientRows.Init(false, Height);
+	bAnyRowDirty = false;
+
+	ComputeStaticPotential();
+	bStaticDirty = false;
+	bGoalsDirty = true;
+}
+
+void FMazePotentialField::SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (IsValidCell(Cell))
+		{
+			Walkable[Cell.Y * Width + Cell.X] = bWalkable;
+			bStaticDirty = true;
+			bGoalsDirty = true;
+		}
+	}
+}
+
+void FMazePotentialField::SetGoals(TConstArrayView<FIntPoint> InGoals)
+{
+	Goals = InGoals;
+	bGoalsDirty = true;
+}
+
+void FMazePotentialField::SetAgent(uint32 AgentId, float X, float Y)
+{
+	const FVector2f Position(X, Y);
+	if (FVector2f* Splatted = AgentPositions.Find(AgentId))
+	{
+		// Agents standing still or shuffling in place leave their rows alone
+		if (FVector2f::DistSquared(*Splatted, Position) < FMath::Square(Params.AgentMoveThreshold))
+		{
+			return;
+		}
+		SplatAgent(*Splatted, -1.0f);
+		*Splatted = Position;
+	}
+	else
+	{
+		AgentPositions.Add(AgentId, Position);
+	}
+	SplatAgent(Position, 1.0f);
+}
+
+void FMazePotentialField::RemoveAgent(uint32 AgentId)
+{
+	FVector2f Splatted;
+	if (AgentPositions.RemoveAndCopyValue(AgentId, Splatted))
+	{
+		SplatAgent(Splatted, -1.0f);
+	}
+}
+
+void FMazePotentialField::SetAgents(TConstArrayView<float> AgentX, TConstArrayView<float> AgentY)
+{
+	check(AgentX.Num() == AgentY.Num());
+
+	for (auto It = AgentPositions.CreateIterator(); It; ++It)
+	{
+		if (It.Key() >= uint32(AgentX.Num()))
+		{
+			SplatAgent(It.Value(), -1.0f);
+			It.RemoveCurrent();
+		}
+	}
+
+	for (int32 Agent = 0; Agent < AgentX.Num(); ++Agent)
+	{
+		SetAgent(Agent, AgentX[Agent], AgentY[Agent]);
+	}
+}
+
+void FMazePotentialField::SplatAgent(const FVector2f& Position, float Sign)
+{
+	const float Radius = Params.AgentRadius;
+	if (Radius <= 0.0f)
+	{
+		return;
+	}
+
+	const int32 MinX = FMath::Max(FMath::CeilToInt(Position.X - Radius), 0);
+	const int32 MaxX = FMath::Min(FMath::FloorToInt(Position.X + Radius), Width - 1);
+	const int32 MinY = FMath::Max(FMath::CeilToInt(Position.Y - Radius), 0);
+	const int32 MaxY = FMath::Min(FMath::FloorToInt(Position.Y + Radius), Height - 1);
+	if (MinX > MaxX || MinY > MaxY)
+	{
+		return;
+	}
+
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const float DistanceSq = FMath::Square(CellX - Position.X) + FMath::Square(CellY - Position.Y);
+			if (DistanceSq >= Radius * Radius)
+			{
+				continue;
+			}
+
+			// Removing the last bump from a cell leaves exactly zero, not rounding noise
+			float& Potential = AgentPotential[CellY * Width + CellX];
+			Potential += Sign * (1.0f - FMath::Sqrt(DistanceSq) / Radius);
+			if (Potential < KINDA_SMALL_NUMBER)
+			{
+				Potential = 0.0f;
+			}
+		}
+	}
+	MarkRowsDirty(MinY, MaxY);
+}
+
+void FMazePotentialField::Update()
+{
+	if (bStaticDirty)
+	{
+		ComputeStaticPotential();
+		bStaticDirty = false;
+		MarkRowsDirty(0, Height - 1);
+	}
+
+	if (bGoalsDirty)
+	{
+		ComputeGoalPotential();
+		bGoalsDirty = false;
+		MarkRowsDirty(0, Height - 1);
+	}
+
+	NumRowsUpdated = 0;
+	if (!bAnyRowDirty)
+	{
+		return;
+	}
+
+	// Agents spread over the maze dirty many short runs of rows, not one range from the top agent to the bottom one
+	GradientRows.SetRange(0, Height, false);
+	ForEachRowSpan(DirtyRows, [this](int32 MinY, int32 MaxY)
+	{
+		CombineRows(MinY, MaxY);
+		NumRowsUpdated += MaxY - MinY + 1;
+
+		// The gradient reads one row above and below
+		const int32 GradientMinY = FMath::Max(MinY - 1, 0);
+		const int32 GradientMaxY = FMath::Min(MaxY + 1, Height - 1);
+		GradientRows.SetRange(GradientMinY, GradientMaxY - GradientMinY + 1, true);
+	});
+	ForEachRowSpan(GradientRows, [this](int32 MinY, int32 MaxY)
+	{
+		ComputeGradientRows(MinY, MaxY);
+	});
+
+	DirtyRows.SetRange(0, Height, false);
+	bAnyRowDirty = false;
+}
+
+void FMazePotentialField::SampleDirections(TConstArrayView<float> PositionX, TConstArrayView<float> PositionY, TArrayView<float> OutX, TArrayView<float> OutY) const
+{
+	check(PositionX.Num() == PositionY.Num() && OutX.Num() == PositionX.Num() && OutY.Num() == PositionX.Num());
+
+	// Keep the sample inside the grid so the four corners of the bilinear lookup are valid
+	const float MaxX = Width - 1.001f;
+	const float MaxY = Height - 1.001f;
+	const float* GradientXData = GradientX.GetData();
+	const float* GradientYData = GradientY.GetData();
+
+	auto SampleCorners = [this, GradientXData, GradientYData](float X, float Y, float& OutGradientX, float& OutGradientY)
+	{
+		const int32 CellX = FMath::FloorToInt(X);
+		const int32 CellY = FMath::FloorToInt(Y);
+		const float TX = X - CellX;
+		const float TY = Y - CellY;
+		const int32 Index = CellY * Width + CellX;
+
+		OutGradientX = FMath::Lerp(
+			FMath::Lerp(GradientXData[Index], GradientXData[Index + 1], TX),
+			FMath::Lerp(GradientXData[Index + Width], GradientXData[Index + Width + 1], TX), TY);
+		OutGradientY = FMath::Lerp(
+			FMath::Lerp(GradientYData[Index], GradientYData[Index + 1], TX),
+			FMath::Lerp(GradientYData[Index + Width], GradientYData[Index + Width + 1], TX), TY);
+	};
+
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float MaxXVector = VectorSetFloat1(MaxX);
+	const VectorRegister4Float MaxYVector = VectorSetFloat1(MaxY);
+	const VectorRegister4Float FlatThreshold = VectorSetFloat1(SMALL_NUMBER);
+
+	// Four agents at a time: the corner loads are scalar gathers, the interpolation and normalisation are SIMD
+	int32 Index = 0;
+	for (; Index + 4 <= PositionX.Num(); Index += 4)
+	{
+		const VectorRegister4Float X = VectorMin(VectorMax(VectorLoad(PositionX.GetData() + Index), Zero), MaxXVector);
+		const VectorRegister4Float Y = VectorMin(VectorMax(VectorLoad(PositionY.GetData() + Index), Zero), MaxYVector);
+		const VectorRegister4Float FloorX = VectorFloor(X);
+		const VectorRegister4Float FloorY = VectorFloor(Y);
+		const VectorRegister4Float TX = VectorSubtract(X, FloorX);
+		const VectorRegister4Float TY = VectorSubtract(Y, FloorY);
+
+		float CellX[4];
+		float CellY[4];
+		VectorStore(FloorX, CellX);
+		VectorStore(FloorY, CellY);
+
+		float X00[4], X10[4], X01[4], X11[4];
+		float Y00[4], Y10[4], Y01[4], Y11[4];
+		for (int32 Lane = 0; Lane < 4; ++Lane)
+		{
+			const int32 Cell = int32(CellY[Lane]) * Width + int32(CellX[Lane]);
+			X00[Lane] = GradientXData[Cell];
+			X10[Lane] = GradientXData[Cell + 1];
+			X01[Lane] = GradientXData[Cell + Width];
+			X11[Lane] = GradientXData[Cell + Width + 1];
+			Y00[Lane] = GradientYData[Cell];
+			Y10[Lane] = GradientYData[Cell + 1];
+			Y01[Lane] = GradientYData[Cell + Width];
+			Y11[Lane] = GradientYData[Cell + Width + 1];
+		}
+
+		auto Bilinear = [&TX, &TY](const float* C00, const float* C10, const float* C01, const float* C11)
+		{
+			const VectorRegister4Float V00 = VectorLoad(C00);
+			const VectorRegister4Float V01 = VectorLoad(C01);
+			const VectorRegister4Float Top = VectorMultiplyAdd(VectorSubtract(VectorLoad(C10), V00), TX, V00);
+			const VectorRegister4Float Bottom = VectorMultiplyAdd(VectorSubtract(VectorLoad(C11), V01), TX, V01);
+			return VectorMultiplyAdd(VectorSubtract(Bottom, Top), TY, Top);
+		};
+
+		const VectorRegister4Float GX = Bilinear(X00, X10, X01, X11);
+		const VectorRegister4Float GY = Bilinear(Y00, Y10, Y01, Y11);
+
+		// Descend: minus the normalised gradient, zero on flat ground
+		const VectorRegister4Float LengthSq = VectorMultiplyAdd(GX, GX, VectorMultiply(GY, GY));
+		const VectorRegister4Float Scale = VectorSelect(VectorCompareGT(LengthSq, FlatThreshold), VectorNegate(VectorReciprocalSqrtAccurate(LengthSq)), Zero);
+		VectorStore(VectorMultiply(GX, Scale), OutX.GetData() + Index);
+		VectorStore(VectorMultiply(GY, Scale), OutY.GetData() + Index);
+	}
+
+	for (; Index < PositionX.Num(); ++Index)
+	{
+		float GX;
+		float GY;
+		SampleCorners(FMath::Clamp(PositionX[Index], 0.0f, MaxX), FMath::Clamp(PositionY[Index], 0.0f, MaxY), GX, GY);
+
+		const float LengthSq = GX * GX + GY * GY;
+		const float Scale = LengthSq > SMALL_NUMBER ? -FMath::InvSqrt(LengthSq) : 0.0f;
+		OutX[Index] = GX * Scale;
+		OutY[Index] = GY * Scale;
+	}
+}
+
+bool FMazePotentialField::FindDescentPath(const FIntPoint& From, int32 MaxSteps, TArray<FIntPoint>& OutCells) const
+{
+	OutCells.Reset();
+
+	FIntPoint Cell = From;
+	if (GetPotential(Cell) >= BlockedPotential)
+	{
+		return false;
+	}
+
+	for (int32 Step = 0; Step < MaxSteps && !IsGoal(Cell); ++Step)
+	{
+		FIntPoint BestCell = Cell;
+		float BestPotential = GetPotential(Cell);
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const float Potential = GetPotential(Cell + Offset);
+			if (Potential < BestPotential)
+			{
+				BestPotential = Potential;
+				BestCell = Cell + Offset;
+			}
+		}
+
+		// Local minimum, only possible where agents or walls bend the field
+		if (BestCell == Cell)
+		{
+			break;
+		}
+
+		Cell = BestCell;
+		OutCells.Add(Cell);
+	}
+
+	return IsGoal(Cell);
+}
+
+void FMazePotentialField::ComputeStaticPotential()
+{
+	// Distance in cells to the nearest blocked cell or grid edge, only up to the wall range
+	TArray<float> WallDistance;
+	WallDistance.Init(0.0f, Width * Height);
+	SearchQueue.Reset();
+
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 Index = Y * Width + X;
+			if (!Walkable[Index])
+			{
+				continue;
+			}
+
+			bool bNextToWall = false;
+			for (const FIntPoint& Offset : CardinalOffsets)
+			{
+				const FIntPoint Neighbour(X + Offset.X, Y + Offset.Y);
+				bNextToWall |= !IsValidCell(Neighbour) || !Walkable[Neighbour.Y * Width + Neighbour.X];
+			}
+			if (bNextToWall)
+			{
+				WallDistance[Index] = 1.0f;
+				SearchQueue.Add(Index);
+			}
+		}
+	}
+
+	for (int32 Head = 0; Head < SearchQueue.Num(); ++Head)
+	{
+		const int32 Index = SearchQueue[Head];
+		if (WallDistance[Index] >= Params.WallRange)
+		{
+			continue;
+		}
+
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Neighbour(Index % Width + Offset.X, Index / Width + Offset.Y);
+			if (!IsValidCell(Neighbour))
+			{
+				continue;
+			}
+
+			const int32 NeighbourIndex = Neighbour.Y * Width + Neighbour.X;
+			if (Walkable[NeighbourIndex] && WallDistance[NeighbourIndex] == 0.0f)
+			{
+				WallDistance[NeighbourIndex] = WallDistance[Index] + 1.0f;
+				SearchQueue.Add(NeighbourIndex);
+			}
+		}
+	}
+
+	const float Range = FMath::Max(Params.WallRange, 1.0f);
+	for (int32 Index = 0; Index < StaticPotential.Num(); ++Index)
+	{
+		const float Distance = WallDistance[Index];
+		StaticPotential[Index] = Distance > 0.0f && Distance <= Range ? FMath::Square((Range + 1.0f - Distance) / (Range + 1.0f)) : 0.0f;
+	}
+}
+
+void FMazePotentialField::ComputeGoalPotential()
+{
+	for (float& Potential : GoalPotential)
+	{
+		Potential = BlockedPotential;
+	}
+
+	SearchQueue.Reset();
+	for (const FIntPoint& Goal : Goals)
+	{
+		if (IsValidCell(Goal) && Walkable[Goal.Y * Width + Goal.X] && GoalPotential[Goal.Y * Width + Goal.X] != 0.0f)
+		{
+			GoalPotential[Goal.Y * Width + Goal.X] = 0.0f;
+			SearchQueue.Add(Goal.Y * Width + Goal.X);
+		}
+	}
+
+	// Walking distance to the nearest goal: the navigation function has no local minima of its own
+	for (int32 Head = 0; Head < SearchQueue.Num(); ++Head)
+	{
+		const int32 Index = SearchQueue[Head];
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Neighbour(Index % Width + Offset.X, Index / Width + Offset.Y);
+			if (!IsValidCell(Neighbour))
+			{
+				continue;
+			}
+
+			const int32 NeighbourIndex = Neighbour.Y * Width + Neighbour.X;
+			if (Walkable[NeighbourIndex] && GoalPotential[NeighbourIndex] == BlockedPotential)
+			{
+				GoalPotential[NeighbourIndex] = GoalPotential[Index] + 1.0f;
+				SearchQueue.Add(NeighbourIndex);
+			}
+		}
+	}
+}
+
+void FMazePotentialField::CombineRows(int32 MinY, int32 MaxY)
+{
+	const int32 End = (MaxY + 1) * Width;
+	const float* Goal = GoalPotential.GetData();
+	const float* Static = StaticPotential.GetData();
+	const float* Agent = AgentPotential.GetData();
+	float* Total = TotalPotential.GetData();
+
+	const VectorRegister4Float WallWeight = VectorSetFloat1(Params.WallWeight);
+	const VectorRegister4Float AgentWeight = VectorSetFloat1(Params.AgentWeight);
+	const VectorRegister4Float Blocked = VectorSetFloat1(BlockedPotential);
+
+	int32 Index = MinY * Width;
+	for (; Index + 4 <= End; Index += 4)
+	{
+		VectorRegister4Float Sum = VectorLoad(Goal + Index);
+		Sum = VectorMultiplyAdd(VectorLoad(Static + Index), WallWeight, Sum);
+		Sum = VectorMultiplyAdd(VectorLoad(Agent + Index), AgentWeight, Sum);
+		VectorStore(VectorMin(Sum, Blocked), Total + Index);
+	}
+
+	for (; Index < End; ++Index)
+	{
+		Total[Index] = FMath::Min(Goal[Index] + Static[Index] * Params.WallWeight + Agent[Index] * Params.AgentWeight, BlockedPotential);
+	}
+}
+
+void FMazePotentialField::ComputeGradientRows(int32 MinY, int32 MaxY)
+{
+	const float* Total = TotalPotential.GetData();
+	float* OutX = GradientX.GetData();
+	float* OutY = GradientY.GetData();
+
+	const VectorRegister4Float Blocked = VectorSetFloat1(BlockedPotential);
+	const VectorRegister4Float Half = VectorSetFloat1(0.5f);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+
+	for (int32 Y = MinY; Y <= MaxY; ++Y)
+	{
+		// Edge rows and columns read outside the grid and take the scalar path
+		if (Y == 0 || Y == Height - 1)
+		{
+			for (int32 X = 0; X < Width; ++X)
+			{
+				ComputeGradientAt(X, Y);
+			}
+			continue;
+		}
+
+		ComputeGradientAt(0, Y);
+
+		int32 X = 1;
+		for (; X + 4 <= Width - 1; X += 4)
+		{
+			const int32 Index = Y * Width + X;
+			const VectorRegister4Float Center = VectorLoad(Total + Index);
+
+			// A blocked neighbour counts as level ground, so walls do not swamp the goal direction
+			auto Neighbour = [&Center, &Blocked](const float* Data)
+			{
+				const VectorRegister4Float Value = VectorLoad(Data);
+				return VectorSelect(VectorCompareGE(Value, Blocked), Center, Value);
+			};
+
+			const VectorRegister4Float Left = Neighbour(Total + Index - 1);
+			const VectorRegister4Float Right = Neighbour(Total + Index + 1);
+			const VectorRegister4Float Up = Neighbour(Total + Index - Width);
+			const VectorRegister4Float Down = Neighbour(Total + Index + Width);
+
+			const VectorRegister4Float CenterBlocked = VectorCompareGE(Center, Blocked);
+			VectorStore(VectorSelect(CenterBlocked, Zero, VectorMultiply(VectorSubtract(Right, Left), Half)), OutX + Index);
+			VectorStore(VectorSelect(CenterBlocked, Zero, VectorMultiply(VectorSubtract(Down, Up), Half)), OutY + Index);
+		}
+
+		for (; X < Width; ++X)
+		{
+			ComputeGradientAt(X, Y);
+		}
+	}
+}
+
+void FMazePotentialField::ComputeGradientAt(int32 X, int32 Y)
+{
+	const int32 Index = Y * Width + X;
+	const float Center = TotalPotential[Index];
+	if (Center >= BlockedPotential)
+	{
+		GradientX[Index] = 0.0f;
+		GradientY[Index] = 0.0f;
+		return;
+	}
+
+	auto Neighbour = [this, Center](int32 NeighbourX, int32 NeighbourY)
+	{
+		const float Value = GetPotential(FIntPoint(NeighbourX, NeighbourY));
+		return Value >= BlockedPotential ? Center : Value;
+	};
+
+	GradientX[Index] = (Neighbour(X + 1, Y) - Neighbour(X - 1, Y)) * 0.5f;
+	GradientY[Index] = (Neighbour(X, Y + 1) - Neighbour(X, Y - 1)) * 0.5f;
+}
+
+void FMazePotentialField::MarkRowsDirty(int32 MinY, int32 MaxY)
+{
+	MinY = FMath::Max(MinY, 0);
+	MaxY = FMath::Min(MaxY, Height - 1);
+	if (MinY <= MaxY)
+	{
+		DirtyRows.SetRange(MinY, MaxY - MinY + 1, true);
+		bAnyRowDirty = true;
+	}
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+// Tuning of the potential field terms; distances are in cells
+struct FMazePotentialFieldParams
+{
+	// Cells closer than this to a wall are pushed away from it; the wall term changes by at most
+	// a third between neighbouring cells, so a weight below 3 never creates a local minimum
+	float WallRange = 2.0f;
+	float WallWeight = 2.0f;
+
+	// Radius and strength of the bump each agent adds around itself
+	float AgentRadius = 2.0f;
+	float AgentWeight = 3.0f;
+
+	// An agent's bump is moved once the agent is this far from where it was splatted
+	float AgentMoveThreshold = 0.25f;
+};
+
+/**
+ * Navigation potential over a dense grid
+ *
+ * The potential is the sum of an attractive term (walking distance to the nearest goal, so it
+ * has no local minima in a maze), a static wall repulsion precomputed once, and a repulsion
+ * bump around every agent. Each term and the resulting gradient are stored as separate float
+ * arrays (SoA) so the combine and gradient passes run four cells at a time with SIMD, and
+ * only the rows touched by agents that moved are recombined on each update.
+ *
+ * Positions are in cell units, with the centre of cell (X, Y) at (X, Y).
+ */
+class MAZEBLAZE_API FMazePotentialField
+{
+public:
+	// Potential of blocked cells and of cells no goal can be reached from
+	static constexpr float BlockedPotential = 1.0e6f;
+
+	FMazePotentialFieldParams Params;
+
+	// Allocate the grid and precompute the wall term from a walkability mask indexed Y * Width + X
+	void Initialize(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable);
+
+	bool IsInitialized() const { return Width > 0 && Height > 0; }
+
+	// Change walkability (e.g. a door opened); the wall and goal terms are recomputed on the next update
+	void SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Replace the attractive goals
+	void SetGoals(TConstArrayView<FIntPoint> InGoals);
+
+	// Place or move the bump of one agent; an agent that moved less than AgentMoveThreshold keeps its bump
+	void SetAgent(uint32 AgentId, float X, float Y);
+
+	// Take an agent's bump out of the field
+	void RemoveAgent(uint32 AgentId);
+
+	// Replace all agents with the given positions, given as parallel X and Y arrays; agent N gets the id N
+	void SetAgents(TConstArrayView<float> AgentX, TConstArrayView<float> AgentY);
+
+	// Bring the combined potential and gradient up to date
+	void Update();
+
+	// Unit descent direction at each position, zero where the field is flat
+	void SampleDirections(TConstArrayView<float> PositionX, TConstArrayView<float> PositionY, TArrayView<float> OutX, TArrayView<float> OutY) const;
+
+	// Follow the steepest descent over neighbouring cells (From excluded); returns true if a goal was reached
+	bool FindDescentPath(const FIntPoint& From, int32 MaxSteps, TArray<FIntPoint>& OutCells) const;
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	float GetPotential(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) ? TotalPotential[Cell.Y * Width + Cell.X] : BlockedPotential;
+	}
+
+	bool IsGoal(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) && GoalPotential[Cell.Y * Width + Cell.X] == 0.0f;
+	}
+
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumGoals() const { return Goals.Num(); }
+	int32 GetNumAgents() const { return AgentPositions.Num(); }
+
+	// Rows recombined by the last update
+	int32 GetNumRowsUpdated() const { return NumRowsUpdated; }
+
+private:
+	void ComputeStaticPotential();
+	void ComputeGoalPotential();
+
+	// Total = Goal + WallWeight * Static + AgentWeight * Agent for rows [MinY, MaxY]
+	void CombineRows(int32 MinY, int32 MaxY);
+
+	// Central differences of Total for rows [MinY, MaxY], ignoring blocked neighbours
+	void ComputeGradientRows(int32 MinY, int32 MaxY);
+	void ComputeGradientAt(int32 X, int32 Y);
+
+	// Add (Sign 1) or remove (Sign -1) the bump of an agent at a position
+	void SplatAgent(const FVector2f& Position, float Sign);
+
+	void MarkRowsDirty(int32 MinY, int32 MaxY);
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TBitArray<> Walkable;
+
+	// Field terms and results, one float per cell
+	TArray<float> StaticPotential;
+	TArray<float> GoalPotential;
+	TArray<float> AgentPotential;
+	TArray<float> TotalPotential;
+	TArray<float> GradientX;
+	TArray<float> GradientY;
+
+	TArray<FIntPoint> Goals;
+
+	// Where each agent's bump is splatted
+	TMap<uint32, FVector2f> AgentPositions;
+
+	// BFS queue shared by the wall and goal passes
+	TArray<int32> SearchQueue;
+
+	bool bStaticDirty = false;
+	bool bGoalsDirty = false;
+
+	// Rows to recombine on the next update, and the rows whose gradient changes with them
+	TBitArray<> DirtyRows;
+	TBitArray<> GradientRows;
+	bool bAnyRowDirty = false;
+	int32 NumRowsUpdated = 0;
+};
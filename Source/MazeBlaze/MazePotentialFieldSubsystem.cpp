@@ -0,0 +1,425 @@
+#include "MazePotentialFieldSubsystem.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "MazeBlazeKey.h"
+#include "MazeGameDoor.h"
+#include "MazeCoreTypes.h"
+#include "MazeBlazeExit.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+}
+
+void UMazePotentialFieldSubsystem::FAgentSet::RemoveAtSwap(int32 Index)
+{
+	Pawns.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	Ids.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	LayerKeys.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CellX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	CellY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	DirectionX.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+	DirectionY.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+}
+
+UMazePotentialFieldSubsystem* UMazePotentialFieldSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazePotentialFieldSubsystem>() : nullptr;
+}
+
+void UMazePotentialFieldSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeActorRegistrySubsystem* Registry = Collection.InitializeDependency<UMazeActorRegistrySubsystem>())
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &UMazePotentialFieldSubsystem::HandleMazeActorChanged);
+	}
+
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazePotentialFieldSubsystem::HandleTopologyChanged);
+	}
+}
+
+void UMazePotentialFieldSubsystem::Deinitialize()
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+
+	Layers.Empty();
+	Agents = FAgentSet();
+
+	Super::Deinitialize();
+}
+
+bool UMazePotentialFieldSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazePotentialFieldSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazePotentialFieldSubsystem, STATGROUP_Tickables);
+}
+
+void UMazePotentialFieldSubsystem::Tick(float DeltaTime)
+{
+	if (Layers.IsEmpty())
+	{
+		return;
+	}
+
+	// Refresh the positions of the agents, dropping the ones that went away
+	for (int32 Index = Agents.Pawns.Num() - 1; Index >= 0; --Index)
+	{
+		const APawn* Pawn = Agents.Pawns[Index].Get();
+		if (!Pawn)
+		{
+			RemoveAgentAt(Index);
+			continue;
+		}
+
+		const FVector2D Position = WorldToField(Pawn->GetActorLocation());
+		Agents.CellX[Index] = Position.X;
+		Agents.CellY[Index] = Position.Y;
+	}
+
+	for (TPair<uint64, FGoalLayer>& Pair : Layers)
+	{
+		UpdateLayer(Pair.Key, Pair.Value);
+
+		// Sample the agents heading for this layer's goals in one batch
+		ScratchAgents.Reset();
+		ScratchX.Reset();
+		ScratchY.Reset();
+		for (int32 Index = 0; Index < Agents.Pawns.Num(); ++Index)
+		{
+			if (Agents.LayerKeys[Index] == Pair.Key)
+			{
+				ScratchAgents.Add(Index);
+				ScratchX.Add(Agents.CellX[Index]);
+				ScratchY.Add(Agents.CellY[Index]);
+			}
+		}
+
+		if (ScratchAgents.IsEmpty())
+		{
+			continue;
+		}
+
+		const int32 NumSamples = ScratchAgents.Num();
+		ScratchX.AddUninitialized(NumSamples);
+		ScratchY.AddUninitialized(NumSamples);
+		Pair.Value.Field.SampleDirections(
+			MakeArrayView(ScratchX.GetData(), NumSamples), MakeArrayView(ScratchY.GetData(), NumSamples),
+			MakeArrayView(ScratchX.GetData() + NumSamples, NumSamples), MakeArrayView(ScratchY.GetData() + NumSamples, NumSamples));
+
+		for (int32 Sample = 0; Sample < NumSamples; ++Sample)
+		{
+			Agents.DirectionX[ScratchAgents[Sample]] = ScratchX[NumSamples + Sample];
+			Agents.DirectionY[ScratchAgents[Sample]] = ScratchY[NumSamples + Sample];
+		}
+	}
+}
+
+bool UMazePotentialFieldSubsystem::FindDescentPoints(APawn* Agent, EMazePotentialGoal Goal, int32 KeySignature, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Agent || !Topology || !Topology->EnsureGraph())
+	{
+		return false;
+	}
+
+	const uint64 LayerKey = MakeLayerKey(Goal, KeySignature);
+	FGoalLayer* Layer = FindOrAddLayer(LayerKey);
+	if (!Layer)
+	{
+		return false;
+	}
+
+	bool bLayerChanged = false;
+	RegisterAgent(Agent, LayerKey, bLayerChanged);
+	UpdateLayer(LayerKey, *Layer);
+
+	const FVector Location = Agent->GetActorLocation();
+
+	FIntPoint StartCell;
+	TArray<FIntPoint> Cells;
+	if (!Topology->FindWalkableCell(Location, StartCell))
+	{
+		return false;
+	}
+
+	const bool bReachedGoal = Layer->Field.FindDescentPath(StartCell, MaxDescentSteps, Cells);
+	if (Cells.IsEmpty())
+	{
+		return false;
+	}
+
+	Topology->CellPathToPoints(Location, StartCell, Cells, Topology->GetCellLocation(Cells.Last()), OutPoints);
+
+	UE_LOG(LogTemp, Verbose, TEXT("MazePotentialField: %s descends %d cells%s"),
+		*Agent->GetName(), Cells.Num(), bReachedGoal ? TEXT(" to a goal") : TEXT(""));
+
+	return true;
+}
+
+bool UMazePotentialFieldSubsystem::GetSteeringDirection(APawn* Agent, EMazePotentialGoal Goal, int32 KeySignature, FVector& OutDirection)
+{
+	OutDirection = FVector::ZeroVector;
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Agent || !Topology || !Topology->EnsureGraph())
+	{
+		return false;
+	}
+
+	const uint64 LayerKey = MakeLayerKey(Goal, KeySignature);
+	FGoalLayer* Layer = FindOrAddLayer(LayerKey);
+	if (!Layer)
+	{
+		return false;
+	}
+
+	bool bLayerChanged = false;
+	const int32 AgentIndex = RegisterAgent(Agent, LayerKey, bLayerChanged);
+
+	// A new agent has no sample from the batch yet; the next ticks sample it with the others
+	if (bLayerChanged)
+	{
+		UpdateLayer(LayerKey, *Layer);
+		Layer->Field.SampleDirections(
+			MakeArrayView(&Agents.CellX[AgentIndex], 1), MakeArrayView(&Agents.CellY[AgentIndex], 1),
+			MakeArrayView(&Agents.DirectionX[AgentIndex], 1), MakeArrayView(&Agents.DirectionY[AgentIndex], 1));
+	}
+
+	const FIntPoint Cell(FMath::RoundToInt(Agents.CellX[AgentIndex]), FMath::RoundToInt(Agents.CellY[AgentIndex]));
+	if (Layer->Field.IsGoal(Cell))
+	{
+		return true;
+	}
+
+	OutDirection = FVector(Agents.DirectionX[AgentIndex], Agents.DirectionY[AgentIndex], 0.0f);
+	return !OutDirection.IsNearlyZero();
+}
+
+FVector UMazePotentialFieldSubsystem::GetAgentDirection(const APawn* Agent) const
+{
+	const int32 AgentIndex = Agents.Pawns.IndexOfByKey(Agent);
+	return AgentIndex == INDEX_NONE ? FVector::ZeroVector : FVector(Agents.DirectionX[AgentIndex], Agents.DirectionY[AgentIndex], 0.0f);
+}
+
+void UMazePotentialFieldSubsystem::UnregisterAgent(const APawn* Agent)
+{
+	const int32 AgentIndex = Agents.Pawns.IndexOfByKey(Agent);
+	if (AgentIndex != INDEX_NONE)
+	{
+		RemoveAgentAt(AgentIndex);
+	}
+}
+
+int32 UMazePotentialFieldSubsystem::RegisterAgent(APawn* Agent, uint64 LayerKey, bool& bOutLayerChanged)
+{
+	const FVector2D Position = WorldToField(Agent->GetActorLocation());
+	int32 AgentIndex = Agents.Pawns.IndexOfByKey(Agent);
+	if (AgentIndex == INDEX_NONE)
+	{
+		AgentIndex = Agents.Pawns.Add(Agent);
+		Agents.Ids.Add(Agent->GetUniqueID());
+		Agents.LayerKeys.Add(LayerKey);
+		Agents.CellX.Add(Position.X);
+		Agents.CellY.Add(Position.Y);
+		Agents.DirectionX.Add(0.0f);
+		Agents.DirectionY.Add(0.0f);
+		bOutLayerChanged = true;
+	}
+	else
+	{
+		bOutLayerChanged = Agents.LayerKeys[AgentIndex] != LayerKey;
+	}
+
+	Agents.LayerKeys[AgentIndex] = LayerKey;
+	Agents.CellX[AgentIndex] = Position.X;
+	Agents.CellY[AgentIndex] = Position.Y;
+	return AgentIndex;
+}
+
+void UMazePotentialFieldSubsystem::RemoveAgentAt(int32 AgentIndex)
+{
+	for (TPair<uint64, FGoalLayer>& Pair : Layers)
+	{
+		Pair.Value.Field.RemoveAgent(Agents.Ids[AgentIndex]);
+	}
+	Agents.RemoveAtSwap(AgentIndex);
+}
+
+void UMazePotentialFieldSubsystem::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	// Keys move and doors close off goals; recompute goals lazily on the next update
+	for (TPair<uint64, FGoalLayer>& Pair : Layers)
+	{
+		Pair.Value.bGoalsDirty = true;
+	}
+}
+
+void UMazePotentialFieldSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	if (Cells.IsEmpty())
+	{
+		// The grid was rebuilt, layers are recreated on their next use and every agent is sampled again
+		Layers.Empty();
+		for (uint64& LayerKey : Agents.LayerKeys)
+		{
+			LayerKey = MAX_uint64;
+		}
+		return;
+	}
+
+	for (TPair<uint64, FGoalLayer>& Pair : Layers)
+	{
+		Pair.Value.Field.SetCellsWalkable(Cells, bWalkable);
+		Pair.Value.bGoalsDirty = true;
+	}
+}
+
+UMazePotentialFieldSubsystem::FGoalLayer* UMazePotentialFieldSubsystem::FindOrAddLayer(uint64 LayerKey)
+{
+	if (FGoalLayer* Layer = Layers.Find(LayerKey))
+	{
+		return Layer;
+	}
+
+	const UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Topology || !Topology->IsGraphBuilt())
+	{
+		return nullptr;
+	}
+
+	const FMazeTopologyGraph& Graph = Topology->GetGraph();
+	if (Graph.GetWidth() < 2 || Graph.GetHeight() < 2)
+	{
+		return nullptr;
+	}
+
+	FGoalLayer& Layer = Layers.Add(LayerKey);
+	Layer.Field.Params.WallRange = WallRange;
+	Layer.Field.Params.WallWeight = WallWeight;
+	Layer.Field.Params.AgentRadius = AgentRadius;
+	Layer.Field.Params.AgentWeight = AgentWeight;
+	Layer.Field.Params.AgentMoveThreshold = AgentMoveThreshold;
+	Layer.Field.Initialize(Graph.GetWidth(), Graph.GetHeight(), Graph.GetWalkable());
+	return &Layer;
+}
+
+void UMazePotentialFieldSubsystem::GatherGoalCells(uint64 LayerKey, TArray<FIntPoint>& OutCells) const
+{
+	const UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this);
+	const UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Registry || !Topology)
+	{
+		return;
+	}
+
+	FIntPoint Cell;
+	const EMazePotentialGoal Goal = EMazePotentialGoal(LayerKey >> 32);
+	switch (Goal)
+	{
+	case EMazePotentialGoal::Keys:
+		for (const AMazeBlazeKey* Key : Registry->GetKeysOnGround())
+		{
+			if (Key && Topology->FindWalkableCell(Key->GetActorLocation(), Cell))
+			{
+				OutCells.Add(Cell);
+			}
+		}
+		break;
+
+	case EMazePotentialGoal::Doors:
+	{
+		const int32 KeySignature = int32(uint32(LayerKey));
+		for (const AMazeGameDoor* Door : Registry->GetClosedDoors())
+		{
+			if (!Door || !MazeCore::CanKeyOpenDoor(KeySignature, Door->GetMask()))
+			{
+				continue;
+			}
+
+			// A closed door blocks its own cells, so attract to the walkable cells in front of it
+			const TArray<FIntPoint>* DoorCells = Topology->GetBlockedDoorCells(Door);
+			if (!DoorCells)
+			{
+				if (Topology->FindWalkableCell(Door->GetActorLocation(), Cell))
+				{
+					OutCells.Add(Cell);
+				}
+				continue;
+			}
+
+			for (const FIntPoint& DoorCell : *DoorCells)
+			{
+				for (const FIntPoint& Offset : CardinalOffsets)
+				{
+					if (Topology->GetGraph().IsWalkable(DoorCell + Offset))
+					{
+						OutCells.AddUnique(DoorCell + Offset);
+					}
+				}
+			}
+		}
+		break;
+	}
+
+	case EMazePotentialGoal::Exits:
+		for (const AMazeBlazeExit* Exit : Registry->GetExits())
+		{
+			if (Exit && Topology->FindWalkableCell(Exit->GetActorLocation(), Cell))
+			{
+				OutCells.Add(Cell);
+			}
+		}
+		break;
+	}
+}
+
+void UMazePotentialFieldSubsystem::UpdateLayer(uint64 LayerKey, FGoalLayer& Layer)
+{
+	if (Layer.bGoalsDirty)
+	{
+		TArray<FIntPoint> GoalCells;
+		GatherGoalCells(LayerKey, GoalCells);
+		Layer.Field.SetGoals(GoalCells);
+		Layer.bGoalsDirty = false;
+	}
+
+	// Every agent repels, whatever it is heading for; only the ones that moved are splatted again
+	for (int32 Index = 0; Index < Agents.Pawns.Num(); ++Index)
+	{
+		Layer.Field.SetAgent(Agents.Ids[Index], Agents.CellX[Index], Agents.CellY[Index]);
+	}
+	Layer.Field.Update();
+}
+
+FVector2D UMazePotentialFieldSubsystem::WorldToField(const FVector& Location) const
+{
+	const UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Topology)
+	{
+		return FVector2D::ZeroVector;
+	}
+
+	const FVector2D Origin = Topology->GetGridOrigin();
+	return FVector2D((Location.X - Origin.X) / Topology->CellSize - 0.5f, (Location.Y - Origin.Y) / Topology->CellSize - 0.5f);
+}
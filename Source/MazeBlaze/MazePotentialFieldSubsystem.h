@@ -0,0 +1,144 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazePotentialField.h"
+#include "MazePotentialFieldSubsystem.generated.h"
+
+class AMazeBlazeKey;
+
+// What a potential field layer attracts agents to
+UENUM(BlueprintType)
+enum class EMazePotentialGoal : uint8
+{
+	Keys UMETA(DisplayName = "Keys"),
+	Doors UMETA(DisplayName = "Matching Doors"),
+	Exits UMETA(DisplayName = "Exits")
+};
+
+/**
+ * World subsystem that steers agents for the PotentialField exploration mode
+ *
+ * Keeps one potential field per goal (keys on the ground, closed doors matching a key signature,
+ * exits) on the topology subsystem's grid. Layers are created on first use; their goals are
+ * refreshed when the registry reports a change, doors opening are forwarded as walkability
+ * changes, and every tick the agents that moved are splatted into every layer as repulsion
+ * and the descent directions of the agents using a layer are sampled in one batch; agents steer
+ * by those directions (GetSteeringDirection) and only descend cell paths where the field is flat.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazePotentialFieldSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the potential field subsystem for the world of the given object
+	static UMazePotentialFieldSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Follow the field from the agent towards the goal, as a list of corner points (agent location included);
+	// the agent is registered with the layer so the others steer around it
+	bool FindDescentPoints(APawn* Agent, EMazePotentialGoal Goal, int32 KeySignature, TArray<FVector>& OutPoints);
+
+	// Register the agent with the goal's layer and get the descent direction sampled for it on the last tick;
+	// returns false where the field gives no direction, and true with a zero direction on a goal cell
+	bool GetSteeringDirection(APawn* Agent, EMazePotentialGoal Goal, int32 KeySignature, FVector& OutDirection);
+
+	// Unit descent direction of an agent sampled on the last tick, zero if the agent is not registered
+	UFUNCTION(BlueprintCallable, Category = "Maze|PotentialField")
+	FVector GetAgentDirection(const APawn* Agent) const;
+
+	// Stop steering an agent around the others
+	UFUNCTION(BlueprintCallable, Category = "Maze|PotentialField")
+	void UnregisterAgent(const APawn* Agent);
+
+	// Layer key for a goal; door layers are per key signature
+	static uint64 MakeLayerKey(EMazePotentialGoal Goal, int32 KeySignature)
+	{
+		return (uint64(Goal) << 32) | uint32(Goal == EMazePotentialGoal::Doors ? KeySignature : 0);
+	}
+
+	// Wall, agent and goal weights shared by every layer
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "0.0"))
+	float WallRange = 2.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "0.0"))
+	float WallWeight = 2.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "0.0"))
+	float AgentRadius = 2.0f;
+
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "0.0"))
+	float AgentWeight = 3.0f;
+
+	// Distance in cells an agent moves before its bump is splatted again
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "0.0"))
+	float AgentMoveThreshold = 0.25f;
+
+	// Longest descent followed by a single move, in cells
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|PotentialField", meta = (ClampMin = "1"))
+	int32 MaxDescentSteps = 64;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	struct FGoalLayer
+	{
+		FMazePotentialField Field;
+		bool bGoalsDirty = true;
+	};
+
+	// Agent positions are stored SoA so each layer can sample them in one batch
+	struct FAgentSet
+	{
+		TArray<TWeakObjectPtr<APawn>> Pawns;
+
+		// Id of each agent's bump in the layers
+		TArray<uint32> Ids;
+		TArray<uint64> LayerKeys;
+		TArray<float> CellX;
+		TArray<float> CellY;
+		TArray<float> DirectionX;
+		TArray<float> DirectionY;
+
+		void RemoveAtSwap(int32 Index);
+	};
+
+	void HandleMazeActorChanged(AActor* ChangedActor);
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Layer for a goal, created and initialised from the topology grid on first use
+	FGoalLayer* FindOrAddLayer(uint64 LayerKey);
+
+	// Walkable cells the layer attracts to
+	void GatherGoalCells(uint64 LayerKey, TArray<FIntPoint>& OutCells) const;
+
+	// Bring a layer's goals and agent term up to date
+	void UpdateLayer(uint64 LayerKey, FGoalLayer& Layer);
+
+	// Add an agent or move it to another layer; returns its index, with bOutLayerChanged set when it has no sample for the layer yet
+	int32 RegisterAgent(APawn* Agent, uint64 LayerKey, bool& bOutLayerChanged);
+
+	// Drop an agent and take its bump out of every layer
+	void RemoveAgentAt(int32 AgentIndex);
+
+	// Location in cell units, with the centre of cell (X, Y) at (X, Y)
+	FVector2D WorldToField(const FVector& Location) const;
+
+	TMap<uint64, FGoalLayer> Layers;
+	FAgentSet Agents;
+
+	// Per-layer scratch for gathering agent positions
+	TArray<float> ScratchX;
+	TArray<float> ScratchY;
+	TArray<int32> ScratchAgents;
+
+	FDelegateHandle MazeActorChangedHandle;
+	FDelegateHandle TopologyChangedHandle;
+};
@@ -0,0 +1,177 @@
+#include "MazeReachablePointPool.h"
+
+void FMazeReachablePointPool::Reset(float InBucketSize, int32 InPointsPerBucket)
+{
+	BucketSize = FMath::Max(InBucketSize, 1.0f);
+	InvBucketSize = 1.0f / BucketSize;
+	PointsPerBucket = FMath::Max(InPointsPerBucket, 1);
+	Buckets.Reset();
+	RefillQueue.Reset();
+	NumPoints = 0;
+}
+
+void FMazeReachablePointPool::AddAnchor(const FVector& Anchor)
+{
+	const FIntPoint BucketKey = GetBucket(Anchor);
+	if (FBucket* Existing = Buckets.Find(BucketKey))
+	{
+		// A bucket whose refills found nothing is tried again
+		QueueRefill(BucketKey, *Existing);
+		return;
+	}
+
+	FBucket& Bucket = Buckets.Add(BucketKey);
+	Bucket.Anchor = Anchor;
+	Bucket.Points.Reserve(PointsPerBucket);
+	QueueRefill(BucketKey, Bucket);
+}
+
+bool FMazeReachablePointPool::TakePoint(const FVector& Location, float MaxRadius, float MinRadius, TFunctionRef<bool(const FVector& Point)> IsReachable, FVector& OutPoint)
+{
+	const FIntPoint Center = GetBucket(Location);
+	const float MaxRadiusSq = FMath::Square(MaxRadius);
+	const float MinRadiusSq = FMath::Square(MinRadius);
+
+	// A point closer than MinRadius only does if nothing further is pooled
+	FBucket* FallbackBucket = nullptr;
+	FIntPoint FallbackKey;
+	int32 FallbackIndex = INDEX_NONE;
+
+	for (int32 DY = -1; DY <= 1; ++DY)
+	{
+		for (int32 DX = -1; DX <= 1; ++DX)
+		{
+			const FIntPoint BucketKey = Center + FIntPoint(DX, DY);
+			FBucket* Bucket = Buckets.Find(BucketKey);
+			if (!Bucket)
+			{
+				continue;
+			}
+
+			for (int32 Index = Bucket->Points.Num() - 1; Index >= 0; --Index)
+			{
+				const float DistanceSq = FVector::DistSquared(Location, Bucket->Points[Index]);
+				if (DistanceSq > MaxRadiusSq)
+				{
+					continue;
+				}
+				if (DistanceSq < MinRadiusSq)
+				{
+					if (!FallbackBucket && IsReachable(Bucket->Points[Index]))
+					{
+						FallbackBucket = Bucket;
+						FallbackKey = BucketKey;
+						FallbackIndex = Index;
+					}
+					continue;
+				}
+				if (!IsReachable(Bucket->Points[Index]))
+				{
+					continue;
+				}
+
+				OutPoint = Bucket->Points[Index];
+				Bucket->Points.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+				--NumPoints;
+				QueueRefill(BucketKey, *Bucket);
+				return true;
+			}
+		}
+	}
+
+	if (!FallbackBucket)
+	{
+		return false;
+	}
+
+	OutPoint = FallbackBucket->Points[FallbackIndex];
+	FallbackBucket->Points.RemoveAtSwap(FallbackIndex, 1, EAllowShrinking::No);
+	--NumPoints;
+	QueueRefill(FallbackKey, *FallbackBucket);
+	return true;
+}
+
+bool FMazeReachablePointPool::StartRefill(FIntPoint& OutBucket, FVector& OutAnchor, uint32& OutGeneration)
+{
+	while (RefillQueue.Num() > 0)
+	{
+		const FIntPoint BucketKey = RefillQueue.Pop(EAllowShrinking::No);
+		FBucket* Bucket = Buckets.Find(BucketKey);
+		if (!Bucket)
+		{
+			continue;
+		}
+
+		++Bucket->NumRefilling;
+		OutBucket = BucketKey;
+		OutAnchor = Bucket->Anchor;
+		OutGeneration = Bucket->Generation;
+
+		// Stays queued while more points are missing than refills are under way
+		Bucket->bQueued = Bucket->Points.Num() + Bucket->NumRefilling < PointsPerBucket;
+		if (Bucket->bQueued)
+		{
+			RefillQueue.Add(BucketKey);
+		}
+		return true;
+	}
+	return false;
+}
+
+void FMazeReachablePointPool::FinishRefill(const FIntPoint& BucketKey, uint32 Generation, bool bFound, const FVector& Point)
+{
+	FBucket* Bucket = Buckets.Find(BucketKey);
+	if (!Bucket || Bucket->Generation != Generation)
+	{
+		return;
+	}
+
+	Bucket->NumRefilling = FMath::Max(Bucket->NumRefilling - 1, 0);
+	if (!bFound)
+	{
+		// Nothing around the anchor (the navmesh may still be building); the next AddAnchor in the bucket queues it again
+		return;
+	}
+
+	if (Bucket->Points.Num() < PointsPerBucket)
+	{
+		Bucket->Points.Add(Point);
+		++NumPoints;
+	}
+}
+
+void FMazeReachablePointPool::Invalidate(const FBox2D& Box)
+{
+	// Points are sampled within BucketSize of their anchor, so only anchors that close to the box can have changed
+	const FBox2D Reach = Box.ExpandBy(BucketSize);
+	const FIntPoint MinBucket(FMath::FloorToInt(Reach.Min.X * InvBucketSize), FMath::FloorToInt(Reach.Min.Y * InvBucketSize));
+	const FIntPoint MaxBucket(FMath::FloorToInt(Reach.Max.X * InvBucketSize), FMath::FloorToInt(Reach.Max.Y * InvBucketSize));
+
+	for (int32 Y = MinBucket.Y; Y <= MaxBucket.Y; ++Y)
+	{
+		for (int32 X = MinBucket.X; X <= MaxBucket.X; ++X)
+		{
+			const FIntPoint BucketKey(X, Y);
+			FBucket* Bucket = Buckets.Find(BucketKey);
+			if (!Bucket || !Reach.IsInside(FVector2D(Bucket->Anchor)))
+			{
+				continue;
+			}
+
+			NumPoints -= Bucket->Points.Num();
+			Bucket->Points.Reset();
+			Bucket->NumRefilling = 0;
+			++Bucket->Generation;
+			QueueRefill(BucketKey, *Bucket);
+		}
+	}
+}
+
+void FMazeReachablePointPool::QueueRefill(const FIntPoint& BucketKey, FBucket& Bucket)
+{
+	if (!Bucket.bQueued && Bucket.Points.Num() + Bucket.NumRefilling < PointsPerBucket)
+	{
+		Bucket.bQueued = true;
+		RefillQueue.Add(BucketKey);
+	}
+}
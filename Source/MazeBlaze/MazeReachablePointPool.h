@@ -0,0 +1,85 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Function.h"
+
+/**
+ * Pool of pre-sampled reachable navmesh points, bucketed on a square grid over the XY plane
+ *
+ * Every bucket has an anchor (a navmesh location inside it) and keeps up to PointsPerBucket
+ * points sampled within BucketSize of that anchor. Taking a point looks at the bucket under the
+ * caller and its eight neighbours only, so it costs the same whatever the size of the maze.
+ * Points are only reachable from their bucket's anchor, so the owner passes a check of whether
+ * the caller can reach a point (e.g. the same region between closed doors); points that fail it
+ * stay pooled for agents on the other side.
+ * Buckets that lost points are queued for a refill; the sampling itself is left to the owner,
+ * which hands each result back with the generation the refill was started with, so points
+ * sampled before an invalidation never make it into the pool.
+ */
+class MAZEBLAZE_API FMazeReachablePointPool
+{
+public:
+	// Forget every bucket and use buckets of the given size
+	void Reset(float InBucketSize, int32 InPointsPerBucket);
+
+	// Give the bucket containing Anchor a place to sample from, unless it has one; the bucket is queued for a refill if it is missing points
+	void AddAnchor(const FVector& Anchor);
+
+	// Take a pooled point within MaxRadius of Location that IsReachable accepts, preferring one at least MinRadius away;
+	// the bucket is queued for a refill
+	bool TakePoint(const FVector& Location, float MaxRadius, float MinRadius, TFunctionRef<bool(const FVector& Point)> IsReachable, FVector& OutPoint);
+
+	// Take a point for a caller that reaches every anchor
+	bool TakePoint(const FVector& Location, float MaxRadius, float MinRadius, FVector& OutPoint)
+	{
+		return TakePoint(Location, MaxRadius, MinRadius, [](const FVector&) { return true; }, OutPoint);
+	}
+
+	// Next bucket missing points; the caller samples one point around OutAnchor and reports it with FinishRefill
+	bool StartRefill(FIntPoint& OutBucket, FVector& OutAnchor, uint32& OutGeneration);
+
+	// Add the point sampled for a refill; results of refills started before the bucket was invalidated are dropped
+	void FinishRefill(const FIntPoint& Bucket, uint32 Generation, bool bFound, const FVector& Point);
+
+	// Drop the points of every bucket whose sampling circle overlaps Box and queue the buckets for a refill
+	void Invalidate(const FBox2D& Box);
+
+	FIntPoint GetBucket(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvBucketSize), FMath::FloorToInt(Location.Y * InvBucketSize));
+	}
+
+	float GetBucketSize() const { return BucketSize; }
+	int32 GetPointsPerBucket() const { return PointsPerBucket; }
+	int32 GetNumBuckets() const { return Buckets.Num(); }
+	int32 GetNumPoints() const { return NumPoints; }
+	int32 GetNumQueuedRefills() const { return RefillQueue.Num(); }
+
+private:
+	struct FBucket
+	{
+		FVector Anchor = FVector::ZeroVector;
+		TArray<FVector> Points;
+
+		// Bumped when the points are dropped, so refills already under way are ignored
+		uint32 Generation = 0;
+
+		// Refills started and not finished yet
+		int32 NumRefilling = 0;
+		bool bQueued = false;
+	};
+
+	// Queue a bucket for a refill if it is missing points that no refill is under way for
+	void QueueRefill(const FIntPoint& BucketKey, FBucket& Bucket);
+
+	float BucketSize = 1000.0f;
+	float InvBucketSize = 1.0f / 1000.0f;
+	int32 PointsPerBucket = 8;
+
+	TMap<FIntPoint, FBucket> Buckets;
+
+	// Buckets waiting for a refill, popped from the back so a bucket is topped up before the next one
+	TArray<FIntPoint> RefillQueue;
+
+	int32 NumPoints = 0;
+};
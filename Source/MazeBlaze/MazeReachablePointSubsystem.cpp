@@ -0,0 +1,216 @@
+#include "MazeReachablePointSubsystem.h"
+#include "MazeAsyncNavigationSubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeExplorationStrategy.h"
+#include "MazeGameDoor.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "NavigationSystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "HAL/PlatformTime.h"
+
+DECLARE_CYCLE_STAT(TEXT("ReachablePoints Warm"), STAT_MazeReachablePointsWarm, STATGROUP_MazeExploration);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ReachablePoints Hits"), STAT_MazeReachablePointsHits, STATGROUP_MazeExploration);
+DECLARE_DWORD_COUNTER_STAT(TEXT("ReachablePoints Misses"), STAT_MazeReachablePointsMisses, STATGROUP_MazeExploration);
+
+namespace
+{
+	// Seconds between attempts to anchor the pool while there is no navmesh
+	constexpr double WarmRetryInterval = 1.0;
+}
+
+UMazeReachablePointSubsystem* UMazeReachablePointSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeReachablePointSubsystem>() : nullptr;
+}
+
+void UMazeReachablePointSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Collection.InitializeDependency<UMazeAsyncNavigationSubsystem>();
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazeReachablePointSubsystem::HandleTopologyChanged);
+	}
+	if (UMazeActorRegistrySubsystem* Registry = Collection.InitializeDependency<UMazeActorRegistrySubsystem>())
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &UMazeReachablePointSubsystem::HandleMazeActorChanged);
+	}
+
+	Pool.Reset(BucketSize, PointsPerBucket);
+}
+
+void UMazeReachablePointSubsystem::Deinitialize()
+{
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+
+	Pool.Reset(BucketSize, PointsPerBucket);
+	bWarmed = false;
+
+	Super::Deinitialize();
+}
+
+bool UMazeReachablePointSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+TStatId UMazeReachablePointSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UMazeReachablePointSubsystem, STATGROUP_Tickables);
+}
+
+void UMazeReachablePointSubsystem::Tick(float DeltaTime)
+{
+	const double Now = GetWorld()->GetTimeSeconds();
+	if (!bWarmed && (LastWarmAttemptTime < 0.0 || Now - LastWarmAttemptTime >= WarmRetryInterval))
+	{
+		LastWarmAttemptTime = Now;
+		bWarmed = WarmPool();
+	}
+
+	UMazeAsyncNavigationSubsystem* AsyncNavigation = UMazeAsyncNavigationSubsystem::Get(this);
+	if (!AsyncNavigation)
+	{
+		return;
+	}
+
+	const float Radii[] = { Pool.GetBucketSize() };
+	FIntPoint Bucket;
+	FVector Anchor;
+	uint32 Generation = 0;
+	for (int32 Query = 0; Query < RefillQueriesPerFrame && Pool.StartRefill(Bucket, Anchor, Generation); ++Query)
+	{
+		const uint32 QueryId = AsyncNavigation->RequestReachablePoint(FNavAgentProperties::DefaultProperties, Anchor, Radii,
+			FMazeAsyncPointDelegate::CreateUObject(this, &UMazeReachablePointSubsystem::HandleRefillPointFound, Bucket, Generation));
+		if (QueryId == 0)
+		{
+			// No navigation data; the bucket is tried again once something anchors it
+			Pool.FinishRefill(Bucket, Generation, false, FVector::ZeroVector);
+			break;
+		}
+	}
+}
+
+bool UMazeReachablePointSubsystem::TakePoint(const FVector& Location, float MaxRadius, float MinRadius, FVector& OutPoint)
+{
+	// Points were sampled from their bucket's anchor, which can be behind a closed door from the caller
+	const UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	const int32 Region = Topology ? Topology->GetRegion(Location) : INDEX_NONE;
+	if (Region == INDEX_NONE)
+	{
+		INC_DWORD_STAT(STAT_MazeReachablePointsMisses);
+		return false;
+	}
+
+	auto IsReachable = [Topology, Region](const FVector& Point) { return Topology->GetRegion(Point) == Region; };
+	if (Pool.TakePoint(Location, MaxRadius, MinRadius, IsReachable, OutPoint))
+	{
+		INC_DWORD_STAT(STAT_MazeReachablePointsHits);
+		return true;
+	}
+
+	// Callers stand on the navmesh, which makes their location a good anchor for a bucket that has none
+	INC_DWORD_STAT(STAT_MazeReachablePointsMisses);
+	Pool.AddAnchor(Location);
+	return false;
+}
+
+bool UMazeReachablePointSubsystem::WarmPool()
+{
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(World);
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!World || !NavSys)
+	{
+		return false;
+	}
+
+	// Points are handed out by topology region, so the grid is built along with the pool
+	if (!Topology || !Topology->EnsureGraph())
+	{
+		return false;
+	}
+
+	FBox Bounds(ForceInit);
+	for (TActorIterator<ANavMeshBoundsVolume> It(World); It; ++It)
+	{
+		Bounds += It->GetComponentsBoundingBox(true);
+	}
+	if (!Bounds.IsValid)
+	{
+		return false;
+	}
+
+	SCOPE_CYCLE_COUNTER(STAT_MazeReachablePointsWarm);
+	const double StartTime = FPlatformTime::Seconds();
+
+	// One projection per bucket, searching the whole bucket around its centre
+	const float Size = Pool.GetBucketSize();
+	const FIntPoint MinBucket = Pool.GetBucket(Bounds.Min);
+	const FIntPoint MaxBucket = Pool.GetBucket(Bounds.Max);
+	const FVector QueryExtent(Size * 0.5f, Size * 0.5f, Bounds.GetExtent().Z);
+	int32 NumAnchors = 0;
+	for (int32 Y = MinBucket.Y; Y <= MaxBucket.Y; ++Y)
+	{
+		for (int32 X = MinBucket.X; X <= MaxBucket.X; ++X)
+		{
+			const FVector BucketCenter((X + 0.5f) * Size, (Y + 0.5f) * Size, Bounds.GetCenter().Z);
+			FNavLocation NavLocation;
+			if (NavSys->ProjectPointToNavigation(BucketCenter, NavLocation, QueryExtent) && Pool.GetBucket(NavLocation.Location) == FIntPoint(X, Y))
+			{
+				Pool.AddAnchor(NavLocation.Location);
+				++NumAnchors;
+			}
+		}
+	}
+
+	if (NumAnchors == 0)
+	{
+		// The navmesh may still be building
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("MazeReachablePoints: Anchored %d buckets of %.0f units in %.2f ms"),
+		NumAnchors, Size, (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+void UMazeReachablePointSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	// Doors are handled from the registry; a whole rebuild means the navmesh may have changed anywhere
+	if (Cells.Num() == 0)
+	{
+		Pool.Reset(BucketSize, PointsPerBucket);
+		bWarmed = false;
+		LastWarmAttemptTime = -1.0;
+	}
+}
+
+void UMazeReachablePointSubsystem::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	// A door opening or closing changes what can be reached from the anchors around it
+	if (const AMazeGameDoor* Door = Cast<AMazeGameDoor>(ChangedActor))
+	{
+		const FBox DoorBox = Door->GetComponentsBoundingBox();
+		if (DoorBox.IsValid)
+		{
+			Pool.Invalidate(FBox2D(FVector2D(DoorBox.Min), FVector2D(DoorBox.Max)));
+		}
+	}
+}
+
+void UMazeReachablePointSubsystem::HandleRefillPointFound(uint32 QueryId, bool bFound, const FVector& Point, FIntPoint Bucket, uint32 Generation)
+{
+	Pool.FinishRefill(Bucket, Generation, bFound, Point);
+}
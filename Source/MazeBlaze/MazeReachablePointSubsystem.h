@@ -0,0 +1,70 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeReachablePointPool.h"
+#include "MazeReachablePointSubsystem.generated.h"
+
+/**
+ * World subsystem that keeps a pool of pre-sampled reachable points for exploration and recovery targets
+ *
+ * When the navmesh is up, every bucket of the navmesh bounds that projects onto it gets an anchor,
+ * and the pool is filled by a few random reachable point queries a frame on the async navigation
+ * workers; taking a point back out is a lookup in the buckets around the caller, keeping only points in
+ * the caller's topology region so nothing behind a closed door is handed out. Doors opening or closing
+ * drop the points of the buckets that sample around them, since their reachable area changed, and a
+ * rebuilt topology starts the pool over.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeReachablePointSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the point pool subsystem for the world of the given object
+	static UMazeReachablePointSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Take a pooled point within about MaxRadius of Location that is reachable from it, preferring one at least
+	// MinRadius away. Misses while the topology is not built. On a miss the caller's bucket is anchored at
+	// Location, so the next take there finds points
+	bool TakePoint(const FVector& Location, float MaxRadius, float MinRadius, FVector& OutPoint);
+
+	const FMazeReachablePointPool& GetPool() const { return Pool; }
+
+	// Side of a bucket; points are sampled within this distance of the bucket's anchor
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|ReachablePoints", meta = (ClampMin = "100.0"))
+	float BucketSize = 1000.0f;
+
+	// Points kept in each bucket
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|ReachablePoints", meta = (ClampMin = "1"))
+	int32 PointsPerBucket = 8;
+
+	// Refill queries sent to the async navigation subsystem each frame
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|ReachablePoints", meta = (ClampMin = "1"))
+	int32 RefillQueriesPerFrame = 16;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Anchor every bucket of the navmesh bounds that has navmesh in it; returns false if there is none yet
+	bool WarmPool();
+
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+	void HandleMazeActorChanged(AActor* ChangedActor);
+	void HandleRefillPointFound(uint32 QueryId, bool bFound, const FVector& Point, FIntPoint Bucket, uint32 Generation);
+
+	FMazeReachablePointPool Pool;
+
+	bool bWarmed = false;
+	double LastWarmAttemptTime = -1.0;
+
+	FDelegateHandle TopologyChangedHandle;
+	FDelegateHandle MazeActorChangedHandle;
+};
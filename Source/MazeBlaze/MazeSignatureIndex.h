@@ -0,0 +1,233 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "MazeSpatialHash.h"
+
+/**
+ * Index of masked elements bucketed per mask bit
+ *
+ * Doors are opened when Signature & Mask is non-zero, so a door can only match a key
+ * if it sits in the bucket of at least one of the key's bits. Each bucket lists the
+ * elements with that bit set, and a bitset tracks which elements are still active
+ * (closed doors), so a query only touches elements that can actually match. The active
+ * elements of each bucket are also kept in a spatial hash, so the nearest query searches
+ * outwards from the caller in the buckets of the signature's bits only.
+ */
+template<typename ElementType>
+class TMazeSignatureIndex
+{
+public:
+	static constexpr int32 NumBuckets = 32;
+
+	int32 Num() const { return ElementToSlot.Num(); }
+
+	int32 NumActive() const { return ActiveCount; }
+
+	// Cell size of the per-bit spatial hashes; should roughly match the maze corridor width
+	void SetCellSize(float InCellSize)
+	{
+		for (int32 Bit = 0; Bit < NumBuckets; ++Bit)
+		{
+			ActiveHashes[Bit].SetCellSize(InCellSize);
+		}
+	}
+
+	void Reset()
+	{
+		Elements.Reset();
+		Locations.Reset();
+		Masks.Reset();
+		ActiveSlots.Reset();
+		FreeSlots.Reset();
+		ElementToSlot.Reset();
+		ActiveCount = 0;
+		for (int32 Bit = 0; Bit < NumBuckets; ++Bit)
+		{
+			Buckets[Bit].Reset();
+			ActiveHashes[Bit].Reset();
+			ActivePerBucket[Bit] = 0;
+		}
+	}
+
+	// Add an element, or update it if it is already indexed
+	void Add(ElementType Element, const FVector& Location, int32 Mask, bool bActive = true)
+	{
+		Remove(Element);
+
+		int32 Slot;
+		if (FreeSlots.Num() > 0)
+		{
+			Slot = FreeSlots.Pop(EAllowShrinking::No);
+			Elements[Slot] = Element;
+			Locations[Slot] = Location;
+			Masks[Slot] = Mask;
+		}
+		else
+		{
+			Slot = Elements.Add(Element);
+			Locations.Add(Location);
+			Masks.Add(Mask);
+			ActiveSlots.Add(false);
+		}
+		ElementToSlot.Add(Element, Slot);
+
+		ForEachBit(Mask, [this, Slot](int32 Bit)
+		{
+			Buckets[Bit].Add(Slot);
+		});
+
+		SetActiveForSlot(Slot, bActive);
+	}
+
+	bool Remove(ElementType Element)
+	{
+		int32 Slot = INDEX_NONE;
+		if (!ElementToSlot.RemoveAndCopyValue(Element, Slot))
+		{
+			return false;
+		}
+
+		SetActiveForSlot(Slot, false);
+		ForEachBit(Masks[Slot], [this, Slot](int32 Bit)
+		{
+			Buckets[Bit].RemoveSingleSwap(Slot, EAllowShrinking::No);
+		});
+
+		Elements[Slot] = ElementType();
+		Masks[Slot] = 0;
+		FreeSlots.Add(Slot);
+		return true;
+	}
+
+	// Mark an element as active (e.g. door closed) or inactive (door opened)
+	void SetActive(ElementType Element, bool bActive)
+	{
+		if (const int32* Slot = ElementToSlot.Find(Element))
+		{
+			SetActiveForSlot(*Slot, bActive);
+		}
+	}
+
+	bool IsActive(ElementType Element) const
+	{
+		const int32* Slot = ElementToSlot.Find(Element);
+		return Slot && ActiveSlots[*Slot];
+	}
+
+	// Number of active elements that share at least one bit with Signature
+	int32 CountActiveMatching(int32 Signature) const
+	{
+		int32 Count = 0;
+		ForEachMatchingActiveSlot(Signature, [&Count](int32 Slot)
+		{
+			++Count;
+		});
+		return Count;
+	}
+
+	// Nearest active element that shares at least one bit with Signature
+	ElementType FindNearestActiveMatching(const FVector& Location, int32 Signature) const
+	{
+		ElementType Best = ElementType();
+		float BestDistanceSq = MAX_FLT;
+
+		// Each bucket's search stops at the nearest element found in the buckets before it
+		ForEachBit(Signature, [&](int32 Bit)
+		{
+			if (ActivePerBucket[Bit] == 0)
+			{
+				return;
+			}
+
+			ElementType Found;
+			float DistanceSq = 0.0f;
+			const float MaxRadius = BestDistanceSq < MAX_FLT ? FMath::Sqrt(BestDistanceSq) : MAX_FLT;
+			if (ActiveHashes[Bit].FindNearest(Location, MaxRadius, Found, DistanceSq) && DistanceSq < BestDistanceSq)
+			{
+				BestDistanceSq = DistanceSq;
+				Best = Found;
+			}
+		});
+
+		return Best;
+	}
+
+	// Visit every active element that shares at least one bit with Signature exactly once
+	template<typename FuncType>
+	void ForEachMatchingActiveSlot(int32 Signature, FuncType&& Func) const
+	{
+		ForEachBit(Signature, [&](int32 Bit)
+		{
+			if (ActivePerBucket[Bit] == 0)
+			{
+				return;
+			}
+
+			// Elements with several matching bits are only visited from their lowest one
+			const uint32 LowerBits = (1u << Bit) - 1u;
+			for (const int32 Slot : Buckets[Bit])
+			{
+				if (ActiveSlots[Slot] && (static_cast<uint32>(Masks[Slot] & Signature) & LowerBits) == 0)
+				{
+					Func(Slot);
+				}
+			}
+		});
+	}
+
+private:
+	template<typename FuncType>
+	static void ForEachBit(int32 Mask, FuncType&& Func)
+	{
+		uint32 Bits = static_cast<uint32>(Mask);
+		while (Bits != 0)
+		{
+			const int32 Bit = FMath::CountTrailingZeros(Bits);
+			Func(Bit);
+			Bits &= Bits - 1;
+		}
+	}
+
+	void SetActiveForSlot(int32 Slot, bool bActive)
+	{
+		if (ActiveSlots[Slot] == bActive)
+		{
+			return;
+		}
+
+		ActiveSlots[Slot] = bActive;
+		const int32 Delta = bActive ? 1 : -1;
+		ActiveCount += Delta;
+		ForEachBit(Masks[Slot], [this, Slot, bActive, Delta](int32 Bit)
+		{
+			ActivePerBucket[Bit] += Delta;
+			if (bActive)
+			{
+				ActiveHashes[Bit].Add(Elements[Slot], Locations[Slot]);
+			}
+			else
+			{
+				ActiveHashes[Bit].Remove(Elements[Slot]);
+			}
+		});
+	}
+
+	// Per-slot element data (slots are recycled through FreeSlots)
+	TArray<ElementType> Elements;
+	TArray<FVector> Locations;
+	TArray<int32> Masks;
+	TBitArray<> ActiveSlots;
+	TArray<int32> FreeSlots;
+
+	TMap<ElementType, int32> ElementToSlot;
+
+	// Slots with each mask bit set, and how many of them are active
+	TArray<int32> Buckets[NumBuckets];
+	int32 ActivePerBucket[NumBuckets] = {};
+
+	// Active elements of each bucket by location
+	TMazeSpatialHash<ElementType> ActiveHashes[NumBuckets];
+
+	int32 ActiveCount = 0;
+};
@@ -0,0 +1,307 @@
+#include "MazeSimulationGameMode.h"
+#include "MazeBlazeAICharacter.h"
+#include "MazeBlazeAIController.h"
+#include "MazeBlazeGameInstance.h"
+#include "Engine/GameViewportClient.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Kismet/GameplayStatics.h"
+#include "Misc/App.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "NavigationSystem.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+AMazeSimulationGameMode::AMazeSimulationGameMode()
+{
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = true;
+
+	// Agents are spawned by the game mode, the local player only watches
+	DefaultPawnClass = nullptr;
+}
+
+void AMazeSimulationGameMode::InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage)
+{
+	Super::InitGame(MapName, Options, ErrorMessage);
+
+	NumAgents = FMath::Max(1, UGameplayStatics::GetIntOption(Options, TEXT("Agents"), NumAgents));
+	Seed = UGameplayStatics::GetIntOption(Options, TEXT("Seed"), Seed);
+	if (UGameplayStatics::HasOption(Options, TEXT("TickRate")))
+	{
+		TickRate = FMath::Max(1.0f, FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("TickRate"))));
+	}
+	if (UGameplayStatics::HasOption(Options, TEXT("MaxTime")))
+	{
+		MaxSimulationTime = FMath::Max(1.0f, FCString::Atof(*UGameplayStatics::ParseOption(Options, TEXT("MaxTime"))));
+	}
+
+	ReportPath = UGameplayStatics::ParseOption(Options, TEXT("Report"));
+	if (ReportPath.IsEmpty())
+	{
+		ReportPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("Simulation"),
+			FString::Printf(TEXT("%s-seed%d.json"), *FPaths::GetBaseFilename(MapName), Seed));
+	}
+
+	// Everything drawing random numbers through FMath starts from the seed
+	FMath::RandInit(Seed);
+	FMath::SRandInit(Seed);
+
+	// Fixed steps without waiting for real time; PIE keeps the editor's clock
+	if (!GIsEditor)
+	{
+		FApp::SetBenchmarking(true);
+		FApp::SetUseFixedTimeStep(true);
+		FApp::SetFixedDeltaTime(1.0 / TickRate);
+	}
+
+	if (IConsoleVariable* DebugDraw = IConsoleManager::Get().FindConsoleVariable(TEXT("MazeBlaze.AI.DebugDraw")))
+	{
+		DebugDraw->Set(0, ECVF_SetByCode);
+	}
+
+	// The agent characters only run their AI when the game is played as AI
+	if (UMazeBlazeGameInstance* GameInstance = Cast<UMazeBlazeGameInstance>(GetGameInstance()))
+	{
+		GameInstance->SetPlayAsAI(true);
+	}
+}
+
+void AMazeSimulationGameMode::StartPlay()
+{
+	Super::StartPlay();
+
+	if (UGameViewportClient* Viewport = GetWorld()->GetGameViewport())
+	{
+		Viewport->bDisableWorldRendering = true;
+	}
+
+	SpawnAgents();
+	StartTime = FPlatformTime::Seconds();
+
+	UE_LOG(LogTemp, Display, TEXT("MazeSimulation: %d agents on %s, seed %d, %.0f ticks per second"),
+		   NumActiveAgents, *GetWorld()->GetMapName(), Seed, TickRate);
+}
+
+void AMazeSimulationGameMode::SpawnAgents()
+{
+	UWorld* World = GetWorld();
+
+	TSubclassOf<AMazeBlazeAICharacter> CharacterClass = AgentClass.LoadSynchronous();
+	if (!CharacterClass)
+	{
+		CharacterClass = AMazeBlazeAICharacter::StaticClass();
+	}
+	TSubclassOf<AMazeBlazeAIController> AgentControllerClass = ControllerClass.LoadSynchronous();
+	if (!AgentControllerClass)
+	{
+		AgentControllerClass = AMazeBlazeAIController::StaticClass();
+	}
+
+	// Sorted by name so the agents get the same starts on every run
+	TArray<APlayerStart*> PlayerStarts;
+	for (TActorIterator<APlayerStart> It(World); It; ++It)
+	{
+		PlayerStarts.Add(*It);
+	}
+	PlayerStarts.Sort([](const APlayerStart& A, const APlayerStart& B) { return A.GetFName().LexicalLess(B.GetFName()); });
+	if (PlayerStarts.Num() == 0)
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeSimulation: %s has no player start to spawn agents at"), *World->GetMapName());
+		return;
+	}
+
+	const UNavigationSystemV1* NavSys = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	FRandomStream Stream(Seed);
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	Runs.Reserve(NumAgents);
+	for (int32 Index = 0; Index < NumAgents; ++Index)
+	{
+		const APlayerStart* Start = PlayerStarts[Index % PlayerStarts.Num()];
+		FVector Location = Start->GetActorLocation();
+		const float Angle = Stream.FRandRange(0.0f, UE_TWO_PI);
+		const float Distance = SpawnRadius * FMath::Sqrt(Stream.FRand());
+		const FVector2D Offset(Distance * FMath::Cos(Angle), Distance * FMath::Sin(Angle));
+		FNavLocation NavLocation;
+		if (NavSys && NavSys->ProjectPointToNavigation(Location + FVector(Offset, 0.0f), NavLocation, FVector(SpawnRadius, SpawnRadius, 200.0f)))
+		{
+			Location.X = NavLocation.Location.X;
+			Location.Y = NavLocation.Location.Y;
+		}
+
+		AMazeBlazeAICharacter* Character = World->SpawnActor<AMazeBlazeAICharacter>(CharacterClass, Location, Start->GetActorRotation(), SpawnParams);
+		AMazeBlazeAIController* Controller = Character ? World->SpawnActor<AMazeBlazeAIController>(AgentControllerClass, Location, Start->GetActorRotation()) : nullptr;
+		if (!Controller)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("MazeSimulation: Failed to spawn agent %d"), Index);
+			if (Character)
+			{
+				Character->Destroy();
+			}
+			continue;
+		}
+		Controller->Possess(Character);
+
+		FAgentRun& Run = Runs.AddDefaulted_GetRef();
+		Run.Character = Character;
+		Run.Controller = Controller;
+	}
+	NumActiveAgents = Runs.Num();
+}
+
+void AMazeSimulationGameMode::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (bFinished)
+	{
+		return;
+	}
+
+	// The time since the last tick covers one whole frame of the game thread
+	const double Now = FPlatformTime::Seconds();
+	if (LastTickTime > 0.0 && NumActiveAgents > 0)
+	{
+		TotalFrameSeconds += Now - LastTickTime;
+		TotalAgentTicks += NumActiveAgents;
+		++NumTicks;
+	}
+	LastTickTime = Now;
+
+	for (FAgentRun& Run : Runs)
+	{
+		if (Run.bFinished)
+		{
+			continue;
+		}
+		const AMazeBlazeAICharacter* Character = Run.Character.Get();
+		if (!Character || Character->HasReachedExit())
+		{
+			FinishAgent(Run);
+		}
+	}
+
+	if (NumActiveAgents == 0 || GetWorld()->GetTimeSeconds() >= MaxSimulationTime)
+	{
+		for (FAgentRun& Run : Runs)
+		{
+			if (!Run.bFinished)
+			{
+				FinishAgent(Run);
+			}
+		}
+		WriteReport();
+	}
+}
+
+void AMazeSimulationGameMode::FinishAgent(FAgentRun& Run, bool bRemoveFromWorld)
+{
+	Run.bFinished = true;
+	--NumActiveAgents;
+
+	if (AMazeBlazeAICharacter* Character = Run.Character.Get())
+	{
+		Run.bReachedExit = Character->HasReachedExit();
+		Run.TimeToExit = Character->GetTimeTaken();
+		Run.KeysCollected = Character->GetKeysCollected();
+		Run.DoorsOpened = Character->GetDoorsOpened();
+		Run.BacktrackingInstances = Character->GetBacktrackingInstances();
+		if (bRemoveFromWorld)
+		{
+			Character->Destroy();
+		}
+	}
+	if (AMazeBlazeAIController* Controller = Run.Controller.Get(); Controller && bRemoveFromWorld)
+	{
+		Controller->Destroy();
+	}
+}
+
+void AMazeSimulationGameMode::WriteReport()
+{
+	bFinished = true;
+
+	const double WallSeconds = FPlatformTime::Seconds() - StartTime;
+	const double SimulatedSeconds = GetWorld()->GetTimeSeconds();
+
+	int32 NumSolved = 0;
+	TArray<TSharedPtr<FJsonValue>> Agents;
+	Agents.Reserve(Runs.Num());
+	for (int32 Index = 0; Index < Runs.Num(); ++Index)
+	{
+		const FAgentRun& Run = Runs[Index];
+		NumSolved += Run.bReachedExit ? 1 : 0;
+
+		TSharedRef<FJsonObject> Agent = MakeShared<FJsonObject>();
+		Agent->SetNumberField(TEXT("index"), Index);
+		Agent->SetBoolField(TEXT("reachedExit"), Run.bReachedExit);
+		Agent->SetNumberField(TEXT("timeToExit"), Run.bReachedExit ? Run.TimeToExit : -1.0);
+		Agent->SetNumberField(TEXT("keysCollected"), Run.KeysCollected);
+		Agent->SetNumberField(TEXT("doorsOpened"), Run.DoorsOpened);
+		Agent->SetNumberField(TEXT("backtrackingInstances"), Run.BacktrackingInstances);
+		Agents.Add(MakeShared<FJsonValueObject>(Agent));
+	}
+
+	const double CpuMsPerTick = NumTicks > 0 ? TotalFrameSeconds * 1000.0 / NumTicks : 0.0;
+	const double CpuMsPerAgentPerTick = TotalAgentTicks > 0.0 ? TotalFrameSeconds * 1000.0 / TotalAgentTicks : 0.0;
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Report->SetNumberField(TEXT("seed"), Seed);
+	Report->SetNumberField(TEXT("numAgents"), Runs.Num());
+	Report->SetNumberField(TEXT("timeStep"), 1.0 / TickRate);
+	Report->SetNumberField(TEXT("simulatedSeconds"), SimulatedSeconds);
+	Report->SetNumberField(TEXT("ticks"), NumTicks);
+	Report->SetNumberField(TEXT("wallSeconds"), WallSeconds);
+	Report->SetNumberField(TEXT("cpuMsPerTick"), CpuMsPerTick);
+	Report->SetNumberField(TEXT("cpuMsPerAgentPerTick"), CpuMsPerAgentPerTick);
+	Report->SetNumberField(TEXT("solved"), NumSolved);
+	Report->SetNumberField(TEXT("solvesPerSecond"), WallSeconds > 0.0 ? NumSolved / WallSeconds : 0.0);
+	Report->SetArrayField(TEXT("agents"), Agents);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	if (FFileHelper::SaveStringToFile(Json, *ReportPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("MazeSimulation: %d of %d agents solved the maze in %.1f simulated seconds (%.1fs wall, %.3f ms per agent per tick), report in %s"),
+			   NumSolved, Runs.Num(), SimulatedSeconds, WallSeconds, CpuMsPerAgentPerTick, *ReportPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeSimulation: Cannot write the report to %s"), *ReportPath);
+	}
+
+	// A standalone run ends with its report; in PIE the session stays open
+	if (!GIsEditor)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void AMazeSimulationGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Leaving the level early still reports the agents that got out; the world removes the rest
+	if (!bFinished && Runs.Num() > 0)
+	{
+		for (FAgentRun& Run : Runs)
+		{
+			if (!Run.bFinished)
+			{
+				FinishAgent(Run, false);
+			}
+		}
+		WriteReport();
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "MazeBlazeExitPolicyInterface.h"
+#include "MazeSimulationGameMode.generated.h"
+
+class AMazeBlazeAICharacter;
+class AMazeBlazeAIController;
+
+/**
+ * Game mode that runs the maze AI headless and reports how fast the agents solve the level
+ *
+ * Spawns NumAgents AI characters at the player starts, ticks the world at a fixed timestep as fast
+ * as the CPU allows and writes a JSON report once every agent reached the exit or the simulated
+ * time ran out. The run is seeded, so the same map, seed and agent count spawn the same agents at
+ * the same places. Typical use:
+ *
+ *   UnrealEditor MazeBlaze.uproject /Game/MazeGame/Levels/Maze_0_Intro?game=/Script/MazeBlaze.MazeSimulationGameMode?Agents=64?Seed=7
+ *       -game -nullrhi -unattended -nosound
+ *
+ * URL options Agents, Seed, TickRate, MaxTime and Report override the config values below.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API AMazeSimulationGameMode : public AGameModeBase, public IMazeBlazeExitPolicyInterface
+{
+	GENERATED_BODY()
+
+public:
+	AMazeSimulationGameMode();
+
+	virtual void InitGame(const FString& MapName, const FString& Options, FString& ErrorMessage) override;
+	virtual void StartPlay() override;
+	virtual void Tick(float DeltaSeconds) override;
+
+	// The level stays loaded until every agent is out and the report is written
+	virtual bool ShouldTravelOnExit_Implementation(const AMazeBlazeCharacter* Character) const override { return false; }
+
+	// Whether the report was written and the run is over
+	bool IsSimulationFinished() const { return bFinished; }
+
+	// Agents spawned for the run
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation", meta = (ClampMin = "1"))
+	int32 NumAgents = 16;
+
+	// Seed of the random streams the agents and their spawn points are drawn from
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation")
+	int32 Seed = 1;
+
+	// Simulated ticks per second; every tick advances the world by exactly 1 / TickRate seconds
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation", meta = (ClampMin = "1.0"))
+	float TickRate = 30.0f;
+
+	// Simulated seconds after which agents still in the maze count as unsolved
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation", meta = (ClampMin = "1.0"))
+	float MaxSimulationTime = 600.0f;
+
+	// Agents are spread over a circle of this radius around their player start
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation", meta = (ClampMin = "0.0"))
+	float SpawnRadius = 150.0f;
+
+	// Character spawned for each agent
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation")
+	TSoftClassPtr<AMazeBlazeAICharacter> AgentClass;
+
+	// Controller possessing each agent
+	UPROPERTY(Config, EditAnywhere, Category = "AI|Simulation")
+	TSoftClassPtr<AMazeBlazeAIController> ControllerClass;
+
+protected:
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+private:
+	struct FAgentRun
+	{
+		TWeakObjectPtr<AMazeBlazeAICharacter> Character;
+		TWeakObjectPtr<AMazeBlazeAIController> Controller;
+		bool bFinished = false;
+		bool bReachedExit = false;
+		float TimeToExit = 0.0f;
+		int32 KeysCollected = 0;
+		int32 DoorsOpened = 0;
+		int32 BacktrackingInstances = 0;
+	};
+
+	void SpawnAgents();
+
+	// Record the metrics of an agent and take it out of the world
+	void FinishAgent(FAgentRun& Run, bool bRemoveFromWorld = true);
+
+	void WriteReport();
+
+	TArray<FAgentRun> Runs;
+	int32 NumActiveAgents = 0;
+
+	// Report file, by default Saved/Simulation/<map>-seed<seed>.json
+	FString ReportPath;
+
+	// Game thread time between ticks of this game mode, with the first frame left out
+	double LastTickTime = 0.0;
+	double TotalFrameSeconds = 0.0;
+	double TotalAgentTicks = 0.0;
+	int32 NumTicks = 0;
+	double StartTime = 0.0;
+
+	bool bFinished = false;
+};
@@ -0,0 +1,388 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform spatial hash over the XY plane of the maze
+ *
+ * Elements are bucketed into square cells (the cell size should roughly match the
+ * maze corridor width) and carry a bitmask, so nearest, k-nearest and radius queries
+ * can be filtered with the same Signature & Mask test used by keys and doors.
+ * Queries do not allocate unless the caller's output array has to grow.
+ */
+template<typename ElementType>
+class TMazeSpatialHash
+{
+public:
+	explicit TMazeSpatialHash(float InCellSize = 400.0f)
+		: CellSize(FMath::Max(InCellSize, 1.0f))
+		, InvCellSize(1.0f / CellSize)
+	{
+	}
+
+	// Change the cell size and rebucket all elements
+	void SetCellSize(float InCellSize)
+	{
+		CellSize = FMath::Max(InCellSize, 1.0f);
+		InvCellSize = 1.0f / CellSize;
+
+		TArray<FEntry> OldEntries = MoveTemp(Entries);
+		Reset();
+		for (const FEntry& Entry : OldEntries)
+		{
+			Add(Entry.Element, Entry.Location, Entry.Mask);
+		}
+	}
+
+	float GetCellSize() const { return CellSize; }
+
+	int32 Num() const { return Entries.Num(); }
+
+	bool Contains(ElementType Element) const { return ElementToIndex.Contains(Element); }
+
+	void Reset()
+	{
+		Entries.Reset();
+		ElementToIndex.Reset();
+		Cells.Reset();
+		MinCell = FIntPoint(MAX_int32, MAX_int32);
+		MaxCell = FIntPoint(MIN_int32, MIN_int32);
+	}
+
+	// Add an element, or move it if it is already in the hash
+	void Add(ElementType Element, const FVector& Location, int32 Mask = 0)
+	{
+		if (ElementToIndex.Contains(Element))
+		{
+			Remove(Element);
+		}
+
+		const FIntPoint Cell = GetCell(Location);
+		const int32 Index = Entries.Add({ Element, Location, Mask, Cell });
+		ElementToIndex.Add(Element, Index);
+		Cells.FindOrAdd(Cell).Add(Index);
+
+		MinCell = FIntPoint(FMath::Min(MinCell.X, Cell.X), FMath::Min(MinCell.Y, Cell.Y));
+		MaxCell = FIntPoint(FMath::Max(MaxCell.X, Cell.X), FMath::Max(MaxCell.Y, Cell.Y));
+	}
+
+	bool Remove(ElementType Element)
+	{
+		int32 Index = INDEX_NONE;
+		if (!ElementToIndex.RemoveAndCopyValue(Element, Index))
+		{
+			return false;
+		}
+
+		RemoveFromCell(Entries[Index].Cell, Index);
+
+		// Move the last entry into the freed slot and patch its references
+		const int32 LastIndex = Entries.Num() - 1;
+		if (Index != LastIndex)
+		{
+			const FEntry& Moved = Entries[LastIndex];
+			TArray<int32>& MovedCell = Cells.FindChecked(Moved.Cell);
+			MovedCell[MovedCell.IndexOfByKey(LastIndex)] = Index;
+			ElementToIndex.FindChecked(Moved.Element) = Index;
+		}
+		Entries.RemoveAtSwap(Index, 1, EAllowShrinking::No);
+		return true;
+	}
+
+	// Nearest element to Location, or the default value if none is within MaxRadius
+	ElementType FindNearest(const FVector& Location, float MaxRadius = MAX_FLT) const
+	{
+		return FindNearestInternal(Location, 0, false, MaxRadius);
+	}
+
+	// Nearest element within MaxRadius and its squared distance; returns false if there is none
+	bool FindNearest(const FVector& Location, float MaxRadius, ElementType& OutElement, float& OutDistanceSq) const
+	{
+		const int32 Index = FindNearestIndex(Location, 0, false, MaxRadius, OutDistanceSq);
+		if (Index == INDEX_NONE)
+		{
+			return false;
+		}
+		OutElement = Entries[Index].Element;
+		return true;
+	}
+
+	// Nearest element whose mask shares at least one bit with MatchMask
+	ElementType FindNearestMatching(const FVector& Location, int32 MatchMask, float MaxRadius = MAX_FLT) const
+	{
+		return FindNearestInternal(Location, MatchMask, true, MaxRadius);
+	}
+
+	// Up to K nearest elements, sorted by distance
+	template<typename AllocatorType>
+	void FindKNearest(const FVector& Location, int32 K, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		FindKNearestInternal(Location, K, 0, false, OutElements);
+	}
+
+	template<typename AllocatorType>
+	void FindKNearestMatching(const FVector& Location, int32 K, int32 MatchMask, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		FindKNearestInternal(Location, K, MatchMask, true, OutElements);
+	}
+
+	// All elements within Radius, in no particular order
+	template<typename AllocatorType>
+	void FindInRadius(const FVector& Location, float Radius, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		FindInRadiusInternal(Location, Radius, 0, false, OutElements);
+	}
+
+	template<typename AllocatorType>
+	void FindInRadiusMatching(const FVector& Location, float Radius, int32 MatchMask, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		FindInRadiusInternal(Location, Radius, MatchMask, true, OutElements);
+	}
+
+private:
+	struct FEntry
+	{
+		ElementType Element;
+		FVector Location;
+		int32 Mask;
+		FIntPoint Cell;
+	};
+
+	FIntPoint GetCell(const FVector& Location) const
+	{
+		return FIntPoint(FMath::FloorToInt(Location.X * InvCellSize), FMath::FloorToInt(Location.Y * InvCellSize));
+	}
+
+	void RemoveFromCell(const FIntPoint& Cell, int32 Index)
+	{
+		TArray<int32>* CellEntries = Cells.Find(Cell);
+		if (CellEntries)
+		{
+			CellEntries->RemoveSingleSwap(Index, EAllowShrinking::No);
+			if (CellEntries->Num() == 0)
+			{
+				Cells.Remove(Cell);
+			}
+		}
+	}
+
+	static bool PassesMask(const FEntry& Entry, int32 MatchMask, bool bFilterByMask)
+	{
+		return !bFilterByMask || (Entry.Mask & MatchMask) != 0;
+	}
+
+	// Number of rings needed to cover every occupied cell from Center
+	int32 GetMaxRing(const FIntPoint& Center, float MaxRadius) const
+	{
+		if (Entries.Num() == 0)
+		{
+			return -1;
+		}
+
+		const int32 BoundsRing = FMath::Max(
+			FMath::Max(FMath::Abs(Center.X - MinCell.X), FMath::Abs(MaxCell.X - Center.X)),
+			FMath::Max(FMath::Abs(Center.Y - MinCell.Y), FMath::Abs(MaxCell.Y - Center.Y)));
+
+		if (MaxRadius >= MAX_FLT * 0.5f)
+		{
+			return BoundsRing;
+		}
+		return FMath::Min(BoundsRing, FMath::CeilToInt(MaxRadius * InvCellSize));
+	}
+
+	// Visit every cell on the square ring at Chebyshev distance Ring from Center
+	template<typename FuncType>
+	void ForEachCellOnRing(const FIntPoint& Center, int32 Ring, FuncType&& Func) const
+	{
+		if (Ring == 0)
+		{
+			if (const TArray<int32>* CellEntries = Cells.Find(Center))
+			{
+				Func(*CellEntries);
+			}
+			return;
+		}
+
+		for (int32 X = Center.X - Ring; X <= Center.X + Ring; ++X)
+		{
+			if (const TArray<int32>* Top = Cells.Find(FIntPoint(X, Center.Y - Ring)))
+			{
+				Func(*Top);
+			}
+			if (const TArray<int32>* Bottom = Cells.Find(FIntPoint(X, Center.Y + Ring)))
+			{
+				Func(*Bottom);
+			}
+		}
+		for (int32 Y = Center.Y - Ring + 1; Y <= Center.Y + Ring - 1; ++Y)
+		{
+			if (const TArray<int32>* Left = Cells.Find(FIntPoint(Center.X - Ring, Y)))
+			{
+				Func(*Left);
+			}
+			if (const TArray<int32>* Right = Cells.Find(FIntPoint(Center.X + Ring, Y)))
+			{
+				Func(*Right);
+			}
+		}
+	}
+
+	ElementType FindNearestInternal(const FVector& Location, int32 MatchMask, bool bFilterByMask, float MaxRadius) const
+	{
+		float DistanceSq = 0.0f;
+		const int32 Index = FindNearestIndex(Location, MatchMask, bFilterByMask, MaxRadius, DistanceSq);
+		return Index != INDEX_NONE ? Entries[Index].Element : ElementType();
+	}
+
+	int32 FindNearestIndex(const FVector& Location, int32 MatchMask, bool bFilterByMask, float MaxRadius, float& OutDistanceSq) const
+	{
+		const FIntPoint Center = GetCell(Location);
+		const int32 MaxRing = GetMaxRing(Center, MaxRadius);
+		const float MaxRadiusSq = MaxRadius >= MAX_FLT * 0.5f ? MAX_FLT : MaxRadius * MaxRadius;
+
+		int32 BestIndex = INDEX_NONE;
+		float BestDistanceSq = MaxRadiusSq;
+
+		for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+		{
+			ForEachCellOnRing(Center, Ring, [&](const TArray<int32>& CellEntries)
+			{
+				for (const int32 Index : CellEntries)
+				{
+					const FEntry& Entry = Entries[Index];
+					if (!PassesMask(Entry, MatchMask, bFilterByMask))
+					{
+						continue;
+					}
+
+					const float DistanceSq = FVector::DistSquared(Location, Entry.Location);
+					if (DistanceSq <= BestDistanceSq)
+					{
+						BestDistanceSq = DistanceSq;
+						BestIndex = Index;
+					}
+				}
+			});
+
+			// Every cell on the next ring is at least Ring cells away from Location
+			const float NextRingDistance = Ring * CellSize;
+			if (BestIndex != INDEX_NONE && BestDistanceSq <= NextRingDistance * NextRingDistance)
+			{
+				break;
+			}
+		}
+
+		OutDistanceSq = BestDistanceSq;
+		return BestIndex;
+	}
+
+	template<typename AllocatorType>
+	void FindKNearestInternal(const FVector& Location, int32 K, int32 MatchMask, bool bFilterByMask, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		OutElements.Reset();
+		if (K <= 0)
+		{
+			return;
+		}
+
+		// Best candidates so far, sorted by ascending distance
+		TArray<TPair<float, int32>, TInlineAllocator<16>> Best;
+
+		const FIntPoint Center = GetCell(Location);
+		const int32 MaxRing = GetMaxRing(Center, MAX_FLT);
+
+		for (int32 Ring = 0; Ring <= MaxRing; ++Ring)
+		{
+			ForEachCellOnRing(Center, Ring, [&](const TArray<int32>& CellEntries)
+			{
+				for (const int32 Index : CellEntries)
+				{
+					const FEntry& Entry = Entries[Index];
+					if (!PassesMask(Entry, MatchMask, bFilterByMask))
+					{
+						continue;
+					}
+
+					const float DistanceSq = FVector::DistSquared(Location, Entry.Location);
+					if (Best.Num() == K && DistanceSq >= Best.Last().Key)
+					{
+						continue;
+					}
+
+					int32 InsertAt = Best.Num();
+					while (InsertAt > 0 && Best[InsertAt - 1].Key > DistanceSq)
+					{
+						--InsertAt;
+					}
+					Best.Insert(TPair<float, int32>(DistanceSq, Index), InsertAt);
+					if (Best.Num() > K)
+					{
+						Best.Pop(EAllowShrinking::No);
+					}
+				}
+			});
+
+			const float NextRingDistance = Ring * CellSize;
+			if (Best.Num() == K && Best.Last().Key <= NextRingDistance * NextRingDistance)
+			{
+				break;
+			}
+		}
+
+		for (const TPair<float, int32>& Candidate : Best)
+		{
+			OutElements.Add(Entries[Candidate.Value].Element);
+		}
+	}
+
+	template<typename AllocatorType>
+	void FindInRadiusInternal(const FVector& Location, float Radius, int32 MatchMask, bool bFilterByMask, TArray<ElementType, AllocatorType>& OutElements) const
+	{
+		OutElements.Reset();
+		if (Entries.Num() == 0)
+		{
+			return;
+		}
+
+		const float RadiusSq = Radius * Radius;
+		const FIntPoint MinQuery(
+			FMath::Max(FMath::FloorToInt((Location.X - Radius) * InvCellSize), MinCell.X),
+			FMath::Max(FMath::FloorToInt((Location.Y - Radius) * InvCellSize), MinCell.Y));
+		const FIntPoint MaxQuery(
+			FMath::Min(FMath::FloorToInt((Location.X + Radius) * InvCellSize), MaxCell.X),
+			FMath::Min(FMath::FloorToInt((Location.Y + Radius) * InvCellSize), MaxCell.Y));
+
+		for (int32 Y = MinQuery.Y; Y <= MaxQuery.Y; ++Y)
+		{
+			for (int32 X = MinQuery.X; X <= MaxQuery.X; ++X)
+			{
+				const TArray<int32>* CellEntries = Cells.Find(FIntPoint(X, Y));
+				if (!CellEntries)
+				{
+					continue;
+				}
+
+				for (const int32 Index : *CellEntries)
+				{
+					const FEntry& Entry = Entries[Index];
+					if (PassesMask(Entry, MatchMask, bFilterByMask) &&
+						FVector::DistSquared(Location, Entry.Location) <= RadiusSq)
+					{
+						OutElements.Add(Entry.Element);
+					}
+				}
+			}
+		}
+	}
+
+	float CellSize;
+	float InvCellSize;
+
+	TArray<FEntry> Entries;
+	TMap<ElementType, int32> ElementToIndex;
+	TMap<FIntPoint, TArray<int32>> Cells;
+
+	// Bounds of all cells that have ever been occupied since the last reset
+	FIntPoint MinCell = FIntPoint(MAX_int32, MAX_int32);
+	FIntPoint MaxCell = FIntPoint(MIN_int32, MIN_int32);
+};
@@ -0,0 +1,552 @@
+#include "MazeTopologyGraph.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+	struct FOpenNode
+	{
+		int32 Node;
+		int32 Cost;
+		int32 Estimate;
+	};
+
+	struct FOpenNodePredicate
+	{
+		bool operator()(const FOpenNode& A, const FOpenNode& B) const
+		{
+			return A.Estimate < B.Estimate;
+		}
+	};
+
+	int32 ManhattanDistance(const FIntPoint& A, const FIntPoint& B)
+	{
+		return FMath::Abs(A.X - B.X) + FMath::Abs(A.Y - B.Y);
+	}
+}
+
+void FMazeTopologyGraph::Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable)
+{
+	check(InWalkable.Num() == InWidth * InHeight);
+
+	Width = InWidth;
+	Height = InHeight;
+	Walkable = InWalkable;
+
+	Nodes.Reset();
+	FreeNodes.Reset();
+	Edges.Reset();
+	FreeEdges.Reset();
+	CellNode.Init(INDEX_NONE, Width * Height);
+	CellEdge.Init(INDEX_NONE, Width * Height);
+	CellEdgeOffset.Init(INDEX_NONE, Width * Height);
+
+	SearchCost.Reset();
+	SearchParentEdge.Reset();
+	SearchTouched.Reset();
+	bRegionsDirty = true;
+
+	for (TConstSetBitIterator<> It(Walkable); It; ++It)
+	{
+		const FIntPoint Cell(It.GetIndex() % Width, It.GetIndex() / Width);
+		if (ShouldBeNode(Cell))
+		{
+			AddNode(Cell);
+		}
+	}
+
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		TraceEdgesFrom(NodeIndex);
+	}
+}
+
+void FMazeTopologyGraph::SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	// The changed cells and their neighbours are the only ones whose node status can change
+	TArray<FIntPoint, TInlineAllocator<32>> AffectedCells;
+	for (const FIntPoint& Cell : Cells)
+	{
+		if (!IsValidCell(Cell))
+		{
+			continue;
+		}
+
+		Walkable[ToIndex(Cell)] = bWalkable;
+		bRegionsDirty = true;
+		AffectedCells.AddUnique(Cell);
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			if (IsValidCell(Cell + Offset))
+			{
+				AffectedCells.AddUnique(Cell + Offset);
+			}
+		}
+	}
+
+	// Drop every edge running through or ending at an affected cell, remembering the
+	// surviving end nodes so their corridors can be traced again
+	TArray<int32, TInlineAllocator<32>> NodesToTrace;
+	auto RemoveEdgeAndKeepEnds = [this, &NodesToTrace](int32 EdgeIndex)
+	{
+		NodesToTrace.AddUnique(Edges[EdgeIndex].NodeA);
+		NodesToTrace.AddUnique(Edges[EdgeIndex].NodeB);
+		RemoveEdge(EdgeIndex);
+	};
+
+	for (const FIntPoint& Cell : AffectedCells)
+	{
+		const int32 Index = ToIndex(Cell);
+		if (CellEdge[Index] != INDEX_NONE)
+		{
+			RemoveEdgeAndKeepEnds(CellEdge[Index]);
+		}
+		if (CellNode[Index] != INDEX_NONE)
+		{
+			while (Nodes[CellNode[Index]].Edges.Num() > 0)
+			{
+				RemoveEdgeAndKeepEnds(Nodes[CellNode[Index]].Edges.Last());
+			}
+		}
+	}
+
+	for (const FIntPoint& Cell : AffectedCells)
+	{
+		const int32 Index = ToIndex(Cell);
+		const bool bShouldBeNode = ShouldBeNode(Cell);
+		if (CellNode[Index] != INDEX_NONE && !bShouldBeNode)
+		{
+			RemoveNode(CellNode[Index]);
+		}
+		else if (CellNode[Index] == INDEX_NONE && bShouldBeNode)
+		{
+			NodesToTrace.AddUnique(AddNode(Cell));
+		}
+		else if (CellNode[Index] != INDEX_NONE)
+		{
+			NodesToTrace.AddUnique(CellNode[Index]);
+		}
+	}
+
+	for (const int32 NodeIndex : NodesToTrace)
+	{
+		if (Nodes[NodeIndex].bAlive)
+		{
+			TraceEdgesFrom(NodeIndex);
+		}
+	}
+}
+
+int32 FMazeTopologyGraph::FindPath(const FIntPoint& From, const FIntPoint& To, TArray<FIntPoint>* OutCells) const
+{
+	if (OutCells)
+	{
+		OutCells->Reset();
+	}
+
+	if (!IsWalkable(From) || !IsWalkable(To))
+	{
+		return INDEX_NONE;
+	}
+	if (From == To)
+	{
+		return 0;
+	}
+
+	// Cells inside a corridor are entered and left through the nodes at both of its ends
+	const int32 FromIndex = ToIndex(From);
+	const int32 ToCellIndex = ToIndex(To);
+	const int32 FromNode = CellNode[FromIndex];
+	const int32 ToNode = CellNode[ToCellIndex];
+	const int32 FromEdge = CellEdge[FromIndex];
+	const int32 ToEdge = CellEdge[ToCellIndex];
+
+	// Cells on a closed corridor ring with no junction are not part of the graph
+	if ((FromNode == INDEX_NONE && FromEdge == INDEX_NONE) || (ToNode == INDEX_NONE && ToEdge == INDEX_NONE))
+	{
+		return INDEX_NONE;
+	}
+
+	// Cost from the end node of an edge to the corridor cell at Offset
+	auto CostFromA = [](int32 Offset) { return Offset + 1; };
+	auto CostFromB = [](const FEdge& Edge, int32 Offset) { return Edge.Length - Offset - 1; };
+
+	int32 BestCost = MAX_int32;
+	int32 BestNode = INDEX_NONE;
+
+	// Both cells in the same corridor: walking along it is a candidate, though a detour can be shorter on a loop
+	if (FromEdge != INDEX_NONE && FromEdge == ToEdge)
+	{
+		BestCost = FMath::Abs(CellEdgeOffset[FromIndex] - CellEdgeOffset[ToCellIndex]);
+	}
+
+	if (SearchCost.Num() != Nodes.Num())
+	{
+		SearchCost.Init(INDEX_NONE, Nodes.Num());
+		SearchParentEdge.SetNumUninitialized(Nodes.Num());
+		SearchTouched.Reset();
+	}
+
+	TArray<FOpenNode, TInlineAllocator<64>> OpenList;
+	auto Relax = [&](int32 Node, int32 Cost, int32 ParentEdge)
+	{
+		if (SearchCost[Node] != INDEX_NONE && SearchCost[Node] <= Cost)
+		{
+			return;
+		}
+		if (SearchCost[Node] == INDEX_NONE)
+		{
+			SearchTouched.Add(Node);
+		}
+		SearchCost[Node] = Cost;
+		SearchParentEdge[Node] = ParentEdge;
+		OpenList.HeapPush(FOpenNode{ Node, Cost, Cost + ManhattanDistance(Nodes[Node].Cell, To) }, FOpenNodePredicate());
+	};
+
+	// Source nodes have no parent edge; their entry cost is kept for path reconstruction
+	if (FromNode != INDEX_NONE)
+	{
+		Relax(FromNode, 0, INDEX_NONE);
+	}
+	else
+	{
+		const FEdge& Edge = Edges[FromEdge];
+		Relax(Edge.NodeA, CostFromA(CellEdgeOffset[FromIndex]), INDEX_NONE);
+		Relax(Edge.NodeB, CostFromB(Edge, CellEdgeOffset[FromIndex]), INDEX_NONE);
+	}
+
+	auto CostToTarget = [&](int32 Node)
+	{
+		if (ToNode != INDEX_NONE)
+		{
+			return Node == ToNode ? 0 : INDEX_NONE;
+		}
+
+		const FEdge& Edge = Edges[ToEdge];
+		const int32 Offset = CellEdgeOffset[ToCellIndex];
+		if (Node == Edge.NodeA && Node == Edge.NodeB)
+		{
+			return FMath::Min(CostFromA(Offset), CostFromB(Edge, Offset));
+		}
+		if (Node == Edge.NodeA)
+		{
+			return CostFromA(Offset);
+		}
+		return Node == Edge.NodeB ? CostFromB(Edge, Offset) : INDEX_NONE;
+	};
+
+	while (OpenList.Num() > 0)
+	{
+		FOpenNode Open;
+		OpenList.HeapPop(Open, FOpenNodePredicate(), EAllowShrinking::No);
+
+		// The heuristic never overestimates, so nothing left in the open list can beat the best path
+		if (Open.Estimate >= BestCost)
+		{
+			break;
+		}
+		if (Open.Cost != SearchCost[Open.Node])
+		{
+			continue;
+		}
+
+		const int32 TargetCost = CostToTarget(Open.Node);
+		if (TargetCost != INDEX_NONE && Open.Cost + TargetCost < BestCost)
+		{
+			BestCost = Open.Cost + TargetCost;
+			BestNode = Open.Node;
+		}
+
+		for (const int32 EdgeIndex : Nodes[Open.Node].Edges)
+		{
+			const FEdge& Edge = Edges[EdgeIndex];
+			const int32 Other = Edge.NodeA == Open.Node ? Edge.NodeB : Edge.NodeA;
+			Relax(Other, Open.Cost + Edge.Length, EdgeIndex);
+		}
+	}
+
+	if (OutCells && BestCost != MAX_int32)
+	{
+		if (BestNode == INDEX_NONE)
+		{
+			// Straight along the shared corridor
+			const FEdge& Edge = Edges[FromEdge];
+			const int32 Step = CellEdgeOffset[ToCellIndex] > CellEdgeOffset[FromIndex] ? 1 : -1;
+			for (int32 Offset = CellEdgeOffset[FromIndex] + Step; Offset != CellEdgeOffset[ToCellIndex] + Step; Offset += Step)
+			{
+				OutCells->Add(Edge.Cells[Offset]);
+			}
+		}
+		else
+		{
+			// Corridor from the last node to the target, written backwards
+			if (ToNode == INDEX_NONE)
+			{
+				const FEdge& Edge = Edges[ToEdge];
+				const int32 Offset = CellEdgeOffset[ToCellIndex];
+				const bool bFromA = BestNode == Edge.NodeA && (Edge.NodeA != Edge.NodeB || CostFromA(Offset) <= CostFromB(Edge, Offset));
+				if (bFromA)
+				{
+					for (int32 Index = Offset; Index >= 0; --Index)
+					{
+						OutCells->Add(Edge.Cells[Index]);
+					}
+				}
+				else
+				{
+					for (int32 Index = Offset; Index < Edge.Cells.Num(); ++Index)
+					{
+						OutCells->Add(Edge.Cells[Index]);
+					}
+				}
+			}
+
+			// Edges back to the source node
+			int32 Node = BestNode;
+			while (SearchParentEdge[Node] != INDEX_NONE)
+			{
+				const FEdge& Edge = Edges[SearchParentEdge[Node]];
+				OutCells->Add(Nodes[Node].Cell);
+				if (Edge.NodeB == Node)
+				{
+					for (int32 Index = Edge.Cells.Num() - 1; Index >= 0; --Index)
+					{
+						OutCells->Add(Edge.Cells[Index]);
+					}
+					Node = Edge.NodeA;
+				}
+				else
+				{
+					for (const FIntPoint& Cell : Edge.Cells)
+					{
+						OutCells->Add(Cell);
+					}
+					Node = Edge.NodeB;
+				}
+			}
+
+			// Corridor from the start to the source node
+			if (FromNode == INDEX_NONE)
+			{
+				OutCells->Add(Nodes[Node].Cell);
+
+				const FEdge& Edge = Edges[FromEdge];
+				const int32 Offset = CellEdgeOffset[FromIndex];
+				const bool bToA = Node == Edge.NodeA && (Edge.NodeA != Edge.NodeB || CostFromA(Offset) <= CostFromB(Edge, Offset));
+				if (bToA)
+				{
+					for (int32 Index = 0; Index < Offset; ++Index)
+					{
+						OutCells->Add(Edge.Cells[Index]);
+					}
+				}
+				else
+				{
+					for (int32 Index = Edge.Cells.Num() - 1; Index > Offset; --Index)
+					{
+						OutCells->Add(Edge.Cells[Index]);
+					}
+				}
+			}
+
+			Algo::Reverse(*OutCells);
+		}
+	}
+
+	for (const int32 Node : SearchTouched)
+	{
+		SearchCost[Node] = INDEX_NONE;
+	}
+	SearchTouched.Reset();
+
+	return BestCost == MAX_int32 ? INDEX_NONE : BestCost;
+}
+
+int32 FMazeTopologyGraph::CountWalkableNeighbours(const FIntPoint& Cell) const
+{
+	int32 Count = 0;
+	for (const FIntPoint& Offset : CardinalOffsets)
+	{
+		Count += IsWalkable(Cell + Offset) ? 1 : 0;
+	}
+	return Count;
+}
+
+int32 FMazeTopologyGraph::AddNode(const FIntPoint& Cell)
+{
+	const int32 NodeIndex = FreeNodes.Num() > 0 ? FreeNodes.Pop(EAllowShrinking::No) : Nodes.AddDefaulted();
+	FNode& Node = Nodes[NodeIndex];
+	Node.Cell = Cell;
+	Node.Edges.Reset();
+	Node.bAlive = true;
+	CellNode[ToIndex(Cell)] = NodeIndex;
+	return NodeIndex;
+}
+
+void FMazeTopologyGraph::RemoveNode(int32 NodeIndex)
+{
+	FNode& Node = Nodes[NodeIndex];
+	while (Node.Edges.Num() > 0)
+	{
+		RemoveEdge(Node.Edges.Last());
+	}
+
+	CellNode[ToIndex(Node.Cell)] = INDEX_NONE;
+	Node.bAlive = false;
+	FreeNodes.Add(NodeIndex);
+}
+
+void FMazeTopologyGraph::RemoveEdge(int32 EdgeIndex)
+{
+	FEdge& Edge = Edges[EdgeIndex];
+	for (const FIntPoint& Cell : Edge.Cells)
+	{
+		CellEdge[ToIndex(Cell)] = INDEX_NONE;
+		CellEdgeOffset[ToIndex(Cell)] = INDEX_NONE;
+	}
+
+	Nodes[Edge.NodeA].Edges.RemoveSingleSwap(EdgeIndex);
+	if (Edge.NodeB != Edge.NodeA)
+	{
+		Nodes[Edge.NodeB].Edges.RemoveSingleSwap(EdgeIndex);
+	}
+
+	Edge.Cells.Reset();
+	Edge.bAlive = false;
+	FreeEdges.Add(EdgeIndex);
+}
+
+void FMazeTopologyGraph::TraceEdgesFrom(int32 NodeIndex)
+{
+	const FIntPoint Cell = Nodes[NodeIndex].Cell;
+	for (const FIntPoint& Offset : CardinalOffsets)
+	{
+		const FIntPoint Neighbour = Cell + Offset;
+		if (!IsWalkable(Neighbour))
+		{
+			continue;
+		}
+
+		const int32 NeighbourIndex = ToIndex(Neighbour);
+		if (CellNode[NeighbourIndex] != INDEX_NONE)
+		{
+			// Adjacent nodes are joined by a single one-step edge
+			const int32 OtherNode = CellNode[NeighbourIndex];
+			if (!HasDirectEdge(NodeIndex, OtherNode))
+			{
+				const int32 EdgeIndex = FreeEdges.Num() > 0 ? FreeEdges.Pop(EAllowShrinking::No) : Edges.AddDefaulted();
+				FEdge& Edge = Edges[EdgeIndex];
+				Edge.NodeA = NodeIndex;
+				Edge.NodeB = OtherNode;
+				Edge.Length = 1;
+				Edge.bAlive = true;
+				Nodes[NodeIndex].Edges.Add(EdgeIndex);
+				Nodes[OtherNode].Edges.Add(EdgeIndex);
+			}
+		}
+		else if (CellEdge[NeighbourIndex] == INDEX_NONE)
+		{
+			TraceCorridor(NodeIndex, Neighbour);
+		}
+	}
+}
+
+void FMazeTopologyGraph::TraceCorridor(int32 NodeIndex, const FIntPoint& FirstCell)
+{
+	const int32 EdgeIndex = FreeEdges.Num() > 0 ? FreeEdges.Pop(EAllowShrinking::No) : Edges.AddDefaulted();
+	FEdge& Edge = Edges[EdgeIndex];
+	Edge.Cells.Reset();
+
+	// Corridor cells have exactly two walkable neighbours: keep going through the one we did not come from
+	FIntPoint Previous = Nodes[NodeIndex].Cell;
+	FIntPoint Cell = FirstCell;
+	while (CellNode[ToIndex(Cell)] == INDEX_NONE)
+	{
+		CellEdge[ToIndex(Cell)] = EdgeIndex;
+		CellEdgeOffset[ToIndex(Cell)] = Edge.Cells.Num();
+		Edge.Cells.Add(Cell);
+
+		for (const FIntPoint& Offset : CardinalOffsets)
+		{
+			const FIntPoint Next = Cell + Offset;
+			if (Next != Previous && IsWalkable(Next))
+			{
+				Previous = Cell;
+				Cell = Next;
+				break;
+			}
+		}
+	}
+
+	Edge.NodeA = NodeIndex;
+	Edge.NodeB = CellNode[ToIndex(Cell)];
+	Edge.Length = Edge.Cells.Num() + 1;
+	Edge.bAlive = true;
+
+	Nodes[Edge.NodeA].Edges.Add(EdgeIndex);
+	if (Edge.NodeB != Edge.NodeA)
+	{
+		Nodes[Edge.NodeB].Edges.Add(EdgeIndex);
+	}
+}
+
+bool FMazeTopologyGraph::HasDirectEdge(int32 NodeA, int32 NodeB) const
+{
+	for (const int32 EdgeIndex : Nodes[NodeA].Edges)
+	{
+		const FEdge& Edge = Edges[EdgeIndex];
+		if (Edge.Length == 1 && (Edge.NodeA == NodeB || Edge.NodeB == NodeB))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+int32 FMazeTopologyGraph::GetRegion(const FIntPoint& Cell) const
+{
+	if (!IsWalkable(Cell))
+	{
+		return INDEX_NONE;
+	}
+	if (bRegionsDirty)
+	{
+		LabelRegions();
+	}
+	return CellRegion[ToIndex(Cell)];
+}
+
+void FMazeTopologyGraph::LabelRegions() const
+{
+	CellRegion.Init(INDEX_NONE, Width * Height);
+	bRegionsDirty = false;
+
+	TArray<int32> Queue;
+	int32 NumRegions = 0;
+	for (TConstSetBitIterator<> It(Walkable); It; ++It)
+	{
+		if (CellRegion[It.GetIndex()] != INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 Region = NumRegions++;
+		CellRegion[It.GetIndex()] = Region;
+		Queue.Reset();
+		Queue.Add(It.GetIndex());
+		for (int32 Head = 0; Head < Queue.Num(); ++Head)
+		{
+			const FIntPoint Cell(Queue[Head] % Width, Queue[Head] / Width);
+			for (const FIntPoint& Offset : CardinalOffsets)
+			{
+				const FIntPoint Neighbour = Cell + Offset;
+				if (IsWalkable(Neighbour) && CellRegion[ToIndex(Neighbour)] == INDEX_NONE)
+				{
+					CellRegion[ToIndex(Neighbour)] = Region;
+					Queue.Add(ToIndex(Neighbour));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,120 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+/**
+ * Junction/dead-end graph of a maze sampled on a grid of corridor-sized cells
+ *
+ * Walkable cells with other than two walkable neighbours (junctions, dead ends, open areas)
+ * become nodes; the chains of two-neighbour cells between them become weighted edges.
+ * Paths are searched with A* over the nodes only, which is far smaller than the cell grid
+ * or the navmesh. Changing cells (e.g. a door opening) only rebuilds the edges around them.
+ */
+class MAZEBLAZE_API FMazeTopologyGraph
+{
+public:
+	struct FNode
+	{
+		FIntPoint Cell = FIntPoint::ZeroValue;
+		TArray<int32, TInlineAllocator<4>> Edges;
+		bool bAlive = false;
+	};
+
+	struct FEdge
+	{
+		int32 NodeA = INDEX_NONE;
+		int32 NodeB = INDEX_NONE;
+
+		// Steps from NodeA to NodeB
+		int32 Length = 0;
+
+		// Corridor cells from NodeA to NodeB, nodes excluded
+		TArray<FIntPoint> Cells;
+
+		bool bAlive = false;
+	};
+
+	// Build the whole graph from a walkability mask indexed Y * Width + X
+	void Build(int32 InWidth, int32 InHeight, const TBitArray<>& InWalkable);
+
+	// Change the walkability of some cells and update only the affected part of the graph
+	void SetCellsWalkable(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Shortest 4-connected cell path from From to To (From excluded, To included)
+	// Returns the path length in steps, or INDEX_NONE if there is none
+	int32 FindPath(const FIntPoint& From, const FIntPoint& To, TArray<FIntPoint>* OutCells = nullptr) const;
+
+	// Connected area of a walkable cell, or INDEX_NONE for a blocked one; two cells reach each other
+	// exactly when they are in the same region. Labelled on the first query after a change
+	int32 GetRegion(const FIntPoint& Cell) const;
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	bool IsWalkable(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) && Walkable[ToIndex(Cell)];
+	}
+
+	const TBitArray<>& GetWalkable() const { return Walkable; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumNodes() const { return Nodes.Num() - FreeNodes.Num(); }
+	int32 GetNumEdges() const { return Edges.Num() - FreeEdges.Num(); }
+
+	// Node and edge storage; entries with bAlive == false are free slots
+	const TArray<FNode>& GetNodes() const { return Nodes; }
+	const TArray<FEdge>& GetEdges() const { return Edges; }
+
+private:
+	int32 ToIndex(const FIntPoint& Cell) const { return Cell.Y * Width + Cell.X; }
+
+	// Number of walkable 4-neighbours
+	int32 CountWalkableNeighbours(const FIntPoint& Cell) const;
+
+	bool ShouldBeNode(const FIntPoint& Cell) const
+	{
+		return IsWalkable(Cell) && CountWalkableNeighbours(Cell) != 2;
+	}
+
+	int32 AddNode(const FIntPoint& Cell);
+	void RemoveNode(int32 NodeIndex);
+	void RemoveEdge(int32 EdgeIndex);
+
+	// Add the edges leaving a node that are not in the graph yet
+	void TraceEdgesFrom(int32 NodeIndex);
+
+	// Follow the corridor leaving Node through FirstCell and add it as an edge
+	void TraceCorridor(int32 NodeIndex, const FIntPoint& FirstCell);
+
+	bool HasDirectEdge(int32 NodeA, int32 NodeB) const;
+
+	// Flood fill the walkable cells into 4-connected regions
+	void LabelRegions() const;
+
+	int32 Width = 0;
+	int32 Height = 0;
+	TBitArray<> Walkable;
+
+	TArray<FNode> Nodes;
+	TArray<int32> FreeNodes;
+	TArray<FEdge> Edges;
+	TArray<int32> FreeEdges;
+
+	// Node at each cell, and edge and position along it for corridor cells
+	TArray<int32> CellNode;
+	TArray<int32> CellEdge;
+	TArray<int32> CellEdgeOffset;
+
+	// A* scratch buffers, reset through the touched list after each search
+	mutable TArray<int32> SearchCost;
+	mutable TArray<int32> SearchParentEdge;
+	mutable TArray<int32> SearchTouched;
+
+	// Region of each cell, relabelled lazily once walkability changes
+	mutable TArray<int32> CellRegion;
+	mutable bool bRegionsDirty = true;
+};
@@ -0,0 +1,372 @@
+#include "MazeTopologySubsystem.h"
+#include "MazeActorRegistrySubsystem.h"
+#include "MazeGameDoor.h"
+#include "Components/StaticMeshComponent.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "NavigationSystem.h"
+#include "EngineUtils.h"
+#include "Engine/World.h"
+#include "DrawDebugHelpers.h"
+#include "HAL/PlatformTime.h"
+
+namespace
+{
+	const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+}
+
+UMazeTopologySubsystem* UMazeTopologySubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeTopologySubsystem>() : nullptr;
+}
+
+void UMazeTopologySubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeActorRegistrySubsystem* Registry = Collection.InitializeDependency<UMazeActorRegistrySubsystem>())
+	{
+		MazeActorChangedHandle = Registry->OnMazeActorChanged.AddUObject(this, &UMazeTopologySubsystem::HandleMazeActorChanged);
+	}
+}
+
+void UMazeTopologySubsystem::Deinitialize()
+{
+	if (UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		Registry->OnMazeActorChanged.Remove(MazeActorChangedHandle);
+	}
+
+	Graph = FMazeTopologyGraph();
+	Hierarchy = FMazeHierarchicalPathfinder();
+	CellLocations.Empty();
+	DoorCells.Empty();
+	bGraphBuilt = false;
+	bHierarchyBuilt = false;
+
+	Super::Deinitialize();
+}
+
+bool UMazeTopologySubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMazeTopologySubsystem::EnsureGraph()
+{
+	return bGraphBuilt || RebuildGraph();
+}
+
+bool UMazeTopologySubsystem::RebuildGraph()
+{
+	bGraphBuilt = false;
+	bHierarchyBuilt = false;
+	DoorCells.Reset();
+
+	UWorld* World = GetWorld();
+	UNavigationSystemV1* NavSys = UNavigationSystemV1::GetCurrent<UNavigationSystemV1>(World);
+	if (!World || !NavSys)
+	{
+		return false;
+	}
+
+	FBox Bounds(ForceInit);
+	for (TActorIterator<ANavMeshBoundsVolume> It(World); It; ++It)
+	{
+		Bounds += It->GetComponentsBoundingBox(true);
+	}
+	if (!Bounds.IsValid)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MazeTopology: No navmesh bounds volume in the level, graph-based navigation is unavailable"));
+		return false;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+
+	GridOrigin = FVector2D(Bounds.Min) + GridOffset;
+	const int32 Width = FMath::Clamp(FMath::CeilToInt((Bounds.Max.X - GridOrigin.X) / CellSize), 1, MaxGridSize);
+	const int32 Height = FMath::Clamp(FMath::CeilToInt((Bounds.Max.Y - GridOrigin.Y) / CellSize), 1, MaxGridSize);
+	const FVector QueryExtent(ProjectionExtent, ProjectionExtent, Bounds.GetExtent().Z);
+
+	TBitArray<> Walkable(false, Width * Height);
+	CellLocations.SetNumUninitialized(Width * Height);
+
+	int32 NumWalkable = 0;
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const int32 Index = Y * Width + X;
+			const FVector CellCenter(GridOrigin.X + (X + 0.5f) * CellSize, GridOrigin.Y + (Y + 0.5f) * CellSize, Bounds.GetCenter().Z);
+
+			FNavLocation NavLocation;
+			if (NavSys->ProjectPointToNavigation(CellCenter, NavLocation, QueryExtent))
+			{
+				Walkable[Index] = true;
+				CellLocations[Index] = NavLocation.Location;
+				++NumWalkable;
+			}
+			else
+			{
+				CellLocations[Index] = CellCenter;
+			}
+		}
+	}
+
+	if (NumWalkable == 0)
+	{
+		// The navmesh may still be building; try again on the next query
+		UE_LOG(LogTemp, Warning, TEXT("MazeTopology: No walkable cell found in %dx%d grid"), Width, Height);
+		return false;
+	}
+
+	// Closed doors block their cells until they are opened, whatever the navmesh says
+	if (const UMazeActorRegistrySubsystem* Registry = UMazeActorRegistrySubsystem::Get(this))
+	{
+		for (const AMazeGameDoor* Door : Registry->GetClosedDoors())
+		{
+			TArray<FIntPoint>& Cells = DoorCells.Add(Door);
+			GetDoorCells(Door, FIntPoint(Width, Height), Cells);
+			for (const FIntPoint& Cell : Cells)
+			{
+				Walkable[Cell.Y * Width + Cell.X] = false;
+			}
+		}
+	}
+
+	// Door cells carved out of the navmesh have no projected location; borrow the height of a walkable neighbour
+	for (const TPair<const AMazeGameDoor*, TArray<FIntPoint>>& Pair : DoorCells)
+	{
+		for (const FIntPoint& Cell : Pair.Value)
+		{
+			for (const FIntPoint& Offset : CardinalOffsets)
+			{
+				const FIntPoint Neighbour = Cell + Offset;
+				if (Neighbour.X >= 0 && Neighbour.Y >= 0 && Neighbour.X < Width && Neighbour.Y < Height && Walkable[Neighbour.Y * Width + Neighbour.X])
+				{
+					CellLocations[Cell.Y * Width + Cell.X].Z = CellLocations[Neighbour.Y * Width + Neighbour.X].Z;
+					break;
+				}
+			}
+		}
+	}
+
+	Graph.Build(Width, Height, Walkable);
+	bGraphBuilt = true;
+
+	UE_LOG(LogTemp, Log, TEXT("MazeTopology: Built %dx%d grid (%d walkable cells) into %d nodes and %d edges in %.2f ms"),
+		Width, Height, NumWalkable, Graph.GetNumNodes(), Graph.GetNumEdges(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+
+	OnTopologyChanged.Broadcast(TConstArrayView<FIntPoint>(), true);
+	return true;
+}
+
+void UMazeTopologySubsystem::HandleMazeActorChanged(AActor* ChangedActor)
+{
+	const AMazeGameDoor* Door = Cast<AMazeGameDoor>(ChangedActor);
+	if (!bGraphBuilt || !Door || !Door->IsOpen())
+	{
+		return;
+	}
+
+	TArray<FIntPoint> Cells;
+	if (DoorCells.RemoveAndCopyValue(Door, Cells))
+	{
+		Graph.SetCellsWalkable(Cells, true);
+		if (bHierarchyBuilt)
+		{
+			Hierarchy.SetCellsWalkable(Cells, true);
+		}
+		UE_LOG(LogTemp, Verbose, TEXT("MazeTopology: %s opened, graph now has %d nodes and %d edges"),
+			*Door->GetName(), Graph.GetNumNodes(), Graph.GetNumEdges());
+
+		OnTopologyChanged.Broadcast(Cells, true);
+	}
+}
+
+void UMazeTopologySubsystem::GetDoorCells(const AMazeGameDoor* Door, const FIntPoint& GridSize, TArray<FIntPoint>& OutCells) const
+{
+	const UStaticMeshComponent* Mesh = Door ? Door->FindComponentByClass<UStaticMeshComponent>() : nullptr;
+	if (!Mesh)
+	{
+		return;
+	}
+
+	// Any cell whose centre is inside the door panel, grown a little so thin doors still cover a cell
+	const FBox DoorBox = Mesh->Bounds.GetBox().ExpandBy(FVector(CellSize * 0.25f, CellSize * 0.25f, 0.0f));
+	const FIntPoint MinCell = WorldToCell(DoorBox.Min);
+	const FIntPoint MaxCell = WorldToCell(DoorBox.Max);
+
+	for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			const FVector2D CellCenter(GridOrigin.X + (X + 0.5f) * CellSize, GridOrigin.Y + (Y + 0.5f) * CellSize);
+			const bool bInGrid = X >= 0 && Y >= 0 && X < GridSize.X && Y < GridSize.Y;
+			if (bInGrid && CellCenter.X >= DoorBox.Min.X && CellCenter.X <= DoorBox.Max.X && CellCenter.Y >= DoorBox.Min.Y && CellCenter.Y <= DoorBox.Max.Y)
+			{
+				OutCells.Add(FIntPoint(X, Y));
+			}
+		}
+	}
+}
+
+FIntPoint UMazeTopologySubsystem::WorldToCell(const FVector& Location) const
+{
+	return FIntPoint(FMath::FloorToInt((Location.X - GridOrigin.X) / CellSize), FMath::FloorToInt((Location.Y - GridOrigin.Y) / CellSize));
+}
+
+bool UMazeTopologySubsystem::FindWalkableCell(const FVector& Location, FIntPoint& OutCell) const
+{
+	const FIntPoint Cell = WorldToCell(Location);
+	float BestDistanceSq = MAX_flt;
+
+	for (int32 DY = -1; DY <= 1; ++DY)
+	{
+		for (int32 DX = -1; DX <= 1; ++DX)
+		{
+			const FIntPoint Candidate = Cell + FIntPoint(DX, DY);
+			if (!Graph.IsWalkable(Candidate))
+			{
+				continue;
+			}
+
+			const float DistanceSq = FVector::DistSquared2D(CellLocations[Candidate.Y * Graph.GetWidth() + Candidate.X], Location);
+			if (DistanceSq < BestDistanceSq)
+			{
+				BestDistanceSq = DistanceSq;
+				OutCell = Candidate;
+			}
+		}
+	}
+
+	return BestDistanceSq < MAX_flt;
+}
+
+int32 UMazeTopologySubsystem::GetRegion(const FVector& Location) const
+{
+	FIntPoint Cell;
+	return bGraphBuilt && FindWalkableCell(Location, Cell) ? Graph.GetRegion(Cell) : INDEX_NONE;
+}
+
+bool UMazeTopologySubsystem::FindPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	FIntPoint FromCell;
+	FIntPoint ToCell;
+	if (!EnsureGraph() || !FindWalkableCell(From, FromCell) || !FindWalkableCell(To, ToCell))
+	{
+		return false;
+	}
+
+	TArray<FIntPoint> Cells;
+	if (Graph.FindPath(FromCell, ToCell, &Cells) == INDEX_NONE)
+	{
+		return false;
+	}
+
+	CellPathToPoints(From, FromCell, Cells, To, OutPoints);
+	return true;
+}
+
+bool UMazeTopologySubsystem::FindHierarchicalPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	FIntPoint FromCell;
+	FIntPoint ToCell;
+	if (!EnsureGraph() || !FindWalkableCell(From, FromCell) || !FindWalkableCell(To, ToCell))
+	{
+		return false;
+	}
+
+	if (!bHierarchyBuilt)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		Hierarchy.Build(Graph.GetWidth(), Graph.GetHeight(), Graph.GetWalkable(), SectorSize);
+		bHierarchyBuilt = true;
+
+		UE_LOG(LogTemp, Log, TEXT("MazeTopology: Built %d sectors with %d entrances in %.2f ms"),
+			Hierarchy.GetNumSectors(), Hierarchy.GetNumEntrances(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	}
+
+	TArray<FIntPoint> Cells;
+	if (Hierarchy.FindPath(FromCell, ToCell, &Cells) == INDEX_NONE)
+	{
+		return false;
+	}
+
+	CellPathToPoints(From, FromCell, Cells, To, OutPoints);
+	return true;
+}
+
+void UMazeTopologySubsystem::CellPathToPoints(const FVector& From, const FIntPoint& FromCell, const TArray<FIntPoint>& Cells, const FVector& To, TArray<FVector>& OutPoints) const
+{
+	// Only keep the cells where the path turns; the straight runs between them are open corridor
+	OutPoints.Add(From);
+	FIntPoint Previous = FromCell;
+	for (int32 Index = 0; Index + 1 < Cells.Num(); ++Index)
+	{
+		const FIntPoint& Cell = Cells[Index];
+		if (Cell - Previous != Cells[Index + 1] - Cell)
+		{
+			OutPoints.Add(CellLocations[Cell.Y * Graph.GetWidth() + Cell.X]);
+		}
+		Previous = Cell;
+	}
+	OutPoints.Add(To);
+}
+
+float UMazeTopologySubsystem::GetPathLength(const FVector& From, const FVector& To)
+{
+	FIntPoint FromCell;
+	FIntPoint ToCell;
+	if (!EnsureGraph() || !FindWalkableCell(From, FromCell) || !FindWalkableCell(To, ToCell))
+	{
+		return -1.0f;
+	}
+
+	const int32 Steps = Graph.FindPath(FromCell, ToCell);
+	return Steps == INDEX_NONE ? -1.0f : Steps * CellSize;
+}
+
+void UMazeTopologySubsystem::DrawDebugGraph(float Duration) const
+{
+	UWorld* World = GetWorld();
+	if (!World || !bGraphBuilt)
+	{
+		return;
+	}
+
+	const FVector Lift(0.0f, 0.0f, 30.0f);
+	auto CellLocation = [this, &Lift](const FIntPoint& Cell)
+	{
+		return CellLocations[Cell.Y * Graph.GetWidth() + Cell.X] + Lift;
+	};
+
+	for (const FMazeTopologyGraph::FNode& Node : Graph.GetNodes())
+	{
+		if (Node.bAlive)
+		{
+			DrawDebugPoint(World, CellLocation(Node.Cell), 12.0f, Node.Edges.Num() == 1 ? FColor::Red : FColor::Cyan, false, Duration);
+		}
+	}
+
+	for (const FMazeTopologyGraph::FEdge& Edge : Graph.GetEdges())
+	{
+		if (!Edge.bAlive)
+		{
+			continue;
+		}
+
+		FVector Start = CellLocation(Graph.GetNodes()[Edge.NodeA].Cell);
+		for (const FIntPoint& Cell : Edge.Cells)
+		{
+			const FVector End = CellLocation(Cell);
+			DrawDebugLine(World, Start, End, FColor::Cyan, false, Duration);
+			Start = End;
+		}
+		DrawDebugLine(World, Start, CellLocation(Graph.GetNodes()[Edge.NodeB].Cell), FColor::Cyan, false, Duration);
+	}
+}
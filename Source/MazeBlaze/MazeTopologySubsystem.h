@@ -0,0 +1,137 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeTopologyGraph.h"
+#include "MazeHierarchicalPathfinder.h"
+#include "MazeTopologySubsystem.generated.h"
+
+class AMazeGameDoor;
+
+// Broadcast when cells change walkability; an empty cell list means the whole grid was rebuilt
+DECLARE_MULTICAST_DELEGATE_TwoParams(FOnMazeTopologyChanged, TConstArrayView<FIntPoint> /*Cells*/, bool /*bWalkable*/);
+
+/**
+ * World subsystem that owns the junction/dead-end graph of the maze for graph-based navigation
+ *
+ * The navmesh bounds are sampled on a grid of half-corridor cells (a cell is walkable when it
+ * projects onto the navmesh), so walls and the openings between corridors get cells of their
+ * own, and closed doors block their cells. The graph is built on first use and updated
+ * incrementally when the registry reports a door being opened, so long key-door-exit routes
+ * are answered by a search over a few hundred nodes instead of a navmesh query.
+ * The same grid also feeds a sector-based hierarchical pathfinder, built on its first query.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeTopologySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the topology subsystem for the world of the given object
+	static UMazeTopologySubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Build the graph if it has not been built yet; returns false if there is no navmesh to sample
+	bool EnsureGraph();
+
+	// Sample the navmesh again and rebuild the whole graph
+	UFUNCTION(BlueprintCallable, Category = "Maze|Topology")
+	bool RebuildGraph();
+
+	// Find a path as a list of corner points from From to To (both included)
+	UFUNCTION(BlueprintCallable, Category = "Maze|Topology")
+	bool FindPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints);
+
+	// Find a path with hierarchical A* over the maze sectors, as a list of corner points
+	UFUNCTION(BlueprintCallable, Category = "Maze|Topology")
+	bool FindHierarchicalPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints);
+
+	// Length of the shortest path between two points along the maze graph, or -1 if unreachable
+	UFUNCTION(BlueprintCallable, Category = "Maze|Topology")
+	float GetPathLength(const FVector& From, const FVector& To);
+
+	// Draw the graph nodes and edges
+	UFUNCTION(BlueprintCallable, Category = "Maze|Topology")
+	void DrawDebugGraph(float Duration = 0.0f) const;
+
+	// Event fired after the graph is rebuilt or a door opens
+	FOnMazeTopologyChanged OnTopologyChanged;
+
+	// Cell containing a world location; may be outside the grid
+	FIntPoint WorldToCell(const FVector& Location) const;
+
+	// Navmesh location of a cell of the built graph
+	FVector GetCellLocation(const FIntPoint& Cell) const { return CellLocations[Cell.Y * Graph.GetWidth() + Cell.X]; }
+
+	// Nearest walkable cell to a location, searching the cell and its 8 neighbours
+	bool FindWalkableCell(const FVector& Location, FIntPoint& OutCell) const;
+
+	// Connected area of the walkable cell nearest a location, or INDEX_NONE; closed doors separate regions
+	int32 GetRegion(const FVector& Location) const;
+
+	// Turn a cell path into the start point, the cells where the path turns and the end point
+	void CellPathToPoints(const FVector& From, const FIntPoint& FromCell, const TArray<FIntPoint>& Cells, const FVector& To, TArray<FVector>& OutPoints) const;
+
+	// Cells still blocked by a closed door, or nullptr if the door blocks none
+	const TArray<FIntPoint>* GetBlockedDoorCells(const AMazeGameDoor* Door) const { return DoorCells.Find(Door); }
+
+	// Cells blocked by every door still closed
+	const TMap<const AMazeGameDoor*, TArray<FIntPoint>>& GetClosedDoorCells() const { return DoorCells; }
+
+	FVector2D GetGridOrigin() const { return GridOrigin; }
+
+	bool IsGraphBuilt() const { return bGraphBuilt; }
+	const FMazeTopologyGraph& GetGraph() const { return Graph; }
+	const FMazeHierarchicalPathfinder& GetHierarchy() const { return Hierarchy; }
+
+	// Size of the sampling cells; should be half the maze corridor pitch so corridor centres and wall lines alternate
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Topology", meta = (ClampMin = "25.0"))
+	float CellSize = 200.0f;
+
+	// Horizontal search extent when projecting cell centres; must stay below the agent radius so wall lines are not walkable
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Topology", meta = (ClampMin = "1.0"))
+	float ProjectionExtent = 30.0f;
+
+	// Offset of the grid from the navmesh bounds corner, to line the cells up with the maze layout
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Topology")
+	FVector2D GridOffset = FVector2D::ZeroVector;
+
+	// Number of cells along each side of a hierarchical pathfinding sector
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Topology", meta = (ClampMin = "4"))
+	int32 SectorSize = 16;
+
+	// Upper bound on the number of cells along each side of the sampled grid
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|Topology", meta = (ClampMin = "8"))
+	int32 MaxGridSize = 512;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	// Update the graph when a door opens
+	void HandleMazeActorChanged(AActor* ChangedActor);
+
+	// Cells of a Width x Height grid covered by a door's mesh
+	void GetDoorCells(const AMazeGameDoor* Door, const FIntPoint& GridSize, TArray<FIntPoint>& OutCells) const;
+
+	FMazeTopologyGraph Graph;
+
+	// Built from the graph's walkability on the first hierarchical query
+	FMazeHierarchicalPathfinder Hierarchy;
+	bool bHierarchyBuilt = false;
+
+	// Navmesh location of each sampled cell, indexed like the graph
+	TArray<FVector> CellLocations;
+
+	// Cells blocked by each door that was closed when the graph was built
+	TMap<const AMazeGameDoor*, TArray<FIntPoint>> DoorCells;
+
+	// World position of the corner of cell (0, 0)
+	FVector2D GridOrigin = FVector2D::ZeroVector;
+
+	bool bGraphBuilt = false;
+
+	FDelegateHandle MazeActorChangedHandle;
+};
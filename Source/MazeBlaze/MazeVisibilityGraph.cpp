@@ -0,0 +1,518 @@
+#include "MazeVisibilityGraph.h"
+#include "Algo/Reverse.h"
+#include "Async/ParallelFor.h"
+#include "Misc/Crc.h"
+
+namespace
+{
+	const FIntPoint DiagonalOffsets[] = { FIntPoint(1, 1), FIntPoint(-1, 1), FIntPoint(1, -1), FIntPoint(-1, -1) };
+
+	struct FOpenVertex
+	{
+		int32 Vertex;
+		float Cost;
+		float Estimate;
+	};
+
+	struct FOpenVertexPredicate
+	{
+		bool operator()(const FOpenVertex& A, const FOpenVertex& B) const
+		{
+			return A.Estimate < B.Estimate;
+		}
+	};
+
+	float CellDistance(const FIntPoint& A, const FIntPoint& B)
+	{
+		return FMath::Sqrt(float(FMath::Square(A.X - B.X) + FMath::Square(A.Y - B.Y)));
+	}
+
+	// Copy Num values to the end of the blob and pad it to 4 bytes
+	template <typename ValueType>
+	void AppendToBlob(TArray<uint8>& Blob, const ValueType* Values, int32 Num)
+	{
+		const int32 Bytes = Num * sizeof(ValueType);
+		const int32 Offset = Blob.AddUninitialized(Bytes);
+		if (Bytes > 0)
+		{
+			FMemory::Memcpy(Blob.GetData() + Offset, Values, Bytes);
+		}
+		Blob.AddZeroed(Align(Blob.Num(), 4) - Blob.Num());
+	}
+}
+
+template <typename FunctionType>
+void FMazeVisibilityGraph::ForEachVertexNear(const FIntPoint& Cell, FunctionType&& Function) const
+{
+	const int32 MinBucketX = FMath::Max(Cell.X - MaxEdgeLength, 0) / BucketSize;
+	const int32 MinBucketY = FMath::Max(Cell.Y - MaxEdgeLength, 0) / BucketSize;
+	const int32 MaxBucketX = FMath::Min(Cell.X + MaxEdgeLength, Width - 1) / BucketSize;
+	const int32 MaxBucketY = FMath::Min(Cell.Y + MaxEdgeLength, Height - 1) / BucketSize;
+
+	for (int32 BucketY = MinBucketY; BucketY <= MaxBucketY; ++BucketY)
+	{
+		for (int32 BucketX = MinBucketX; BucketX <= MaxBucketX; ++BucketX)
+		{
+			const int32 Bucket = BucketY * BucketsX + BucketX;
+			for (int32 Entry = BucketOffsets[Bucket]; Entry < BucketOffsets[Bucket + 1]; ++Entry)
+			{
+				Function(BucketVertices[Entry]);
+			}
+		}
+	}
+}
+
+void FMazeVisibilityGraph::Build(int32 InWidth, int32 InHeight, const TBitArray<>& Walkable, const TBitArray<>& DoorCells, int32 InMaxEdgeLength)
+{
+	check(Walkable.Num() == InWidth * InHeight && DoorCells.Num() == InWidth * InHeight);
+
+	Reset();
+	Width = InWidth;
+	Height = InHeight;
+	MaxEdgeLength = FMath::Max(InMaxEdgeLength, 1);
+	GridHash = HashGrid(InWidth, InHeight, Walkable, DoorCells);
+
+	auto IsOpen = [&Walkable, this](const FIntPoint& Cell)
+	{
+		return IsValidCell(Cell) && Walkable[Cell.Y * Width + Cell.X];
+	};
+
+	// A wall corner sticks out where a diagonal neighbour is blocked but both cells beside it are open
+	TArray<FIntPoint> Vertices;
+	for (int32 Y = 0; Y < Height; ++Y)
+	{
+		for (int32 X = 0; X < Width; ++X)
+		{
+			const FIntPoint Cell(X, Y);
+			if (!IsOpen(Cell))
+			{
+				continue;
+			}
+
+			for (const FIntPoint& Diagonal : DiagonalOffsets)
+			{
+				const FIntPoint Corner = Cell + Diagonal;
+				if (IsValidCell(Corner) && !IsOpen(Corner) && IsOpen(FIntPoint(Corner.X, Y)) && IsOpen(FIntPoint(X, Corner.Y)))
+				{
+					Vertices.Add(Cell);
+					break;
+				}
+			}
+		}
+	}
+
+	NumVertices = Vertices.Num();
+	VertexCells = Vertices;
+	BuildBuckets();
+
+	// Doors closed, to find the edges that depend on a door being open
+	TBitArray<> ClosedWalkable = Walkable;
+	for (TConstSetBitIterator<> It(DoorCells); It; ++It)
+	{
+		ClosedWalkable[It.GetIndex()] = false;
+	}
+
+	// Sight checks dominate the build; each vertex tests the later vertices in range on its own thread
+	TArray<TArray<TPair<int32, bool>>> Links;
+	Links.SetNum(NumVertices);
+	ParallelFor(NumVertices, [this, &Vertices, &Walkable, &ClosedWalkable, &Links](int32 Vertex)
+	{
+		const FIntPoint& Cell = Vertices[Vertex];
+		ForEachVertexNear(Cell, [&](int32 Other)
+		{
+			const FIntPoint& OtherCell = Vertices[Other];
+			if (Other > Vertex && CellDistance(Cell, OtherCell) <= MaxEdgeLength && HasLineOfSight(Walkable, Cell, OtherCell))
+			{
+				Links[Vertex].Add(TPair<int32, bool>(Other, !HasLineOfSight(ClosedWalkable, Cell, OtherCell)));
+			}
+		});
+	});
+
+	// Both directions of every link, in CSR form
+	TArray<int32> Offsets;
+	Offsets.Init(0, NumVertices + 1);
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		Offsets[Vertex + 1] += Links[Vertex].Num();
+		for (const TPair<int32, bool>& Link : Links[Vertex])
+		{
+			++Offsets[Link.Key + 1];
+		}
+	}
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		Offsets[Vertex + 1] += Offsets[Vertex];
+	}
+
+	const int32 NumEdgeEntries = Offsets[NumVertices];
+	TArray<int32> Targets;
+	TArray<float> Lengths;
+	TArray<uint8> CrossesDoor;
+	Targets.SetNumUninitialized(NumEdgeEntries);
+	Lengths.SetNumUninitialized(NumEdgeEntries);
+	CrossesDoor.SetNumUninitialized(NumEdgeEntries);
+
+	TArray<int32> Cursor(Offsets.GetData(), NumVertices);
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		for (const TPair<int32, bool>& Link : Links[Vertex])
+		{
+			const float Length = CellDistance(Vertices[Vertex], Vertices[Link.Key]);
+			for (const TPair<int32, int32>& Direction : { TPair<int32, int32>(Vertex, Link.Key), TPair<int32, int32>(Link.Key, Vertex) })
+			{
+				const int32 Entry = Cursor[Direction.Key]++;
+				Targets[Entry] = Direction.Value;
+				Lengths[Entry] = Length;
+				CrossesDoor[Entry] = Link.Value ? 1 : 0;
+			}
+		}
+	}
+
+	FHeader Header;
+	Header.Magic = BlobMagic;
+	Header.Version = FormatVersion;
+	Header.Width = Width;
+	Header.Height = Height;
+	Header.GridHash = GridHash;
+	Header.MaxEdgeLength = MaxEdgeLength;
+	Header.NumVertices = NumVertices;
+	Header.NumEdgeEntries = NumEdgeEntries;
+
+	AppendToBlob(OwnedBlob, &Header, 1);
+	AppendToBlob(OwnedBlob, Vertices.GetData(), NumVertices);
+	AppendToBlob(OwnedBlob, Offsets.GetData(), Offsets.Num());
+	AppendToBlob(OwnedBlob, Targets.GetData(), NumEdgeEntries);
+	AppendToBlob(OwnedBlob, Lengths.GetData(), NumEdgeEntries);
+	AppendToBlob(OwnedBlob, CrossesDoor.GetData(), NumEdgeEntries);
+
+	verify(Load(OwnedBlob, GridHash));
+}
+
+bool FMazeVisibilityGraph::Load(TConstArrayView<uint8> InBlob, uint32 ExpectedGridHash)
+{
+	if (InBlob.GetData() != OwnedBlob.GetData())
+	{
+		Reset();
+	}
+
+	FHeader Header;
+	if (InBlob.Num() < int32(sizeof(FHeader)))
+	{
+		return false;
+	}
+	FMemory::Memcpy(&Header, InBlob.GetData(), sizeof(FHeader));
+
+	if (Header.Magic != BlobMagic || Header.Version != FormatVersion || Header.GridHash != ExpectedGridHash
+		|| Header.Width <= 0 || Header.Height <= 0 || Header.NumVertices < 0 || Header.NumEdgeEntries < 0)
+	{
+		return false;
+	}
+
+	const int64 VerticesBytes = int64(Header.NumVertices) * sizeof(FIntPoint);
+	const int64 OffsetsBytes = int64(Header.NumVertices + 1) * sizeof(int32);
+	const int64 EdgesBytes = int64(Header.NumEdgeEntries) * sizeof(int32);
+	const int64 ExpectedBytes = sizeof(FHeader) + VerticesBytes + OffsetsBytes + EdgesBytes * 2 + Align(int64(Header.NumEdgeEntries), 4);
+	if (InBlob.Num() != ExpectedBytes)
+	{
+		return false;
+	}
+
+	const uint8* Data = InBlob.GetData() + sizeof(FHeader);
+	const TConstArrayView<FIntPoint> InVertexCells(reinterpret_cast<const FIntPoint*>(Data), Header.NumVertices);
+	Data += VerticesBytes;
+	const TConstArrayView<int32> InEdgeOffsets(reinterpret_cast<const int32*>(Data), Header.NumVertices + 1);
+	Data += OffsetsBytes;
+	const TConstArrayView<int32> InEdgeTargets(reinterpret_cast<const int32*>(Data), Header.NumEdgeEntries);
+	Data += EdgesBytes;
+	const TConstArrayView<float> InEdgeLengths(reinterpret_cast<const float*>(Data), Header.NumEdgeEntries);
+	Data += EdgesBytes;
+	const TConstArrayView<uint8> InEdgeCrossesDoor(Data, Header.NumEdgeEntries);
+
+	// A truncated or corrupted file must not send the search out of bounds
+	if (InEdgeOffsets[0] != 0 || InEdgeOffsets[Header.NumVertices] != Header.NumEdgeEntries)
+	{
+		return false;
+	}
+	for (int32 Vertex = 0; Vertex < Header.NumVertices; ++Vertex)
+	{
+		const FIntPoint& Cell = InVertexCells[Vertex];
+		if (InEdgeOffsets[Vertex] > InEdgeOffsets[Vertex + 1] || Cell.X < 0 || Cell.Y < 0 || Cell.X >= Header.Width || Cell.Y >= Header.Height)
+		{
+			return false;
+		}
+	}
+	for (const int32 Target : InEdgeTargets)
+	{
+		if (Target < 0 || Target >= Header.NumVertices)
+		{
+			return false;
+		}
+	}
+
+	Width = Header.Width;
+	Height = Header.Height;
+	GridHash = Header.GridHash;
+	MaxEdgeLength = Header.MaxEdgeLength;
+	NumVertices = Header.NumVertices;
+	Blob = InBlob;
+	VertexCells = InVertexCells;
+	EdgeOffsets = InEdgeOffsets;
+	EdgeTargets = InEdgeTargets;
+	EdgeLengths = InEdgeLengths;
+	EdgeCrossesDoor = InEdgeCrossesDoor;
+
+	BuildBuckets();
+	return true;
+}
+
+void FMazeVisibilityGraph::Reset()
+{
+	Width = 0;
+	Height = 0;
+	MaxEdgeLength = 0;
+	NumVertices = 0;
+	GridHash = 0;
+	OwnedBlob.Empty();
+	Blob = TConstArrayView<uint8>();
+	VertexCells = TConstArrayView<FIntPoint>();
+	EdgeOffsets = TConstArrayView<int32>();
+	EdgeTargets = TConstArrayView<int32>();
+	EdgeLengths = TConstArrayView<float>();
+	EdgeCrossesDoor = TConstArrayView<uint8>();
+	BucketOffsets.Empty();
+	BucketVertices.Empty();
+	SearchCost.Empty();
+	SearchParent.Empty();
+	GoalCost.Empty();
+	SearchTouched.Empty();
+	GoalTouched.Empty();
+}
+
+uint32 FMazeVisibilityGraph::HashGrid(int32 InWidth, int32 InHeight, const TBitArray<>& Walkable, const TBitArray<>& DoorCells)
+{
+	uint32 Hash = FCrc::TypeCrc32(InWidth, FormatVersion);
+	Hash = FCrc::TypeCrc32(InHeight, Hash);
+	for (TConstSetBitIterator<> It(Walkable); It; ++It)
+	{
+		Hash = FCrc::TypeCrc32(It.GetIndex(), Hash);
+	}
+
+	// Separate the door list so moving a cell from one set to the other changes the hash
+	Hash = FCrc::TypeCrc32(INDEX_NONE, Hash);
+	for (TConstSetBitIterator<> It(DoorCells); It; ++It)
+	{
+		Hash = FCrc::TypeCrc32(It.GetIndex(), Hash);
+	}
+	return Hash;
+}
+
+float FMazeVisibilityGraph::FindPath(const FIntPoint& From, const FIntPoint& To, const TBitArray<>& Walkable, TArray<FIntPoint>* OutWaypoints) const
+{
+	if (!IsValidCell(From) || !IsValidCell(To) || !Walkable[From.Y * Width + From.X] || !Walkable[To.Y * Width + To.X])
+	{
+		return -1.0f;
+	}
+
+	if (HasLineOfSight(Walkable, From, To))
+	{
+		if (OutWaypoints && From != To)
+		{
+			OutWaypoints->Add(To);
+		}
+		return CellDistance(From, To);
+	}
+
+	if (SearchCost.Num() != NumVertices)
+	{
+		SearchCost.Init(-1.0f, NumVertices);
+		SearchParent.SetNumUninitialized(NumVertices);
+		GoalCost.Init(-1.0f, NumVertices);
+		SearchTouched.Reset();
+		GoalTouched.Reset();
+	}
+
+	TArray<TPair<int32, float>> Visible;
+	FindVisibleVertices(Walkable, To, Visible);
+	for (const TPair<int32, float>& Link : Visible)
+	{
+		GoalCost[Link.Key] = Link.Value;
+		GoalTouched.Add(Link.Key);
+	}
+
+	TArray<FOpenVertex, TInlineAllocator<64>> OpenList;
+	auto Relax = [&](int32 Vertex, float Cost, int32 Parent)
+	{
+		if (SearchCost[Vertex] >= 0.0f && SearchCost[Vertex] <= Cost)
+		{
+			return;
+		}
+		if (SearchCost[Vertex] < 0.0f)
+		{
+			SearchTouched.Add(Vertex);
+		}
+		SearchCost[Vertex] = Cost;
+		SearchParent[Vertex] = Parent;
+		OpenList.HeapPush(FOpenVertex{ Vertex, Cost, Cost + CellDistance(VertexCells[Vertex], To) }, FOpenVertexPredicate());
+	};
+
+	if (GoalTouched.Num() > 0)
+	{
+		Visible.Reset();
+		FindVisibleVertices(Walkable, From, Visible);
+		for (const TPair<int32, float>& Link : Visible)
+		{
+			Relax(Link.Key, Link.Value, INDEX_NONE);
+		}
+	}
+
+	float BestCost = MAX_flt;
+	int32 BestVertex = INDEX_NONE;
+	while (OpenList.Num() > 0)
+	{
+		FOpenVertex Open;
+		OpenList.HeapPop(Open, FOpenVertexPredicate(), EAllowShrinking::No);
+
+		// Straight-line estimates never overestimate, so nothing left can beat the best path
+		if (Open.Estimate >= BestCost)
+		{
+			break;
+		}
+		if (Open.Cost != SearchCost[Open.Vertex])
+		{
+			continue;
+		}
+
+		if (GoalCost[Open.Vertex] >= 0.0f && Open.Cost + GoalCost[Open.Vertex] < BestCost)
+		{
+			BestCost = Open.Cost + GoalCost[Open.Vertex];
+			BestVertex = Open.Vertex;
+		}
+
+		for (int32 Entry = EdgeOffsets[Open.Vertex]; Entry < EdgeOffsets[Open.Vertex + 1]; ++Entry)
+		{
+			const int32 Target = EdgeTargets[Entry];
+			if (EdgeCrossesDoor[Entry] && !HasLineOfSight(Walkable, VertexCells[Open.Vertex], VertexCells[Target]))
+			{
+				continue;
+			}
+			Relax(Target, Open.Cost + EdgeLengths[Entry], Open.Vertex);
+		}
+	}
+
+	if (OutWaypoints && BestVertex != INDEX_NONE)
+	{
+		const int32 FirstWaypoint = OutWaypoints->Num();
+		for (int32 Vertex = BestVertex; Vertex != INDEX_NONE; Vertex = SearchParent[Vertex])
+		{
+			OutWaypoints->Add(VertexCells[Vertex]);
+		}
+
+		TArrayView<FIntPoint> Corners = MakeArrayView(*OutWaypoints).RightChop(FirstWaypoint);
+		Algo::Reverse(Corners);
+		OutWaypoints->Add(To);
+	}
+
+	for (const int32 Vertex : SearchTouched)
+	{
+		SearchCost[Vertex] = -1.0f;
+	}
+	for (const int32 Vertex : GoalTouched)
+	{
+		GoalCost[Vertex] = -1.0f;
+	}
+	SearchTouched.Reset();
+	GoalTouched.Reset();
+
+	return BestVertex != INDEX_NONE ? BestCost : -1.0f;
+}
+
+bool FMazeVisibilityGraph::HasLineOfSight(const TBitArray<>& Walkable, const FIntPoint& From, const FIntPoint& To) const
+{
+	auto IsOpen = [&Walkable, this](int32 X, int32 Y)
+	{
+		return X >= 0 && Y >= 0 && X < Width && Y < Height && Walkable[Y * Width + X];
+	};
+
+	// Walk every cell the line between the two centres passes through
+	const int32 StepX = To.X > From.X ? 1 : -1;
+	const int32 StepY = To.Y > From.Y ? 1 : -1;
+	const int32 DoubleDX = 2 * FMath::Abs(To.X - From.X);
+	const int32 DoubleDY = 2 * FMath::Abs(To.Y - From.Y);
+	int32 Error = (DoubleDX - DoubleDY) / 2;
+	int32 X = From.X;
+	int32 Y = From.Y;
+
+	for (;;)
+	{
+		if (!IsOpen(X, Y))
+		{
+			return false;
+		}
+		if (X == To.X && Y == To.Y)
+		{
+			return true;
+		}
+
+		if (Error > 0)
+		{
+			X += StepX;
+			Error -= DoubleDY;
+		}
+		else if (Error < 0)
+		{
+			Y += StepY;
+			Error += DoubleDX;
+		}
+		else
+		{
+			// Through a lattice point: both cells beside it must be open so the line never squeezes between walls
+			if (!IsOpen(X + StepX, Y) || !IsOpen(X, Y + StepY))
+			{
+				return false;
+			}
+			X += StepX;
+			Y += StepY;
+			Error += DoubleDX - DoubleDY;
+		}
+	}
+}
+
+void FMazeVisibilityGraph::FindVisibleVertices(const TBitArray<>& Walkable, const FIntPoint& Cell, TArray<TPair<int32, float>>& OutVertices) const
+{
+	ForEachVertexNear(Cell, [&](int32 Vertex)
+	{
+		const float Distance = CellDistance(Cell, VertexCells[Vertex]);
+		if (Distance <= MaxEdgeLength && HasLineOfSight(Walkable, Cell, VertexCells[Vertex]))
+		{
+			OutVertices.Add(TPair<int32, float>(Vertex, Distance));
+		}
+	});
+}
+
+void FMazeVisibilityGraph::BuildBuckets()
+{
+	BucketsX = FMath::DivideAndRoundUp(Width, BucketSize);
+	BucketsY = FMath::DivideAndRoundUp(Height, BucketSize);
+	BucketOffsets.Init(0, BucketsX * BucketsY + 1);
+	BucketVertices.SetNumUninitialized(NumVertices);
+
+	auto BucketOf = [this](const FIntPoint& Cell)
+	{
+		return (Cell.Y / BucketSize) * BucketsX + Cell.X / BucketSize;
+	};
+
+	for (const FIntPoint& Cell : VertexCells)
+	{
+		++BucketOffsets[BucketOf(Cell) + 1];
+	}
+	for (int32 Bucket = 0; Bucket < BucketsX * BucketsY; ++Bucket)
+	{
+		BucketOffsets[Bucket + 1] += BucketOffsets[Bucket];
+	}
+
+	TArray<int32> Cursor(BucketOffsets.GetData(), BucketsX * BucketsY);
+	for (int32 Vertex = 0; Vertex < NumVertices; ++Vertex)
+	{
+		BucketVertices[Cursor[BucketOf(VertexCells[Vertex])]++] = Vertex;
+	}
+}
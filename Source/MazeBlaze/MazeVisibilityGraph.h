@@ -0,0 +1,121 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+/**
+ * Any-angle navigation over the convex wall corners of a grid
+ *
+ * A vertex is a walkable cell diagonal to a blocked cell whose two shared neighbours are
+ * walkable, i.e. the cell an agent rounds a wall corner from. Vertices that see each other
+ * in a straight line are linked, so the shortest path between two cells is a chain of
+ * corners found by A*, after linking the start and goal to the corners they see.
+ *
+ * The graph is stored as one flat blob (a header and CSR arrays of 4-byte values) so a
+ * prebuilt graph can be used straight from a memory-mapped file without being copied.
+ * Cells that may be blocked later (closed doors) are passed separately: the graph is built
+ * with them open and edges crossing them are checked against the live walkability on use.
+ *
+ * Cell (X, Y) spans [X, X + 1] x [Y, Y + 1]; sight lines run between cell centres.
+ */
+class MAZEBLAZE_API FMazeVisibilityGraph
+{
+public:
+	// Changed whenever the blob layout changes, so stale files are rebuilt
+	static constexpr uint32 FormatVersion = 1;
+
+	// Build the graph over Walkable (doors open) and keep it in an owned blob; edges are at most MaxEdgeLength cells long
+	void Build(int32 InWidth, int32 InHeight, const TBitArray<>& Walkable, const TBitArray<>& DoorCells, int32 MaxEdgeLength);
+
+	// The graph blob, as written to disk
+	TConstArrayView<uint8> GetBlob() const { return Blob; }
+
+	// Use a blob written from GetBlob without copying it; the memory must outlive the graph.
+	// Fails if the blob is malformed or was built for another grid
+	bool Load(TConstArrayView<uint8> InBlob, uint32 ExpectedGridHash);
+
+	// Drop the graph
+	void Reset();
+
+	// Hash of the grid a graph is built for
+	static uint32 HashGrid(int32 InWidth, int32 InHeight, const TBitArray<>& Walkable, const TBitArray<>& DoorCells);
+
+	// Length in cells of the shortest any-angle path over the live walkability, or -1 if there is none.
+	// OutWaypoints receives the corners passed and To (From excluded)
+	float FindPath(const FIntPoint& From, const FIntPoint& To, const TBitArray<>& Walkable, TArray<FIntPoint>* OutWaypoints = nullptr) const;
+
+	// Whether the straight line between two cell centres only crosses walkable cells (no squeezing between diagonal walls)
+	bool HasLineOfSight(const TBitArray<>& Walkable, const FIntPoint& From, const FIntPoint& To) const;
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	bool IsLoaded() const { return Width > 0; }
+	bool IsUsingOwnedBlob() const { return Blob.GetData() == OwnedBlob.GetData(); }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	int32 GetNumVertices() const { return NumVertices; }
+	int32 GetNumEdges() const { return EdgeTargets.Num() / 2; }
+	uint32 GetGridHash() const { return GridHash; }
+	TConstArrayView<FIntPoint> GetVertexCells() const { return VertexCells; }
+
+private:
+	struct FHeader
+	{
+		uint32 Magic;
+		uint32 Version;
+		int32 Width;
+		int32 Height;
+		uint32 GridHash;
+		int32 MaxEdgeLength;
+		int32 NumVertices;
+		int32 NumEdgeEntries;
+	};
+
+	static constexpr uint32 BlobMagic = 0x5356414D; // "MAVS"
+
+	// Vertices within MaxEdgeLength of a cell that see it; appended as (vertex, distance) pairs
+	void FindVisibleVertices(const TBitArray<>& Walkable, const FIntPoint& Cell, TArray<TPair<int32, float>>& OutVertices) const;
+
+	// Call Function(VertexIndex) for the vertices in the buckets within MaxEdgeLength of a cell
+	template <typename FunctionType>
+	void ForEachVertexNear(const FIntPoint& Cell, FunctionType&& Function) const;
+
+	// Group the vertices into square buckets for the range queries
+	void BuildBuckets();
+
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 MaxEdgeLength = 0;
+	int32 NumVertices = 0;
+	uint32 GridHash = 0;
+
+	// Blob built in memory; empty when the graph uses external memory
+	TArray<uint8> OwnedBlob;
+	TConstArrayView<uint8> Blob;
+
+	// Views into the blob: vertex cells, then edges in CSR form (both directions stored)
+	TConstArrayView<FIntPoint> VertexCells;
+	TConstArrayView<int32> EdgeOffsets;
+	TConstArrayView<int32> EdgeTargets;
+	TConstArrayView<float> EdgeLengths;
+
+	// 1 for edges crossing a door cell, which need a sight check against the live walkability
+	TConstArrayView<uint8> EdgeCrossesDoor;
+
+	// Vertices per bucket of BucketSize cells, in CSR form
+	static constexpr int32 BucketSize = 16;
+	int32 BucketsX = 0;
+	int32 BucketsY = 0;
+	TArray<int32> BucketOffsets;
+	TArray<int32> BucketVertices;
+
+	// A* scratch buffers, reset through the touched list after each search
+	mutable TArray<float> SearchCost;
+	mutable TArray<int32> SearchParent;
+	mutable TArray<float> GoalCost;
+	mutable TArray<int32> SearchTouched;
+	mutable TArray<int32> GoalTouched;
+};
@@ -0,0 +1,200 @@
+#include "MazeVisibilityGraphSubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Engine/World.h"
+
+// Console command to build the graph of the running map and save it for the next runs
+static FAutoConsoleCommandWithWorld BuildVisibilityGraphCmd(
+	TEXT("MazeBlaze.BuildVisibilityGraph"),
+	TEXT("Builds the visibility graph of the current maze and saves it to the map's graph file"),
+	FConsoleCommandWithWorldDelegate::CreateLambda([](UWorld* World)
+	{
+		if (UMazeVisibilityGraphSubsystem* VisibilityGraph = UMazeVisibilityGraphSubsystem::Get(World))
+		{
+			VisibilityGraph->SaveGraph();
+		}
+	})
+);
+
+UMazeVisibilityGraphSubsystem* UMazeVisibilityGraphSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeVisibilityGraphSubsystem>() : nullptr;
+}
+
+void UMazeVisibilityGraphSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazeVisibilityGraphSubsystem::HandleTopologyChanged);
+	}
+}
+
+void UMazeVisibilityGraphSubsystem::Deinitialize()
+{
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+
+	ReleaseGraph();
+
+	Super::Deinitialize();
+}
+
+bool UMazeVisibilityGraphSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMazeVisibilityGraphSubsystem::EnsureGraph()
+{
+	if (Graph.IsLoaded())
+	{
+		return true;
+	}
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	if (!Topology || !Topology->EnsureGraph())
+	{
+		return false;
+	}
+
+	// The graph is built with every door open; the cells of the doors still closed are checked on use
+	const FMazeTopologyGraph& TopologyGraph = Topology->GetGraph();
+	const int32 Width = TopologyGraph.GetWidth();
+	const int32 Height = TopologyGraph.GetHeight();
+	TBitArray<> Walkable = TopologyGraph.GetWalkable();
+	TBitArray<> DoorCells(false, Width * Height);
+	for (const TPair<const AMazeGameDoor*, TArray<FIntPoint>>& Pair : Topology->GetClosedDoorCells())
+	{
+		for (const FIntPoint& Cell : Pair.Value)
+		{
+			Walkable[Cell.Y * Width + Cell.X] = true;
+			DoorCells[Cell.Y * Width + Cell.X] = true;
+		}
+	}
+
+	const uint32 GridHash = FMazeVisibilityGraph::HashGrid(Width, Height, Walkable, DoorCells);
+	const FString FilePath = GetGraphFilePath();
+	if (LoadMappedGraph(FilePath, GridHash))
+	{
+		UE_LOG(LogTemp, Log, TEXT("MazeVisibilityGraph: Mapped %s (%d corners, %d links)"), *FilePath, Graph.GetNumVertices(), Graph.GetNumEdges());
+		return true;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	Graph.Build(Width, Height, Walkable, DoorCells, MaxEdgeLength);
+
+	UE_LOG(LogTemp, Log, TEXT("MazeVisibilityGraph: No prebuilt graph for this grid, built %d corners and %d links in %.2f ms (run MazeBlaze.BuildVisibilityGraph to save it)"),
+		Graph.GetNumVertices(), Graph.GetNumEdges(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+	return true;
+}
+
+bool UMazeVisibilityGraphSubsystem::FindPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	FIntPoint FromCell;
+	FIntPoint ToCell;
+	if (!Topology || !EnsureGraph() || !Topology->FindWalkableCell(From, FromCell) || !Topology->FindWalkableCell(To, ToCell))
+	{
+		return false;
+	}
+
+	TArray<FIntPoint> Waypoints;
+	if (Graph.FindPath(FromCell, ToCell, Topology->GetGraph().GetWalkable(), &Waypoints) < 0.0f)
+	{
+		return false;
+	}
+
+	// The last waypoint is the goal cell, replaced by the exact goal
+	OutPoints.Reserve(Waypoints.Num() + 1);
+	OutPoints.Add(From);
+	for (int32 Index = 0; Index < Waypoints.Num() - 1; ++Index)
+	{
+		OutPoints.Add(Topology->GetCellLocation(Waypoints[Index]));
+	}
+	OutPoints.Add(To);
+	return true;
+}
+
+bool UMazeVisibilityGraphSubsystem::SaveGraph()
+{
+	if (!EnsureGraph())
+	{
+		UE_LOG(LogTemp, Warning, TEXT("MazeVisibilityGraph: No maze grid to build a graph for"));
+		return false;
+	}
+
+	const FString FilePath = GetGraphFilePath();
+	if (IsGraphMapped())
+	{
+		// Loaded from the file with a matching grid hash, so it is already up to date
+		UE_LOG(LogTemp, Log, TEXT("MazeVisibilityGraph: %s is up to date"), *FilePath);
+		return true;
+	}
+
+	if (!FFileHelper::SaveArrayToFile(Graph.GetBlob(), *FilePath))
+	{
+		UE_LOG(LogTemp, Error, TEXT("MazeVisibilityGraph: Failed to write %s"), *FilePath);
+		return false;
+	}
+
+	UE_LOG(LogTemp, Log, TEXT("MazeVisibilityGraph: Saved %d corners and %d links to %s (%d bytes)"),
+		Graph.GetNumVertices(), Graph.GetNumEdges(), *FilePath, Graph.GetBlob().Num());
+	return true;
+}
+
+FString UMazeVisibilityGraphSubsystem::GetGraphFilePath() const
+{
+	const UWorld* World = GetWorld();
+	const FString MapName = World ? UWorld::RemovePIEPrefix(World->GetMapName()) : FString();
+	return FPaths::Combine(FPaths::ProjectContentDir(), GraphDirectory, MapName + TEXT(".mazevis"));
+}
+
+void UMazeVisibilityGraphSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	// Opened doors are read from the live walkability; a rebuilt grid needs a graph of its own
+	if (Cells.IsEmpty())
+	{
+		ReleaseGraph();
+	}
+}
+
+bool UMazeVisibilityGraphSubsystem::LoadMappedGraph(const FString& FilePath, uint32 GridHash)
+{
+	ReleaseGraph();
+
+	// Files inside a pak cannot be mapped, which is why the graph directory is staged outside it
+	MappedFile.Reset(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+	if (MappedFile.IsValid())
+	{
+		MappedRegion.Reset(MappedFile->MapRegion());
+	}
+
+	if (!MappedRegion.IsValid() || !Graph.Load(TConstArrayView<uint8>(MappedRegion->GetMappedPtr(), int32(MappedRegion->GetMappedSize())), GridHash))
+	{
+		if (MappedFile.IsValid())
+		{
+			UE_LOG(LogTemp, Log, TEXT("MazeVisibilityGraph: %s was built for another grid or format, ignoring it"), *FilePath);
+		}
+		ReleaseGraph();
+		return false;
+	}
+	return true;
+}
+
+void UMazeVisibilityGraphSubsystem::ReleaseGraph()
+{
+	// The graph points into the mapped region, so it goes first
+	Graph.Reset();
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Async/MappedFileHandle.h"
+#include "MazeVisibilityGraph.h"
+#include "MazeVisibilityGraphSubsystem.generated.h"
+
+/**
+ * World subsystem that runs the VisibilityGraph exploration mode
+ *
+ * Paths are any-angle routes over the wall corners of the topology subsystem's grid. The corner
+ * graph is built offline with the MazeBlaze.BuildVisibilityGraph console command and saved as a
+ * flat file per map under the content directory; at startup the file is memory-mapped and used in
+ * place. A missing file, or one built for another grid, falls back to building the graph at runtime.
+ * Doors are open in the saved graph and checked against the live walkability during searches.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeVisibilityGraphSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the visibility graph subsystem for the world of the given object
+	static UMazeVisibilityGraphSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Load the prebuilt graph of the map, or build it if there is none for the current grid
+	bool EnsureGraph();
+
+	// Find an any-angle path as a list of corner points from From to To (both included)
+	UFUNCTION(BlueprintCallable, Category = "Maze|VisibilityGraph")
+	bool FindPath(const FVector& From, const FVector& To, TArray<FVector>& OutPoints);
+
+	// Write the graph of the current grid to the map's graph file, to be loaded on the next run
+	UFUNCTION(BlueprintCallable, Category = "Maze|VisibilityGraph")
+	bool SaveGraph();
+
+	// File the graph of the current map is saved to and loaded from
+	FString GetGraphFilePath() const;
+
+	// Whether the graph is used straight from a memory-mapped file
+	bool IsGraphMapped() const { return Graph.IsLoaded() && !Graph.IsUsingOwnedBlob(); }
+
+	const FMazeVisibilityGraph& GetGraph() const { return Graph; }
+
+	// Directory under the project content directory holding the graph files; stage it as non-UFS so it can be mapped
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|VisibilityGraph")
+	FString GraphDirectory = TEXT("MazeData");
+
+	// Longest link between two corners, in cells
+	UPROPERTY(Config, EditAnywhere, Category = "Maze|VisibilityGraph", meta = (ClampMin = "1"))
+	int32 MaxEdgeLength = 64;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Map the graph file and use it if it was built for the grid
+	bool LoadMappedGraph(const FString& FilePath, uint32 GridHash);
+
+	// Drop the graph and unmap its file
+	void ReleaseGraph();
+
+	FMazeVisibilityGraph Graph;
+
+	// Kept open while the graph points into the mapped file
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+
+	FDelegateHandle TopologyChangedHandle;
+};
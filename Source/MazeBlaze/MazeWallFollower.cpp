@@ -0,0 +1,196 @@
+#include "MazeWallFollower.h"
+#include "Algo/Reverse.h"
+
+namespace
+{
+	// Indexed by heading
+	const FIntPoint HeadingOffsets[] = { FIntPoint(1, 0), FIntPoint(0, 1), FIntPoint(-1, 0), FIntPoint(0, -1) };
+
+	// Turns tried in order, as heading deltas: towards the hand, straight, away from the hand, back
+	const int32 LeftHandTurns[] = { 3, 0, 1, 2 };
+	const int32 RightHandTurns[] = { 1, 0, 3, 2 };
+}
+
+void FMazeWallFollower::Reset(int32 InWidth, int32 InHeight, const FIntPoint& InCell, bool bInLeftHand)
+{
+	Width = InWidth;
+	Height = InHeight;
+	Visited.Init(false, Width * Height);
+	NumVisited = 0;
+	Heading = 0;
+	bLeftHand = bInLeftHand;
+	NumHandSwitches = 0;
+	NumSweeps = 0;
+
+	Relocate(InCell);
+}
+
+void FMazeWallFollower::Relocate(const FIntPoint& InCell)
+{
+	Cell = InCell;
+	bHasLoopAnchor = false;
+	bSwitchedInLoop = false;
+	Visit(Cell);
+}
+
+int32 FMazeWallFollower::Advance(const TBitArray<>& Walkable, int32 MaxCells, TArray<FIntPoint>& OutCells, FMazeWallFollowerScratch& Scratch)
+{
+	check(Walkable.Num() == Width * Height);
+
+	int32 NumWalked = 0;
+	while (NumWalked < MaxCells)
+	{
+		int32 NextHeading = INDEX_NONE;
+		int32 FirstWalkableHeading = INDEX_NONE;
+		for (const int32 Turn : bLeftHand ? LeftHandTurns : RightHandTurns)
+		{
+			const int32 Candidate = (Heading + Turn) & 3;
+			const FIntPoint Next = Cell + HeadingOffsets[Candidate];
+			if (!IsValidCell(Next) || !Walkable[Next.Y * Width + Next.X])
+			{
+				continue;
+			}
+
+			if (FirstWalkableHeading == INDEX_NONE)
+			{
+				FirstWalkableHeading = Candidate;
+			}
+			if (!Visited[Next.Y * Width + Next.X])
+			{
+				NextHeading = Candidate;
+				break;
+			}
+		}
+
+		if (FirstWalkableHeading == INDEX_NONE)
+		{
+			// Walled in (e.g. a door closed around the agent)
+			break;
+		}
+
+		if (NextHeading != INDEX_NONE)
+		{
+			bHasLoopAnchor = false;
+			bSwitchedInLoop = false;
+		}
+		else
+		{
+			// Nothing new around: plain wall following, watching for a loop
+			NextHeading = FirstWalkableHeading;
+			const FIntPoint Next = Cell + HeadingOffsets[NextHeading];
+			if (!bHasLoopAnchor)
+			{
+				LoopAnchorCell = Next;
+				LoopAnchorHeading = NextHeading;
+				bHasLoopAnchor = true;
+			}
+			else if (LoopAnchorCell == Next && LoopAnchorHeading == NextHeading)
+			{
+				bHasLoopAnchor = false;
+				if (!bSwitchedInLoop)
+				{
+					bLeftHand = !bLeftHand;
+					bSwitchedInLoop = true;
+					++NumHandSwitches;
+				}
+				else
+				{
+					// Both walls loop; fall back on the memory
+					bSwitchedInLoop = false;
+					const int32 NumRouted = RouteToUnvisited(Walkable, OutCells, Scratch);
+					if (NumRouted == 0)
+					{
+						// Everything reachable has been visited, start a new sweep
+						Visited.Init(false, Width * Height);
+						NumVisited = 0;
+						Visit(Cell);
+						++NumSweeps;
+					}
+					NumWalked += NumRouted;
+					continue;
+				}
+			}
+		}
+
+		Heading = NextHeading;
+		Cell += HeadingOffsets[NextHeading];
+		Visit(Cell);
+		OutCells.Add(Cell);
+		++NumWalked;
+	}
+
+	return NumWalked;
+}
+
+int32 FMazeWallFollower::RouteToUnvisited(const TBitArray<>& Walkable, TArray<FIntPoint>& OutCells, FMazeWallFollowerScratch& Scratch)
+{
+	if (Scratch.Parents.Num() != Width * Height)
+	{
+		Scratch.Parents.Init(INDEX_NONE, Width * Height);
+	}
+
+	const int32 StartIndex = Cell.Y * Width + Cell.X;
+	Scratch.Queue.Reset();
+	Scratch.Queue.Add(StartIndex);
+	Scratch.Parents[StartIndex] = StartIndex;
+
+	int32 TargetIndex = INDEX_NONE;
+	for (int32 Head = 0; Head < Scratch.Queue.Num() && TargetIndex == INDEX_NONE; ++Head)
+	{
+		const int32 Index = Scratch.Queue[Head];
+		for (const FIntPoint& Offset : HeadingOffsets)
+		{
+			const FIntPoint Next(Index % Width + Offset.X, Index / Width + Offset.Y);
+			const int32 NextIndex = Next.Y * Width + Next.X;
+			if (!IsValidCell(Next) || !Walkable[NextIndex] || Scratch.Parents[NextIndex] != INDEX_NONE)
+			{
+				continue;
+			}
+
+			Scratch.Parents[NextIndex] = Index;
+			Scratch.Queue.Add(NextIndex);
+			if (!Visited[NextIndex])
+			{
+				TargetIndex = NextIndex;
+				break;
+			}
+		}
+	}
+
+	const int32 FirstRouteCell = OutCells.Num();
+	if (TargetIndex != INDEX_NONE)
+	{
+		for (int32 Index = TargetIndex; Index != StartIndex; Index = Scratch.Parents[Index])
+		{
+			OutCells.Add(FIntPoint(Index % Width, Index / Width));
+		}
+
+		TArrayView<FIntPoint> Route = MakeArrayView(OutCells).RightChop(FirstRouteCell);
+		Algo::Reverse(Route);
+	}
+
+	// The buffers are shared, leave them clean for the next follower
+	for (const int32 Index : Scratch.Queue)
+	{
+		Scratch.Parents[Index] = INDEX_NONE;
+	}
+
+	for (int32 Index = FirstRouteCell; Index < OutCells.Num(); ++Index)
+	{
+		const FIntPoint Step = OutCells[Index] - Cell;
+		Heading = Step.X == 1 ? 0 : Step.Y == 1 ? 1 : Step.X == -1 ? 2 : 3;
+		Cell = OutCells[Index];
+		Visit(Cell);
+	}
+
+	return OutCells.Num() - FirstRouteCell;
+}
+
+void FMazeWallFollower::Visit(const FIntPoint& InCell)
+{
+	if (IsValidCell(InCell) && !Visited[InCell.Y * Width + InCell.X])
+	{
+		Visited[InCell.Y * Width + InCell.X] = true;
+		++NumVisited;
+	}
+}
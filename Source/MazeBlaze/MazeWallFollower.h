@@ -0,0 +1,84 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+
+// Search buffers shared by every follower on the same grid; only needed when a follower is trapped in a loop
+struct FMazeWallFollowerScratch
+{
+	TArray<int32> Parents;
+	TArray<int32> Queue;
+};
+
+/**
+ * Reactive wall follower with a one-bit-per-cell memory of the visited cells
+ *
+ * Every step takes the first walkable direction in hand order (turn towards the hand, straight,
+ * turn away, back), preferring cells that were never visited. A walk over visited cells that
+ * comes back to where it started went round a loop: the follower switches hands, and if the
+ * other wall loops as well, it walks a breadth-first route to the nearest unvisited cell.
+ * When nothing reachable is left unvisited the memory is cleared for a new sweep.
+ *
+ * Headings are 0 = +X, 1 = +Y, 2 = -X, 3 = -Y; with Y pointing right of X (as in the world,
+ * seen from above) the left hand is at Heading - 1.
+ */
+class MAZEBLAZE_API FMazeWallFollower
+{
+public:
+	// Start following at Cell on a Width x Height grid, forgetting every visited cell
+	void Reset(int32 InWidth, int32 InHeight, const FIntPoint& InCell, bool bInLeftHand = true);
+
+	// Continue from another cell (the agent was moved by something else), keeping the visited cells
+	void Relocate(const FIntPoint& InCell);
+
+	// Walk about MaxCells cells over a walkability mask indexed Y * Width + X and append them to OutCells;
+	// a route out of a loop is always walked whole. Returns the number of cells walked
+	int32 Advance(const TBitArray<>& Walkable, int32 MaxCells, TArray<FIntPoint>& OutCells, FMazeWallFollowerScratch& Scratch);
+
+	bool HasVisited(const FIntPoint& Cell) const
+	{
+		return IsValidCell(Cell) && Visited[Cell.Y * Width + Cell.X];
+	}
+
+	bool IsValidCell(const FIntPoint& Cell) const
+	{
+		return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+	}
+
+	bool IsInitialized() const { return Width > 0 && Height > 0; }
+	int32 GetWidth() const { return Width; }
+	int32 GetHeight() const { return Height; }
+	const FIntPoint& GetCell() const { return Cell; }
+	int32 GetHeading() const { return Heading; }
+	bool IsLeftHand() const { return bLeftHand; }
+	int32 GetNumVisitedCells() const { return NumVisited; }
+	int32 GetNumHandSwitches() const { return NumHandSwitches; }
+	int32 GetNumSweeps() const { return NumSweeps; }
+
+	// Bytes used by this follower, the visited bitset included
+	SIZE_T GetAllocatedSize() const { return sizeof(*this) + Visited.GetAllocatedSize(); }
+
+private:
+	// Walk the shortest route to the nearest unvisited cell; returns the number of cells walked, 0 if none is reachable
+	int32 RouteToUnvisited(const TBitArray<>& Walkable, TArray<FIntPoint>& OutCells, FMazeWallFollowerScratch& Scratch);
+
+	void Visit(const FIntPoint& InCell);
+
+	TBitArray<> Visited;
+	int32 Width = 0;
+	int32 Height = 0;
+	int32 NumVisited = 0;
+	FIntPoint Cell = FIntPoint::ZeroValue;
+
+	// First step of the current walk over visited cells; stepping on it again closes a loop
+	FIntPoint LoopAnchorCell = FIntPoint::ZeroValue;
+	uint8 LoopAnchorHeading = 0;
+	bool bHasLoopAnchor = false;
+	bool bSwitchedInLoop = false;
+
+	uint8 Heading = 0;
+	bool bLeftHand = true;
+
+	int32 NumHandSwitches = 0;
+	int32 NumSweeps = 0;
+};
@@ -0,0 +1,134 @@
+#include "MazeWallFollowingSubsystem.h"
+#include "MazeTopologySubsystem.h"
+#include "GameFramework/Pawn.h"
+#include "Engine/World.h"
+
+UMazeWallFollowingSubsystem* UMazeWallFollowingSubsystem::Get(const UObject* WorldContextObject)
+{
+	const UWorld* World = WorldContextObject ? WorldContextObject->GetWorld() : nullptr;
+	return World ? World->GetSubsystem<UMazeWallFollowingSubsystem>() : nullptr;
+}
+
+void UMazeWallFollowingSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (UMazeTopologySubsystem* Topology = Collection.InitializeDependency<UMazeTopologySubsystem>())
+	{
+		TopologyChangedHandle = Topology->OnTopologyChanged.AddUObject(this, &UMazeWallFollowingSubsystem::HandleTopologyChanged);
+	}
+}
+
+void UMazeWallFollowingSubsystem::Deinitialize()
+{
+	if (UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this))
+	{
+		Topology->OnTopologyChanged.Remove(TopologyChangedHandle);
+	}
+
+	Followers.Empty();
+	Scratch = FMazeWallFollowerScratch();
+
+	Super::Deinitialize();
+}
+
+bool UMazeWallFollowingSubsystem::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+bool UMazeWallFollowingSubsystem::ChooseRoute(APawn* Agent, TArray<FVector>& OutPoints)
+{
+	OutPoints.Reset();
+
+	UMazeTopologySubsystem* Topology = UMazeTopologySubsystem::Get(this);
+	FIntPoint AgentCell;
+	if (!Agent || !Topology || !Topology->EnsureGraph() || !Topology->FindWalkableCell(Agent->GetActorLocation(), AgentCell))
+	{
+		return false;
+	}
+
+	const FMazeTopologyGraph& Graph = Topology->GetGraph();
+	FMazeWallFollower* Follower = Followers.Find(Agent);
+	if (!Follower)
+	{
+		RemoveStaleFollowers();
+
+		Follower = &Followers.Add(Agent);
+		Follower->Reset(Graph.GetWidth(), Graph.GetHeight(), AgentCell, NumFollowersCreated++ % 2 == 0);
+	}
+	else if (Follower->GetCell() != AgentCell)
+	{
+		// The agent did not end up where the last run ended (blocked, or it went after a key)
+		Follower->Relocate(AgentCell);
+	}
+
+	TArray<FIntPoint> Cells;
+	if (Follower->Advance(Graph.GetWalkable(), CellsPerMove, Cells, Scratch) == 0)
+	{
+		return false;
+	}
+
+	Topology->CellPathToPoints(Agent->GetActorLocation(), AgentCell, Cells, Topology->GetCellLocation(Cells.Last()), OutPoints);
+	return true;
+}
+
+void UMazeWallFollowingSubsystem::UnregisterAgent(const APawn* Agent)
+{
+	Followers.Remove(Agent);
+}
+
+int32 UMazeWallFollowingSubsystem::GetAgentMemoryBytes(const APawn* Agent) const
+{
+	const FMazeWallFollower* Follower = Followers.Find(Agent);
+	return Follower ? int32(Follower->GetAllocatedSize()) : 0;
+}
+
+FMazeWallFollowingStats UMazeWallFollowingSubsystem::GetStats() const
+{
+	FMazeWallFollowingStats Stats;
+	SIZE_T FollowerBytes = 0;
+	double VisitedFractionSum = 0.0;
+
+	for (const TPair<TWeakObjectPtr<const APawn>, FMazeWallFollower>& Pair : Followers)
+	{
+		if (!Pair.Key.IsValid())
+		{
+			continue;
+		}
+
+		const FMazeWallFollower& Follower = Pair.Value;
+		++Stats.NumAgents;
+		FollowerBytes += Follower.GetAllocatedSize();
+		VisitedFractionSum += double(Follower.GetNumVisitedCells()) / FMath::Max(Follower.GetWidth() * Follower.GetHeight(), 1);
+	}
+
+	if (Stats.NumAgents > 0)
+	{
+		Stats.BytesPerAgent = int32(FollowerBytes / Stats.NumAgents);
+		Stats.AverageVisitedFraction = float(VisitedFractionSum / Stats.NumAgents);
+	}
+	Stats.TotalBytes = int32(FollowerBytes + Followers.GetAllocatedSize() + Scratch.Parents.GetAllocatedSize() + Scratch.Queue.GetAllocatedSize());
+	return Stats;
+}
+
+void UMazeWallFollowingSubsystem::HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable)
+{
+	// Doors are read from the live graph; only a rebuilt grid invalidates the followers
+	if (Cells.IsEmpty())
+	{
+		Followers.Empty();
+		Scratch = FMazeWallFollowerScratch();
+	}
+}
+
+void UMazeWallFollowingSubsystem::RemoveStaleFollowers()
+{
+	for (auto It = Followers.CreateIterator(); It; ++It)
+	{
+		if (!It->Key.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MazeWallFollower.h"
+#include "MazeWallFollowingSubsystem.generated.h"
+
+// Memory used by the wall following agents
+USTRUCT(BlueprintType)
+struct MAZEBLAZE_API FMazeWallFollowingStats
+{
+	GENERATED_BODY()
+
+	// Agents with a wall follower
+	UPROPERTY(BlueprintReadOnly, Category = "Exploration|WallFollowing")
+	int32 NumAgents = 0;
+
+	// Bytes of one follower, its visited-cell bitset included
+	UPROPERTY(BlueprintReadOnly, Category = "Exploration|WallFollowing")
+	int32 BytesPerAgent = 0;
+
+	// Bytes of all followers and the shared search buffers
+	UPROPERTY(BlueprintReadOnly, Category = "Exploration|WallFollowing")
+	int32 TotalBytes = 0;
+
+	// Average share of the grid cells each agent has visited in its current sweep
+	UPROPERTY(BlueprintReadOnly, Category = "Exploration|WallFollowing")
+	float AverageVisitedFraction = 0.0f;
+};
+
+/**
+ * World subsystem that runs the WallFollowing exploration mode
+ *
+ * Every agent gets a wall follower on the topology subsystem's grid, alternating left and
+ * right hands so a crowd spreads out. A move is a run of cells turned into corner points, so
+ * agents follow it without any navmesh query. Followers read the live walkability of the
+ * topology graph, so opened doors are followed right away.
+ */
+UCLASS(config = Game)
+class MAZEBLAZE_API UMazeWallFollowingSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	// Get the wall following subsystem for the world of the given object
+	static UMazeWallFollowingSubsystem* Get(const UObject* WorldContextObject);
+
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	// Advance the agent's follower and return the run as corner points (agent location included)
+	bool ChooseRoute(APawn* Agent, TArray<FVector>& OutPoints);
+
+	// Forget an agent's follower
+	UFUNCTION(BlueprintCallable, Category = "Exploration|WallFollowing")
+	void UnregisterAgent(const APawn* Agent);
+
+	// Bytes used by an agent's follower, or zero if it has none
+	UFUNCTION(BlueprintCallable, Category = "Exploration|WallFollowing")
+	int32 GetAgentMemoryBytes(const APawn* Agent) const;
+
+	// Memory used by all followers
+	UFUNCTION(BlueprintCallable, Category = "Exploration|WallFollowing")
+	FMazeWallFollowingStats GetStats() const;
+
+	const FMazeWallFollower* FindFollower(const APawn* Agent) const { return Followers.Find(Agent); }
+
+	// Cells walked per move
+	UPROPERTY(Config, EditAnywhere, Category = "Exploration|WallFollowing", meta = (ClampMin = "1"))
+	int32 CellsPerMove = 24;
+
+protected:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+
+private:
+	void HandleTopologyChanged(TConstArrayView<FIntPoint> Cells, bool bWalkable);
+
+	// Drop the followers of destroyed pawns
+	void RemoveStaleFollowers();
+
+	TMap<TWeakObjectPtr<const APawn>, FMazeWallFollower> Followers;
+	FMazeWallFollowerScratch Scratch;
+
+	// Followers created so far, for alternating hands
+	int32 NumFollowersCreated = 0;
+
+	FDelegateHandle TopologyChangedHandle;
+};
@@ -5,6 +5,7 @@
 #include "AIErrorHandlingTests.h"
 #include "Engine/World.h"
 #include "../MazeBlazeAIController.h"
+#include "../MazeAIStatusText.h"
 
 bool UAIErrorHandlingTestRunner::RunAllAIErrorHandlingTests(const UObject* WorldContextObject)
 {
@@ -107,7 +108,7 @@ FString UAIErrorHandlingTestRunner::GetAIControllerErrorState(AMazeBlazeAIContro
         return TEXT("Invalid Controller");
     }
     
-    return UEnum::GetValueAsString(AIController->CurrentErrorState);
+    return FMazeAIStatusText::GetErrorTypeName(AIController->CurrentErrorState);
 }
 
 FString UAIErrorHandlingTestRunner::GetAIControllerLastErrorMessage(AMazeBlazeAIController* AIController)
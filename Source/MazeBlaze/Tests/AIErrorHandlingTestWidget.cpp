@@ -7,6 +7,34 @@
 #include "Engine/World.h"
 #include "EngineUtils.h"
 #include "../MazeBlazeAIController.h"
+#include "../MazeAgentMonitorSubsystem.h"
+#include "../MazeAIStatusText.h"
+
+template <typename FunctionType>
+void UAIErrorHandlingTestWidget::ForEachAIController(FunctionType&& Function) const
+{
+    // The monitor already holds every controller; iterating actors builds an object list per call
+    const UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(this);
+    if (AgentMonitor && AgentMonitor->bEnabled)
+    {
+        for (AMazeBlazeAIController* AIController : AgentMonitor->GetControllers())
+        {
+            if (AIController)
+            {
+                Function(AIController);
+            }
+        }
+        return;
+    }
+    
+    for (AMazeBlazeAIController* AIController : GetAllAIControllers())
+    {
+        if (AIController)
+        {
+            Function(AIController);
+        }
+    }
+}
 
 void UAIErrorHandlingTestWidget::RunAllTests()
 {
@@ -100,36 +128,44 @@ int32 UAIErrorHandlingTestWidget::GetAIControllerCount() const
 
 int32 UAIErrorHandlingTestWidget::GetAIControllersInErrorState() const
 {
-    TArray<AMazeBlazeAIController*> AIControllers = GetAllAIControllers();
-    
     int32 Count = 0;
-    for (AMazeBlazeAIController* AIController : AIControllers)
+    ForEachAIController([&Count](const AMazeBlazeAIController* AIController)
     {
-        if (AIController && AIController->IsInErrorState())
+        if (AIController->IsInErrorState())
         {
             Count++;
         }
-    }
+    });
     
     return Count;
 }
 
 TArray<FString> UAIErrorHandlingTestWidget::GetAllErrorStates() const
 {
-    TArray<AMazeBlazeAIController*> AIControllers = GetAllAIControllers();
     TArray<FString> ErrorStates;
-    
-    for (AMazeBlazeAIController* AIController : AIControllers)
+    ForEachAIController([&ErrorStates](const AMazeBlazeAIController* AIController)
     {
-        if (AIController && AIController->IsInErrorState())
+        if (AIController->IsInErrorState())
         {
-            ErrorStates.Add(UAIErrorHandlingTestRunner::GetAIControllerErrorState(AIController));
+            ErrorStates.Add(FMazeAIStatusText::GetErrorTypeName(AIController->CurrentErrorState));
         }
-    }
+    });
     
     return ErrorStates;
 }
 
+void UAIErrorHandlingTestWidget::CollectErrorStates(TArray<FName>& OutErrorStates) const
+{
+    OutErrorStates.Reset();
+    ForEachAIController([&OutErrorStates](const AMazeBlazeAIController* AIController)
+    {
+        if (AIController->IsInErrorState())
+        {
+            OutErrorStates.Add(FMazeAIStatusText::GetErrorTypeFName(AIController->CurrentErrorState));
+        }
+    });
+}
+
 TArray<FString> UAIErrorHandlingTestWidget::GetAllErrorMessages() const
 {
     TArray<AMazeBlazeAIController*> AIControllers = GetAllAIControllers();
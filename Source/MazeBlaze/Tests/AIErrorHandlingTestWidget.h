@@ -48,6 +48,9 @@ public:
     UFUNCTION(BlueprintPure, Category = "AI Testing")
     TArray<FString> GetAllErrorStates() const;
     
+    /** Get the error states into an array kept by the caller; does not allocate once the array has room */
+    void CollectErrorStates(TArray<FName>& OutErrorStates) const;
+    
     /** Get a list of all error messages */
     UFUNCTION(BlueprintPure, Category = "AI Testing")
     TArray<FString> GetAllErrorMessages() const;
@@ -85,4 +88,8 @@ private:
     
     /** Find all AI controllers in the level */
     TArray<class AMazeBlazeAIController*> GetAllAIControllers() const;
+    
+    /** Call a function for every AI controller, using the agent monitor's list when it has one */
+    template <typename FunctionType>
+    void ForEachAIController(FunctionType&& Function) const;
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+// MazeAIStatusTextTests.cpp
+// AI state and error name tables checked against reflection, and status text polling of spawned agents checked for buffer growth and allocations
+
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "HAL/MemoryBase.h"
+
+#include "AIErrorHandlingTestWidget.h"
+#include "../MazeAIStatusText.h"
+#include "../MazeAgentMonitorSubsystem.h"
+#include "../MazeBlazeAIController.h"
+
+namespace MazeAIStatusTextTests
+{
+    // Process-wide malloc and realloc calls, advanced only by allocators that count them; GMalloc is left in place
+    uint64 GetNumAllocationCalls()
+    {
+        return FMalloc::TotalMallocCalls + FMalloc::TotalReallocCalls;
+    }
+
+    bool IsCountingAllocations()
+    {
+        const uint64 NumCallsBefore = GetNumAllocationCalls();
+        FMemory::Free(FMemory::Malloc(16));
+        return GetNumAllocationCalls() != NumCallsBefore;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeAIStatusTextSpec, "MazeBlaze.AIStatusText", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeAIStatusTextSpec)
+
+void FMazeAIStatusTextSpec::Define()
+{
+    Describe("Tables", [this]()
+    {
+        It("should name every state and error type like UEnum::GetValueAsString", [this]()
+        {
+            // NumEnums counts the generated _MAX entry
+            TestEqual(TEXT("One entry per state"), StaticEnum<EAIState>()->NumEnums() - 1, FMazeAIStatusText::NumStates);
+            TestEqual(TEXT("One entry per error type"), StaticEnum<EAIErrorType>()->NumEnums() - 1, FMazeAIStatusText::NumErrorTypes);
+
+            for (int32 Index = 0; Index < FMazeAIStatusText::NumStates; ++Index)
+            {
+                const EAIState State = static_cast<EAIState>(Index);
+                TestEqual(TEXT("State name"), FString(FMazeAIStatusText::GetStateName(State)), UEnum::GetValueAsString(State));
+                TestEqual(TEXT("State string"), FMazeAIStatusText::GetStateString(State), UEnum::GetValueAsString(State));
+            }
+            for (int32 Index = 0; Index < FMazeAIStatusText::NumErrorTypes; ++Index)
+            {
+                const EAIErrorType ErrorType = static_cast<EAIErrorType>(Index);
+                TestEqual(TEXT("Error type name"), FString(FMazeAIStatusText::GetErrorTypeName(ErrorType)), UEnum::GetValueAsString(ErrorType));
+                TestEqual(TEXT("Error type FName"), FMazeAIStatusText::GetErrorTypeFName(ErrorType), FName(*UEnum::GetValueAsString(ErrorType)));
+            }
+
+            TestEqual(TEXT("Timeout message reads as before"), FMazeAIStatusText::GetStateTimeoutMessage(EAIState::SeekingDoor),
+                FString::Printf(TEXT("Stuck in state %s for too long"), *UEnum::GetValueAsString(EAIState::SeekingDoor)));
+        });
+    });
+
+    Describe("Allocations", [this]()
+    {
+        It("should poll the error states and status text of spawned agents without growing their buffers", [this]()
+        {
+            UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+            FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            WorldContext.SetCurrentWorld(World);
+
+            // Agents in error, registered with the monitor the widget iterates as BeginPlay would
+            const int32 NumAgents = 64;
+            UMazeAgentMonitorSubsystem* AgentMonitor = UMazeAgentMonitorSubsystem::Get(World);
+            TArray<AMazeBlazeAIController*> Controllers;
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                AMazeBlazeAIController* Controller = World->SpawnActor<AMazeBlazeAIController>();
+                if (!Controller)
+                {
+                    continue;
+                }
+
+                Controller->CurrentErrorState = static_cast<EAIErrorType>(1 + Agent % (FMazeAIStatusText::NumErrorTypes - 1));
+                Controller->LastErrorMessage = FMazeAIStatusText::GetStateTimeoutMessage(static_cast<EAIState>(Agent % FMazeAIStatusText::NumStates));
+                if (AgentMonitor)
+                {
+                    AgentMonitor->RegisterController(Controller);
+                }
+                Controllers.Add(Controller);
+            }
+
+            UAIErrorHandlingTestWidget* Widget = NewObject<UAIErrorHandlingTestWidget>(World);
+            TArray<FName> ErrorStates;
+
+            // The first poll sizes the reused array; later polls must write into the same storage
+            Widget->CollectErrorStates(ErrorStates);
+            const FName* ErrorStatesData = ErrorStates.GetData();
+            const SIZE_T ErrorStatesSize = ErrorStates.GetAllocatedSize();
+
+            // Buffer checks only catch growth of the reused storage, so the loop also counts every allocation made while it runs
+            const int32 NumFrames = 10;
+            const int32 NumPolls = NumFrames * (1 + Controllers.Num());
+            const bool bIsCountingAllocations = MazeAIStatusTextTests::IsCountingAllocations();
+            int32 NumGrownArrays = 0;
+            int32 NumGrownBuilders = 0;
+            const uint64 NumCallsBefore = MazeAIStatusTextTests::GetNumAllocationCalls();
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                Widget->CollectErrorStates(ErrorStates);
+                NumGrownArrays += ErrorStates.GetData() != ErrorStatesData || ErrorStates.GetAllocatedSize() != ErrorStatesSize ? 1 : 0;
+
+                for (const AMazeBlazeAIController* Controller : Controllers)
+                {
+                    FMazeAIStatusTextBuilder StatusText;
+                    const TCHAR* InlineData = StatusText.GetData();
+                    Controller->AppendDebugStatusText(StatusText);
+                    NumGrownBuilders += StatusText.GetData() != InlineData ? 1 : 0;
+                }
+            }
+            const uint64 NumAllocationCalls = MazeAIStatusTextTests::GetNumAllocationCalls() - NumCallsBefore;
+
+            TestEqual(TEXT("Every agent spawned"), Controllers.Num(), NumAgents);
+            TestEqual(TEXT("Every agent polled"), ErrorStates.Num(), NumAgents);
+            TestEqual(TEXT("Error state array reused"), NumGrownArrays, 0);
+            TestEqual(TEXT("Status text stayed in the inline builder"), NumGrownBuilders, 0);
+
+            // Other threads share the counter, so a poll that allocates even a temporary shows up as one call per poll or more
+            if (bIsCountingAllocations)
+            {
+                UE_LOG(LogTemp, Display, TEXT("Status text polling: %llu allocation calls over %d polls"), NumAllocationCalls, NumPolls);
+                TestTrue(TEXT("Polling made no per-poll allocations"), NumAllocationCalls < static_cast<uint64>(NumPolls));
+            }
+            else
+            {
+                UE_LOG(LogTemp, Display, TEXT("Status text polling: the active allocator does not count calls, temporaries are not checked"));
+            }
+
+            if (Controllers.Num() > 0)
+            {
+                const FString StatusText = Controllers[0]->GetDebugStatusText();
+                TestTrue(TEXT("Status text reports the error"), StatusText.Contains(FMazeAIStatusText::GetErrorTypeName(Controllers[0]->CurrentErrorState)));
+            }
+
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        });
+    });
+}
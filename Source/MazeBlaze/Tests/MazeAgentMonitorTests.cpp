@@ -0,0 +1,133 @@
+// MazeAgentMonitorTests.cpp
+// Batched stuck, state and path following timeouts, agent removal and an update benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+
+#include "../MazeAgentMonitor.h"
+
+BEGIN_DEFINE_SPEC(FMazeAgentMonitorSpec, "MazeBlaze.AgentMonitor", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeAgentMonitorSpec)
+
+void FMazeAgentMonitorSpec::Define()
+{
+    Describe("Update", [this]()
+    {
+        It("should report an agent creeping along while moving, and not one walking or waiting", [this]()
+        {
+            FMazeAgentMonitor Monitor;
+            const int32 Creeping = Monitor.AddAgent(FVector::ZeroVector, 0);
+            const int32 Walking = Monitor.AddAgent(FVector::ZeroVector, 0);
+            const int32 Waiting = Monitor.AddAgent(FVector::ZeroVector, 0);
+
+            // Defaults: 50 units, 3 seconds; ticks of half a second
+            TArray<FMazeAgentMonitorEventRecord> Events;
+            int32 StuckTick = INDEX_NONE;
+            for (int32 Tick = 1; Tick <= 8; ++Tick)
+            {
+                Monitor.SetSample(Creeping, FVector(Tick * 5.0f, 0.0f, 0.0f), true, 0);
+                Monitor.SetSample(Walking, FVector(Tick * 100.0f, 0.0f, 0.0f), true, uint8(Tick % 2));
+                Monitor.SetSample(Waiting, FVector::ZeroVector, false, uint8(Tick % 2));
+
+                Events.Reset();
+                Monitor.Update(0.5f, Events);
+                for (const FMazeAgentMonitorEventRecord& Record : Events)
+                {
+                    TestEqual(TEXT("Only the creeping agent is stuck"), Record.AgentIndex, Creeping);
+                    TestEqual(TEXT("Stuck event"), Record.Event, EMazeAgentMonitorEvent::Stuck);
+                    StuckTick = Tick;
+                }
+            }
+            TestEqual(TEXT("Stuck once past three seconds"), StuckTick, 7);
+            TestEqual(TEXT("Stuck time restarts after the event"), Monitor.GetStuckTime(Creeping), 0.5f);
+        });
+
+        It("should report state and path following timeouts once and restart them", [this]()
+        {
+            FMazeAgentMonitor Monitor;
+            Monitor.Settings.MaxTimeInState = 2.0f;
+            Monitor.Settings.MaxPathFollowingTime = 3.0f;
+            const int32 Agent = Monitor.AddAgent(FVector::ZeroVector, 1);
+
+            TArray<FMazeAgentMonitorEventRecord> Events;
+            for (int32 Tick = 1; Tick <= 4; ++Tick)
+            {
+                Monitor.SetSample(Agent, FVector(Tick * 100.0f, 0.0f, 0.0f), true, 1);
+                Monitor.Update(1.0f, Events);
+            }
+
+            TestEqual(TEXT("Two events"), Events.Num(), 2);
+            TestEqual(TEXT("State timed out first"), Events[0].Event, EMazeAgentMonitorEvent::StateTimeout);
+            TestEqual(TEXT("Then the path"), Events[1].Event, EMazeAgentMonitorEvent::PathFollowingTimeout);
+            TestEqual(TEXT("Time in state restarted"), Monitor.GetTimeInState(Agent), 1.0f);
+
+            Monitor.ResetAgent(Agent, FVector::ZeroVector);
+            TestEqual(TEXT("Reset clears the path timer"), Monitor.GetPathFollowingTime(Agent), 0.0f);
+        });
+
+        It("should keep the timers of inactive agents and of agents moved by a removal", [this]()
+        {
+            FMazeAgentMonitor Monitor;
+            const int32 First = Monitor.AddAgent(FVector::ZeroVector, 0);
+            const int32 Last = Monitor.AddAgent(FVector(1000.0f, 0.0f, 0.0f), 0);
+
+            TArray<FMazeAgentMonitorEventRecord> Events;
+            Monitor.SetSample(First, FVector::ZeroVector, true, 0);
+            Monitor.SetSample(Last, FVector(1000.0f, 0.0f, 0.0f), true, 0);
+            Monitor.Update(1.0f, Events);
+            Monitor.Update(1.0f, Events);
+
+            Monitor.SetSample(First, FVector::ZeroVector, true, 0, false);
+            Monitor.Update(1.0f, Events);
+            TestEqual(TEXT("Inactive agent keeps its stuck time"), Monitor.GetStuckTime(First), 2.0f);
+            TestEqual(TEXT("Active agent goes on"), Monitor.GetStuckTime(Last), 3.0f);
+
+            Monitor.RemoveAgentAtSwap(First);
+            TestEqual(TEXT("One agent left"), Monitor.Num(), 1);
+            TestEqual(TEXT("Last agent moved with its timers"), Monitor.GetStuckTime(0), 3.0f);
+            TestEqual(TEXT("No events yet"), Events.Num(), 0);
+        });
+    });
+
+    Describe("Performance", [this]()
+    {
+        It("should report every blocked agent among ten thousand and log the update cost", [this]()
+        {
+            FMazeAgentMonitor Monitor;
+            const int32 NumAgents = 10000;
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                Monitor.AddAgent(FVector(Agent * 100.0f, 0.0f, 0.0f), 0);
+            }
+
+            TArray<FMazeAgentMonitorEventRecord> Events;
+            const int32 NumFrames = 100;
+            double UpdateSeconds = 0.0;
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                // Every tenth agent is stuck against a wall, the others walk
+                for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+                {
+                    const float Walked = Agent % 10 == 0 ? 0.0f : Frame * 10.0f;
+                    Monitor.SetSample(Agent, FVector(Agent * 100.0f + Walked, 0.0f, 0.0f), true, uint8(Frame / 30));
+                }
+
+                const double StartTime = FPlatformTime::Seconds();
+                Monitor.Update(1.0f / 30.0f, Events);
+                UpdateSeconds += FPlatformTime::Seconds() - StartTime;
+            }
+            const double NanosecondsPerAgent = UpdateSeconds * 1e9 / (double(NumFrames) * NumAgents);
+
+            int32 NumStuck = 0;
+            for (const FMazeAgentMonitorEventRecord& Record : Events)
+            {
+                NumStuck += Record.Event == EMazeAgentMonitorEvent::Stuck ? 1 : 0;
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("AgentMonitor: %d agents, %.2f ns per agent update, %d stuck events, %.1f KB"),
+                NumAgents, NanosecondsPerAgent, NumStuck, Monitor.GetAllocatedSize() / 1024.0);
+
+            TestEqual(TEXT("Every blocked agent reported"), NumStuck, NumAgents / 10);
+        });
+    });
+}
@@ -0,0 +1,162 @@
+// MazeAsyncNavigationQueueTests.cpp
+// Async navigation query batches: request order, the per-frame cap, cancelling and queries queued from delegates
+
+#include "Misc/AutomationTest.h"
+
+#include "../MazeAsyncNavigationQueue.h"
+
+namespace MazeAsyncNavigationQueueTests
+{
+    // Path query without navigation data, so the workers find nothing and the delegate gets a null path
+    uint32 AddPathQuery(FMazeAsyncNavigationQueue& Queue, TArray<uint32>& Delivered)
+    {
+        FMazeAsyncNavigationQuery Query;
+        Query.bPathQuery = true;
+        Query.OnPathComplete.BindLambda([&Delivered](uint32 QueryId, FNavPathSharedPtr Path)
+        {
+            Delivered.Add(QueryId);
+        });
+        return Queue.Add(MoveTemp(Query));
+    }
+
+    FString JoinIds(TConstArrayView<uint32> QueryIds)
+    {
+        FString Result;
+        for (const uint32 QueryId : QueryIds)
+        {
+            Result += FString::Printf(Result.IsEmpty() ? TEXT("%u") : TEXT(", %u"), QueryId);
+        }
+        return Result;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeAsyncNavigationQueueSpec, "MazeBlaze.AsyncNavigationQueue", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeAsyncNavigationQueueSpec)
+
+void FMazeAsyncNavigationQueueSpec::Define()
+{
+    using namespace MazeAsyncNavigationQueueTests;
+
+    Describe("Batching", [this]()
+    {
+        It("should send at most the per-frame cap to the workers and deliver in request order over the next frames", [this]()
+        {
+            FMazeAsyncNavigationQueue Queue;
+            TArray<uint32> Delivered;
+            TArray<uint32> Requested;
+            for (int32 Index = 0; Index < 10; ++Index)
+            {
+                const uint32 QueryId = AddPathQuery(Queue, Delivered);
+                TestTrue(TEXT("Zero is no query"), QueryId != 0);
+                Requested.Add(QueryId);
+            }
+            TestEqual(TEXT("All waiting"), Queue.GetNumPending(), 10);
+
+            // Two queries per task
+            const int32 Cap = 4;
+            const int32 ExpectedBatches[] = { 4, 4, 2 };
+            for (const int32 ExpectedBatch : ExpectedBatches)
+            {
+                Queue.Launch(Cap, 2);
+                TestEqual(TEXT("Capped batch"), Queue.GetNumRunning(), ExpectedBatch);
+                TestEqual(TEXT("Nothing delivered before the batch completes"), Delivered.Num(), Requested.Num() - Queue.GetNumPending() - ExpectedBatch);
+
+                Queue.Complete();
+                TestEqual(TEXT("Batch delivered"), Queue.GetNumRunning(), 0);
+            }
+
+            TestEqual(TEXT("Queue drained"), Queue.GetNumPending(), 0);
+            TestEqual(TEXT("Every query delivered once, in request order"), JoinIds(Delivered), JoinIds(Requested));
+        });
+
+        It("should complete a batch still out before launching the next one", [this]()
+        {
+            FMazeAsyncNavigationQueue Queue;
+            TArray<uint32> Delivered;
+            const uint32 First = AddPathQuery(Queue, Delivered);
+            Queue.Launch(1, 1);
+
+            const uint32 Second = AddPathQuery(Queue, Delivered);
+            Queue.Launch(1, 1);
+            TestEqual(TEXT("First batch delivered by the second launch"), JoinIds(Delivered), JoinIds({ First }));
+            TestEqual(TEXT("Second query on the workers"), Queue.GetNumRunning(), 1);
+
+            Queue.Complete();
+            TestEqual(TEXT("Both delivered"), JoinIds(Delivered), JoinIds({ First, Second }));
+        });
+
+        It("should put queries made by delegates into the next batch", [this]()
+        {
+            FMazeAsyncNavigationQueue Queue;
+            TArray<uint32> Delivered;
+            uint32 FollowUp = 0;
+
+            // A recovering agent whose point query fails asks for a path straight away
+            FMazeAsyncNavigationQuery PointQuery;
+            PointQuery.Radii.Add(500.0f);
+            PointQuery.OnPointComplete.BindLambda([&Queue, &Delivered, &FollowUp](uint32 QueryId, bool bFound, const FVector& Point)
+            {
+                Delivered.Add(QueryId);
+                if (!bFound)
+                {
+                    FollowUp = AddPathQuery(Queue, Delivered);
+                }
+            });
+            const uint32 PointQueryId = Queue.Add(MoveTemp(PointQuery));
+
+            Queue.Launch(8, 8);
+            Queue.Complete();
+            TestEqual(TEXT("Point query delivered"), JoinIds(Delivered), JoinIds({ PointQueryId }));
+            TestTrue(TEXT("Follow-up queued"), FollowUp != 0);
+            TestEqual(TEXT("Follow-up waits for the next batch"), Queue.GetNumPending(), 1);
+
+            Queue.Launch(8, 8);
+            Queue.Complete();
+            TestEqual(TEXT("Follow-up delivered"), JoinIds(Delivered), JoinIds({ PointQueryId, FollowUp }));
+        });
+    });
+
+    Describe("Cancel", [this]()
+    {
+        It("should drop waiting and running queries without calling their delegates", [this]()
+        {
+            FMazeAsyncNavigationQueue Queue;
+            TArray<uint32> Delivered;
+            const uint32 Running = AddPathQuery(Queue, Delivered);
+            const uint32 RunningCancelled = AddPathQuery(Queue, Delivered);
+            const uint32 Waiting = AddPathQuery(Queue, Delivered);
+            const uint32 WaitingCancelled = AddPathQuery(Queue, Delivered);
+
+            Queue.Launch(2, 1);
+            Queue.Cancel(RunningCancelled);
+            Queue.Cancel(WaitingCancelled);
+            TestEqual(TEXT("Cancelled running query stays with its batch"), Queue.GetNumRunning(), 2);
+            TestEqual(TEXT("Cancelled waiting query removed"), Queue.GetNumPending(), 1);
+
+            // No query, and ids that are unknown or already delivered, are ignored
+            Queue.Cancel(0);
+            Queue.Cancel(WaitingCancelled + 100);
+
+            Queue.Complete();
+            Queue.Cancel(Running);
+            Queue.Launch(2, 1);
+            Queue.Complete();
+            TestEqual(TEXT("Only the live queries delivered"), JoinIds(Delivered), JoinIds({ Running, Waiting }));
+        });
+
+        It("should drop everything on reset", [this]()
+        {
+            FMazeAsyncNavigationQueue Queue;
+            TArray<uint32> Delivered;
+            AddPathQuery(Queue, Delivered);
+            AddPathQuery(Queue, Delivered);
+            Queue.Launch(1, 1);
+
+            Queue.Reset();
+            Queue.Complete();
+            TestEqual(TEXT("Nothing waiting"), Queue.GetNumPending(), 0);
+            TestEqual(TEXT("Nothing running"), Queue.GetNumRunning(), 0);
+            TestEqual(TEXT("Nothing delivered"), Delivered.Num(), 0);
+        });
+    });
+}
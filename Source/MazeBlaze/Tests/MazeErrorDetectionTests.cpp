@@ -0,0 +1,257 @@
+// MazeErrorDetectionTests.cpp
+// Error detection service ticked for spawned agents, each with its own node memory, up to 256 agents sharing one node
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "BehaviorTree/BlackboardData.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Enum.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Object.h"
+#include "BehaviorTree/Blackboard/BlackboardKeyType_Vector.h"
+
+#include "../BTService_ErrorDetection.h"
+#include "../MazeAIStatusText.h"
+
+namespace MazeErrorDetectionTests
+{
+    const FString StuckMessage = TEXT("AI appears to be stuck while moving");
+    const FString PathFollowingMessage = TEXT("Path following taking too long");
+
+    // Agents possessing plain pawns in a world without navigation, so only the service's own timers report errors
+    struct FAgents
+    {
+        UWorld* World = nullptr;
+        TArray<AMazeBlazeAIController*> Controllers;
+    };
+
+    // The keys the service reads
+    UBlackboardData* MakeBlackboard()
+    {
+        UBlackboardData* Blackboard = NewObject<UBlackboardData>();
+        auto AddKey = [Blackboard](const TCHAR* Name, TSubclassOf<UBlackboardKeyType> KeyClass)
+        {
+            FBlackboardEntry& Entry = Blackboard->Keys.AddDefaulted_GetRef();
+            Entry.EntryName = Name;
+            Entry.KeyType = NewObject<UBlackboardKeyType>(Blackboard, KeyClass);
+        };
+        AddKey(TEXT("CurrentState"), UBlackboardKeyType_Enum::StaticClass());
+        AddKey(TEXT("CurrentTarget"), UBlackboardKeyType_Vector::StaticClass());
+        AddKey(TEXT("ExitLocation"), UBlackboardKeyType_Vector::StaticClass());
+        AddKey(TEXT("VisibleKeys"), UBlackboardKeyType_Object::StaticClass());
+        AddKey(TEXT("VisibleDoors"), UBlackboardKeyType_Object::StaticClass());
+        AddKey(TEXT("CurrentKey"), UBlackboardKeyType_Object::StaticClass());
+        return Blackboard;
+    }
+
+    void SpawnAgents(int32 NumAgents, FAgents& OutAgents)
+    {
+        UWorld::InitializationValues WorldValues;
+        WorldValues.CreateNavigation(false);
+        OutAgents.World = UWorld::CreateWorld(EWorldType::Game, false, NAME_None, nullptr, true, ERHIFeatureLevel::Num, &WorldValues);
+        GEngine->CreateNewWorldContext(EWorldType::Game).SetCurrentWorld(OutAgents.World);
+
+        UBlackboardData* Blackboard = MakeBlackboard();
+        for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+        {
+            AMazeBlazeAIController* Controller = OutAgents.World->SpawnActor<AMazeBlazeAIController>();
+            APawn* Pawn = OutAgents.World->SpawnActor<APawn>();
+            if (!Controller || !Pawn)
+            {
+                continue;
+            }
+
+            // Without tree assets OnPossess reports AssetMissing; the blackboard is set up here instead
+            Controller->Possess(Pawn);
+            Controller->CurrentErrorState = EAIErrorType::None;
+            Controller->GetBlackboardComp()->InitializeBlackboard(*Blackboard);
+            Controller->FindComponentByClass<UBehaviorTreeComponent>()->CacheBlackboardComponent(Controller->GetBlackboardComp());
+            Controller->GetBlackboardComp()->SetValueAsVector(TEXT("CurrentTarget"), FVector(1000.0f, 0.0f, 0.0f));
+            OutAgents.Controllers.Add(Controller);
+        }
+    }
+
+    void DestroyAgents(FAgents& Agents)
+    {
+        GEngine->DestroyWorldContext(Agents.World);
+        Agents.World->DestroyWorld(false);
+    }
+
+    // Node memory of one tree instance per agent, with the service's special memory in front as the behavior tree lays it out
+    class FNodeMemoryBlocks
+    {
+    public:
+        FNodeMemoryBlocks(UBTService_ErrorDetection& Service, UBehaviorTreeComponent& OwnerComp, int32 NumBlocks)
+            : NodeMemoryOffset(Align((Service.GetSpecialMemorySize() + 3) & ~3, 16))
+            , BlockSize(NodeMemoryOffset + Align(Service.GetInstanceMemorySize(), 16))
+        {
+            Memory.SetNumZeroed(NumBlocks * BlockSize);
+            for (int32 Block = 0; Block < NumBlocks; ++Block)
+            {
+                Service.InitializeMemory(OwnerComp, Get(Block), EBTMemoryInit::Initialize);
+            }
+        }
+
+        uint8* Get(int32 Block) { return Memory.GetData() + Block * BlockSize + NodeMemoryOffset; }
+
+    private:
+        int32 NodeMemoryOffset;
+        int32 BlockSize;
+        TArray<uint8, TAlignedHeapAllocator<16>> Memory;
+    };
+
+    // Place the agent, steer it or leave it idle, and tick the service on its memory; returns the error reported, if any
+    FString TickAgent(UBTService_ErrorDetection& Service, AMazeBlazeAIController& Controller, uint8* NodeMemory, const FVector& Location, bool bTryingToMove, float DeltaSeconds)
+    {
+        APawn* Pawn = Controller.GetPawn();
+        Pawn->SetActorLocation(Location);
+        if (bTryingToMove)
+        {
+            Pawn->AddMovementInput(FVector::ForwardVector, 1.0f, true);
+        }
+        Pawn->ConsumeMovementInputVector();
+
+        Service.TickNode(*Controller.FindComponentByClass<UBehaviorTreeComponent>(), NodeMemory, DeltaSeconds);
+
+        // Clear the error so the agent is checked again on the next tick
+        if (!Controller.IsInErrorState())
+        {
+            return FString();
+        }
+        Controller.CurrentErrorState = EAIErrorType::None;
+        return Controller.LastErrorMessage;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeErrorDetectionSpec, "MazeBlaze.ErrorDetection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeErrorDetectionSpec)
+
+void FMazeErrorDetectionSpec::Define()
+{
+    using namespace MazeErrorDetectionTests;
+
+    Describe("Stuck detection", [this]()
+    {
+        It("should report an agent that tries to move without getting anywhere", [this]()
+        {
+            FAgents Agents;
+            SpawnAgents(2, Agents);
+            if (TestEqual(TEXT("Agents spawned"), Agents.Controllers.Num(), 2))
+            {
+                UBTService_ErrorDetection* Service = NewObject<UBTService_ErrorDetection>();
+                UBehaviorTreeComponent& OwnerComp = *Agents.Controllers[0]->FindComponentByClass<UBehaviorTreeComponent>();
+                FNodeMemoryBlocks Memories(*Service, OwnerComp, 2);
+
+                // Defaults: 5 seconds within 50 units while moving
+                int32 FirstReport = INDEX_NONE;
+                bool bIdleReported = false;
+                for (int32 Tick = 0; Tick < 10; ++Tick)
+                {
+                    if (TickAgent(*Service, *Agents.Controllers[0], Memories.Get(0), FVector(10.0f, 0.0f, 0.0f), true, 1.0f) == StuckMessage && FirstReport == INDEX_NONE)
+                    {
+                        FirstReport = Tick;
+                    }
+                    bIdleReported |= !TickAgent(*Service, *Agents.Controllers[1], Memories.Get(1), FVector(5000.0f, 0.0f, 0.0f), false, 1.0f).IsEmpty();
+                }
+                TestEqual(TEXT("Reported after five seconds in place"), FirstReport, 5);
+                TestFalse(TEXT("Standing still without a move is not stuck"), bIdleReported);
+            }
+
+            DestroyAgents(Agents);
+        });
+    });
+
+    Describe("Stress", [this]()
+    {
+        It("should keep 256 agents sharing one node independent", [this]()
+        {
+            const int32 NumAgents = 256;
+            FAgents Agents;
+            SpawnAgents(NumAgents, Agents);
+            if (!TestEqual(TEXT("Agents spawned"), Agents.Controllers.Num(), NumAgents))
+            {
+                DestroyAgents(Agents);
+                return;
+            }
+
+            // One service node shared by every agent, one block of node memory per tree instance
+            UBTService_ErrorDetection* Service = NewObject<UBTService_ErrorDetection>();
+            FNodeMemoryBlocks Memories(*Service, *Agents.Controllers[0]->FindComponentByClass<UBehaviorTreeComponent>(), NumAgents);
+
+            // Agents walk, stand still while moving, stand still idle, or walk for a while and then get stuck
+            auto GetLocation = [](int32 Agent, int32 Tick)
+            {
+                const int32 WalkedTicks = Agent % 4 == 0 ? Tick : Agent % 4 == 3 ? FMath::Min(Tick, 3) : 0;
+                return FVector(Agent * 1000.0f + WalkedTicks * 100.0f, 0.0f, 0.0f);
+            };
+
+            TArray<int32> StuckReports;
+            StuckReports.Init(INDEX_NONE, NumAgents);
+            TArray<int32> PathFollowingReports;
+            PathFollowingReports.Init(INDEX_NONE, NumAgents);
+            TArray<int32> StateReports;
+            StateReports.Init(INDEX_NONE, NumAgents);
+
+            const int32 NumTicks = 20;
+            double TickSeconds = 0.0;
+            for (int32 Tick = 0; Tick < NumTicks; ++Tick)
+            {
+                for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+                {
+                    AMazeBlazeAIController& Controller = *Agents.Controllers[Agent];
+
+                    // Odd agents keep switching state, even ones stay exploring
+                    const EAIState State = Agent % 2 == 1 && Tick % 2 == 1 ? EAIState::SeekingKey : EAIState::Exploring;
+                    Controller.SetCurrentState(State);
+
+                    const double StartTime = FPlatformTime::Seconds();
+                    const FString Error = TickAgent(*Service, Controller, Memories.Get(Agent), GetLocation(Agent, Tick), Agent % 4 != 2, 1.0f);
+                    TickSeconds += FPlatformTime::Seconds() - StartTime;
+
+                    TArray<int32>& Reports = Error == StuckMessage ? StuckReports
+                        : Error == PathFollowingMessage ? PathFollowingReports
+                        : StateReports;
+                    if (!Error.IsEmpty() && Reports[Agent] == INDEX_NONE)
+                    {
+                        if (&Reports == &StateReports && Error != FMazeAIStatusText::GetStateTimeoutMessage(State))
+                        {
+                            AddError(FString::Printf(TEXT("Agent %d reported \"%s\" at tick %d"), Agent, *Error, Tick));
+                            DestroyAgents(Agents);
+                            return;
+                        }
+                        Reports[Agent] = Tick;
+                    }
+                }
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("ErrorDetection: %d agents, %d bytes of node memory each, %.3f us per agent tick"),
+                NumAgents, int32(Service->GetInstanceMemorySize()), TickSeconds * 1e6 / (NumTicks * NumAgents));
+
+            // Walking agents run into the path following timeout; stuck agents stop their path following timer
+            const int32 ExpectedStuck[4] = { INDEX_NONE, 5, INDEX_NONE, 8 };
+            const int32 ExpectedPathFollowing[4] = { 10, INDEX_NONE, INDEX_NONE, INDEX_NONE };
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                if (StuckReports[Agent] != ExpectedStuck[Agent % 4])
+                {
+                    AddError(FString::Printf(TEXT("Agent %d reported stuck at tick %d, expected %d"), Agent, StuckReports[Agent], ExpectedStuck[Agent % 4]));
+                    break;
+                }
+                if (PathFollowingReports[Agent] != ExpectedPathFollowing[Agent % 4])
+                {
+                    AddError(FString::Printf(TEXT("Agent %d reported its path following at tick %d, expected %d"), Agent, PathFollowingReports[Agent], ExpectedPathFollowing[Agent % 4]));
+                    break;
+                }
+                if (StateReports[Agent] != (Agent % 2 == 0 ? 16 : INDEX_NONE))
+                {
+                    AddError(FString::Printf(TEXT("Agent %d reported its state at tick %d"), Agent, StateReports[Agent]));
+                    break;
+                }
+            }
+            TestEqual(TEXT("Node memory holds the whole agent state"), int32(Service->GetInstanceMemorySize()), int32(sizeof(FBTErrorDetectionMemory)));
+
+            DestroyAgents(Agents);
+        });
+    });
+}
@@ -0,0 +1,192 @@
+// MazeErrorTelemetryTests.cpp
+// Lock-free record ring, error counts per type, the telemetry file written by the flusher thread and a recording benchmark
+
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformTime.h"
+#include "Async/Async.h"
+
+#include "../MazeErrorTelemetry.h"
+
+namespace
+{
+    FMazeErrorTelemetryRecord MakeRecord(int32 Index, EMazeErrorTelemetryEvent Event = EMazeErrorTelemetryEvent::Reported)
+    {
+        FMazeErrorTelemetryRecord Record;
+        Record.Timestamp = Index * 0.5;
+        Record.Location = FVector3f(Index * 10.0f, -Index * 20.0f, 90.0f);
+        Record.AgentId = 1000 + Index % 37;
+        Record.ErrorType = uint8(1 + Index % (FMazeAIStatusText::NumErrorTypes - 1));
+        Record.Event = Event;
+        return Record;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeErrorTelemetrySpec, "MazeBlaze.ErrorTelemetry", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeErrorTelemetrySpec)
+
+void FMazeErrorTelemetrySpec::Define()
+{
+    Describe("FMazeErrorRecordRing", [this]()
+    {
+        It("should keep records in order across the wrap and refuse them when full", [this]()
+        {
+            FMazeErrorRecordRing Ring(6);
+            TestEqual(TEXT("Capacity rounded up"), Ring.GetCapacity(), 8);
+
+            TArray<FMazeErrorTelemetryRecord> Popped;
+            for (int32 Index = 0; Index < 5; ++Index)
+            {
+                Ring.Push(MakeRecord(Index));
+            }
+            TestEqual(TEXT("Partial pop"), Ring.Pop(Popped, 3), 3);
+
+            int32 NumPushed = 5;
+            while (Ring.Push(MakeRecord(NumPushed)))
+            {
+                ++NumPushed;
+            }
+            TestEqual(TEXT("Full after eight records in the ring"), NumPushed, 11);
+            TestEqual(TEXT("Eight waiting"), Ring.Num(), 8);
+
+            TestEqual(TEXT("Rest popped"), Ring.Pop(Popped), 8);
+            for (int32 Index = 0; Index < Popped.Num(); ++Index)
+            {
+                TestEqual(TEXT("In push order"), Popped[Index].AgentId, MakeRecord(Index).AgentId);
+                TestEqual(TEXT("Timestamp kept"), Popped[Index].Timestamp, Index * 0.5);
+            }
+        });
+
+        It("should hand every record from a producer to a consumer thread", [this]()
+        {
+            FMazeErrorRecordRing Ring(256);
+            const int32 NumRecords = 200000;
+
+            TFuture<int32> Consumer = Async(EAsyncExecution::Thread, [&Ring, NumRecords]()
+            {
+                TArray<FMazeErrorTelemetryRecord> Popped;
+                int32 NumInOrder = 0;
+                int32 NumPopped = 0;
+                while (NumPopped < NumRecords)
+                {
+                    Popped.Reset();
+                    Ring.Pop(Popped);
+                    for (const FMazeErrorTelemetryRecord& Record : Popped)
+                    {
+                        NumInOrder += Record.Timestamp == NumPopped++ ? 1 : 0;
+                    }
+                }
+                return NumInOrder;
+            });
+
+            for (int32 Index = 0; Index < NumRecords; ++Index)
+            {
+                FMazeErrorTelemetryRecord Record;
+                Record.Timestamp = Index;
+                while (!Ring.Push(Record))
+                {
+                    FPlatformProcess::Yield();
+                }
+            }
+
+            TestEqual(TEXT("Every record arrived in order"), Consumer.Get(), NumRecords);
+        });
+    });
+
+    Describe("FMazeErrorTelemetry", [this]()
+    {
+        It("should count events per error type", [this]()
+        {
+            FMazeErrorTelemetry Telemetry(64);
+            for (int32 Index = 0; Index < 60; ++Index)
+            {
+                Telemetry.Record(MakeRecord(Index));
+            }
+            Telemetry.Record(MakeRecord(0, EMazeErrorTelemetryEvent::Recovered));
+            Telemetry.Record(MakeRecord(1, EMazeErrorTelemetryEvent::RecoveryFailed));
+
+            // Six error types besides None, ten records each
+            for (uint8 ErrorType = 1; ErrorType < FMazeAIStatusText::NumErrorTypes; ++ErrorType)
+            {
+                TestEqual(TEXT("Reported per type"), Telemetry.GetCount(EMazeErrorTelemetryEvent::Reported, ErrorType), 10);
+            }
+            TestEqual(TEXT("No None errors"), Telemetry.GetCount(EMazeErrorTelemetryEvent::Reported, 0), 0);
+            TestEqual(TEXT("All reported"), Telemetry.GetTotalCount(EMazeErrorTelemetryEvent::Reported), 60);
+            TestEqual(TEXT("One recovery"), Telemetry.GetCount(EMazeErrorTelemetryEvent::Recovered, MakeRecord(0).ErrorType), 1);
+            TestEqual(TEXT("One failed recovery"), Telemetry.GetTotalCount(EMazeErrorTelemetryEvent::RecoveryFailed), 1);
+            TestEqual(TEXT("Nothing queued without a file"), Telemetry.GetNumDropped(), int64(0));
+        });
+
+        It("should write every record to the file and read it back", [this]()
+        {
+            const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MazeErrorTelemetryTest.mazeerr"));
+            const int32 NumRecords = 5000;
+            {
+                FMazeErrorTelemetry Telemetry(NumRecords);
+                if (!TestTrue(TEXT("Flusher started"), Telemetry.StartFlushing(FilePath, 0.05f)))
+                {
+                    return;
+                }
+                for (int32 Index = 0; Index < NumRecords; ++Index)
+                {
+                    Telemetry.Record(MakeRecord(Index));
+                }
+                Telemetry.StopFlushing();
+                TestEqual(TEXT("All written"), Telemetry.GetNumWritten(), int64(NumRecords));
+            }
+
+            TArray<FMazeErrorTelemetryRecord> Records;
+            TestTrue(TEXT("File loaded"), FMazeErrorTelemetry::LoadFile(FilePath, Records));
+            TestEqual(TEXT("Record count"), Records.Num(), NumRecords);
+            TestEqual(TEXT("26 bytes per record after the header"), IFileManager::Get().FileSize(*FilePath), int64(8 + 26 * NumRecords));
+            if (Records.Num() == NumRecords)
+            {
+                const FMazeErrorTelemetryRecord Expected = MakeRecord(NumRecords - 1);
+                const FMazeErrorTelemetryRecord& Last = Records.Last();
+                TestEqual(TEXT("Timestamp"), Last.Timestamp, Expected.Timestamp);
+                TestTrue(TEXT("Location"), Last.Location == Expected.Location);
+                TestEqual(TEXT("Agent"), Last.AgentId, Expected.AgentId);
+                TestEqual(TEXT("Error type"), Last.ErrorType, Expected.ErrorType);
+            }
+
+            IFileManager::Get().Delete(*FilePath);
+        });
+    });
+
+    Describe("Performance", [this]()
+    {
+        It("should write or drop every error recorded by hundreds of agents and log the cost", [this]()
+        {
+            const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("MazeErrorTelemetryBenchmark.mazeerr"));
+            FMazeErrorTelemetry Telemetry(8192);
+            Telemetry.StartFlushing(FilePath, 0.1f);
+
+            // 500 agents stuck in a recovery loop, each reporting and failing to recover every frame
+            const int32 NumAgents = 500;
+            const int32 NumFrames = 100;
+            double RecordSeconds = 0.0;
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                const double StartTime = FPlatformTime::Seconds();
+                for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+                {
+                    Telemetry.Record(MakeRecord(Agent));
+                    Telemetry.Record(MakeRecord(Agent, EMazeErrorTelemetryEvent::RecoveryFailed));
+                }
+                RecordSeconds += FPlatformTime::Seconds() - StartTime;
+                FPlatformProcess::Sleep(0.001f);
+            }
+            Telemetry.StopFlushing();
+
+            const int64 NumEvents = int64(NumAgents) * NumFrames * 2;
+            const double NanosecondsPerEvent = RecordSeconds * 1e9 / NumEvents;
+            UE_LOG(LogTemp, Display, TEXT("ErrorTelemetry: %lld events, %.1f ns per event, %lld written, %lld dropped"),
+                NumEvents, NanosecondsPerEvent, Telemetry.GetNumWritten(), Telemetry.GetNumDropped());
+
+            TestEqual(TEXT("Every event written or dropped"), Telemetry.GetNumWritten() + Telemetry.GetNumDropped(), NumEvents);
+
+            IFileManager::Get().Delete(*FilePath);
+        });
+    });
+}
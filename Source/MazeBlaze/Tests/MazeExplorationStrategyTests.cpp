@@ -0,0 +1,118 @@
+// MazeExplorationStrategyTests.cpp
+// Exploration strategy factory: one strategy per exploration system, each with stats of its own,
+// and strategies swapped on a possessing controller
+
+#include "Misc/AutomationTest.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+
+#include "../MazeExplorationStrategy.h"
+#include "../MazeBlazeAIController.h"
+
+namespace MazeExplorationStrategyTests
+{
+    // Strategy that records when it is activated and deactivated
+    class FRecordingStrategy : public IMazeExplorationStrategy
+    {
+    public:
+        FRecordingStrategy(EAIExplorationSystem InSystem, TArray<FString>& InEvents) : System(InSystem), Events(InEvents) {}
+
+        virtual EAIExplorationSystem GetSystem() const override { return System; }
+
+    protected:
+        virtual void OnActivated(AMazeBlazeAIController& Controller) override { Events.Add(FString::Printf(TEXT("Activate %d"), static_cast<int32>(System))); }
+        virtual void OnDeactivated(AMazeBlazeAIController& Controller) override { Events.Add(FString::Printf(TEXT("Deactivate %d"), static_cast<int32>(System))); }
+        virtual TStatId GetExploreStatId() const override { return TStatId(); }
+        virtual TStatId GetPathStatId() const override { return TStatId(); }
+
+    private:
+        EAIExplorationSystem System;
+        TArray<FString>& Events;
+    };
+}
+
+BEGIN_DEFINE_SPEC(FMazeExplorationStrategySpec, "MazeBlaze.ExplorationStrategy", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeExplorationStrategySpec)
+
+void FMazeExplorationStrategySpec::Define()
+{
+    Describe("Create", [this]()
+    {
+        It("should make a strategy for every exploration system", [this]()
+        {
+            const UEnum* SystemEnum = StaticEnum<EAIExplorationSystem>();
+
+            // The last entry is the generated _MAX value
+            for (int32 Index = 0; Index < SystemEnum->NumEnums() - 1; ++Index)
+            {
+                const EAIExplorationSystem System = static_cast<EAIExplorationSystem>(SystemEnum->GetValueByIndex(Index));
+                const TUniquePtr<IMazeExplorationStrategy> Strategy = IMazeExplorationStrategy::Create(System);
+                if (!TestTrue(TEXT("Strategy created"), Strategy.IsValid()))
+                {
+                    return;
+                }
+                TestEqual(*FString::Printf(TEXT("%s strategy"), *SystemEnum->GetNameStringByIndex(Index)), static_cast<int32>(Strategy->GetSystem()), static_cast<int32>(System));
+            }
+        });
+
+        It("should make independent strategies for each agent", [this]()
+        {
+            const TUniquePtr<IMazeExplorationStrategy> First = IMazeExplorationStrategy::Create(EAIExplorationSystem::WallFollowing);
+            const TUniquePtr<IMazeExplorationStrategy> Second = IMazeExplorationStrategy::Create(EAIExplorationSystem::WallFollowing);
+            TestTrue(TEXT("Separate instances"), First.Get() != Second.Get());
+        });
+    });
+
+    Describe("Hot swap", [this]()
+    {
+        It("should deactivate the old strategy and activate the new one without repossessing the pawn", [this]()
+        {
+            using namespace MazeExplorationStrategyTests;
+
+            UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+            FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+            WorldContext.SetCurrentWorld(World);
+
+            AMazeBlazeAIController* Controller = World->SpawnActor<AMazeBlazeAIController>();
+            APawn* Pawn = World->SpawnActor<APawn>();
+            if (TestNotNull(TEXT("Controller spawned"), Controller) && TestNotNull(TEXT("Pawn spawned"), Pawn))
+            {
+                TArray<FString> Events;
+                const FString FrontierId = FString::FromInt(static_cast<int32>(EAIExplorationSystem::Frontier));
+                const FString GraphId = FString::FromInt(static_cast<int32>(EAIExplorationSystem::GraphBased));
+
+                // A strategy set before possession is kept and activated by OnPossess
+                Controller->SetExplorationStrategy(MakeUnique<FRecordingStrategy>(EAIExplorationSystem::Frontier, Events));
+                TestEqual(TEXT("No pawn, no activation"), Events.Num(), 0);
+                Controller->Possess(Pawn);
+                TestEqual(TEXT("Activated on possession"), FString::Join(Events, TEXT(", ")), TEXT("Activate ") + FrontierId);
+
+                // The controller has no behavior tree assets, so possession stops short of running a tree (the error goes to the telemetry).
+                // A running agent keeps its pawn and state across the swap; only the strategies change hands
+                Controller->SetCurrentState(EAIState::SeekingKey);
+                const UBrainComponent* Brain = Controller->GetBrainComponent();
+                Events.Reset();
+                Controller->SetExplorationStrategy(MakeUnique<FRecordingStrategy>(EAIExplorationSystem::GraphBased, Events));
+                TestEqual(TEXT("Old strategy deactivated before the new one is activated"), FString::Join(Events, TEXT(", ")),
+                    FString::Printf(TEXT("Deactivate %s, Activate %s"), *FrontierId, *GraphId));
+                TestEqual(TEXT("Dispatches to the new strategy"), static_cast<int32>(Controller->GetExplorationSystem()), static_cast<int32>(EAIExplorationSystem::GraphBased));
+                TestTrue(TEXT("Pawn kept"), Controller->GetPawn() == Pawn);
+                TestTrue(TEXT("Brain kept"), Controller->GetBrainComponent() == Brain);
+                TestTrue(TEXT("State kept"), Controller->GetCurrentState() == EAIState::SeekingKey);
+
+                // Switching the system goes through the same hand-over
+                Events.Reset();
+                Controller->SetExplorationSystem(EAIExplorationSystem::WallFollowing);
+                TestEqual(TEXT("Recording strategy deactivated"), FString::Join(Events, TEXT(", ")), TEXT("Deactivate ") + GraphId);
+                TestEqual(TEXT("Switched system"), static_cast<int32>(Controller->GetExplorationSystem()), static_cast<int32>(EAIExplorationSystem::WallFollowing));
+                TestTrue(TEXT("State kept after the system switch"), Controller->GetCurrentState() == EAIState::SeekingKey);
+
+                Controller->UnPossess();
+            }
+
+            GEngine->DestroyWorldContext(World);
+            World->DestroyWorld(false);
+        });
+    });
+}
@@ -0,0 +1,210 @@
+// MazeFlowFieldTests.cpp
+// Flow field distances against a grid BFS, following the field, incremental door openings and a build benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazeFlowField.h"
+
+BEGIN_DEFINE_SPEC(FMazeFlowFieldSpec, "MazeBlaze.FlowField", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeFlowFieldSpec)
+
+namespace MazeFlowFieldTests
+{
+    // Every reachable cell's distance and direction must match the other field's
+    bool FieldsMatch(const FMazeFlowField& A, const FMazeFlowField& B)
+    {
+        for (int32 Y = 0; Y < A.GetHeight(); ++Y)
+        {
+            for (int32 X = 0; X < A.GetWidth(); ++X)
+            {
+                FIntPoint NextA(INDEX_NONE, INDEX_NONE);
+                FIntPoint NextB(INDEX_NONE, INDEX_NONE);
+                if (A.GetDistance(FIntPoint(X, Y)) != B.GetDistance(FIntPoint(X, Y))
+                    || A.GetNextCell(FIntPoint(X, Y), NextA) != B.GetNextCell(FIntPoint(X, Y), NextB) || NextA != NextB)
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+void FMazeFlowFieldSpec::Define()
+{
+    using namespace MazeTestMaze;
+    using namespace MazeFlowFieldTests;
+
+    Describe("Build", [this]()
+    {
+        It("should match grid BFS distances to the goal", [this]()
+        {
+            for (int32 Seed = 1; Seed <= 4; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(12, Seed, Seed * 0.05f, Maze);
+
+                const FIntPoint Goal = Maze.FreeCells.Last();
+                FMazeFlowField Field;
+                Field.Build(Maze.Size, Maze.Size, Maze.Walkable, MakeArrayView(&Goal, 1));
+
+                for (const FIntPoint& Cell : Maze.FreeCells)
+                {
+                    TestEqual(TEXT("Distance"), Field.GetDistance(Cell), GridDistance(Maze, Cell, Goal));
+                }
+                TestEqual(TEXT("Walls are unreachable"), Field.GetDistance(FIntPoint(0, 0)), FMazeFlowField::Unreachable);
+                TestEqual(TEXT("Off the grid is unreachable"), Field.GetDistance(FIntPoint(-1, 3)), FMazeFlowField::Unreachable);
+            }
+        });
+
+        It("should lead every cell to the goal one closer step at a time", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(12, 5, 0.2f, Maze);
+
+            const FIntPoint Goal = Maze.FreeCells[Maze.FreeCells.Num() / 2];
+            FMazeFlowField Field;
+            Field.Build(Maze.Size, Maze.Size, Maze.Walkable, MakeArrayView(&Goal, 1));
+
+            FIntPoint Next;
+            TestFalse(TEXT("No step from the goal"), Field.GetNextCell(Goal, Next));
+            for (const FIntPoint& Start : Maze.FreeCells)
+            {
+                FIntPoint Cell = Start;
+                int32 Steps = 0;
+                while (Field.GetNextCell(Cell, Next) && Steps <= Maze.FreeCells.Num())
+                {
+                    const FIntPoint Step = Next - Cell;
+                    const bool bDiagonal = Step.X != 0 && Step.Y != 0;
+                    if (!Maze.IsWalkable(Next) || (bDiagonal && (!Maze.IsWalkable(FIntPoint(Next.X, Cell.Y)) || !Maze.IsWalkable(FIntPoint(Cell.X, Next.Y)))))
+                    {
+                        AddError(FString::Printf(TEXT("Step from (%d, %d) to (%d, %d) goes through a wall"), Cell.X, Cell.Y, Next.X, Next.Y));
+                        return;
+                    }
+                    if (Field.GetDistance(Next) >= Field.GetDistance(Cell))
+                    {
+                        AddError(FString::Printf(TEXT("Step from (%d, %d) does not get closer"), Cell.X, Cell.Y));
+                        return;
+                    }
+                    Cell = Next;
+                    ++Steps;
+                }
+                TestEqual(TEXT("Reached the goal"), Cell, Goal);
+                TestTrue(TEXT("No longer than the walk"), Steps <= Field.GetDistance(Start));
+            }
+        });
+
+        It("should give the same field on one thread and on many", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(40, 7, 0.5f, Maze);
+
+            const TArray<FIntPoint> Goals = { Maze.FreeCells[0], Maze.FreeCells.Last() };
+            FMazeFlowField Serial;
+            Serial.MinParallelFrontier = MAX_int32;
+            Serial.Build(Maze.Size, Maze.Size, Maze.Walkable, Goals);
+
+            FMazeFlowField Parallel;
+            Parallel.MinParallelFrontier = 1;
+            Parallel.Build(Maze.Size, Maze.Size, Maze.Walkable, Goals);
+
+            TestEqual(TEXT("No parallel level on one thread"), Serial.GetNumParallelLevels(), 0);
+            TestEqual(TEXT("Every level in parallel"), Parallel.GetNumParallelLevels(), Parallel.GetNumLevels());
+            TestTrue(TEXT("Same field"), FieldsMatch(Serial, Parallel));
+        });
+    });
+
+    Describe("SetCellsWalkable", [this]()
+    {
+        It("should give the same field as a rebuild when doors open", [this]()
+        {
+            for (int32 Seed = 1; Seed <= 4; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(15, Seed, 0.15f, Maze);
+
+                // Close a handful of openings as doors, then open them one at a time
+                FRandomStream Random(Seed);
+                TArray<FIntPoint> Doors;
+                TBitArray<> Closed = Maze.Walkable;
+                for (int32 Door = 0; Door < 8; ++Door)
+                {
+                    const FIntPoint Cell = Maze.Openings[Random.RandHelper(Maze.Openings.Num())];
+                    Doors.AddUnique(Cell);
+                    Closed[Cell.Y * Maze.Size + Cell.X] = false;
+                }
+
+                const FIntPoint Goal(1, 1);
+                FMazeFlowField Field;
+                Field.MinParallelFrontier = 1;
+                Field.Build(Maze.Size, Maze.Size, Closed, MakeArrayView(&Goal, 1));
+
+                TBitArray<> Opened = Closed;
+                for (const FIntPoint& Door : Doors)
+                {
+                    Field.SetCellsWalkable(MakeArrayView(&Door, 1), true);
+                    Opened[Door.Y * Maze.Size + Door.X] = true;
+
+                    FMazeFlowField Rebuilt;
+                    Rebuilt.Build(Maze.Size, Maze.Size, Opened, MakeArrayView(&Goal, 1));
+                    TestTrue(TEXT("Same field after opening a door"), FieldsMatch(Field, Rebuilt));
+                }
+
+                // Closing them all again falls back to a rebuild
+                Field.SetCellsWalkable(Doors, false);
+                FMazeFlowField Rebuilt;
+                Rebuilt.Build(Maze.Size, Maze.Size, Closed, MakeArrayView(&Goal, 1));
+                TestTrue(TEXT("Same field after closing the doors"), FieldsMatch(Field, Rebuilt));
+            }
+        });
+    });
+
+    Describe("Performance", [this]()
+    {
+        It("should time a door update against a build and stay compact", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(150, 11, 0.3f, Maze);
+
+            const FIntPoint Door = Maze.Openings[Maze.Openings.Num() / 2];
+            TBitArray<> Closed = Maze.Walkable;
+            Closed[Door.Y * Maze.Size + Door.X] = false;
+
+            const FIntPoint Goal(1, 1);
+            FMazeFlowField Field;
+            double StartTime = FPlatformTime::Seconds();
+            Field.Build(Maze.Size, Maze.Size, Closed, MakeArrayView(&Goal, 1));
+            const double BuildMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+            const int32 BuildLevels = Field.GetNumLevels();
+            const int32 BuildParallelLevels = Field.GetNumParallelLevels();
+
+            StartTime = FPlatformTime::Seconds();
+            Field.SetCellsWalkable(MakeArrayView(&Door, 1), true);
+            const double UpdateMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            // Following the field is one lookup per agent per step
+            FRandomStream Random(11);
+            int64 Steps = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Agent = 0; Agent < 1000; ++Agent)
+            {
+                FIntPoint Cell = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                FIntPoint Next;
+                while (Field.GetNextCell(Cell, Next))
+                {
+                    Cell = Next;
+                    ++Steps;
+                }
+            }
+            const double StepNanoseconds = (FPlatformTime::Seconds() - StartTime) * 1e9 / FMath::Max<int64>(Steps, 1);
+
+            UE_LOG(LogTemp, Display, TEXT("FlowField: %dx%d grid built in %.2f ms (%d levels, %d parallel), door opened in %.3f ms, %.1f ns per step, %.1f KB"),
+                Maze.Size, Maze.Size, BuildMilliseconds, BuildLevels, BuildParallelLevels, UpdateMilliseconds, StepNanoseconds, Field.GetAllocatedSize() / 1024.0);
+
+            TestTrue(TEXT("Under 8 bytes per cell"), Field.GetAllocatedSize() < SIZE_T(Maze.Size * Maze.Size) * 8);
+        });
+    });
+}
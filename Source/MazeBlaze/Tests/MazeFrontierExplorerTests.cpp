@@ -0,0 +1,368 @@
+// MazeFrontierExplorerTests.cpp
+// Occupancy grid and frontier explorer checks, plus a headless coverage benchmark against random exploration
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+#include "Algo/Reverse.h"
+
+#include "../MazeOccupancyGrid.h"
+#include "../MazeFrontierExplorer.h"
+
+namespace MazeFrontierExplorerTests
+{
+    const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+    // Perfect maze on a (2N+1) x (2N+1) cell grid: rooms on odd coordinates, one-cell corridors
+    struct FSyntheticMaze
+    {
+        int32 Size = 0;
+        TArray<bool> Walls;
+        TArray<FIntPoint> FreeCells;
+
+        bool IsWall(const FIntPoint& Cell) const
+        {
+            return Cell.X < 0 || Cell.Y < 0 || Cell.X >= Size || Cell.Y >= Size || Walls[Cell.Y * Size + Cell.X];
+        }
+    };
+
+    // Carve a maze with a seeded recursive backtracker
+    void BuildMaze(int32 RoomsPerSide, int32 Seed, FSyntheticMaze& OutMaze)
+    {
+        FRandomStream Random(Seed);
+        OutMaze.Size = RoomsPerSide * 2 + 1;
+        OutMaze.Walls.Init(true, OutMaze.Size * OutMaze.Size);
+
+        TArray<bool> Visited;
+        Visited.Init(false, RoomsPerSide * RoomsPerSide);
+        TArray<FIntPoint> Stack;
+        Stack.Add(FIntPoint(0, 0));
+        Visited[0] = true;
+        OutMaze.Walls[1 * OutMaze.Size + 1] = false;
+
+        while (Stack.Num() > 0)
+        {
+            const FIntPoint Room = Stack.Last();
+            TArray<FIntPoint, TInlineAllocator<4>> Unvisited;
+            for (const FIntPoint& Offset : CardinalOffsets)
+            {
+                const FIntPoint Next = Room + Offset;
+                if (Next.X >= 0 && Next.Y >= 0 && Next.X < RoomsPerSide && Next.Y < RoomsPerSide && !Visited[Next.Y * RoomsPerSide + Next.X])
+                {
+                    Unvisited.Add(Next);
+                }
+            }
+
+            if (Unvisited.Num() == 0)
+            {
+                Stack.Pop();
+                continue;
+            }
+
+            const FIntPoint Next = Unvisited[Random.RandRange(0, Unvisited.Num() - 1)];
+            Visited[Next.Y * RoomsPerSide + Next.X] = true;
+            OutMaze.Walls[(Next.Y * 2 + 1) * OutMaze.Size + Next.X * 2 + 1] = false;
+            OutMaze.Walls[(Room.Y + Next.Y + 1) * OutMaze.Size + Room.X + Next.X + 1] = false;
+            Stack.Add(Next);
+        }
+
+        OutMaze.FreeCells.Reset();
+        for (int32 Index = 0; Index < OutMaze.Walls.Num(); ++Index)
+        {
+            if (!OutMaze.Walls[Index])
+            {
+                OutMaze.FreeCells.Add(FIntPoint(Index % OutMaze.Size, Index / OutMaze.Size));
+            }
+        }
+    }
+
+    // Shortest path on the full maze, like a navmesh query (start cell excluded)
+    void FindMazePath(const FSyntheticMaze& Maze, const FIntPoint& From, const FIntPoint& To, TArray<FIntPoint>& OutPath)
+    {
+        TArray<int32> Parents;
+        Parents.Init(INDEX_NONE, Maze.Size * Maze.Size);
+        TArray<FIntPoint> Queue;
+        Queue.Add(From);
+        Parents[From.Y * Maze.Size + From.X] = From.Y * Maze.Size + From.X;
+
+        for (int32 Head = 0; Head < Queue.Num() && Queue[Head] != To; ++Head)
+        {
+            for (const FIntPoint& Offset : CardinalOffsets)
+            {
+                const FIntPoint Next = Queue[Head] + Offset;
+                if (!Maze.IsWall(Next) && Parents[Next.Y * Maze.Size + Next.X] == INDEX_NONE)
+                {
+                    Parents[Next.Y * Maze.Size + Next.X] = Queue[Head].Y * Maze.Size + Queue[Head].X;
+                    Queue.Add(Next);
+                }
+            }
+        }
+
+        OutPath.Reset();
+        for (FIntPoint Cell = To; Cell != From; )
+        {
+            OutPath.Add(Cell);
+            const int32 Parent = Parents[Cell.Y * Maze.Size + Cell.X];
+            Cell = FIntPoint(Parent % Maze.Size, Parent / Maze.Size);
+        }
+        Algo::Reverse(OutPath);
+    }
+
+    // Agent with a ray sensor mapping the maze into its own occupancy grid
+    struct FSimulatedAgent
+    {
+        static constexpr int32 SensorRange = 8;
+        static constexpr int32 NumSensorRays = 32;
+
+        FIntPoint Cell;
+        FMazeOccupancyGrid Grid;
+
+        FSimulatedAgent(const FSyntheticMaze& Maze, const FIntPoint& StartCell)
+            : Cell(StartCell)
+        {
+            // One world unit per cell with the origin at zero, so grid cells are maze cells
+            Grid.Initialize(FVector(Maze.Size * 0.5f, Maze.Size * 0.5f, 0.0f), 1.0f, Maze.Size, Maze.Size);
+            Sense(Maze);
+        }
+
+        void Sense(const FSyntheticMaze& Maze)
+        {
+            for (int32 RayIndex = 0; RayIndex < NumSensorRays; ++RayIndex)
+            {
+                const float Angle = 2.0f * PI * RayIndex / NumSensorRays;
+                const FIntPoint RayEnd = Cell + FIntPoint(FMath::RoundToInt32(FMath::Cos(Angle) * SensorRange), FMath::RoundToInt32(FMath::Sin(Angle) * SensorRange));
+
+                FMazeOccupancyGrid::TraceCells(Cell, RayEnd, [this, &Maze](const FIntPoint& RayCell)
+                {
+                    const bool bWall = Maze.IsWall(RayCell);
+                    Grid.SetState(RayCell, bWall ? EMazeCellState::Blocked : EMazeCellState::Free);
+                    return !bWall;
+                });
+            }
+        }
+
+        float GetCoverage(const FSyntheticMaze& Maze) const
+        {
+            return static_cast<float>(Grid.GetNumFreeCells()) / Maze.FreeCells.Num();
+        }
+    };
+
+    // Steps until the frontier explorer has seen TargetCoverage of the maze
+    int32 RunFrontierExplorer(const FSyntheticMaze& Maze, float TargetCoverage, int32 MaxSteps, double& OutSelectSeconds)
+    {
+        FSimulatedAgent Agent(Maze, FIntPoint(1, 1));
+        FMazeFrontierExplorer Explorer;
+        TArray<FIntPoint> Path;
+        int32 PathIndex = 0;
+        OutSelectSeconds = 0.0;
+
+        for (int32 Step = 0; Step < MaxSteps; ++Step)
+        {
+            if (Agent.GetCoverage(Maze) >= TargetCoverage)
+            {
+                return Step;
+            }
+
+            // Replan once the goal is reached or has been seen from elsewhere
+            if (PathIndex >= Path.Num() || !Agent.Grid.IsFrontier(Path.Last()))
+            {
+                const double StartTime = FPlatformTime::Seconds();
+                FIntPoint Target;
+                const bool bFound = Explorer.SelectTarget(Agent.Grid, Agent.Cell, Target) && Explorer.FindPath(Agent.Grid, Target, Path);
+                OutSelectSeconds += FPlatformTime::Seconds() - StartTime;
+
+                if (!bFound || Path.Num() == 0)
+                {
+                    return MaxSteps;
+                }
+                PathIndex = 0;
+            }
+
+            Agent.Cell = Path[PathIndex++];
+            Agent.Sense(Maze);
+        }
+
+        return MaxSteps;
+    }
+
+    // Steps until random exploration (as in BTTask_SimpleExplore) has seen TargetCoverage of the maze
+    int32 RunRandomExplorer(const FSyntheticMaze& Maze, float TargetCoverage, int32 MaxSteps, int32 Seed)
+    {
+        // MaxExplorationDistance of 1000 with 100 unit cells
+        const int32 ExplorationRadius = 10;
+
+        FSimulatedAgent Agent(Maze, FIntPoint(1, 1));
+        FRandomStream Random(Seed);
+        TArray<FIntPoint> Candidates;
+        TArray<FIntPoint> Path;
+        int32 PathIndex = 0;
+
+        for (int32 Step = 0; Step < MaxSteps; ++Step)
+        {
+            if (Agent.GetCoverage(Maze) >= TargetCoverage)
+            {
+                return Step;
+            }
+
+            if (PathIndex >= Path.Num())
+            {
+                Candidates.Reset();
+                for (const FIntPoint& Cell : Maze.FreeCells)
+                {
+                    if (Cell != Agent.Cell && (Cell - Agent.Cell).SizeSquared() <= ExplorationRadius * ExplorationRadius)
+                    {
+                        Candidates.Add(Cell);
+                    }
+                }
+
+                FindMazePath(Maze, Agent.Cell, Candidates[Random.RandRange(0, Candidates.Num() - 1)], Path);
+                PathIndex = 0;
+            }
+
+            Agent.Cell = Path[PathIndex++];
+            Agent.Sense(Maze);
+        }
+
+        return MaxSteps;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeFrontierExplorerSpec, "MazeBlaze.FrontierExplorer", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeFrontierExplorerSpec)
+
+void FMazeFrontierExplorerSpec::Define()
+{
+    using namespace MazeFrontierExplorerTests;
+
+    Describe("Occupancy grid", [this]()
+    {
+        It("Should keep the incremental frontier equal to a full recompute", [this]()
+        {
+            FMazeOccupancyGrid Grid;
+            Grid.Initialize(FVector(32.0f, 32.0f, 0.0f), 1.0f, 64, 64);
+
+            FRandomStream Random(11);
+            for (int32 Ray = 0; Ray < 300; ++Ray)
+            {
+                const FIntPoint From(Random.RandRange(0, 63), Random.RandRange(0, 63));
+                const FIntPoint To(Random.RandRange(-8, 71), Random.RandRange(-8, 71));
+                Grid.IntegrateRay(From, To, Random.FRand() < 0.5f);
+            }
+
+            int32 ExpectedFrontier = 0;
+            for (int32 Index = 0; Index < Grid.GetNumCells(); ++Index)
+            {
+                const FIntPoint Cell = Grid.ToCell(Index);
+                bool bExpected = false;
+                if (Grid.GetState(Cell) == EMazeCellState::Free)
+                {
+                    for (const FIntPoint& Offset : CardinalOffsets)
+                    {
+                        bExpected |= Grid.IsValidCell(Cell + Offset) && Grid.GetState(Cell + Offset) == EMazeCellState::Unknown;
+                    }
+                }
+
+                ExpectedFrontier += bExpected ? 1 : 0;
+                if (Grid.IsFrontier(Cell) != bExpected)
+                {
+                    AddError(FString::Printf(TEXT("Frontier flag mismatch at (%d, %d)"), Cell.X, Cell.Y));
+                    return;
+                }
+            }
+            TestEqual(TEXT("Frontier count"), Grid.GetNumFrontierCells(), ExpectedFrontier);
+        });
+
+        It("Should trace 4-connected lines between the end points", [this]()
+        {
+            TArray<FIntPoint> Cells;
+            FMazeOccupancyGrid::TraceCells(FIntPoint(0, 0), FIntPoint(5, -3), [&Cells](const FIntPoint& Cell)
+            {
+                Cells.Add(Cell);
+                return true;
+            });
+
+            TestEqual(TEXT("Cell count"), Cells.Num(), 9);
+            TestTrue(TEXT("Ends at target"), Cells.Last() == FIntPoint(5, -3));
+            for (int32 i = 1; i < Cells.Num(); ++i)
+            {
+                TestEqual(TEXT("Single axis steps"), FMath::Abs(Cells[i].X - Cells[i - 1].X) + FMath::Abs(Cells[i].Y - Cells[i - 1].Y), 1);
+            }
+        });
+    });
+
+    Describe("Target selection", [this]()
+    {
+        It("Should prefer the nearer of two equal frontiers and return a walkable path", [this]()
+        {
+            // A corridor along y = 5 known from x = 2 to x = 20, unknown beyond both ends
+            FMazeOccupancyGrid Grid;
+            Grid.Initialize(FVector(16.0f, 8.0f, 0.0f), 1.0f, 32, 16);
+            for (int32 X = 2; X <= 20; ++X)
+            {
+                Grid.SetState(FIntPoint(X, 4), EMazeCellState::Blocked);
+                Grid.SetState(FIntPoint(X, 5), EMazeCellState::Free);
+                Grid.SetState(FIntPoint(X, 6), EMazeCellState::Blocked);
+            }
+
+            FMazeFrontierExplorer Explorer;
+            Explorer.Params.MinClusterSize = 1;
+
+            FIntPoint Target;
+            TestTrue(TEXT("Found frontier"), Explorer.SelectTarget(Grid, FIntPoint(6, 5), Target));
+            TestTrue(TEXT("Nearer corridor end"), Target == FIntPoint(2, 5));
+
+            TArray<FIntPoint> Path;
+            TestTrue(TEXT("Found path"), Explorer.FindPath(Grid, Target, Path));
+            TestEqual(TEXT("Path length"), Path.Num(), 4);
+            TestTrue(TEXT("Path ends at target"), Path.Last() == Target);
+
+            // Once that end is explored only the far end is left
+            Grid.SetState(FIntPoint(1, 5), EMazeCellState::Blocked);
+            TestTrue(TEXT("Found other frontier"), Explorer.SelectTarget(Grid, FIntPoint(6, 5), Target));
+            TestTrue(TEXT("Far corridor end"), Target == FIntPoint(20, 5));
+
+            Grid.SetState(FIntPoint(21, 5), EMazeCellState::Blocked);
+            TestFalse(TEXT("Nothing left to explore"), Explorer.SelectTarget(Grid, FIntPoint(6, 5), Target));
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("Should cover synthetic mazes in fewer steps than random exploration", [this]()
+        {
+            const int32 MazeSizes[] = { 10, 20, 30 };
+            const int32 NumSeeds = 3;
+            const float TargetCoverage = 0.95f;
+            const int32 MaxSteps = 200000;
+
+            for (const int32 RoomsPerSide : MazeSizes)
+            {
+                int64 FrontierSteps = 0;
+                int64 RandomSteps = 0;
+                double SelectSeconds = 0.0;
+                double FrontierSeconds = 0.0;
+
+                for (int32 Seed = 0; Seed < NumSeeds; ++Seed)
+                {
+                    FSyntheticMaze Maze;
+                    BuildMaze(RoomsPerSide, RoomsPerSide * 100 + Seed, Maze);
+
+                    double RunSelectSeconds = 0.0;
+                    const double StartTime = FPlatformTime::Seconds();
+                    const int32 Steps = RunFrontierExplorer(Maze, TargetCoverage, MaxSteps, RunSelectSeconds);
+                    FrontierSeconds += FPlatformTime::Seconds() - StartTime;
+                    SelectSeconds += RunSelectSeconds;
+
+                    TestTrue(TEXT("Frontier explorer reached the target coverage"), Steps < MaxSteps);
+                    FrontierSteps += Steps;
+                    RandomSteps += RunRandomExplorer(Maze, TargetCoverage, MaxSteps, Seed);
+                }
+
+                UE_LOG(LogTemp, Display, TEXT("FrontierExplorer benchmark: %2dx%2d rooms | frontier %7lld steps (%.2f ms, %.2f ms selecting) | random %7lld steps"),
+                       RoomsPerSide, RoomsPerSide, FrontierSteps / NumSeeds, FrontierSeconds * 1000.0 / NumSeeds, SelectSeconds * 1000.0 / NumSeeds, RandomSteps / NumSeeds);
+
+                TestTrue(TEXT("Frontier exploration covers the maze faster than random exploration"), FrontierSteps < RandomSteps);
+            }
+        });
+    });
+}
@@ -0,0 +1,189 @@
+// MazeHierarchicalPathfinderTests.cpp
+// HPA* path checks against a grid BFS, sector invalidation on door open, path cache use and a 256x256 benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazeHierarchicalPathfinder.h"
+
+BEGIN_DEFINE_SPEC(FMazeHierarchicalPathfinderSpec, "MazeBlaze.HierarchicalPathfinder", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeHierarchicalPathfinderSpec)
+
+void FMazeHierarchicalPathfinderSpec::Define()
+{
+    using namespace MazeTestMaze;
+
+    Describe("FindPath", [this]()
+    {
+        It("should find the shortest path in a maze without loops", [this]()
+        {
+            for (int32 Seed = 1; Seed <= 3; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(16, Seed, 0.0f, Maze);
+
+                FMazeHierarchicalPathfinder Pathfinder;
+                Pathfinder.Build(Maze.Size, Maze.Size, Maze.Walkable, 8);
+
+                FRandomStream Random(Seed);
+                TArray<FIntPoint> Path;
+                for (int32 Query = 0; Query < 100; ++Query)
+                {
+                    const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+
+                    const int32 Cost = Pathfinder.FindPath(From, To, &Path);
+                    TestEqual(TEXT("Path length"), Cost, GridDistance(Maze, From, To));
+                    TestEqual(TEXT("Path cells"), Path.Num(), Cost);
+                    TestTrue(TEXT("Path is connected"), IsValidPath(Maze, From, To, Path));
+                }
+            }
+        });
+
+        It("should find valid, near shortest paths when the maze has loops", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(16, 4, 0.2f, Maze);
+
+            FMazeHierarchicalPathfinder Pathfinder;
+            Pathfinder.Build(Maze.Size, Maze.Size, Maze.Walkable, 6);
+
+            FRandomStream Random(4);
+            TArray<FIntPoint> Path;
+            for (int32 Query = 0; Query < 100; ++Query)
+            {
+                const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+
+                const int32 Cost = Pathfinder.FindPath(From, To, &Path);
+                const int32 Shortest = GridDistance(Maze, From, To);
+                TestTrue(TEXT("Never shorter than the shortest path"), Cost >= Shortest);
+                TestTrue(TEXT("Close to the shortest path"), Cost <= Shortest * 3 / 2 + 2);
+                TestEqual(TEXT("Path cells"), Path.Num(), Cost);
+                TestTrue(TEXT("Path is connected"), IsValidPath(Maze, From, To, Path));
+            }
+        });
+
+        It("should reuse cached entrance paths", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(16, 9, 0.0f, Maze);
+
+            FMazeHierarchicalPathfinder Pathfinder;
+            Pathfinder.Build(Maze.Size, Maze.Size, Maze.Walkable, 8);
+
+            const FIntPoint From(1, 1);
+            const FIntPoint To(Maze.Size - 2, Maze.Size - 2);
+            TArray<FIntPoint> FirstPath;
+            TArray<FIntPoint> SecondPath;
+
+            Pathfinder.FindPath(From, To, &FirstPath);
+            const int32 MissesAfterFirst = Pathfinder.GetCacheMisses();
+            TestTrue(TEXT("First query fills the cache"), Pathfinder.GetNumCachedPaths() > 0);
+
+            Pathfinder.FindPath(From, To, &SecondPath);
+            TestEqual(TEXT("No new misses"), Pathfinder.GetCacheMisses(), MissesAfterFirst);
+            TestTrue(TEXT("Cache hits"), Pathfinder.GetCacheHits() > 0);
+            TestTrue(TEXT("Same path"), FirstPath == SecondPath);
+
+            // The reverse route walks cached corridors the other way round
+            TArray<FIntPoint> ReversePath;
+            const int32 HitsBeforeReverse = Pathfinder.GetCacheHits();
+            Pathfinder.FindPath(To, From, &ReversePath);
+            TestTrue(TEXT("Reverse route hits the cache"), Pathfinder.GetCacheHits() > HitsBeforeReverse);
+            TestTrue(TEXT("Reverse path is connected"), IsValidPath(Maze, To, From, ReversePath));
+        });
+    });
+
+    Describe("SetCellsWalkable", [this]()
+    {
+        It("should match a full rebuild as doors open one by one", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(16, 7, 0.05f, Maze);
+
+            FRandomStream Random(7);
+            TArray<FIntPoint> Doors;
+            for (int32 Index = 0; Index < 10; ++Index)
+            {
+                const FIntPoint Door = Maze.Openings[Random.RandHelper(Maze.Openings.Num())];
+                Doors.AddUnique(Door);
+                Maze.Walkable[Door.Y * Maze.Size + Door.X] = false;
+            }
+
+            FMazeHierarchicalPathfinder Pathfinder;
+            Pathfinder.Build(Maze.Size, Maze.Size, Maze.Walkable, 8);
+
+            // Warm the cache so invalidation is exercised
+            for (int32 Query = 0; Query < 20; ++Query)
+            {
+                Pathfinder.FindPath(Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())], Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())]);
+            }
+
+            for (const FIntPoint& Door : Doors)
+            {
+                Pathfinder.SetCellsWalkable(MakeArrayView(&Door, 1), true);
+                Maze.Walkable[Door.Y * Maze.Size + Door.X] = true;
+
+                FMazeHierarchicalPathfinder Rebuilt;
+                Rebuilt.Build(Maze.Size, Maze.Size, Maze.Walkable, 8);
+                TestEqual(TEXT("Entrance count"), Pathfinder.GetNumEntrances(), Rebuilt.GetNumEntrances());
+
+                TArray<FIntPoint> Path;
+                for (int32 Query = 0; Query < 20; ++Query)
+                {
+                    const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    TestEqual(TEXT("Same length as a rebuilt pathfinder"), Pathfinder.FindPath(From, To, &Path), Rebuilt.FindPath(From, To));
+                    TestTrue(TEXT("Path is connected"), IsValidPath(Maze, From, To, Path) || Path.Num() == 0);
+                }
+            }
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("should time long routes on a 256x256 maze against a grid search", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(128, 3, 0.05f, Maze);
+
+            FMazeHierarchicalPathfinder Pathfinder;
+            double StartTime = FPlatformTime::Seconds();
+            Pathfinder.Build(Maze.Size, Maze.Size, Maze.Walkable, 16);
+            const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            const int32 NumQueries = 100;
+            FRandomStream Random(3);
+            TArray<TPair<FIntPoint, FIntPoint>> Queries;
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                const FIntPoint From(1 + 2 * Random.RandHelper(8), 1 + 2 * Random.RandHelper(8));
+                const FIntPoint To(Maze.Size - 2 - 2 * Random.RandHelper(8), Maze.Size - 2 - 2 * Random.RandHelper(8));
+                Queries.Add(TPair<FIntPoint, FIntPoint>(From, To));
+            }
+
+            // Full refinement, so the cached corridors are part of the measurement
+            TArray<FIntPoint> Path;
+            StartTime = FPlatformTime::Seconds();
+            for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+            {
+                Pathfinder.FindPath(Query.Key, Query.Value, &Path);
+            }
+            const double HierarchicalMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            StartTime = FPlatformTime::Seconds();
+            for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+            {
+                GridDistance(Maze, Query.Key, Query.Value);
+            }
+            const double GridMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            UE_LOG(LogTemp, Display, TEXT("HierarchicalPathfinder: %dx%d grid, %d sectors, %d entrances, built in %.2f ms; route %.1f us (grid BFS %.1f us), cache %d hits / %d misses"),
+                Maze.Size, Maze.Size, Pathfinder.GetNumSectors(), Pathfinder.GetNumEntrances(), BuildMs,
+                HierarchicalMicroseconds, GridMicroseconds, Pathfinder.GetCacheHits(), Pathfinder.GetCacheMisses());
+        });
+    });
+}
@@ -0,0 +1,142 @@
+// MazePathCacheTests.cpp
+// Path cache exact, suffix and prefix reuse, LRU eviction, invalidation and a crowd hit-rate benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "../MazePathCache.h"
+
+BEGIN_DEFINE_SPEC(FMazePathCacheSpec, "MazeBlaze.PathCache", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazePathCacheSpec)
+
+void FMazePathCacheSpec::Define()
+{
+    // An L-shaped corridor: east along Y = 50, then north along X = 2050
+    const TArray<FVector> Corridor = { FVector(50.0f, 50.0f, 0.0f), FVector(2050.0f, 50.0f, 0.0f), FVector(2050.0f, 2050.0f, 0.0f) };
+
+    Describe("Find", [this, Corridor]()
+    {
+        It("should answer the same cells with the cached path, ending at the caller's start and goal", [this, Corridor]()
+        {
+            FMazePathCache Cache;
+            Cache.Configure(100.0f, 16, 50.0f);
+            Cache.Add(Corridor[0], Corridor.Last(), Cache.GetVersion(), Corridor);
+
+            TArray<FVector> Points;
+            const FVector Start(60.0f, 40.0f, 0.0f);
+            const FVector Goal(2040.0f, 2060.0f, 0.0f);
+            TestEqual(TEXT("Exact hit"), Cache.Find(Start, Goal, Points), EMazePathCacheHit::Exact);
+            TestEqual(TEXT("Same corners"), Points.Num(), Corridor.Num());
+            TestEqual(TEXT("Starts at the caller"), Points[0], Start);
+            TestEqual(TEXT("Ends at the goal"), Points.Last(), Goal);
+            TestEqual(TEXT("Turns at the same corner"), Points[1], Corridor[1]);
+        });
+
+        It("should reuse the end of a path for a start along it and the beginning for a goal along it", [this, Corridor]()
+        {
+            FMazePathCache Cache;
+            Cache.Configure(100.0f, 16, 50.0f);
+            Cache.Add(Corridor[0], Corridor.Last(), Cache.GetVersion(), Corridor);
+
+            TArray<FVector> Points;
+            const FVector MidCorridor(1000.0f, 60.0f, 0.0f);
+            TestEqual(TEXT("Suffix hit"), Cache.Find(MidCorridor, Corridor.Last(), Points), EMazePathCacheHit::Suffix);
+            TestEqual(TEXT("Start, corner and goal"), Points.Num(), 3);
+            TestEqual(TEXT("Starts mid corridor"), Points[0], MidCorridor);
+            TestEqual(TEXT("Still turns at the corner"), Points[1], Corridor[1]);
+
+            const FVector NorthLeg(2040.0f, 1000.0f, 0.0f);
+            TestEqual(TEXT("Prefix hit"), Cache.Find(Corridor[0], NorthLeg, Points), EMazePathCacheHit::Prefix);
+            TestEqual(TEXT("Start, corner and goal"), Points.Num(), 3);
+            TestEqual(TEXT("Ends on the north leg"), Points.Last(), NorthLeg);
+
+            TestEqual(TEXT("Reused paths are cached under their own key"), Cache.Find(MidCorridor, Corridor.Last(), Points), EMazePathCacheHit::Exact);
+            TestEqual(TEXT("Three paths"), Cache.Num(), 3);
+
+            const FVector OffCorridor(1000.0f, 1000.0f, 0.0f);
+            TestEqual(TEXT("Nothing along the path"), Cache.Find(OffCorridor, Corridor.Last(), Points), EMazePathCacheHit::None);
+            TestEqual(TEXT("Misses counted"), Cache.GetCounters().Misses, int64(1));
+        });
+    });
+
+    Describe("Eviction", [this, Corridor]()
+    {
+        It("should drop the least recently used path when full", [this]()
+        {
+            FMazePathCache Cache;
+            Cache.Configure(100.0f, 2, 0.0f);
+
+            auto AddStraight = [&Cache](float Y)
+            {
+                const TArray<FVector> Points = { FVector(50.0f, Y, 0.0f), FVector(950.0f, Y, 0.0f) };
+                Cache.Add(Points[0], Points[1], Cache.GetVersion(), Points);
+            };
+            AddStraight(50.0f);
+            AddStraight(250.0f);
+
+            TArray<FVector> Points;
+            TestEqual(TEXT("First path used"), Cache.Find(FVector(50.0f, 50.0f, 0.0f), FVector(950.0f, 50.0f, 0.0f), Points), EMazePathCacheHit::Exact);
+
+            AddStraight(450.0f);
+            TestEqual(TEXT("Still two paths"), Cache.Num(), 2);
+            TestEqual(TEXT("One eviction"), Cache.GetCounters().Evictions, int64(1));
+            TestEqual(TEXT("Recently used path kept"), Cache.Find(FVector(50.0f, 50.0f, 0.0f), FVector(950.0f, 50.0f, 0.0f), Points), EMazePathCacheHit::Exact);
+            TestEqual(TEXT("Least recently used path dropped"), Cache.Find(FVector(50.0f, 250.0f, 0.0f), FVector(950.0f, 250.0f, 0.0f), Points), EMazePathCacheHit::None);
+        });
+
+        It("should drop every path and late paths of the old version on invalidation", [this, Corridor]()
+        {
+            FMazePathCache Cache;
+            Cache.Configure(100.0f, 16, 50.0f);
+            const uint32 OldVersion = Cache.GetVersion();
+            Cache.Add(Corridor[0], Corridor.Last(), OldVersion, Corridor);
+
+            // A door opens while another path is still being found
+            Cache.Invalidate();
+            Cache.Add(Corridor[1], Corridor.Last(), OldVersion, TArray<FVector>{ Corridor[1], Corridor[2] });
+
+            TArray<FVector> Points;
+            TestEqual(TEXT("Cache is empty"), Cache.Num(), 0);
+            TestEqual(TEXT("Old path gone"), Cache.Find(Corridor[0], Corridor.Last(), Points), EMazePathCacheHit::None);
+            TestEqual(TEXT("Invalidated paths counted"), Cache.GetCounters().Invalidations, int64(1));
+        });
+    });
+
+    Describe("Performance", [this, Corridor]()
+    {
+        It("should answer most of a crowd heading for one exit from the cache", [this, Corridor]()
+        {
+            FMazePathCache Cache;
+            Cache.Configure(100.0f, 2048, 50.0f);
+
+            // 500 agents scattered along the corridor path to the exit; a miss stands in for a navmesh query that finds the corridor
+            const int32 NumAgents = 500;
+            FRandomStream Random(4);
+            int32 NumQueries = 0;
+            TArray<FVector> Points;
+            const double StartTime = FPlatformTime::Seconds();
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                const int32 Leg = Random.RandHelper(2);
+                const FVector Start = FMath::Lerp(Corridor[Leg], Corridor[Leg + 1], Random.FRand()) + FVector(Random.FRandRange(-20.0f, 20.0f), Random.FRandRange(-20.0f, 20.0f), 0.0f);
+                if (Cache.Find(Start, Corridor.Last(), Points) == EMazePathCacheHit::None)
+                {
+                    TArray<FVector> Found = { Start };
+                    Found.Append(Corridor.GetData() + Leg + 1, Corridor.Num() - Leg - 1);
+                    Cache.Add(Start, Corridor.Last(), Cache.GetVersion(), Found);
+                    ++NumQueries;
+                }
+            }
+            const double LookupMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumAgents;
+
+            const FMazePathCacheCounters& Counters = Cache.GetCounters();
+            const float HitRate = float(Counters.GetHits()) / NumAgents;
+            UE_LOG(LogTemp, Display, TEXT("PathCache: %d agents, %d navmesh queries, hit rate %.2f (%lld exact, %lld suffix, %lld prefix), %d paths in %.1f KB, %.2f us per lookup"),
+                NumAgents, NumQueries, HitRate, Counters.ExactHits, Counters.SuffixHits, Counters.PrefixHits, Cache.Num(), Cache.GetAllocatedSize() / 1024.0, LookupMicroseconds);
+
+            TestTrue(TEXT("Most agents reuse a path"), HitRate > 0.9f);
+            TestTrue(TEXT("Under a kilobyte per path"), Cache.GetAllocatedSize() < SIZE_T(Cache.Num() + 1) * 1024);
+        });
+    });
+}
@@ -0,0 +1,264 @@
+// MazePotentialFieldTests.cpp
+// Potential field descent in mazes, agent repulsion, SIMD/scalar sampling agreement, door updates and a many-agent benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazePotentialField.h"
+
+BEGIN_DEFINE_SPEC(FMazePotentialFieldSpec, "MazeBlaze.PotentialField", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazePotentialFieldSpec)
+
+void FMazePotentialFieldSpec::Define()
+{
+    using namespace MazeTestMaze;
+
+    Describe("FindDescentPath", [this]()
+    {
+        It("should descend along a shortest path from every cell of a maze", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(10, 2, 0.15f, Maze);
+
+            const FIntPoint Goal(Maze.Size - 2, Maze.Size - 2);
+            FMazePotentialField Field;
+            Field.Initialize(Maze.Size, Maze.Size, Maze.Walkable);
+            Field.SetGoals(MakeArrayView(&Goal, 1));
+            Field.Update();
+
+            // Walls bend the field but never trap the descent
+            TArray<FIntPoint> Path;
+            for (const FIntPoint& From : Maze.FreeCells)
+            {
+                TestTrue(TEXT("Reached the goal"), Field.FindDescentPath(From, Maze.Size * Maze.Size, Path));
+                TestEqual(TEXT("Shortest path"), Path.Num(), GridDistance(Maze, From, Goal));
+                TestTrue(TEXT("Path is connected"), IsValidPath(Maze, From, Goal, Path));
+            }
+        });
+
+        It("should follow door openings", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(8, 11, 0.0f, Maze);
+
+            // In a perfect maze every opening is a bridge
+            const FIntPoint Opening = Maze.Openings[0];
+            const FIntPoint SideA = Opening.X % 2 == 0 ? Opening - FIntPoint(1, 0) : Opening - FIntPoint(0, 1);
+            const FIntPoint SideB = Opening.X % 2 == 0 ? Opening + FIntPoint(1, 0) : Opening + FIntPoint(0, 1);
+
+            FMazePotentialField Field;
+            Field.Initialize(Maze.Size, Maze.Size, Maze.Walkable);
+            Field.SetGoals(MakeArrayView(&SideB, 1));
+            Field.SetCellsWalkable(MakeArrayView(&Opening, 1), false);
+            Field.Update();
+
+            TArray<FIntPoint> Path;
+            TestFalse(TEXT("Door closed"), Field.FindDescentPath(SideA, 1000, Path));
+            TestEqual(TEXT("Unreachable side is blocked"), Field.GetPotential(SideA), FMazePotentialField::BlockedPotential);
+
+            Field.SetCellsWalkable(MakeArrayView(&Opening, 1), true);
+            Field.Update();
+            TestTrue(TEXT("Door open"), Field.FindDescentPath(SideA, 1000, Path));
+            TestEqual(TEXT("Through the door"), Path.Num(), 2);
+        });
+    });
+
+    Describe("SetAgents", [this]()
+    {
+        It("should push descent directions away from other agents", [this]()
+        {
+            const int32 Size = 11;
+            TBitArray<> Walkable(true, Size * Size);
+            TArray<FIntPoint> Goals;
+            for (int32 Y = 0; Y < Size; ++Y)
+            {
+                Goals.Add(FIntPoint(0, Y));
+            }
+
+            FMazePotentialField Field;
+            Field.Initialize(Size, Size, Walkable);
+            Field.SetGoals(Goals);
+            Field.Update();
+
+            const float SampleX = 5.0f;
+            const float SampleY = 4.0f;
+            float DirectionX = 0.0f;
+            float DirectionY = 0.0f;
+            auto Sample = [&]()
+            {
+                Field.SampleDirections(MakeArrayView(&SampleX, 1), MakeArrayView(&SampleY, 1), MakeArrayView(&DirectionX, 1), MakeArrayView(&DirectionY, 1));
+            };
+
+            Sample();
+            TestTrue(TEXT("Heads for the goal column"), DirectionX < -0.99f);
+            TestTrue(TEXT("No sideways push"), FMath::IsNearlyZero(DirectionY, 1e-4f));
+            const float FreePotential = Field.GetPotential(FIntPoint(5, 5));
+
+            // An agent just below the sample point
+            const float AgentX = 5.0f;
+            const float AgentY = 5.0f;
+            Field.SetAgents(MakeArrayView(&AgentX, 1), MakeArrayView(&AgentY, 1));
+            Field.Update();
+            Sample();
+            TestTrue(TEXT("Agent raises the potential"), Field.GetPotential(FIntPoint(5, 5)) > FreePotential);
+            TestTrue(TEXT("Pushed away from the agent"), DirectionY < -0.1f);
+
+            // Clearing the agents restores the original field
+            Field.SetAgents(TConstArrayView<float>(), TConstArrayView<float>());
+            Field.Update();
+            Sample();
+            TestEqual(TEXT("Potential restored"), Field.GetPotential(FIntPoint(5, 5)), FreePotential);
+            TestTrue(TEXT("Push removed"), FMath::IsNearlyZero(DirectionY, 1e-4f));
+        });
+
+        It("should only recombine the rows around agents that moved", [this]()
+        {
+            const int32 Size = 64;
+            TBitArray<> Walkable(true, Size * Size);
+            const FIntPoint Goal(0, 0);
+
+            FMazePotentialField Field;
+            Field.Initialize(Size, Size, Walkable);
+            Field.SetGoals(MakeArrayView(&Goal, 1));
+            Field.SetAgent(1, 10.0f, 5.0f);
+            Field.SetAgent(2, 10.0f, 50.0f);
+            Field.Update();
+            TestEqual(TEXT("Goals recombine every row"), Field.GetNumRowsUpdated(), Size);
+
+            // Below the move threshold nothing is splatted again
+            Field.SetAgent(1, 10.1f, 5.0f);
+            Field.SetAgent(2, 10.0f, 50.1f);
+            Field.Update();
+            TestEqual(TEXT("No rows for agents standing still"), Field.GetNumRowsUpdated(), 0);
+
+            // Both agents move one row down: rows 3-8 and 48-53, not everything between them
+            Field.SetAgent(1, 10.0f, 6.0f);
+            Field.SetAgent(2, 10.0f, 51.0f);
+            Field.Update();
+            TestEqual(TEXT("Two short runs of rows"), Field.GetNumRowsUpdated(), 12);
+            TestTrue(TEXT("Bump moved with the agent"), Field.GetPotential(FIntPoint(10, 6)) > Field.GetPotential(FIntPoint(10, 3)) + 1.0f);
+
+            // Removing both leaves the plain distance field
+            Field.RemoveAgent(1);
+            Field.RemoveAgent(2);
+            Field.Update();
+            TestEqual(TEXT("No agents left"), Field.GetNumAgents(), 0);
+            TestEqual(TEXT("Agent term cleared"), Field.GetPotential(FIntPoint(10, 6)), 16.0f);
+        });
+    });
+
+    Describe("SampleDirections", [this]()
+    {
+        It("should give the same directions in SIMD batches and one at a time", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(12, 5, 0.2f, Maze);
+
+            const FIntPoint Goal(1, 1);
+            FMazePotentialField Field;
+            Field.Initialize(Maze.Size, Maze.Size, Maze.Walkable);
+            Field.SetGoals(MakeArrayView(&Goal, 1));
+
+            FRandomStream Random(5);
+            TArray<float> X;
+            TArray<float> Y;
+            for (int32 Agent = 0; Agent < 37; ++Agent)
+            {
+                const FIntPoint Cell = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                X.Add(Cell.X + Random.FRandRange(-0.4f, 0.4f));
+                Y.Add(Cell.Y + Random.FRandRange(-0.4f, 0.4f));
+            }
+            Field.SetAgents(X, Y);
+            Field.Update();
+
+            TArray<float> BatchX;
+            TArray<float> BatchY;
+            BatchX.SetNumZeroed(X.Num());
+            BatchY.SetNumZeroed(X.Num());
+            Field.SampleDirections(X, Y, BatchX, BatchY);
+
+            for (int32 Agent = 0; Agent < X.Num(); ++Agent)
+            {
+                float SingleX = 0.0f;
+                float SingleY = 0.0f;
+                Field.SampleDirections(MakeArrayView(&X[Agent], 1), MakeArrayView(&Y[Agent], 1), MakeArrayView(&SingleX, 1), MakeArrayView(&SingleY, 1));
+                TestTrue(TEXT("Same X"), FMath::IsNearlyEqual(BatchX[Agent], SingleX, 1e-3f));
+                TestTrue(TEXT("Same Y"), FMath::IsNearlyEqual(BatchY[Agent], SingleY, 1e-3f));
+            }
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("should update and sample hundreds of agents within a frame budget", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(64, 3, 0.05f, Maze);
+
+            const FIntPoint Goal(Maze.Size - 2, Maze.Size - 2);
+            FMazePotentialField Field;
+            double StartTime = FPlatformTime::Seconds();
+            Field.Initialize(Maze.Size, Maze.Size, Maze.Walkable);
+            Field.SetGoals(MakeArrayView(&Goal, 1));
+            Field.Update();
+            const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            const int32 NumAgents = 512;
+            const int32 NumFrames = 60;
+            FRandomStream Random(3);
+            TArray<float> X;
+            TArray<float> Y;
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                const FIntPoint Cell = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                X.Add(Cell.X);
+                Y.Add(Cell.Y);
+            }
+
+            TArray<float> DirectionX;
+            TArray<float> DirectionY;
+            DirectionX.SetNumZeroed(NumAgents);
+            DirectionY.SetNumZeroed(NumAgents);
+
+            // Agents step along the field each frame, so the agent term keeps changing
+            double UpdateSeconds = 0.0;
+            double SampleSeconds = 0.0;
+            int32 NumRowsUpdated = 0;
+            for (int32 Frame = 0; Frame < NumFrames; ++Frame)
+            {
+                StartTime = FPlatformTime::Seconds();
+                Field.SetAgents(X, Y);
+                Field.Update();
+                UpdateSeconds += FPlatformTime::Seconds() - StartTime;
+                NumRowsUpdated += Field.GetNumRowsUpdated();
+
+                StartTime = FPlatformTime::Seconds();
+                Field.SampleDirections(X, Y, DirectionX, DirectionY);
+                SampleSeconds += FPlatformTime::Seconds() - StartTime;
+
+                for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+                {
+                    X[Agent] += DirectionX[Agent] * 0.1f;
+                    Y[Agent] += DirectionY[Agent] * 0.1f;
+                }
+            }
+
+            int32 NumMoving = 0;
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                const float LengthSq = FMath::Square(DirectionX[Agent]) + FMath::Square(DirectionY[Agent]);
+                TestTrue(TEXT("Unit or zero direction"), FMath::IsNearlyEqual(LengthSq, 1.0f, 1e-3f) || LengthSq == 0.0f);
+                NumMoving += LengthSq > 0.0f ? 1 : 0;
+            }
+
+            const double UpdateMs = UpdateSeconds * 1000.0 / NumFrames;
+            const double SampleMs = SampleSeconds * 1000.0 / NumFrames;
+            UE_LOG(LogTemp, Display, TEXT("PotentialField: %dx%d grid built in %.2f ms; %d agents, update %.3f ms (%d rows), sampling %.3f ms per frame, %d moving"),
+                Maze.Size, Maze.Size, BuildMs, NumAgents, UpdateMs, NumRowsUpdated / NumFrames, SampleMs, NumMoving);
+
+            TestTrue(TEXT("Most agents have a direction"), NumMoving > NumAgents / 2);
+        });
+    });
+}
@@ -0,0 +1,200 @@
+// MazeReachablePointPoolTests.cpp
+// Reachable point pool lookups, refills, invalidation of stale refills and a lookup benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "../MazeReachablePointPool.h"
+
+BEGIN_DEFINE_SPEC(FMazeReachablePointPoolSpec, "MazeBlaze.ReachablePointPool", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeReachablePointPoolSpec)
+
+void FMazeReachablePointPoolSpec::Define()
+{
+    constexpr float BucketSize = 1000.0f;
+    constexpr int32 PointsPerBucket = 4;
+
+    // Answer every queued refill with a random point around its anchor, as the navmesh would; returns the number of refills
+    auto FillPool = [](FMazeReachablePointPool& Pool, FRandomStream& Random)
+    {
+        int32 NumRefills = 0;
+        FIntPoint Bucket;
+        FVector Anchor;
+        uint32 Generation = 0;
+        while (Pool.StartRefill(Bucket, Anchor, Generation))
+        {
+            const FVector Point = Anchor + FVector(Random.FRandRange(-1.0f, 1.0f), Random.FRandRange(-1.0f, 1.0f), 0.0f) * Pool.GetBucketSize() * 0.7f;
+            Pool.FinishRefill(Bucket, Generation, true, Point);
+            ++NumRefills;
+        }
+        return NumRefills;
+    };
+
+    Describe("TakePoint", [this, FillPool]()
+    {
+        It("should hand out points within the radius and refill the bucket they came from", [this, FillPool]()
+        {
+            FMazeReachablePointPool Pool;
+            Pool.Reset(BucketSize, PointsPerBucket);
+            Pool.AddAnchor(FVector(500.0f, 500.0f, 0.0f));
+            Pool.AddAnchor(FVector(1500.0f, 500.0f, 0.0f));
+
+            FRandomStream Random(1);
+            TestEqual(TEXT("Every anchored bucket is filled"), FillPool(Pool, Random), 2 * PointsPerBucket);
+            TestEqual(TEXT("Points pooled"), Pool.GetNumPoints(), 2 * PointsPerBucket);
+
+            const FVector Location(500.0f, 500.0f, 0.0f);
+            for (int32 Take = 0; Take < 2 * PointsPerBucket; ++Take)
+            {
+                FVector Point;
+                if (!Pool.TakePoint(Location, 3000.0f, 0.0f, Point))
+                {
+                    AddError(TEXT("Ran out of points"));
+                    return;
+                }
+                TestTrue(TEXT("Point within the radius"), FVector::Dist(Location, Point) <= 3000.0f);
+            }
+
+            FVector Point;
+            TestFalse(TEXT("Pool is empty"), Pool.TakePoint(Location, 3000.0f, 0.0f, Point));
+            TestEqual(TEXT("Both buckets refilled"), FillPool(Pool, Random), 2 * PointsPerBucket);
+            TestTrue(TEXT("Points again"), Pool.TakePoint(Location, 3000.0f, 0.0f, Point));
+        });
+
+        It("should skip points outside the radius and prefer points beyond the minimum", [this]()
+        {
+            FMazeReachablePointPool Pool;
+            Pool.Reset(BucketSize, PointsPerBucket);
+            Pool.AddAnchor(FVector(500.0f, 500.0f, 0.0f));
+
+            FIntPoint Bucket;
+            FVector Anchor;
+            uint32 Generation = 0;
+            const FVector Points[] = { FVector(510.0f, 500.0f, 0.0f), FVector(900.0f, 500.0f, 0.0f), FVector(1400.0f, 500.0f, 0.0f) };
+            for (const FVector& Sampled : Points)
+            {
+                Pool.StartRefill(Bucket, Anchor, Generation);
+                Pool.FinishRefill(Bucket, Generation, true, Sampled);
+            }
+
+            const FVector Location(500.0f, 500.0f, 0.0f);
+            FVector Point;
+            TestTrue(TEXT("Found a point"), Pool.TakePoint(Location, 500.0f, 100.0f, Point));
+            TestEqual(TEXT("Far enough and close enough"), Point, Points[1]);
+            TestTrue(TEXT("Found a point"), Pool.TakePoint(Location, 500.0f, 100.0f, Point));
+            TestEqual(TEXT("Too close only when nothing else is left"), Point, Points[0]);
+            TestFalse(TEXT("The last point is out of reach"), Pool.TakePoint(Location, 500.0f, 100.0f, Point));
+        });
+
+        It("should only hand out points the caller can reach and keep the others pooled", [this]()
+        {
+            FMazeReachablePointPool Pool;
+            Pool.Reset(BucketSize, PointsPerBucket);
+            Pool.AddAnchor(FVector(500.0f, 500.0f, 0.0f));
+            Pool.AddAnchor(FVector(1500.0f, 500.0f, 0.0f));
+
+            // Every point stays within its anchor's bucket
+            FRandomStream Random(4);
+            FIntPoint Bucket;
+            FVector Anchor;
+            uint32 Generation = 0;
+            while (Pool.StartRefill(Bucket, Anchor, Generation))
+            {
+                Pool.FinishRefill(Bucket, Generation, true, Anchor + FVector(Random.FRandRange(-400.0f, 400.0f), Random.FRandRange(-400.0f, 400.0f), 0.0f));
+            }
+
+            // A closed door along X = 1000 splits the two buckets
+            auto SameSide = [](const FVector& Caller)
+            {
+                return [Caller](const FVector& Point) { return (Point.X < 1000.0f) == (Caller.X < 1000.0f); };
+            };
+
+            const FVector Location(900.0f, 500.0f, 0.0f);
+            FVector Point;
+            for (int32 Take = 0; Take < PointsPerBucket; ++Take)
+            {
+                TestTrue(TEXT("Found a point"), Pool.TakePoint(Location, 3000.0f, 0.0f, SameSide(Location), Point));
+                TestTrue(TEXT("On the caller's side of the door"), Point.X < 1000.0f);
+            }
+            TestFalse(TEXT("Nothing left on this side"), Pool.TakePoint(Location, 3000.0f, 0.0f, SameSide(Location), Point));
+            TestEqual(TEXT("The other side keeps its points"), Pool.GetNumPoints(), PointsPerBucket);
+
+            const FVector OtherSide(1100.0f, 500.0f, 0.0f);
+            TestTrue(TEXT("Found from the other side"), Pool.TakePoint(OtherSide, 3000.0f, 0.0f, SameSide(OtherSide), Point));
+            TestTrue(TEXT("Beyond the door"), Point.X >= 1000.0f);
+        });
+    });
+
+    Describe("Invalidate", [this, FillPool]()
+    {
+        It("should drop the points around a door and ignore refills started before", [this, FillPool]()
+        {
+            FMazeReachablePointPool Pool;
+            Pool.Reset(BucketSize, PointsPerBucket);
+            for (int32 X = 0; X < 8; ++X)
+            {
+                Pool.AddAnchor(FVector((X + 0.5f) * BucketSize, 500.0f, 0.0f));
+            }
+
+            FRandomStream Random(2);
+            FillPool(Pool, Random);
+            TestEqual(TEXT("Pool is full"), Pool.GetNumPoints(), 8 * PointsPerBucket);
+
+            // A refill is under way when the door opens
+            FVector Point;
+            Pool.TakePoint(FVector(500.0f, 500.0f, 0.0f), 2000.0f, 0.0f, Point);
+            FIntPoint Bucket;
+            FVector Anchor;
+            uint32 Generation = 0;
+            TestTrue(TEXT("Refill started"), Pool.StartRefill(Bucket, Anchor, Generation));
+
+            // A door in the first bucket reaches the anchors up to a bucket away
+            Pool.Invalidate(FBox2D(FVector2D(400.0f, 400.0f), FVector2D(600.0f, 600.0f)));
+            TestEqual(TEXT("Buckets around the door are empty"), Pool.GetNumPoints(), 6 * PointsPerBucket);
+
+            Pool.FinishRefill(Bucket, Generation, true, Anchor);
+            TestEqual(TEXT("Stale refill dropped"), Pool.GetNumPoints(), 6 * PointsPerBucket);
+
+            TestEqual(TEXT("Only the dropped buckets are refilled"), FillPool(Pool, Random), 2 * PointsPerBucket);
+            TestEqual(TEXT("Pool is full again"), Pool.GetNumPoints(), 8 * PointsPerBucket);
+        });
+    });
+
+    Describe("Performance", [this, FillPool]()
+    {
+        It("should find a point for nearly every take and log the time per take", [this, FillPool]()
+        {
+            // 100 x 100 buckets of 1000 units, like a large maze
+            constexpr int32 NumBucketsPerSide = 100;
+            FMazeReachablePointPool Pool;
+            Pool.Reset(BucketSize, PointsPerBucket);
+            for (int32 Y = 0; Y < NumBucketsPerSide; ++Y)
+            {
+                for (int32 X = 0; X < NumBucketsPerSide; ++X)
+                {
+                    Pool.AddAnchor(FVector((X + 0.5f) * BucketSize, (Y + 0.5f) * BucketSize, 0.0f));
+                }
+            }
+
+            FRandomStream Random(3);
+            FillPool(Pool, Random);
+
+            const int32 NumTakes = 10000;
+            int32 NumFound = 0;
+            const double StartTime = FPlatformTime::Seconds();
+            for (int32 Take = 0; Take < NumTakes; ++Take)
+            {
+                const FVector Location(Random.FRandRange(0.0f, NumBucketsPerSide * BucketSize), Random.FRandRange(0.0f, NumBucketsPerSide * BucketSize), 0.0f);
+                FVector Point;
+                NumFound += Pool.TakePoint(Location, 2000.0f, 250.0f, Point) ? 1 : 0;
+            }
+            const double TakeMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumTakes;
+
+            UE_LOG(LogTemp, Display, TEXT("ReachablePointPool: %d buckets, %.3f us per take, %d of %d found"),
+                Pool.GetNumBuckets(), TakeMicroseconds, NumFound, NumTakes);
+
+            TestTrue(TEXT("Nearly every take finds a point"), NumFound > NumTakes * 9 / 10);
+        });
+    });
+}
@@ -0,0 +1,86 @@
+// MazeSignatureIndexTests.cpp
+// Checks the per-bit door index against the Signature & Mask rule used by AMazeGameDoor
+
+#include "Misc/AutomationTest.h"
+#include "Math/RandomStream.h"
+
+#include "../MazeSignatureIndex.h"
+
+BEGIN_DEFINE_SPEC(FMazeSignatureIndexSpec, "MazeBlaze.SignatureIndex", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeSignatureIndexSpec)
+
+void FMazeSignatureIndexSpec::Define()
+{
+    Describe("Matching doors", [this]()
+    {
+        It("Should find the same nearest closed door as a full scan", [this]()
+        {
+            struct FDoor
+            {
+                FVector Location;
+                int32 Mask;
+                bool bClosed;
+            };
+
+            FRandomStream Random(2024);
+            TArray<FDoor> Doors;
+            TMazeSignatureIndex<int32> Index;
+
+            // Colour-coded doors: mostly single-bit masks, some that accept two colours
+            for (int32 i = 0; i < 500; ++i)
+            {
+                int32 Mask = 1 << Random.RandRange(0, 31);
+                if (Random.FRand() < 0.2f)
+                {
+                    Mask |= 1 << Random.RandRange(0, 31);
+                }
+                const FVector Location(Random.FRandRange(0.0f, 20000.0f), Random.FRandRange(0.0f, 20000.0f), 0.0f);
+                const bool bClosed = Random.FRand() < 0.7f;
+
+                Doors.Add({ Location, Mask, bClosed });
+                Index.Add(i + 1, Location, Mask, bClosed);
+            }
+
+            for (int32 Query = 0; Query < 200; ++Query)
+            {
+                const int32 Signature = Random.RandRange(0, MAX_int32) | (Random.FRand() < 0.5f ? 0 : MIN_int32);
+                const FVector Location(Random.FRandRange(0.0f, 20000.0f), Random.FRandRange(0.0f, 20000.0f), 0.0f);
+
+                float ExpectedDistance = MAX_FLT;
+                int32 ExpectedCount = 0;
+                for (const FDoor& Door : Doors)
+                {
+                    if (Door.bClosed && (Signature & Door.Mask))
+                    {
+                        ++ExpectedCount;
+                        ExpectedDistance = FMath::Min(ExpectedDistance, FVector::Dist(Location, Door.Location));
+                    }
+                }
+
+                const int32 Found = Index.FindNearestActiveMatching(Location, Signature);
+                const float FoundDistance = Found > 0 ? FVector::Dist(Location, Doors[Found - 1].Location) : MAX_FLT;
+
+                TestEqual(TEXT("Nearest matching door distance"), FoundDistance, ExpectedDistance, 0.01f);
+                TestEqual(TEXT("Matching closed door count"), Index.CountActiveMatching(Signature), ExpectedCount);
+            }
+        });
+
+        It("Should skip doors once they are opened", [this]()
+        {
+            TMazeSignatureIndex<int32> Index;
+            Index.Add(1, FVector(100.0f, 0.0f, 0.0f), 0x1);
+            Index.Add(2, FVector(500.0f, 0.0f, 0.0f), 0x3);
+            Index.Add(3, FVector(50.0f, 0.0f, 0.0f), 0x4);
+
+            TestEqual(TEXT("Nearest red door"), Index.FindNearestActiveMatching(FVector::ZeroVector, 0x1), 1);
+
+            Index.SetActive(1, false);
+            TestEqual(TEXT("Opened door skipped"), Index.FindNearestActiveMatching(FVector::ZeroVector, 0x1), 2);
+            TestEqual(TEXT("Two-colour door counted once"), Index.CountActiveMatching(0x3), 1);
+
+            Index.Remove(2);
+            TestEqual(TEXT("No red door left"), Index.FindNearestActiveMatching(FVector::ZeroVector, 0x1), 0);
+            TestEqual(TEXT("Active doors"), Index.NumActive(), 1);
+        });
+    });
+}
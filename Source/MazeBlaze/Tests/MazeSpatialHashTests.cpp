@@ -0,0 +1,199 @@
+// MazeSpatialHashTests.cpp
+// Correctness checks and query benchmark for the maze spatial hash
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "../MazeSpatialHash.h"
+
+namespace MazeSpatialHashTests
+{
+    // Maze-like extents: 100 x 100 corridors of 400 units
+    constexpr float WorldExtent = 40000.0f;
+    constexpr float CorridorWidth = 400.0f;
+
+    struct FItem
+    {
+        FVector Location;
+        int32 Mask;
+    };
+
+    void BuildItems(int32 Count, int32 Seed, TArray<FItem>& OutItems, TMazeSpatialHash<int32>& OutHash)
+    {
+        FRandomStream Random(Seed);
+        OutItems.Reset(Count);
+        OutHash.Reset();
+
+        for (int32 i = 0; i < Count; ++i)
+        {
+            const FVector Location(Random.FRandRange(0.0f, WorldExtent), Random.FRandRange(0.0f, WorldExtent), 0.0f);
+            const int32 Mask = 1 << Random.RandRange(0, 31);
+            OutItems.Add({ Location, Mask });
+
+            // Element 0 is the "not found" value, so elements are 1-based
+            OutHash.Add(i + 1, Location, Mask);
+        }
+    }
+
+    int32 BruteForceNearest(const TArray<FItem>& Items, const FVector& Location, int32 MatchMask, bool bFilterByMask)
+    {
+        int32 Best = 0;
+        float BestDistanceSq = MAX_FLT;
+        for (int32 i = 0; i < Items.Num(); ++i)
+        {
+            if (bFilterByMask && (Items[i].Mask & MatchMask) == 0)
+            {
+                continue;
+            }
+
+            // Linear scan with a sqrt per candidate, like the original FindNearestKey
+            const float DistanceSq = FMath::Square(FVector::Dist(Location, Items[i].Location));
+            if (DistanceSq < BestDistanceSq)
+            {
+                BestDistanceSq = DistanceSq;
+                Best = i + 1;
+            }
+        }
+        return Best;
+    }
+
+    float DistanceTo(const TArray<FItem>& Items, const FVector& Location, int32 Element)
+    {
+        return Element > 0 ? FVector::Dist(Location, Items[Element - 1].Location) : MAX_FLT;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMazeSpatialHashSpec, "MazeBlaze.SpatialHash", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeSpatialHashSpec)
+
+void FMazeSpatialHashSpec::Define()
+{
+    using namespace MazeSpatialHashTests;
+
+    Describe("Queries", [this]()
+    {
+        It("Should match a brute-force scan for nearest, masked nearest and radius queries", [this]()
+        {
+            TArray<FItem> Items;
+            TMazeSpatialHash<int32> Hash(CorridorWidth);
+            BuildItems(2000, 1234, Items, Hash);
+
+            FRandomStream Random(42);
+            TArray<int32> RadiusResults;
+            for (int32 Query = 0; Query < 200; ++Query)
+            {
+                const FVector Location(Random.FRandRange(-1000.0f, WorldExtent + 1000.0f), Random.FRandRange(-1000.0f, WorldExtent + 1000.0f), 0.0f);
+                const int32 MatchMask = 1 << Random.RandRange(0, 31);
+
+                const int32 Expected = BruteForceNearest(Items, Location, 0, false);
+                const int32 Actual = Hash.FindNearest(Location);
+                TestEqual(TEXT("Nearest distance"), DistanceTo(Items, Location, Actual), DistanceTo(Items, Location, Expected), 0.01f);
+
+                const int32 ExpectedMasked = BruteForceNearest(Items, Location, MatchMask, true);
+                const int32 ActualMasked = Hash.FindNearestMatching(Location, MatchMask);
+                TestEqual(TEXT("Masked nearest distance"), DistanceTo(Items, Location, ActualMasked), DistanceTo(Items, Location, ExpectedMasked), 0.01f);
+
+                const float Radius = 1500.0f;
+                int32 ExpectedInRadius = 0;
+                for (const FItem& Item : Items)
+                {
+                    ExpectedInRadius += FVector::DistSquared(Location, Item.Location) <= Radius * Radius ? 1 : 0;
+                }
+                Hash.FindInRadius(Location, Radius, RadiusResults);
+                TestEqual(TEXT("Radius query count"), RadiusResults.Num(), ExpectedInRadius);
+            }
+        });
+
+        It("Should return k-nearest results sorted by distance", [this]()
+        {
+            TArray<FItem> Items;
+            TMazeSpatialHash<int32> Hash(CorridorWidth);
+            BuildItems(500, 99, Items, Hash);
+
+            const FVector Location(WorldExtent * 0.5f, WorldExtent * 0.5f, 0.0f);
+            TArray<int32> Nearest;
+            Hash.FindKNearest(Location, 8, Nearest);
+            TestEqual(TEXT("K results"), Nearest.Num(), 8);
+
+            for (int32 i = 1; i < Nearest.Num(); ++i)
+            {
+                TestTrue(TEXT("Sorted by distance"), DistanceTo(Items, Location, Nearest[i - 1]) <= DistanceTo(Items, Location, Nearest[i]));
+            }
+            TestEqual(TEXT("First is nearest"), DistanceTo(Items, Location, Nearest[0]), DistanceTo(Items, Location, BruteForceNearest(Items, Location, 0, false)), 0.01f);
+        });
+
+        It("Should keep indices consistent after removals", [this]()
+        {
+            TArray<FItem> Items;
+            TMazeSpatialHash<int32> Hash(CorridorWidth);
+            BuildItems(300, 7, Items, Hash);
+
+            // Remove every other element and mirror it with an impossible mask in the brute-force list
+            for (int32 Element = 1; Element <= Items.Num(); Element += 2)
+            {
+                TestTrue(TEXT("Removed"), Hash.Remove(Element));
+                Items[Element - 1].Mask = 0;
+            }
+            TestEqual(TEXT("Remaining count"), Hash.Num(), Items.Num() / 2);
+
+            FRandomStream Random(3);
+            for (int32 Query = 0; Query < 50; ++Query)
+            {
+                const FVector Location(Random.FRandRange(0.0f, WorldExtent), Random.FRandRange(0.0f, WorldExtent), 0.0f);
+                const int32 Expected = BruteForceNearest(Items, Location, ~0, true);
+                const int32 Actual = Hash.FindNearest(Location);
+                TestEqual(TEXT("Nearest after removal"), DistanceTo(Items, Location, Actual), DistanceTo(Items, Location, Expected), 0.01f);
+            }
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("Should report nearest query time against item count", [this]()
+        {
+            const int32 ItemCounts[] = { 100, 1000, 10000, 50000 };
+            const int32 NumQueries = 2000;
+
+            for (const int32 Count : ItemCounts)
+            {
+                TArray<FItem> Items;
+                TMazeSpatialHash<int32> Hash(CorridorWidth);
+                BuildItems(Count, Count, Items, Hash);
+
+                TArray<FVector> Queries;
+                FRandomStream Random(Count + 1);
+                for (int32 i = 0; i < NumQueries; ++i)
+                {
+                    Queries.Add(FVector(Random.FRandRange(0.0f, WorldExtent), Random.FRandRange(0.0f, WorldExtent), 0.0f));
+                }
+
+                int32 Checksum = 0;
+                double StartTime = FPlatformTime::Seconds();
+                for (const FVector& Location : Queries)
+                {
+                    Checksum += BruteForceNearest(Items, Location, 0, false);
+                }
+                const double LinearUs = (FPlatformTime::Seconds() - StartTime) * 1.0e6 / NumQueries;
+
+                StartTime = FPlatformTime::Seconds();
+                for (const FVector& Location : Queries)
+                {
+                    Checksum -= Hash.FindNearest(Location);
+                }
+                const double HashUs = (FPlatformTime::Seconds() - StartTime) * 1.0e6 / NumQueries;
+
+                StartTime = FPlatformTime::Seconds();
+                for (int32 i = 0; i < NumQueries; ++i)
+                {
+                    Checksum += Hash.FindNearestMatching(Queries[i], 1 << (i % 32));
+                }
+                const double MaskedHashUs = (FPlatformTime::Seconds() - StartTime) * 1.0e6 / NumQueries;
+
+                // The checksum only keeps the query loops from being optimised away
+                UE_LOG(LogTemp, Display, TEXT("SpatialHash benchmark: %6d items | linear %8.2f us | hash %6.2f us | hash masked %6.2f us | checksum %d"),
+                       Count, LinearUs, HashUs, MaskedHashUs, Checksum);
+            }
+        });
+    });
+}
@@ -0,0 +1,148 @@
+// MazeTestMaze.h
+// Grid mazes with loops and a reference BFS, shared by the pathfinding specs
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/BitArray.h"
+#include "Math/RandomStream.h"
+
+namespace MazeTestMaze
+{
+    const FIntPoint CardinalOffsets[] = { FIntPoint(1, 0), FIntPoint(-1, 0), FIntPoint(0, 1), FIntPoint(0, -1) };
+
+    // Maze on a (2N+1) x (2N+1) cell grid with some extra openings so there are loops
+    struct FLoopMaze
+    {
+        int32 Size = 0;
+        TBitArray<> Walkable;
+        TArray<FIntPoint> FreeCells;
+
+        // Openings between two rooms, usable as doors
+        TArray<FIntPoint> Openings;
+
+        bool IsWalkable(const FIntPoint& Cell) const
+        {
+            return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Size && Cell.Y < Size && Walkable[Cell.Y * Size + Cell.X];
+        }
+    };
+
+    inline void BuildMaze(int32 RoomsPerSide, int32 Seed, float LoopChance, FLoopMaze& OutMaze)
+    {
+        FRandomStream Random(Seed);
+        OutMaze.Size = RoomsPerSide * 2 + 1;
+        OutMaze.Walkable.Init(false, OutMaze.Size * OutMaze.Size);
+
+        TArray<bool> Visited;
+        Visited.Init(false, RoomsPerSide * RoomsPerSide);
+        TArray<FIntPoint> Stack;
+        Stack.Add(FIntPoint(0, 0));
+        Visited[0] = true;
+        OutMaze.Walkable[1 * OutMaze.Size + 1] = true;
+
+        while (Stack.Num() > 0)
+        {
+            const FIntPoint Room = Stack.Last();
+            TArray<FIntPoint, TInlineAllocator<4>> Unvisited;
+            for (const FIntPoint& Offset : CardinalOffsets)
+            {
+                const FIntPoint Next = Room + Offset;
+                if (Next.X >= 0 && Next.Y >= 0 && Next.X < RoomsPerSide && Next.Y < RoomsPerSide && !Visited[Next.Y * RoomsPerSide + Next.X])
+                {
+                    Unvisited.Add(Next);
+                }
+            }
+
+            if (Unvisited.Num() == 0)
+            {
+                Stack.Pop();
+                continue;
+            }
+
+            const FIntPoint Next = Unvisited[Random.RandHelper(Unvisited.Num())];
+            Visited[Next.Y * RoomsPerSide + Next.X] = true;
+            Stack.Add(Next);
+            OutMaze.Walkable[(Next.Y * 2 + 1) * OutMaze.Size + Next.X * 2 + 1] = true;
+            OutMaze.Walkable[(Room.Y + Next.Y + 1) * OutMaze.Size + Room.X + Next.X + 1] = true;
+        }
+
+        // Cells between two rooms are either wall or opening
+        for (int32 Y = 1; Y < OutMaze.Size - 1; ++Y)
+        {
+            for (int32 X = 1; X < OutMaze.Size - 1; ++X)
+            {
+                if ((X + Y) % 2 == 0)
+                {
+                    continue;
+                }
+
+                const int32 Index = Y * OutMaze.Size + X;
+                if (!OutMaze.Walkable[Index] && Random.FRand() < LoopChance)
+                {
+                    OutMaze.Walkable[Index] = true;
+                }
+                if (OutMaze.Walkable[Index])
+                {
+                    OutMaze.Openings.Add(FIntPoint(X, Y));
+                }
+            }
+        }
+
+        for (TConstSetBitIterator<> It(OutMaze.Walkable); It; ++It)
+        {
+            OutMaze.FreeCells.Add(FIntPoint(It.GetIndex() % OutMaze.Size, It.GetIndex() / OutMaze.Size));
+        }
+    }
+
+    // Reference shortest path length over the walkable cells, or INDEX_NONE
+    inline int32 GridDistance(const FLoopMaze& Maze, const FIntPoint& From, const FIntPoint& To)
+    {
+        if (!Maze.IsWalkable(From) || !Maze.IsWalkable(To))
+        {
+            return INDEX_NONE;
+        }
+
+        TArray<int32> Distances;
+        Distances.Init(INDEX_NONE, Maze.Size * Maze.Size);
+        TArray<FIntPoint> Queue;
+        Queue.Add(From);
+        Distances[From.Y * Maze.Size + From.X] = 0;
+
+        for (int32 Head = 0; Head < Queue.Num(); ++Head)
+        {
+            const FIntPoint Cell = Queue[Head];
+            if (Cell == To)
+            {
+                return Distances[Cell.Y * Maze.Size + Cell.X];
+            }
+
+            for (const FIntPoint& Offset : CardinalOffsets)
+            {
+                const FIntPoint Next = Cell + Offset;
+                if (Maze.IsWalkable(Next) && Distances[Next.Y * Maze.Size + Next.X] == INDEX_NONE)
+                {
+                    Distances[Next.Y * Maze.Size + Next.X] = Distances[Cell.Y * Maze.Size + Cell.X] + 1;
+                    Queue.Add(Next);
+                }
+            }
+        }
+
+        return INDEX_NONE;
+    }
+
+    // The path must be a chain of walkable neighbours ending on the target
+    inline bool IsValidPath(const FLoopMaze& Maze, const FIntPoint& From, const FIntPoint& To, const TArray<FIntPoint>& Path)
+    {
+        FIntPoint Previous = From;
+        for (const FIntPoint& Cell : Path)
+        {
+            const FIntPoint Step = Cell - Previous;
+            if (FMath::Abs(Step.X) + FMath::Abs(Step.Y) != 1 || !Maze.IsWalkable(Cell))
+            {
+                return false;
+            }
+            Previous = Cell;
+        }
+        return Path.Num() == 0 ? From == To : Path.Last() == To;
+    }
+}
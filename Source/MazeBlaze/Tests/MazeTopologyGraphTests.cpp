@@ -0,0 +1,169 @@
+// MazeTopologyGraphTests.cpp
+// Topology graph path checks against a grid BFS, incremental door updates and a query benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazeTopologyGraph.h"
+
+BEGIN_DEFINE_SPEC(FMazeTopologyGraphSpec, "MazeBlaze.TopologyGraph", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeTopologyGraphSpec)
+
+void FMazeTopologyGraphSpec::Define()
+{
+    using namespace MazeTestMaze;
+
+    Describe("FindPath", [this]()
+    {
+        It("should match grid BFS distances and return valid paths", [this]()
+        {
+            for (int32 Seed = 1; Seed <= 4; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(12, Seed, Seed * 0.05f, Maze);
+
+                FMazeTopologyGraph Graph;
+                Graph.Build(Maze.Size, Maze.Size, Maze.Walkable);
+                TestTrue(TEXT("Graph is much smaller than the grid"), Graph.GetNumNodes() < Maze.FreeCells.Num());
+
+                FRandomStream Random(Seed);
+                TArray<FIntPoint> Path;
+                for (int32 Query = 0; Query < 100; ++Query)
+                {
+                    const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+
+                    const int32 Cost = Graph.FindPath(From, To, &Path);
+                    TestEqual(TEXT("Path length"), Cost, GridDistance(Maze, From, To));
+                    TestEqual(TEXT("Path cells"), Path.Num(), Cost);
+                    TestTrue(TEXT("Path is connected"), IsValidPath(Maze, From, To, Path));
+                }
+            }
+        });
+
+        It("should not find a path to a blocked cell", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(5, 3, 0.0f, Maze);
+
+            FMazeTopologyGraph Graph;
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable);
+
+            TestEqual(TEXT("Wall corner"), Graph.FindPath(FIntPoint(1, 1), FIntPoint(0, 0)), INDEX_NONE);
+            TestEqual(TEXT("Outside the grid"), Graph.FindPath(FIntPoint(1, 1), FIntPoint(-1, 4)), INDEX_NONE);
+        });
+    });
+
+    Describe("SetCellsWalkable", [this]()
+    {
+        It("should match a full rebuild as doors open one by one", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(12, 7, 0.1f, Maze);
+
+            // Close a handful of openings as doors
+            FRandomStream Random(7);
+            TArray<FIntPoint> Doors;
+            for (int32 Index = 0; Index < 10; ++Index)
+            {
+                const FIntPoint Door = Maze.Openings[Random.RandHelper(Maze.Openings.Num())];
+                Doors.AddUnique(Door);
+                Maze.Walkable[Door.Y * Maze.Size + Door.X] = false;
+            }
+
+            FMazeTopologyGraph Graph;
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable);
+
+            for (const FIntPoint& Door : Doors)
+            {
+                Graph.SetCellsWalkable(MakeArrayView(&Door, 1), true);
+                Maze.Walkable[Door.Y * Maze.Size + Door.X] = true;
+
+                FMazeTopologyGraph Rebuilt;
+                Rebuilt.Build(Maze.Size, Maze.Size, Maze.Walkable);
+                TestEqual(TEXT("Node count"), Graph.GetNumNodes(), Rebuilt.GetNumNodes());
+                TestEqual(TEXT("Edge count"), Graph.GetNumEdges(), Rebuilt.GetNumEdges());
+
+                for (int32 Query = 0; Query < 20; ++Query)
+                {
+                    const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                    TestEqual(TEXT("Path length after opening"), Graph.FindPath(From, To), GridDistance(Maze, From, To));
+                }
+            }
+        });
+
+        It("should cut paths when cells become blocked", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(8, 11, 0.0f, Maze);
+
+            FMazeTopologyGraph Graph;
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable);
+
+            // In a perfect maze every opening is a bridge, closing it disconnects the two sides
+            const FIntPoint Opening = Maze.Openings[0];
+            const FIntPoint SideA = Opening.X % 2 == 0 ? Opening - FIntPoint(1, 0) : Opening - FIntPoint(0, 1);
+            const FIntPoint SideB = Opening.X % 2 == 0 ? Opening + FIntPoint(1, 0) : Opening + FIntPoint(0, 1);
+            TestEqual(TEXT("Open"), Graph.FindPath(SideA, SideB), 2);
+            TestEqual(TEXT("One region while open"), Graph.GetRegion(SideA), Graph.GetRegion(SideB));
+
+            Graph.SetCellsWalkable(MakeArrayView(&Opening, 1), false);
+            TestEqual(TEXT("Closed"), Graph.FindPath(SideA, SideB), INDEX_NONE);
+            TestNotEqual(TEXT("Split into two regions"), Graph.GetRegion(SideA), Graph.GetRegion(SideB));
+            TestEqual(TEXT("Door cell has no region"), Graph.GetRegion(Opening), INDEX_NONE);
+
+            Graph.SetCellsWalkable(MakeArrayView(&Opening, 1), true);
+            TestEqual(TEXT("Reopened"), Graph.FindPath(SideA, SideB), 2);
+            TestEqual(TEXT("Regions merged again"), Graph.GetRegion(SideA), Graph.GetRegion(SideB));
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("should give the same route lengths as a grid search and time both", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(60, 5, 0.05f, Maze);
+
+            FMazeTopologyGraph Graph;
+            double StartTime = FPlatformTime::Seconds();
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable);
+            const double BuildMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            // Corner to corner routes, the worst case for both searches
+            const int32 NumQueries = 200;
+            FRandomStream Random(5);
+            TArray<TPair<FIntPoint, FIntPoint>> Queries;
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                const FIntPoint From(1 + 2 * Random.RandHelper(5), 1 + 2 * Random.RandHelper(5));
+                const FIntPoint To(Maze.Size - 2 - 2 * Random.RandHelper(5), Maze.Size - 2 - 2 * Random.RandHelper(5));
+                Queries.Add(TPair<FIntPoint, FIntPoint>(From, To));
+            }
+
+            int64 GraphChecksum = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+            {
+                GraphChecksum += Graph.FindPath(Query.Key, Query.Value);
+            }
+            const double GraphMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            int64 GridChecksum = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (const TPair<FIntPoint, FIntPoint>& Query : Queries)
+            {
+                GridChecksum += GridDistance(Maze, Query.Key, Query.Value);
+            }
+            const double GridMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            UE_LOG(LogTemp, Display, TEXT("TopologyGraph: %d cells -> %d nodes, %d edges, built in %.2f ms; route %.1f us (grid BFS %.1f us)"),
+                Maze.FreeCells.Num(), Graph.GetNumNodes(), Graph.GetNumEdges(), BuildMs, GraphMicroseconds, GridMicroseconds);
+
+            TestEqual(TEXT("Same route lengths"), GraphChecksum, GridChecksum);
+        });
+    });
+}
@@ -0,0 +1,255 @@
+// MazeVisibilityGraphTests.cpp
+// Corner visibility graph paths, door links, blob loading from memory and from a mapped file, and build cost
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformFileManager.h"
+#include "HAL/FileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazeVisibilityGraph.h"
+
+BEGIN_DEFINE_SPEC(FMazeVisibilityGraphSpec, "MazeBlaze.VisibilityGraph", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeVisibilityGraphSpec)
+
+void FMazeVisibilityGraphSpec::Define()
+{
+    using namespace MazeTestMaze;
+
+    // Both graphs must give the same path lengths between random cells of the maze
+    auto TestSamePaths = [this](const FLoopMaze& Maze, const FMazeVisibilityGraph& Expected, const FMazeVisibilityGraph& Actual)
+    {
+        FRandomStream Random(3);
+        for (int32 Query = 0; Query < 50; ++Query)
+        {
+            const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+            const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+            if (!FMath::IsNearlyEqual(Expected.FindPath(From, To, Maze.Walkable), Actual.FindPath(From, To, Maze.Walkable)))
+            {
+                AddError(FString::Printf(TEXT("Different path from (%d, %d) to (%d, %d)"), From.X, From.Y, To.X, To.Y));
+                return;
+            }
+        }
+    };
+
+    Describe("FindPath", [this]()
+    {
+        It("should find any-angle paths no longer than the grid path", [this]()
+        {
+            for (int32 Seed = 1; Seed <= 3; ++Seed)
+            {
+                for (const float LoopChance : { 0.0f, 0.3f, 0.8f })
+                {
+                    FLoopMaze Maze;
+                    BuildMaze(10, Seed, LoopChance, Maze);
+
+                    FMazeVisibilityGraph Graph;
+                    Graph.Build(Maze.Size, Maze.Size, Maze.Walkable, TBitArray<>(false, Maze.Walkable.Num()), Maze.Size * 2);
+
+                    FRandomStream Random(Seed);
+                    for (int32 Query = 0; Query < 40; ++Query)
+                    {
+                        const FIntPoint From = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+                        const FIntPoint To = Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())];
+
+                        TArray<FIntPoint> Waypoints;
+                        const float Length = Graph.FindPath(From, To, Maze.Walkable, &Waypoints);
+                        const float StraightLength = FVector2D::Distance(FVector2D(From), FVector2D(To));
+                        if (Length < StraightLength - KINDA_SMALL_NUMBER || Length > GridDistance(Maze, From, To) + KINDA_SMALL_NUMBER)
+                        {
+                            AddError(FString::Printf(TEXT("Path from (%d, %d) to (%d, %d) is %.2f cells long"), From.X, From.Y, To.X, To.Y, Length));
+                            return;
+                        }
+
+                        // Every leg is a straight line through open cells
+                        FIntPoint Previous = From;
+                        for (const FIntPoint& Waypoint : Waypoints)
+                        {
+                            if (!Graph.HasLineOfSight(Maze.Walkable, Previous, Waypoint))
+                            {
+                                AddError(FString::Printf(TEXT("Blocked leg from (%d, %d) to (%d, %d)"), Previous.X, Previous.Y, Waypoint.X, Waypoint.Y));
+                                return;
+                            }
+                            Previous = Waypoint;
+                        }
+                        TestTrue(TEXT("Path ends on the target"), Previous == To);
+                    }
+                }
+            }
+        });
+
+        It("should not see between two walls touching at a corner", [this]()
+        {
+            // Open cells (0, 0) and (1, 1) meet only at the corner of two walls
+            TBitArray<> Walkable(false, 4);
+            Walkable[0] = true;
+            Walkable[3] = true;
+
+            FMazeVisibilityGraph Graph;
+            Graph.Build(2, 2, Walkable, TBitArray<>(false, 4), 8);
+            TestFalse(TEXT("No sight through the corner"), Graph.HasLineOfSight(Walkable, FIntPoint(0, 0), FIntPoint(1, 1)));
+            TestTrue(TEXT("No path through the corner"), Graph.FindPath(FIntPoint(0, 0), FIntPoint(1, 1), Walkable) < 0.0f);
+        });
+
+        It("should report cells that cannot be reached", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(8, 4, 0.0f, Maze);
+
+            // Wall in the first room
+            Maze.Walkable[1 * Maze.Size + 2] = false;
+            Maze.Walkable[2 * Maze.Size + 1] = false;
+
+            FMazeVisibilityGraph Graph;
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable, TBitArray<>(false, Maze.Walkable.Num()), Maze.Size);
+
+            const FIntPoint FarCell(Maze.Size - 2, Maze.Size - 2);
+            TestTrue(TEXT("Walled-in room"), Graph.FindPath(FIntPoint(1, 1), FarCell, Maze.Walkable) < 0.0f);
+            TestTrue(TEXT("Wall cell"), Graph.FindPath(FIntPoint(0, 0), FarCell, Maze.Walkable) < 0.0f);
+            TestTrue(TEXT("Outside the grid"), Graph.FindPath(FIntPoint(-1, 1), FarCell, Maze.Walkable) < 0.0f);
+        });
+
+        It("should only use links through a door while it is open", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(8, 11, 0.0f, Maze);
+
+            // The first room is left through a single door
+            const FIntPoint Door = Maze.IsWalkable(FIntPoint(2, 1)) ? FIntPoint(2, 1) : FIntPoint(1, 2);
+            const FIntPoint OtherOpening = Door == FIntPoint(2, 1) ? FIntPoint(1, 2) : FIntPoint(2, 1);
+            Maze.Walkable[OtherOpening.Y * Maze.Size + OtherOpening.X] = false;
+
+            TBitArray<> DoorCells(false, Maze.Walkable.Num());
+            DoorCells[Door.Y * Maze.Size + Door.X] = true;
+
+            FMazeVisibilityGraph Graph;
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable, DoorCells, Maze.Size * 2);
+
+            FMazeVisibilityGraph DoorlessGraph;
+            DoorlessGraph.Build(Maze.Size, Maze.Size, Maze.Walkable, TBitArray<>(false, Maze.Walkable.Num()), Maze.Size * 2);
+
+            const FIntPoint FarCell(Maze.Size - 2, Maze.Size - 2);
+            TBitArray<> ClosedWalkable = Maze.Walkable;
+            ClosedWalkable[Door.Y * Maze.Size + Door.X] = false;
+            TestTrue(TEXT("Closed door blocks"), Graph.FindPath(FIntPoint(1, 1), FarCell, ClosedWalkable) < 0.0f);
+            TestTrue(TEXT("Closed door blocks the way back"), Graph.FindPath(FarCell, FIntPoint(1, 1), ClosedWalkable) < 0.0f);
+
+            const float OpenLength = Graph.FindPath(FIntPoint(1, 1), FarCell, Maze.Walkable);
+            TestTrue(TEXT("Open door passes"), OpenLength > 0.0f);
+            TestTrue(TEXT("Same path as without doors"), FMath::IsNearlyEqual(OpenLength, DoorlessGraph.FindPath(FIntPoint(1, 1), FarCell, Maze.Walkable)));
+            TestNotEqual(TEXT("Door changes the grid hash"), Graph.GetGridHash(), DoorlessGraph.GetGridHash());
+        });
+    });
+
+    Describe("Load", [this, TestSamePaths]()
+    {
+        It("should use a saved blob in place and reject blobs for other grids", [this, TestSamePaths]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(12, 6, 0.2f, Maze);
+            const TBitArray<> DoorCells(false, Maze.Walkable.Num());
+
+            FMazeVisibilityGraph Built;
+            Built.Build(Maze.Size, Maze.Size, Maze.Walkable, DoorCells, 32);
+            const TArray<uint8> Blob(Built.GetBlob().GetData(), Built.GetBlob().Num());
+            const uint32 GridHash = FMazeVisibilityGraph::HashGrid(Maze.Size, Maze.Size, Maze.Walkable, DoorCells);
+            TestEqual(TEXT("Built for the grid"), Built.GetGridHash(), GridHash);
+
+            FMazeVisibilityGraph Loaded;
+            TestTrue(TEXT("Loaded"), Loaded.Load(Blob, GridHash));
+            TestFalse(TEXT("Not copied"), Loaded.IsUsingOwnedBlob());
+            TestEqual(TEXT("Same corners"), Loaded.GetNumVertices(), Built.GetNumVertices());
+            TestEqual(TEXT("Same links"), Loaded.GetNumEdges(), Built.GetNumEdges());
+            TestSamePaths(Maze, Built, Loaded);
+
+            TestFalse(TEXT("Other grid"), Loaded.Load(Blob, GridHash + 1));
+            TestFalse(TEXT("Dropped on failure"), Loaded.IsLoaded());
+
+            TArray<uint8> OldVersion = Blob;
+            OldVersion[4] = uint8(FMazeVisibilityGraph::FormatVersion + 1);
+            TestFalse(TEXT("Other format version"), Loaded.Load(OldVersion, GridHash));
+
+            TestFalse(TEXT("Truncated"), Loaded.Load(MakeArrayView(Blob).LeftChop(4), GridHash));
+        });
+
+        It("should run from a memory-mapped graph file", [this, TestSamePaths]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(12, 7, 0.2f, Maze);
+            const TBitArray<> DoorCells(false, Maze.Walkable.Num());
+
+            FMazeVisibilityGraph Built;
+            Built.Build(Maze.Size, Maze.Size, Maze.Walkable, DoorCells, 32);
+
+            const FString FilePath = FPaths::Combine(FPaths::AutomationTransientDir(), TEXT("VisibilityGraphTest.mazevis"));
+            if (!TestTrue(TEXT("Saved"), FFileHelper::SaveArrayToFile(Built.GetBlob(), *FilePath)))
+            {
+                return;
+            }
+
+            {
+                TUniquePtr<IMappedFileHandle> MappedFile(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*FilePath));
+                TUniquePtr<IMappedFileRegion> MappedRegion(MappedFile.IsValid() ? MappedFile->MapRegion() : nullptr);
+                if (TestTrue(TEXT("Mapped"), MappedRegion.IsValid()))
+                {
+                    FMazeVisibilityGraph Mapped;
+                    TestTrue(TEXT("Loaded"), Mapped.Load(TConstArrayView<uint8>(MappedRegion->GetMappedPtr(), int32(MappedRegion->GetMappedSize())), Built.GetGridHash()));
+                    TestSamePaths(Maze, Built, Mapped);
+                }
+            }
+
+            IFileManager::Get().Delete(*FilePath);
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("should build the graph of a large maze in parallel and answer queries", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(64, 9, 0.1f, Maze);
+
+            FMazeVisibilityGraph Graph;
+            double StartTime = FPlatformTime::Seconds();
+            Graph.Build(Maze.Size, Maze.Size, Maze.Walkable, TBitArray<>(false, Maze.Walkable.Num()), 64);
+            const double BuildMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            FMazeVisibilityGraph Loaded;
+            StartTime = FPlatformTime::Seconds();
+            Loaded.Load(Graph.GetBlob(), Graph.GetGridHash());
+            const double LoadMilliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+            const int32 NumQueries = 100;
+            FRandomStream Random(9);
+            TArray<FIntPoint> Queries;
+            for (int32 Query = 0; Query < NumQueries * 2; ++Query)
+            {
+                Queries.Add(Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())]);
+            }
+
+            int32 NumFound = 0;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                NumFound += Loaded.FindPath(Queries[Query * 2], Queries[Query * 2 + 1], Maze.Walkable) >= 0.0f ? 1 : 0;
+            }
+            const double QueryMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Query = 0; Query < NumQueries; ++Query)
+            {
+                GridDistance(Maze, Queries[Query * 2], Queries[Query * 2 + 1]);
+            }
+            const double GridMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumQueries;
+
+            UE_LOG(LogTemp, Display, TEXT("VisibilityGraph: %dx%d grid, %d corners and %d links (%.1f KB), built in %.1f ms, loaded in %.2f ms, %.1f us per query (grid search %.1f us)"),
+                Maze.Size, Maze.Size, Graph.GetNumVertices(), Graph.GetNumEdges(), Graph.GetBlob().Num() / 1024.0, BuildMilliseconds, LoadMilliseconds, QueryMicroseconds, GridMicroseconds);
+
+            TestEqual(TEXT("Every cell is reachable"), NumFound, NumQueries);
+        });
+    });
+}
@@ -0,0 +1,191 @@
+// MazeWallFollowerTests.cpp
+// Wall follower coverage of perfect and looping mazes, memory sweeps, per-agent memory and a crowd benchmark
+
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "Math/RandomStream.h"
+
+#include "MazeTestMaze.h"
+#include "../MazeWallFollower.h"
+
+BEGIN_DEFINE_SPEC(FMazeWallFollowerSpec, "MazeBlaze.WallFollower", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+END_DEFINE_SPEC(FMazeWallFollowerSpec)
+
+void FMazeWallFollowerSpec::Define()
+{
+    using namespace MazeTestMaze;
+
+    // Walk one cell at a time until every free cell is visited; returns the number of cells walked or INDEX_NONE
+    auto WalkUntilCovered = [this](const FLoopMaze& Maze, FMazeWallFollower& Follower, int32 MaxCells)
+    {
+        FMazeWallFollowerScratch Scratch;
+        TArray<FIntPoint> Cells;
+        int32 NumWalked = 0;
+        while (Follower.GetNumVisitedCells() < Maze.FreeCells.Num() && NumWalked < MaxCells)
+        {
+            const FIntPoint From = Follower.GetCell();
+            Cells.Reset();
+            NumWalked += Follower.Advance(Maze.Walkable, 1, Cells, Scratch);
+            if (Cells.Num() == 0 || !IsValidPath(Maze, From, Cells.Last(), Cells))
+            {
+                AddError(TEXT("Follower left the corridors"));
+                return INDEX_NONE;
+            }
+        }
+        return Follower.GetNumVisitedCells() == Maze.FreeCells.Num() ? NumWalked : INDEX_NONE;
+    };
+
+    Describe("Advance", [this, WalkUntilCovered]()
+    {
+        It("should cover a maze without loops like a plain wall follower", [this, WalkUntilCovered]()
+        {
+            for (int32 Seed = 1; Seed <= 4; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(16, Seed, 0.0f, Maze);
+
+                FMazeWallFollower Follower;
+                Follower.Reset(Maze.Size, Maze.Size, FIntPoint(1, 1), Seed % 2 == 0);
+
+                // A wall follower walks every corridor of a tree at most twice
+                const int32 NumWalked = WalkUntilCovered(Maze, Follower, Maze.FreeCells.Num() * 2);
+                TestTrue(TEXT("Covered the maze"), NumWalked != INDEX_NONE);
+                TestEqual(TEXT("No loop to escape"), Follower.GetNumHandSwitches(), 0);
+            }
+        });
+
+        It("should escape loops and cover a maze that has them", [this, WalkUntilCovered]()
+        {
+            for (int32 Seed = 1; Seed <= 4; ++Seed)
+            {
+                FLoopMaze Maze;
+                BuildMaze(16, Seed, 0.3f, Maze);
+
+                FMazeWallFollower Follower;
+                Follower.Reset(Maze.Size, Maze.Size, FIntPoint(1, 1));
+
+                const int32 NumWalked = WalkUntilCovered(Maze, Follower, Maze.FreeCells.Num() * 4);
+                TestTrue(TEXT("Covered the maze"), NumWalked != INDEX_NONE);
+                TestEqual(TEXT("Still on the first sweep"), Follower.GetNumSweeps(), 0);
+            }
+        });
+
+        It("should start a new sweep once everything reachable is visited", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(6, 8, 0.2f, Maze);
+
+            FMazeWallFollower Follower;
+            Follower.Reset(Maze.Size, Maze.Size, FIntPoint(1, 1));
+
+            FMazeWallFollowerScratch Scratch;
+            TArray<FIntPoint> Cells;
+            const int32 NumCells = Maze.FreeCells.Num() * 10;
+            TestTrue(TEXT("Keeps walking"), Follower.Advance(Maze.Walkable, NumCells, Cells, Scratch) >= NumCells);
+            TestTrue(TEXT("Path is connected"), IsValidPath(Maze, FIntPoint(1, 1), Cells.Last(), Cells));
+            TestTrue(TEXT("Started over"), Follower.GetNumSweeps() > 0);
+        });
+
+        It("should follow doors opened in the walkability mask", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(8, 11, 0.0f, Maze);
+
+            // Close the bridge next to the start so only one side is reachable
+            const FIntPoint Opening = Maze.IsWalkable(FIntPoint(2, 1)) ? FIntPoint(2, 1) : FIntPoint(1, 2);
+            Maze.Walkable[Opening.Y * Maze.Size + Opening.X] = false;
+
+            FMazeWallFollower Follower;
+            Follower.Reset(Maze.Size, Maze.Size, FIntPoint(1, 1));
+
+            FMazeWallFollowerScratch Scratch;
+            TArray<FIntPoint> Cells;
+            Follower.Advance(Maze.Walkable, Maze.FreeCells.Num() * 2, Cells, Scratch);
+            TestFalse(TEXT("Closed door not crossed"), Cells.Contains(Opening));
+
+            Maze.Walkable[Opening.Y * Maze.Size + Opening.X] = true;
+            Cells.Reset();
+            Follower.Advance(Maze.Walkable, Maze.FreeCells.Num() * 4, Cells, Scratch);
+            TestTrue(TEXT("Open door crossed"), Cells.Contains(Opening));
+        });
+    });
+
+    Describe("Memory", [this]()
+    {
+        It("should use one bit per cell for the visited cells", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(128, 2, 0.05f, Maze);
+
+            FMazeWallFollower Follower;
+            Follower.Reset(Maze.Size, Maze.Size, FIntPoint(1, 1));
+
+            FMazeWallFollowerScratch Scratch;
+            TArray<FIntPoint> Cells;
+            Follower.Advance(Maze.Walkable, 20000, Cells, Scratch);
+
+            const SIZE_T NumCells = SIZE_T(Maze.Size) * Maze.Size;
+            const SIZE_T Bytes = Follower.GetAllocatedSize();
+            const SIZE_T HistoryBytes = SIZE_T(Follower.GetNumVisitedCells()) * sizeof(FVector);
+            UE_LOG(LogTemp, Display, TEXT("WallFollower: %dx%d grid, %llu bytes per agent, %d cells visited (a location history would take %llu bytes)"),
+                Maze.Size, Maze.Size, uint64(Bytes), Follower.GetNumVisitedCells(), uint64(HistoryBytes));
+
+            // Allow for the allocator rounding the bitset up
+            TestTrue(TEXT("About a bit per cell"), Bytes <= sizeof(FMazeWallFollower) + NumCells / 8 + NumCells / 64);
+            TestTrue(TEXT("Smaller than a location history"), Bytes < HistoryBytes);
+        });
+    });
+
+    Describe("Benchmark", [this]()
+    {
+        It("should move a thousand agents for less than a path search each", [this]()
+        {
+            FLoopMaze Maze;
+            BuildMaze(64, 5, 0.1f, Maze);
+
+            const int32 NumAgents = 1000;
+            const int32 NumMoves = 10;
+            const int32 CellsPerMove = 24;
+            FRandomStream Random(5);
+            TArray<FMazeWallFollower> Followers;
+            Followers.SetNum(NumAgents);
+            for (int32 Agent = 0; Agent < NumAgents; ++Agent)
+            {
+                Followers[Agent].Reset(Maze.Size, Maze.Size, Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())], Agent % 2 == 0);
+            }
+
+            FMazeWallFollowerScratch Scratch;
+            TArray<FIntPoint> Cells;
+            double StartTime = FPlatformTime::Seconds();
+            for (int32 Move = 0; Move < NumMoves; ++Move)
+            {
+                for (FMazeWallFollower& Follower : Followers)
+                {
+                    Cells.Reset();
+                    Follower.Advance(Maze.Walkable, CellsPerMove, Cells, Scratch);
+                }
+            }
+            const double MoveMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / (NumAgents * NumMoves);
+
+            // A grid search to a random free cell stands in for a navmesh path query
+            const int32 NumSearches = 100;
+            StartTime = FPlatformTime::Seconds();
+            for (int32 Search = 0; Search < NumSearches; ++Search)
+            {
+                GridDistance(Maze, Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())], Maze.FreeCells[Random.RandHelper(Maze.FreeCells.Num())]);
+            }
+            const double SearchMicroseconds = (FPlatformTime::Seconds() - StartTime) * 1e6 / NumSearches;
+
+            SIZE_T TotalBytes = Scratch.Parents.GetAllocatedSize() + Scratch.Queue.GetAllocatedSize();
+            for (const FMazeWallFollower& Follower : Followers)
+            {
+                TotalBytes += Follower.GetAllocatedSize();
+            }
+
+            UE_LOG(LogTemp, Display, TEXT("WallFollower: %d agents on %dx%d, %.2f us per %d-cell move (grid search %.1f us), %llu bytes per agent, %.1f KB total"),
+                NumAgents, Maze.Size, Maze.Size, MoveMicroseconds, CellsPerMove, SearchMicroseconds, uint64(Followers[0].GetAllocatedSize()), TotalBytes / 1024.0);
+
+            TestTrue(TEXT("A move costs a fraction of a path search"), MoveMicroseconds * 4.0 < SearchMicroseconds);
+        });
+    });
+}
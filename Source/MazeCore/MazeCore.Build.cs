@@ -0,0 +1,15 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+// Engine-independent maze logic; the same sources also build standalone with the CMake project in /MazeCore
+public class MazeCore : ModuleRules
+{
+	public MazeCore(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = PCHUsageMode.UseExplicitOrSharedPCHs;
+
+		// Only for the module boilerplate; the maze code itself uses the standard library
+		PublicDependencyModuleNames.AddRange(new string[] { "Core" });
+	}
+}
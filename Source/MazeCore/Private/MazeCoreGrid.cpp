@@ -0,0 +1,21 @@
+#include "MazeCoreGrid.h"
+
+namespace MazeCore
+{
+	void FGrid::Reset(int32_t InWidth, int32_t InHeight)
+	{
+		Width = InWidth > 0 ? InWidth : 0;
+		Height = InHeight > 0 ? InHeight : 0;
+		Walkable.assign(static_cast<size_t>(Width) * Height, 0);
+	}
+
+	int32_t FGrid::CountWalkable() const
+	{
+		int32_t Count = 0;
+		for (const uint8_t Cell : Walkable)
+		{
+			Count += Cell;
+		}
+		return Count;
+	}
+}
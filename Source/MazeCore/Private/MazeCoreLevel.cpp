@@ -0,0 +1,210 @@
+#include "MazeCoreLevel.h"
+#include "MazeCoreSolvers.h"
+#include <algorithm>
+
+namespace MazeCore
+{
+	namespace
+	{
+		// Small deterministic generator, so a seed gives the same level on every platform
+		class FRandom
+		{
+		public:
+			explicit FRandom(uint32_t Seed) : State(Seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+			uint32_t Next()
+			{
+				// SplitMix64
+				uint64_t Value = (State += 0x9E3779B97F4A7C15ull);
+				Value = (Value ^ (Value >> 30)) * 0xBF58476D1CE4E5B9ull;
+				Value = (Value ^ (Value >> 27)) * 0x94D049BB133111EBull;
+				return static_cast<uint32_t>((Value ^ (Value >> 31)) >> 32);
+			}
+
+			// Uniform in [0, Count)
+			int32_t Range(int32_t Count)
+			{
+				return static_cast<int32_t>(Next() % static_cast<uint32_t>(Count));
+			}
+
+			float Fraction()
+			{
+				return static_cast<float>(Next() >> 8) / 16777216.0f;
+			}
+
+		private:
+			uint64_t State;
+		};
+
+		// Random reachable cell that is not taken yet, or NoIndex if there is none
+		int32_t PickReachableCell(const std::vector<int32_t>& Distances, const std::vector<uint8_t>& Taken, FRandom& Random)
+		{
+			std::vector<int32_t> Candidates;
+			for (int32_t Index = 0; Index < static_cast<int32_t>(Distances.size()); ++Index)
+			{
+				if (Distances[Index] != NoIndex && !Taken[Index])
+				{
+					Candidates.push_back(Index);
+				}
+			}
+			return Candidates.empty() ? NoIndex : Candidates[Random.Range(static_cast<int32_t>(Candidates.size()))];
+		}
+	}
+
+	bool FLevel::IndexDoors()
+	{
+		DoorAtCell.assign(Grid.GetNumCells(), static_cast<int8_t>(NoIndex));
+		if (Doors.size() > MaxDoors)
+		{
+			return false;
+		}
+
+		for (int32_t Door = 0; Door < static_cast<int32_t>(Doors.size()); ++Door)
+		{
+			for (const FCell& Cell : Doors[Door].Cells)
+			{
+				if (!Grid.IsWalkable(Cell))
+				{
+					return false;
+				}
+				DoorAtCell[Grid.ToIndex(Cell)] = static_cast<int8_t>(Door);
+			}
+		}
+		return true;
+	}
+
+	FLevel FLevel::Generate(const FLevelParams& Params)
+	{
+		FRandom Random(Params.Seed);
+		const int32_t Rooms = std::max(Params.RoomsPerSide, 2);
+		const int32_t Size = Rooms * 2 + 1;
+
+		FLevel Level;
+		Level.Grid.Reset(Size, Size);
+		Level.Start = FCell(1, 1);
+
+		// Depth-first carving of a perfect maze over the rooms
+		std::vector<uint8_t> Visited(static_cast<size_t>(Rooms) * Rooms, 0);
+		std::vector<FCell> Stack = { FCell(0, 0) };
+		Visited[0] = 1;
+		Level.Grid.SetWalkable(Level.Start, true);
+
+		while (!Stack.empty())
+		{
+			const FCell Room = Stack.back();
+			FCell Unvisited[4];
+			int32_t NumUnvisited = 0;
+			for (const FCell& Offset : CardinalOffsets)
+			{
+				const FCell Next = Room + Offset;
+				if (Next.X >= 0 && Next.Y >= 0 && Next.X < Rooms && Next.Y < Rooms && !Visited[Next.Y * Rooms + Next.X])
+				{
+					Unvisited[NumUnvisited++] = Next;
+				}
+			}
+
+			if (NumUnvisited == 0)
+			{
+				Stack.pop_back();
+				continue;
+			}
+
+			const FCell Next = Unvisited[Random.Range(NumUnvisited)];
+			Visited[Next.Y * Rooms + Next.X] = 1;
+			Stack.push_back(Next);
+			Level.Grid.SetWalkable(FCell(Next.X * 2 + 1, Next.Y * 2 + 1), true);
+			Level.Grid.SetWalkable(FCell(Room.X + Next.X + 1, Room.Y + Next.Y + 1), true);
+		}
+
+		// Cells between two rooms are either wall or opening; knock some walls out for loops
+		std::vector<FCell> Openings;
+		for (int32_t Y = 1; Y < Size - 1; ++Y)
+		{
+			for (int32_t X = 1; X < Size - 1; ++X)
+			{
+				if ((X + Y) % 2 == 0)
+				{
+					continue;
+				}
+
+				const FCell Cell(X, Y);
+				if (!Level.Grid.IsWalkable(Cell) && Random.Fraction() < Params.LoopChance)
+				{
+					Level.Grid.SetWalkable(Cell, true);
+				}
+				if (Level.Grid.IsWalkable(Cell))
+				{
+					Openings.push_back(Cell);
+				}
+			}
+		}
+
+		// Doors on random openings far enough from the start that the rooms on the way to a door
+		// leave space for the keys before it. Numbered by distance, the doors on the way to door k
+		// come before it, so it can be reached once they are open
+		const int32_t NumKeys = std::min(std::max(Params.NumKeys, 1), MaxKeys);
+		const int32_t MinDoorDistance = NumKeys * 2 + 3;
+		FGridSearch Search;
+		std::vector<int32_t> Distances;
+		Level.IndexDoors();
+		Search.ComputeDistances(Level, 0, Level.Start, Distances);
+		Openings.erase(std::remove_if(Openings.begin(), Openings.end(), [&](const FCell& Cell)
+		{
+			return Distances[Level.Grid.ToIndex(Cell)] < MinDoorDistance;
+		}), Openings.end());
+
+		const int32_t NumDoors = std::min({ std::max(Params.NumDoors, 0), MaxDoors, static_cast<int32_t>(Openings.size()) });
+		for (int32_t Door = 0; Door < NumDoors; ++Door)
+		{
+			const int32_t Pick = Door + Random.Range(static_cast<int32_t>(Openings.size()) - Door);
+			std::swap(Openings[Door], Openings[Pick]);
+		}
+		std::sort(Openings.begin(), Openings.begin() + NumDoors, [&](const FCell& A, const FCell& B)
+		{
+			return Distances[Level.Grid.ToIndex(A)] < Distances[Level.Grid.ToIndex(B)];
+		});
+		for (int32_t Door = 0; Door < NumDoors; ++Door)
+		{
+			Level.Doors.push_back(FDoor{ { Openings[Door] }, 1 << (Door % NumKeys) });
+		}
+		Level.IndexDoors();
+
+		// Key k goes where it can be reached with the doors before door k open
+		std::vector<uint8_t> Taken(static_cast<size_t>(Level.Grid.GetNumCells()), 0);
+		Taken[Level.Grid.ToIndex(Level.Start)] = 1;
+		for (const FDoor& Door : Level.Doors)
+		{
+			Taken[Level.Grid.ToIndex(Door.Cells[0])] = 1;
+		}
+
+		for (int32_t Key = 0; Key < NumKeys; ++Key)
+		{
+			const FDoorSet OpenDoors = Key < NumDoors ? (FDoorSet(1) << Key) - 1 : Level.GetAllDoors();
+			Search.ComputeDistances(Level, OpenDoors, Level.Start, Distances);
+			const int32_t Cell = PickReachableCell(Distances, Taken, Random);
+			if (Cell == NoIndex)
+			{
+				break;
+			}
+			Taken[Cell] = 1;
+			Level.Keys.push_back(FKey{ Level.Grid.ToCell(Cell), 1 << Key });
+		}
+
+		// The exit is the free cell furthest from the start once every door is open
+		Search.ComputeDistances(Level, Level.GetAllDoors(), Level.Start, Distances);
+		int32_t ExitCell = NoIndex;
+		for (int32_t Index = 0; Index < static_cast<int32_t>(Distances.size()); ++Index)
+		{
+			if (!Taken[Index] && Distances[Index] != NoIndex && (ExitCell == NoIndex || Distances[Index] > Distances[ExitCell]))
+			{
+				ExitCell = Index;
+			}
+		}
+		if (ExitCell != NoIndex)
+		{
+			Level.Exits.push_back(Level.Grid.ToCell(ExitCell));
+		}
+
+		return Level;
+	}
+}
@@ -0,0 +1,913 @@
+#include "MazeCorePlanner.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+
+namespace MazeCore
+{
+	namespace
+	{
+		// Anchor value of the goal state, reached from whichever exit
+		constexpr int32_t GoalAnchor = 0xFFFF;
+
+		uint64_t HashState(uint64_t Packed, FDoorSet OpenDoors)
+		{
+			uint64_t Hash = Packed * 0x9E3779B97F4A7C15ull ^ OpenDoors * 0xC2B2AE3D27D4EB4Full;
+			return Hash ^ (Hash >> 29);
+		}
+
+		template <size_t Size>
+		uint64_t HashBytes(const std::array<uint8_t, Size>& Bytes)
+		{
+			// FNV-1a
+			uint64_t Hash = 0xCBF29CE484222325ull;
+			for (const uint8_t Byte : Bytes)
+			{
+				Hash = (Hash ^ Byte) * 0x100000001B3ull;
+			}
+			return Hash ^ (Hash >> 32);
+		}
+
+		// Visit the cells next to a cell by index, staying inside the grid
+		template <typename FunctionType>
+		void ForEachNeighbour(int32_t Index, int32_t Width, int32_t NumCells, FunctionType&& Visit)
+		{
+			const int32_t X = Index % Width;
+			if (X > 0)
+			{
+				Visit(Index - 1);
+			}
+			if (X + 1 < Width)
+			{
+				Visit(Index + 1);
+			}
+			if (Index >= Width)
+			{
+				Visit(Index - Width);
+			}
+			if (Index + Width < NumCells)
+			{
+				Visit(Index + Width);
+			}
+		}
+
+		int32_t LowestDoor(FDoorSet Doors)
+		{
+			int32_t Door = 0;
+			while (((Doors >> Door) & 1) == 0)
+			{
+				++Door;
+			}
+			return Door;
+		}
+	}
+
+	bool FKeyDoorPlanner::Build(const FLevel& InLevel)
+	{
+		Level = InLevel;
+		Anchors.clear();
+		KeyAnchors.clear();
+		ExitAnchors.clear();
+		DoorAnchors.assign(Level.Doors.size(), std::vector<int32_t>());
+		KeyDoors.assign(Level.Keys.size(), 0);
+		NumBuiltAnchors = 0;
+		if (Level.Keys.size() > MaxKeys || !Level.IndexDoors())
+		{
+			return false;
+		}
+
+		const FGrid& Grid = Level.Grid;
+		AnchorAtCell.assign(Grid.GetNumCells(), NoIndex);
+		CellDistance.assign(Grid.GetNumCells(), NoIndex);
+
+		for (int32_t Key = 0; Key < static_cast<int32_t>(Level.Keys.size()); ++Key)
+		{
+			const FCell& Cell = Level.Keys[Key].Cell;
+			if (!Grid.IsValidCell(Cell))
+			{
+				// Carried off the level: the key has no slot
+				KeyAnchors.push_back(NoIndex);
+			}
+			else if (!Level.IsPassable(Cell, 0) || AnchorAtCell[Grid.ToIndex(Cell)] != NoIndex)
+			{
+				// Keys must lie on their own cells outside the doors
+				return false;
+			}
+			else
+			{
+				KeyAnchors.push_back(AddAnchor(Cell));
+				Anchors[KeyAnchors.back()].KeySlot = Key;
+			}
+
+			for (int32_t Door = 0; Door < static_cast<int32_t>(Level.Doors.size()); ++Door)
+			{
+				if (CanKeyOpenDoor(Level.Keys[Key].Signature, Level.Doors[Door].Mask))
+				{
+					KeyDoors[Key] |= FDoorSet(1) << Door;
+				}
+			}
+		}
+
+		for (int32_t Exit = 0; Exit < static_cast<int32_t>(Level.Exits.size()); ++Exit)
+		{
+			if (!Level.IsPassable(Level.Exits[Exit], 0))
+			{
+				return false;
+			}
+			ExitAnchors.push_back(AddAnchor(Level.Exits[Exit]));
+			Anchors[ExitAnchors.back()].Exit = Exit;
+		}
+
+		for (int32_t Door = 0; Door < static_cast<int32_t>(Level.Doors.size()); ++Door)
+		{
+			for (const FCell& DoorCell : Level.Doors[Door].Cells)
+			{
+				for (const FCell& Offset : CardinalOffsets)
+				{
+					const FCell Cell = DoorCell + Offset;
+					if (!Level.IsPassable(Cell, 0))
+					{
+						continue;
+					}
+
+					const int32_t Anchor = AddAnchor(Cell);
+					if (!IsDoorOpen(Anchors[Anchor].AdjacentDoors, Door))
+					{
+						Anchors[Anchor].AdjacentDoors |= FDoorSet(1) << Door;
+						DoorAnchors[Door].push_back(Anchor);
+					}
+				}
+			}
+		}
+
+		NumBuiltAnchors = static_cast<int32_t>(Anchors.size());
+		if (NumBuiltAnchors >= GoalAnchor)
+		{
+			return false;
+		}
+
+		// Label the regions between closed doors and count their anchors, so connecting a region stops once all are found
+		CellRegion.assign(Grid.GetNumCells(), NoIndex);
+		RegionAnchorCount.clear();
+		for (int32_t Index = 0; Index < Grid.GetNumCells(); ++Index)
+		{
+			if (CellRegion[Index] != NoIndex || !Level.IsPassable(Grid.ToCell(Index), 0))
+			{
+				continue;
+			}
+
+			const int32_t Region = static_cast<int32_t>(RegionAnchorCount.size());
+			RegionAnchorCount.push_back(0);
+			CellRegion[Index] = Region;
+			CellQueue.clear();
+			CellQueue.push_back(Index);
+			for (size_t Head = 0; Head < CellQueue.size(); ++Head)
+			{
+				if (AnchorAtCell[CellQueue[Head]] != NoIndex)
+				{
+					++RegionAnchorCount[Region];
+				}
+				ForEachNeighbour(CellQueue[Head], Grid.GetWidth(), Grid.GetNumCells(), [this, Region](int32_t Next)
+				{
+					if (CellRegion[Next] == NoIndex && Level.IsPassable(Level.Grid.ToCell(Next), 0))
+					{
+						CellRegion[Next] = Region;
+						CellQueue.push_back(Next);
+					}
+				});
+			}
+		}
+
+		for (int32_t Anchor = 0; Anchor < NumBuiltAnchors; ++Anchor)
+		{
+			ConnectRegion(Anchor);
+		}
+
+		// Crossing a door: into a door cell next to one anchor, through the door, out to another anchor
+		std::vector<int32_t> DoorDistance(Grid.GetNumCells(), NoIndex);
+		for (int32_t Door = 0; Door < static_cast<int32_t>(Level.Doors.size()); ++Door)
+		{
+			const std::vector<int32_t>& Around = DoorAnchors[Door];
+			for (const int32_t From : Around)
+			{
+				// Breadth-first inside the door from the door cells next to From
+				CellQueue.clear();
+				for (const FCell& Offset : CardinalOffsets)
+				{
+					const FCell Cell = Anchors[From].Cell + Offset;
+					if (Level.GetDoorAt(Cell) == Door && DoorDistance[Grid.ToIndex(Cell)] == NoIndex)
+					{
+						DoorDistance[Grid.ToIndex(Cell)] = 1;
+						CellQueue.push_back(Grid.ToIndex(Cell));
+					}
+				}
+				for (size_t Head = 0; Head < CellQueue.size(); ++Head)
+				{
+					const FCell Cell = Grid.ToCell(CellQueue[Head]);
+					for (const FCell& Offset : CardinalOffsets)
+					{
+						const FCell Next = Cell + Offset;
+						if (Level.GetDoorAt(Next) == Door && DoorDistance[Grid.ToIndex(Next)] == NoIndex)
+						{
+							DoorDistance[Grid.ToIndex(Next)] = DoorDistance[CellQueue[Head]] + 1;
+							CellQueue.push_back(Grid.ToIndex(Next));
+						}
+					}
+				}
+
+				for (const int32_t To : Around)
+				{
+					int32_t Cost = NoIndex;
+					for (const FCell& Offset : CardinalOffsets)
+					{
+						const FCell Cell = Anchors[To].Cell + Offset;
+						if (To != From && Level.GetDoorAt(Cell) == Door && DoorDistance[Grid.ToIndex(Cell)] != NoIndex)
+						{
+							const int32_t Through = DoorDistance[Grid.ToIndex(Cell)] + 1;
+							Cost = Cost == NoIndex ? Through : std::min(Cost, Through);
+						}
+					}
+					if (Cost != NoIndex)
+					{
+						Anchors[From].Edges.push_back(FAnchorEdge{ To, Cost, Door });
+					}
+				}
+
+				for (const int32_t Index : CellQueue)
+				{
+					DoorDistance[Index] = NoIndex;
+				}
+			}
+		}
+
+		// Heuristic: distance to the nearest exit with every door open
+		for (FAnchor& Anchor : Anchors)
+		{
+			Anchor.ExitDistance = NoIndex;
+		}
+		using FOpenAnchor = std::pair<int32_t, int32_t>;
+		std::priority_queue<FOpenAnchor, std::vector<FOpenAnchor>, std::greater<FOpenAnchor>> OpenList;
+		for (const int32_t Exit : ExitAnchors)
+		{
+			Anchors[Exit].ExitDistance = 0;
+			OpenList.push(FOpenAnchor(0, Exit));
+		}
+		while (!OpenList.empty())
+		{
+			const FOpenAnchor Open = OpenList.top();
+			OpenList.pop();
+			if (Open.first != Anchors[Open.second].ExitDistance)
+			{
+				continue;
+			}
+			// Edges are symmetric, so the distances from the exits are the distances to them
+			for (const FAnchorEdge& Edge : Anchors[Open.second].Edges)
+			{
+				int32_t& Distance = Anchors[Edge.To].ExitDistance;
+				if (Distance == NoIndex || Open.first + Edge.Cost < Distance)
+				{
+					Distance = Open.first + Edge.Cost;
+					OpenList.push(FOpenAnchor(Distance, Edge.To));
+				}
+			}
+		}
+
+		return true;
+	}
+
+	int32_t FKeyDoorPlanner::AddAnchor(const FCell& Cell)
+	{
+		int32_t& Anchor = AnchorAtCell[Level.Grid.ToIndex(Cell)];
+		if (Anchor == NoIndex)
+		{
+			Anchor = static_cast<int32_t>(Anchors.size());
+			Anchors.emplace_back();
+			Anchors.back().Cell = Cell;
+		}
+		return Anchor;
+	}
+
+	void FKeyDoorPlanner::ConnectRegion(int32_t Anchor)
+	{
+		const FGrid& Grid = Level.Grid;
+		const int32_t StartIndex = Grid.ToIndex(Anchors[Anchor].Cell);
+		CellQueue.clear();
+		CellQueue.push_back(StartIndex);
+		CellDistance[StartIndex] = 0;
+
+		// Built anchors of the region other than this one
+		int32_t AnchorsLeft = RegionAnchorCount[CellRegion[StartIndex]] - (Anchor < NumBuiltAnchors ? 1 : 0);
+		for (size_t Head = 0; Head < CellQueue.size() && AnchorsLeft > 0; ++Head)
+		{
+			const int32_t Index = CellQueue[Head];
+			const int32_t Other = AnchorAtCell[Index];
+			if (Other != NoIndex && Other != Anchor)
+			{
+				Anchors[Anchor].Edges.push_back(FAnchorEdge{ Other, CellDistance[Index], NoIndex });
+				--AnchorsLeft;
+			}
+
+			ForEachNeighbour(Index, Grid.GetWidth(), Grid.GetNumCells(), [this, Index](int32_t Next)
+			{
+				if (CellRegion[Next] != NoIndex && CellDistance[Next] == NoIndex)
+				{
+					CellDistance[Next] = CellDistance[Index] + 1;
+					CellQueue.push_back(Next);
+				}
+			});
+		}
+
+		for (const int32_t Index : CellQueue)
+		{
+			CellDistance[Index] = NoIndex;
+		}
+	}
+
+	const std::vector<int32_t>& FKeyDoorPlanner::GetDistances(int32_t FromAnchor, FDoorSet OpenDoors)
+	{
+		++Stats.DistanceQueries;
+		const FDistanceKey Key{ FromAnchor, OpenDoors };
+		const auto Found = DistanceCache.find(Key);
+		if (Found != DistanceCache.end())
+		{
+			++Stats.DistanceCacheHits;
+			return Found->second;
+		}
+
+		if (static_cast<int32_t>(DistanceCache.size()) >= MaxCachedDistances)
+		{
+			DistanceCache.clear();
+		}
+
+		std::vector<int32_t>& Distances = DistanceCache[Key];
+		Distances.assign(Anchors.size(), NoIndex);
+		Distances[FromAnchor] = 0;
+
+		// Binary heap of (distance, anchor) with the nearest on top
+		Heap.clear();
+		Heap.push_back(std::make_pair(0, FromAnchor));
+		const auto Nearer = [](const std::pair<int32_t, int32_t>& A, const std::pair<int32_t, int32_t>& B) { return A.first > B.first; };
+		while (!Heap.empty())
+		{
+			std::pop_heap(Heap.begin(), Heap.end(), Nearer);
+			const std::pair<int32_t, int32_t> Open = Heap.back();
+			Heap.pop_back();
+			if (Open.first != Distances[Open.second])
+			{
+				continue;
+			}
+
+			for (const FAnchorEdge& Edge : Anchors[Open.second].Edges)
+			{
+				if (Edge.Door != NoIndex && !IsDoorOpen(OpenDoors, Edge.Door))
+				{
+					continue;
+				}
+				const int32_t Distance = Open.first + Edge.Cost;
+				if (Distances[Edge.To] == NoIndex || Distance < Distances[Edge.To])
+				{
+					Distances[Edge.To] = Distance;
+					Heap.push_back(std::make_pair(Distance, Edge.To));
+					std::push_heap(Heap.begin(), Heap.end(), Nearer);
+				}
+			}
+		}
+
+		return Distances;
+	}
+
+	FDoorSet FKeyDoorPlanner::GetDoorsOpenedAt(int32_t Anchor, int32_t Key, FDoorSet OpenDoors) const
+	{
+		return Key == NoIndex ? 0 : Anchors[Anchor].AdjacentDoors & KeyDoors[Key] & ~OpenDoors;
+	}
+
+	uint64_t FKeyDoorPlanner::PackCanonical(int32_t Anchor, int32_t CarriedKey, FKeyLayout Layout, FDoorSet OpenDoors)
+	{
+		// Keys whose doors are all open are as good as no key, wherever they are
+		for (int32_t Slot = 0; Slot < static_cast<int32_t>(KeyAnchors.size()); ++Slot)
+		{
+			if (Layout[Slot] != EmptySlot && (KeyDoors[Layout[Slot]] & ~OpenDoors) == 0)
+			{
+				Layout[Slot] = EmptySlot;
+			}
+		}
+		if (CarriedKey != NoIndex && (KeyDoors[CarriedKey] & ~OpenDoors) == 0)
+		{
+			CarriedKey = NoIndex;
+		}
+		return PackState(Anchor, CarriedKey, InternLayout(Layout));
+	}
+
+	int32_t FKeyDoorPlanner::InternLayout(const FKeyLayout& Layout)
+	{
+		// Keep the table at most half full
+		if (Layouts.size() * 2 >= LayoutTable.size())
+		{
+			LayoutTable.assign(std::max<size_t>(LayoutTable.size() * 2, 256), NoIndex);
+			const size_t Mask = LayoutTable.size() - 1;
+			for (int32_t Index = 0; Index < static_cast<int32_t>(Layouts.size()); ++Index)
+			{
+				size_t Slot = HashBytes(Layouts[Index]) & Mask;
+				while (LayoutTable[Slot] != NoIndex)
+				{
+					Slot = (Slot + 1) & Mask;
+				}
+				LayoutTable[Slot] = Index;
+			}
+		}
+
+		const size_t Mask = LayoutTable.size() - 1;
+		size_t Slot = HashBytes(Layout) & Mask;
+		while (LayoutTable[Slot] != NoIndex)
+		{
+			if (Layouts[LayoutTable[Slot]] == Layout)
+			{
+				return LayoutTable[Slot];
+			}
+			Slot = (Slot + 1) & Mask;
+		}
+
+		LayoutTable[Slot] = static_cast<int32_t>(Layouts.size());
+		Layouts.push_back(Layout);
+		return LayoutTable[Slot];
+	}
+
+	int32_t FKeyDoorPlanner::AddState(uint64_t Packed, FDoorSet OpenDoors, int32_t Cost, int32_t Parent, EPlanAction Action, int32_t ActionIndex)
+	{
+		// Keep the table at most half full
+		if (Records.size() * 2 >= StateTable.size())
+		{
+			StateTable.assign(std::max<size_t>(StateTable.size() * 2, 1024), NoIndex);
+			const size_t Mask = StateTable.size() - 1;
+			for (int32_t Record = 0; Record < static_cast<int32_t>(Records.size()); ++Record)
+			{
+				size_t Slot = HashState(Records[Record].Packed, Records[Record].OpenDoors) & Mask;
+				while (StateTable[Slot] != NoIndex)
+				{
+					Slot = (Slot + 1) & Mask;
+				}
+				StateTable[Slot] = Record;
+			}
+		}
+
+		const size_t Mask = StateTable.size() - 1;
+		size_t Slot = HashState(Packed, OpenDoors) & Mask;
+		while (StateTable[Slot] != NoIndex)
+		{
+			FStateRecord& Existing = Records[StateTable[Slot]];
+			if (Existing.Packed == Packed && Existing.OpenDoors == OpenDoors)
+			{
+				// The heuristic is consistent, so a closed state already has its shortest cost
+				if (Existing.bClosed || Existing.Cost <= Cost)
+				{
+					return NoIndex;
+				}
+				Existing.Cost = Cost;
+				Existing.Parent = Parent;
+				Existing.Action = Action;
+				Existing.ActionIndex = ActionIndex;
+				return StateTable[Slot];
+			}
+			Slot = (Slot + 1) & Mask;
+		}
+
+		StateTable[Slot] = static_cast<int32_t>(Records.size());
+		FStateRecord& Record = Records.emplace_back();
+		Record.Packed = Packed;
+		Record.OpenDoors = OpenDoors;
+		Record.Cost = Cost;
+		Record.Parent = Parent;
+		Record.Action = Action;
+		Record.ActionIndex = ActionIndex;
+		return StateTable[Slot];
+	}
+
+	FPlan FKeyDoorPlanner::Solve(const FCell& Start, int32_t CarriedKey)
+	{
+		Stats = FPlannerStats();
+		Records.clear();
+		StateTable.clear();
+		DistanceCache.clear();
+		Layouts.clear();
+		LayoutTable.clear();
+
+		// Drop the start anchor of the previous search
+		Anchors.resize(NumBuiltAnchors);
+
+		FPlan Plan;
+		if (!Level.IsPassable(Start, 0))
+		{
+			return Plan;
+		}
+		if (CarriedKey < 0 || CarriedKey >= static_cast<int32_t>(Level.Keys.size()))
+		{
+			CarriedKey = NoIndex;
+		}
+
+		int32_t StartAnchor = AnchorAtCell[Level.Grid.ToIndex(Start)];
+		if (StartAnchor == NoIndex)
+		{
+			// A cell next to no door, key or exit: link it one way into the graph
+			StartAnchor = static_cast<int32_t>(Anchors.size());
+			Anchors.emplace_back();
+			Anchors.back().Cell = Start;
+			ConnectRegion(StartAnchor);
+
+			Anchors.back().ExitDistance = NoIndex;
+			for (const FAnchorEdge& Edge : Anchors.back().Edges)
+			{
+				const int32_t Through = Anchors[Edge.To].ExitDistance;
+				if (Through != NoIndex && (Anchors.back().ExitDistance == NoIndex || Edge.Cost + Through < Anchors.back().ExitDistance))
+				{
+					Anchors.back().ExitDistance = Edge.Cost + Through;
+				}
+			}
+		}
+		if (Anchors[StartAnchor].ExitDistance == NoIndex)
+		{
+			// No exit even with every door open
+			return Plan;
+		}
+
+		// Every key in its own slot, the carried one and the ones off the level out of it
+		FKeyLayout StartLayout;
+		StartLayout.fill(EmptySlot);
+		for (int32_t Key = 0; Key < static_cast<int32_t>(Level.Keys.size()); ++Key)
+		{
+			StartLayout[Key] = Key == CarriedKey || KeyAnchors[Key] == NoIndex ? EmptySlot : static_cast<uint8_t>(Key);
+		}
+
+		// The subgoal plan bounds the search: states that cannot beat it are dropped
+		FPlan SubgoalPlan = SolveBySubgoals(StartAnchor, CarriedKey, StartLayout);
+		Stats.SubgoalPlanLength = SubgoalPlan.bSolved ? SubgoalPlan.Length : NoIndex;
+		const int32_t UpperBound = SubgoalPlan.bSolved ? SubgoalPlan.Length : std::numeric_limits<int32_t>::max();
+
+		using FOpenState = std::pair<int32_t, int32_t>;
+		std::priority_queue<FOpenState, std::vector<FOpenState>, std::greater<FOpenState>> OpenList;
+		const auto Push = [&](int32_t Record, int32_t Anchor)
+		{
+			if (Record != NoIndex)
+			{
+				const int32_t Estimate = Anchor == GoalAnchor ? 0 : Anchors[Anchor].ExitDistance;
+				if (Records[Record].Cost + Estimate < UpperBound)
+				{
+					OpenList.push(FOpenState(Records[Record].Cost + Estimate, Record));
+				}
+			}
+		};
+
+		const FDoorSet StartOpen = GetDoorsOpenedAt(StartAnchor, CarriedKey, 0);
+		Push(AddState(PackCanonical(StartAnchor, CarriedKey, StartLayout, StartOpen), StartOpen, 0, NoIndex, EPlanAction::OpenDoor, NoIndex), StartAnchor);
+
+		while (!OpenList.empty())
+		{
+			const FOpenState Open = OpenList.top();
+			OpenList.pop();
+
+			FStateRecord& Record = Records[Open.second];
+			const int32_t Anchor = GetPackedAnchor(Record.Packed);
+			if (Record.bClosed || Open.first != Record.Cost + (Anchor == GoalAnchor ? 0 : Anchors[Anchor].ExitDistance))
+			{
+				continue;
+			}
+			Record.bClosed = true;
+
+			if (Anchor == GoalAnchor)
+			{
+				Stats.StoredStates = static_cast<int32_t>(Records.size());
+				FPlan Plan = MakePlan(Open.second);
+				Plan.bOptimal = true;
+				return Plan;
+			}
+			if (++Stats.ExpandedStates > MaxExpandedStates)
+			{
+				Stats.bHitLimit = true;
+				break;
+			}
+
+			// Copies, as adding states may move the records
+			const int32_t Cost = Record.Cost;
+			const FDoorSet OpenDoors = Record.OpenDoors;
+			const int32_t Carried = GetPackedKey(Record.Packed);
+			const int32_t LayoutId = GetPackedLayout(Record.Packed);
+			const std::vector<int32_t>& Distances = GetDistances(Anchor, OpenDoors);
+
+			for (int32_t Exit = 0; Exit < static_cast<int32_t>(ExitAnchors.size()); ++Exit)
+			{
+				const int32_t Distance = Distances[ExitAnchors[Exit]];
+				if (Distance != NoIndex)
+				{
+					Push(AddState(PackState(GoalAnchor, NoIndex, 0), 0, Cost + Distance, Open.second, EPlanAction::ReachExit, Exit), GoalAnchor);
+				}
+			}
+
+			if (Carried != NoIndex)
+			{
+				for (FDoorSet Fits = KeyDoors[Carried] & ~OpenDoors; Fits != 0; Fits &= Fits - 1)
+				{
+					const int32_t Door = LowestDoor(Fits);
+					for (const int32_t Next : DoorAnchors[Door])
+					{
+						const int32_t Distance = Distances[Next];
+						if (Distance != NoIndex && Next != Anchor)
+						{
+							const FDoorSet NextOpen = OpenDoors | GetDoorsOpenedAt(Next, Carried, OpenDoors);
+							Push(AddState(PackCanonical(Next, Carried, Layouts[LayoutId], NextOpen), NextOpen, Cost + Distance, Open.second, EPlanAction::OpenDoor, Door), Next);
+						}
+					}
+				}
+			}
+
+			const FDoorSet CarriedOpens = Carried != NoIndex ? KeyDoors[Carried] : 0;
+			for (int32_t Slot = 0; Slot < static_cast<int32_t>(KeyAnchors.size()); ++Slot)
+			{
+				const int32_t Key = Layouts[LayoutId][Slot];
+				if (Key == EmptySlot || (KeyDoors[Key] & ~OpenDoors & ~CarriedOpens) == 0)
+				{
+					continue;
+				}
+
+				const int32_t Next = KeyAnchors[Slot];
+				const int32_t Distance = Distances[Next];
+				if (Distance == NoIndex)
+				{
+					continue;
+				}
+
+				// The carried key is dropped in the slot of the new one
+				FKeyLayout NextLayout = Layouts[LayoutId];
+				NextLayout[Slot] = Carried == NoIndex ? EmptySlot : static_cast<uint8_t>(Carried);
+				const FDoorSet NextOpen = OpenDoors | GetDoorsOpenedAt(Next, Key, OpenDoors);
+				Push(AddState(PackCanonical(Next, Key, NextLayout, NextOpen), NextOpen, Cost + Distance, Open.second, EPlanAction::PickUpKey, Key), Next);
+			}
+		}
+
+		// Nothing shorter than the subgoal plan, unless the budget ran out first
+		Stats.StoredStates = static_cast<int32_t>(Records.size());
+		SubgoalPlan.bOptimal = SubgoalPlan.bSolved && !Stats.bHitLimit;
+		return SubgoalPlan;
+	}
+
+	FPlan FKeyDoorPlanner::MakePlan(int32_t GoalRecord) const
+	{
+		std::vector<int32_t> Chain;
+		for (int32_t Record = GoalRecord; Record != NoIndex; Record = Records[Record].Parent)
+		{
+			Chain.push_back(Record);
+		}
+		std::reverse(Chain.begin(), Chain.end());
+
+		FPlan Plan;
+		FDoorSet OpenDoors = 0;
+		for (const int32_t Index : Chain)
+		{
+			const FStateRecord& Record = Records[Index];
+			if (Record.Action == EPlanAction::ReachExit)
+			{
+				Plan.Steps.push_back(FPlanStep{ EPlanAction::ReachExit, Record.ActionIndex, Level.Exits[Record.ActionIndex] });
+				break;
+			}
+
+			const FCell Cell = Anchors[GetPackedAnchor(Record.Packed)].Cell;
+			FDoorSet Opened = Record.OpenDoors & ~OpenDoors;
+			if (Record.Action == EPlanAction::PickUpKey)
+			{
+				Plan.Steps.push_back(FPlanStep{ EPlanAction::PickUpKey, Record.ActionIndex, Cell });
+			}
+			else if (Record.ActionIndex != NoIndex)
+			{
+				// The door walked to first, then any other the key fits there
+				Plan.Steps.push_back(FPlanStep{ EPlanAction::OpenDoor, Record.ActionIndex, Cell });
+				Opened &= ~(FDoorSet(1) << Record.ActionIndex);
+			}
+			for (; Opened != 0; Opened &= Opened - 1)
+			{
+				Plan.Steps.push_back(FPlanStep{ EPlanAction::OpenDoor, LowestDoor(Opened), Cell });
+			}
+			OpenDoors = Record.OpenDoors;
+		}
+
+		Plan.bSolved = true;
+		Plan.Length = Records[GoalRecord].Cost;
+		return Plan;
+	}
+
+	FPlan FKeyDoorPlanner::SolveBySubgoals(int32_t StartAnchor, int32_t CarriedKey, const FKeyLayout& Layout)
+	{
+		FWalker Walker;
+		Walker.CarriedKey = CarriedKey;
+		Walker.Layout = Layout;
+		WalkTo(Walker, StartAnchor, 0);
+		SubgoalBudget = 16 * static_cast<int32_t>(Level.Doors.size() + 1);
+
+		// Exits in the order of the doors in the way
+		std::vector<int64_t> RouteCost;
+		std::vector<int32_t> FirstDoor;
+		FindDoorRoutes(StartAnchor, Walker.OpenDoors, 0, RouteCost, FirstDoor);
+		std::vector<int32_t> Exits;
+		for (int32_t Exit = 0; Exit < static_cast<int32_t>(ExitAnchors.size()); ++Exit)
+		{
+			if (RouteCost[ExitAnchors[Exit]] != NoIndex)
+			{
+				Exits.push_back(Exit);
+			}
+		}
+		std::sort(Exits.begin(), Exits.end(), [&](int32_t A, int32_t B) { return RouteCost[ExitAnchors[A]] < RouteCost[ExitAnchors[B]]; });
+
+		for (const int32_t Exit : Exits)
+		{
+			FWalker Attempt = Walker;
+			if (ReachAnchor(Attempt, ExitAnchors[Exit], 0, 0))
+			{
+				Attempt.Plan.Steps.push_back(FPlanStep{ EPlanAction::ReachExit, Exit, Level.Exits[Exit] });
+				Attempt.Plan.bSolved = true;
+				return Attempt.Plan;
+			}
+		}
+		return FPlan();
+	}
+
+	bool FKeyDoorPlanner::ReachAnchor(FWalker& Walker, int32_t Target, FDoorSet AvoidDoors, int32_t Depth)
+	{
+		if (--SubgoalBudget < 0 || Depth > static_cast<int32_t>(Level.Doors.size()))
+		{
+			return false;
+		}
+
+		std::vector<int64_t> RouteCost;
+		std::vector<int32_t> FirstDoor;
+
+		// Every pass opens a door or gives up
+		for (size_t Pass = 0; Pass <= Level.Doors.size(); ++Pass)
+		{
+			const int32_t Distance = GetDistances(Walker.Anchor, Walker.OpenDoors)[Target];
+			if (Distance != NoIndex)
+			{
+				WalkTo(Walker, Target, Distance);
+				return true;
+			}
+
+			FindDoorRoutes(Walker.Anchor, Walker.OpenDoors, AvoidDoors, RouteCost, FirstDoor);
+			if (RouteCost[Target] == NoIndex || !OpenDoorOnRoute(Walker, FirstDoor[Target], AvoidDoors, Depth))
+			{
+				return false;
+			}
+		}
+		return false;
+	}
+
+	bool FKeyDoorPlanner::OpenDoorOnRoute(FWalker& Walker, int32_t Door, FDoorSet AvoidDoors, int32_t Depth)
+	{
+		const FDoorSet DoorBit = FDoorSet(1) << Door;
+		const auto Fits = [&](int32_t Key) { return Key != NoIndex && Key != EmptySlot && (KeyDoors[Key] & DoorBit) != 0; };
+
+		if (!Fits(Walker.CarriedKey))
+		{
+			// The nearest key for the door within reach
+			const std::vector<int32_t>& Distances = GetDistances(Walker.Anchor, Walker.OpenDoors);
+			int32_t BestSlot = NoIndex;
+			for (int32_t Slot = 0; Slot < static_cast<int32_t>(KeyAnchors.size()); ++Slot)
+			{
+				const int32_t Distance = Distances[KeyAnchors[Slot]];
+				if (Fits(Walker.Layout[Slot]) && Distance != NoIndex && (BestSlot == NoIndex || Distance < Distances[KeyAnchors[BestSlot]]))
+				{
+					BestSlot = Slot;
+				}
+			}
+
+			if (BestSlot != NoIndex)
+			{
+				PickUpKey(Walker, BestSlot, Distances[KeyAnchors[BestSlot]]);
+			}
+			else
+			{
+				// Every key for it lies behind other doors: reach one without going through this door
+				std::vector<int64_t> RouteCost;
+				std::vector<int32_t> FirstDoor;
+				FindDoorRoutes(Walker.Anchor, Walker.OpenDoors, AvoidDoors | DoorBit, RouteCost, FirstDoor);
+				std::vector<int32_t> Slots;
+				for (int32_t Slot = 0; Slot < static_cast<int32_t>(KeyAnchors.size()); ++Slot)
+				{
+					if (Fits(Walker.Layout[Slot]) && RouteCost[KeyAnchors[Slot]] != NoIndex)
+					{
+						Slots.push_back(Slot);
+					}
+				}
+				std::sort(Slots.begin(), Slots.end(), [&](int32_t A, int32_t B) { return RouteCost[KeyAnchors[A]] < RouteCost[KeyAnchors[B]]; });
+
+				bool bGotKey = false;
+				for (const int32_t Slot : Slots)
+				{
+					FWalker Attempt = Walker;
+					if (!ReachAnchor(Attempt, KeyAnchors[Slot], AvoidDoors | DoorBit, Depth + 1))
+					{
+						continue;
+					}
+
+					// Keys may have been swapped on the way
+					if (!Fits(Attempt.CarriedKey) && Fits(Attempt.Layout[Slot]))
+					{
+						PickUpKey(Attempt, Slot, 0);
+					}
+					if (Fits(Attempt.CarriedKey))
+					{
+						Walker = std::move(Attempt);
+						bGotKey = true;
+						break;
+					}
+				}
+				if (!bGotKey)
+				{
+					return false;
+				}
+			}
+		}
+
+		if (Walker.OpenDoors & DoorBit)
+		{
+			return true;
+		}
+
+		// Opened on arrival at the nearest cell next to it
+		const std::vector<int32_t>& Distances = GetDistances(Walker.Anchor, Walker.OpenDoors);
+		int32_t Best = NoIndex;
+		for (const int32_t Anchor : DoorAnchors[Door])
+		{
+			if (Distances[Anchor] != NoIndex && (Best == NoIndex || Distances[Anchor] < Distances[Best]))
+			{
+				Best = Anchor;
+			}
+		}
+		if (Best == NoIndex)
+		{
+			return false;
+		}
+		WalkTo(Walker, Best, Distances[Best]);
+		return (Walker.OpenDoors & DoorBit) != 0;
+	}
+
+	void FKeyDoorPlanner::WalkTo(FWalker& Walker, int32_t Anchor, int32_t Distance)
+	{
+		Walker.Anchor = Anchor;
+		Walker.Plan.Length += Distance;
+		for (FDoorSet Opened = GetDoorsOpenedAt(Anchor, Walker.CarriedKey, Walker.OpenDoors); Opened != 0; Opened &= Opened - 1)
+		{
+			const int32_t Door = LowestDoor(Opened);
+			Walker.Plan.Steps.push_back(FPlanStep{ EPlanAction::OpenDoor, Door, Anchors[Anchor].Cell });
+			Walker.OpenDoors |= FDoorSet(1) << Door;
+		}
+	}
+
+	void FKeyDoorPlanner::PickUpKey(FWalker& Walker, int32_t Slot, int32_t Distance)
+	{
+		const int32_t Anchor = KeyAnchors[Slot];
+		WalkTo(Walker, Anchor, Distance);
+
+		const int32_t Key = Walker.Layout[Slot];
+		Walker.Plan.Steps.push_back(FPlanStep{ EPlanAction::PickUpKey, Key, Anchors[Anchor].Cell });
+		Walker.Layout[Slot] = Walker.CarriedKey == NoIndex ? EmptySlot : static_cast<uint8_t>(Walker.CarriedKey);
+		Walker.CarriedKey = Key;
+		WalkTo(Walker, Anchor, 0);
+	}
+
+	void FKeyDoorPlanner::FindDoorRoutes(int32_t FromAnchor, FDoorSet OpenDoors, FDoorSet AvoidDoors, std::vector<int64_t>& OutCost, std::vector<int32_t>& OutFirstDoor)
+	{
+		// A closed door weighs more than any walk
+		constexpr int64_t ClosedDoorCost = int64_t(1) << 32;
+
+		OutCost.assign(Anchors.size(), NoIndex);
+		OutFirstDoor.assign(Anchors.size(), NoIndex);
+		OutCost[FromAnchor] = 0;
+
+		using FOpenAnchor = std::pair<int64_t, int32_t>;
+		std::priority_queue<FOpenAnchor, std::vector<FOpenAnchor>, std::greater<FOpenAnchor>> OpenList;
+		OpenList.push(FOpenAnchor(0, FromAnchor));
+		while (!OpenList.empty())
+		{
+			const FOpenAnchor Open = OpenList.top();
+			OpenList.pop();
+			if (Open.first != OutCost[Open.second])
+			{
+				continue;
+			}
+
+			for (const FAnchorEdge& Edge : Anchors[Open.second].Edges)
+			{
+				const bool bClosed = Edge.Door != NoIndex && !IsDoorOpen(OpenDoors, Edge.Door);
+				if (bClosed && IsDoorOpen(AvoidDoors, Edge.Door))
+				{
+					continue;
+				}
+
+				const int64_t Cost = Open.first + Edge.Cost + (bClosed ? ClosedDoorCost : 0);
+				if (OutCost[Edge.To] == NoIndex || Cost < OutCost[Edge.To])
+				{
+					OutCost[Edge.To] = Cost;
+					OutFirstDoor[Edge.To] = OutFirstDoor[Open.second] != NoIndex ? OutFirstDoor[Open.second] : (bClosed ? Edge.Door : NoIndex);
+					OpenList.push(FOpenAnchor(Cost, Edge.To));
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,255 @@
+#include "MazeCoreSolvers.h"
+#include <algorithm>
+#include <queue>
+#include <set>
+#include <tuple>
+
+namespace MazeCore
+{
+	void FGridSearch::BeginSearch(int32_t NumCells)
+	{
+		if (static_cast<int32_t>(CellGeneration.size()) != NumCells)
+		{
+			CellGeneration.assign(NumCells, 0);
+			CellCost.resize(NumCells);
+			CellParent.resize(NumCells);
+			Generation = 0;
+		}
+
+		// On wrap-around every stamp could be mistaken for the new generation
+		if (++Generation == 0)
+		{
+			std::fill(CellGeneration.begin(), CellGeneration.end(), 0);
+			Generation = 1;
+		}
+		Queue.clear();
+	}
+
+	void FGridSearch::ComputeDistances(const FLevel& Level, FDoorSet OpenDoors, const FCell& From, std::vector<int32_t>& OutDistances)
+	{
+		const FGrid& Grid = Level.Grid;
+		OutDistances.assign(Grid.GetNumCells(), NoIndex);
+		if (!Level.IsPassable(From, OpenDoors))
+		{
+			return;
+		}
+
+		Queue.clear();
+		Queue.push_back(Grid.ToIndex(From));
+		OutDistances[Grid.ToIndex(From)] = 0;
+
+		for (size_t Head = 0; Head < Queue.size(); ++Head)
+		{
+			const FCell Cell = Grid.ToCell(Queue[Head]);
+			const int32_t NextDistance = OutDistances[Queue[Head]] + 1;
+			for (const FCell& Offset : CardinalOffsets)
+			{
+				const FCell Next = Cell + Offset;
+				if (Level.IsPassable(Next, OpenDoors) && OutDistances[Grid.ToIndex(Next)] == NoIndex)
+				{
+					OutDistances[Grid.ToIndex(Next)] = NextDistance;
+					Queue.push_back(Grid.ToIndex(Next));
+				}
+			}
+		}
+	}
+
+	bool FGridSearch::FindPath(const FLevel& Level, FDoorSet OpenDoors, const FCell& From, const FCell& To, std::vector<FCell>& OutPath)
+	{
+		const FGrid& Grid = Level.Grid;
+		if (!Level.IsPassable(From, OpenDoors) || !Level.IsPassable(To, OpenDoors))
+		{
+			return false;
+		}
+
+		BeginSearch(Grid.GetNumCells());
+
+		// Open list of (estimate, cell) with the lowest estimate on top
+		using FOpenCell = std::pair<int32_t, int32_t>;
+		std::priority_queue<FOpenCell, std::vector<FOpenCell>, std::greater<FOpenCell>> OpenList;
+
+		const int32_t FromIndex = Grid.ToIndex(From);
+		const int32_t ToIndex = Grid.ToIndex(To);
+		CellGeneration[FromIndex] = Generation;
+		CellCost[FromIndex] = 0;
+		CellParent[FromIndex] = NoIndex;
+		OpenList.push(FOpenCell(ManhattanDistance(From, To), FromIndex));
+
+		while (!OpenList.empty())
+		{
+			const FOpenCell Open = OpenList.top();
+			OpenList.pop();
+
+			const FCell Cell = Grid.ToCell(Open.second);
+			const int32_t Cost = CellCost[Open.second];
+			if (Open.first != Cost + ManhattanDistance(Cell, To))
+			{
+				// Superseded by a cheaper entry
+				continue;
+			}
+
+			if (Open.second == ToIndex)
+			{
+				const size_t FirstStep = OutPath.size();
+				for (int32_t Index = ToIndex; Index != FromIndex; Index = CellParent[Index])
+				{
+					OutPath.push_back(Grid.ToCell(Index));
+				}
+				std::reverse(OutPath.begin() + FirstStep, OutPath.end());
+				return true;
+			}
+
+			for (const FCell& Offset : CardinalOffsets)
+			{
+				const FCell Next = Cell + Offset;
+				if (!Level.IsPassable(Next, OpenDoors))
+				{
+					continue;
+				}
+
+				const int32_t NextIndex = Grid.ToIndex(Next);
+				if (CellGeneration[NextIndex] != Generation || Cost + 1 < CellCost[NextIndex])
+				{
+					CellGeneration[NextIndex] = Generation;
+					CellCost[NextIndex] = Cost + 1;
+					CellParent[NextIndex] = Open.second;
+					OpenList.push(FOpenCell(Cost + 1 + ManhattanDistance(Next, To), NextIndex));
+				}
+			}
+		}
+
+		return false;
+	}
+
+	namespace
+	{
+		// Passable cell next to a door nearest to the agent, or NoIndex
+		int32_t FindDoorApproach(const FLevel& Level, FDoorSet OpenDoors, const FDoor& Door, const std::vector<int32_t>& Distances)
+		{
+			int32_t Best = NoIndex;
+			for (const FCell& DoorCell : Door.Cells)
+			{
+				for (const FCell& Offset : CardinalOffsets)
+				{
+					const FCell Cell = DoorCell + Offset;
+					if (!Level.IsPassable(Cell, OpenDoors))
+					{
+						continue;
+					}
+					const int32_t Index = Level.Grid.ToIndex(Cell);
+					if (Distances[Index] != NoIndex && (Best == NoIndex || Distances[Index] < Distances[Best]))
+					{
+						Best = Index;
+					}
+				}
+			}
+			return Best;
+		}
+	}
+
+	FPlan SolveGreedy(const FLevel& Level, FGridSearch& Search)
+	{
+		FPlan Plan;
+		const FGrid& Grid = Level.Grid;
+		std::vector<FCell> KeyCells;
+		for (const FKey& Key : Level.Keys)
+		{
+			KeyCells.push_back(Key.Cell);
+		}
+
+		FCell Position = Level.Start;
+		int32_t CarriedKey = NoIndex;
+		FDoorSet OpenDoors = 0;
+		std::vector<int32_t> Distances;
+
+		// Coming back to the same place with the same key and doors means the agent is going round in circles
+		std::set<std::tuple<int32_t, int32_t, FDoorSet>> SeenStates;
+
+		auto MoveTo = [&](int32_t Index, EPlanAction Action, int32_t Target)
+		{
+			Plan.Length += Distances[Index];
+			Position = Grid.ToCell(Index);
+			Plan.Steps.push_back(FPlanStep{ Action, Target, Position });
+		};
+
+		while (SeenStates.insert(std::make_tuple(Grid.ToIndex(Position), CarriedKey, OpenDoors)).second)
+		{
+			Search.ComputeDistances(Level, OpenDoors, Position, Distances);
+
+			int32_t BestExit = NoIndex;
+			for (int32_t Exit = 0; Exit < static_cast<int32_t>(Level.Exits.size()); ++Exit)
+			{
+				const int32_t Distance = Level.Grid.IsValidCell(Level.Exits[Exit]) ? Distances[Grid.ToIndex(Level.Exits[Exit])] : NoIndex;
+				if (Distance != NoIndex && (BestExit == NoIndex || Distance < Distances[Grid.ToIndex(Level.Exits[BestExit])]))
+				{
+					BestExit = Exit;
+				}
+			}
+			if (BestExit != NoIndex)
+			{
+				MoveTo(Grid.ToIndex(Level.Exits[BestExit]), EPlanAction::ReachExit, BestExit);
+				Plan.bSolved = true;
+				return Plan;
+			}
+
+			// Nearest closed door the carried key opens
+			int32_t BestDoor = NoIndex;
+			int32_t BestApproach = NoIndex;
+			for (int32_t Door = 0; CarriedKey != NoIndex && Door < static_cast<int32_t>(Level.Doors.size()); ++Door)
+			{
+				if (IsDoorOpen(OpenDoors, Door) || !CanKeyOpenDoor(Level.Keys[CarriedKey].Signature, Level.Doors[Door].Mask))
+				{
+					continue;
+				}
+				const int32_t Approach = FindDoorApproach(Level, OpenDoors, Level.Doors[Door], Distances);
+				if (Approach != NoIndex && (BestApproach == NoIndex || Distances[Approach] < Distances[BestApproach]))
+				{
+					BestDoor = Door;
+					BestApproach = Approach;
+				}
+			}
+			if (BestDoor != NoIndex)
+			{
+				MoveTo(BestApproach, EPlanAction::OpenDoor, BestDoor);
+				OpenDoors |= FDoorSet(1) << BestDoor;
+				continue;
+			}
+
+			// Nearest other key that fits a closed door
+			int32_t BestKey = NoIndex;
+			for (int32_t Key = 0; Key < static_cast<int32_t>(Level.Keys.size()); ++Key)
+			{
+				const int32_t Distance = Key != CarriedKey && Grid.IsValidCell(KeyCells[Key]) ? Distances[Grid.ToIndex(KeyCells[Key])] : NoIndex;
+				if (Distance == NoIndex || (BestKey != NoIndex && Distance >= Distances[Grid.ToIndex(KeyCells[BestKey])]))
+				{
+					continue;
+				}
+
+				bool bFitsClosedDoor = false;
+				for (int32_t Door = 0; Door < static_cast<int32_t>(Level.Doors.size()) && !bFitsClosedDoor; ++Door)
+				{
+					bFitsClosedDoor = !IsDoorOpen(OpenDoors, Door) && CanKeyOpenDoor(Level.Keys[Key].Signature, Level.Doors[Door].Mask);
+				}
+				if (bFitsClosedDoor)
+				{
+					BestKey = Key;
+				}
+			}
+			if (BestKey == NoIndex)
+			{
+				break;
+			}
+
+			// The carried key is dropped where the new one was picked up
+			MoveTo(Grid.ToIndex(KeyCells[BestKey]), EPlanAction::PickUpKey, BestKey);
+			if (CarriedKey != NoIndex)
+			{
+				KeyCells[CarriedKey] = KeyCells[BestKey];
+			}
+			KeyCells[BestKey] = FCell(NoIndex, NoIndex);
+			CarriedKey = BestKey;
+		}
+
+		return Plan;
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "MazeCoreTypes.h"
+#include <vector>
+
+namespace MazeCore
+{
+	/**
+	 * Walkability of a Width x Height grid of cells, indexed Y * Width + X
+	 */
+	class MAZECORE_API FGrid
+	{
+	public:
+		FGrid() = default;
+
+		// A grid of walls
+		FGrid(int32_t InWidth, int32_t InHeight) { Reset(InWidth, InHeight); }
+
+		void Reset(int32_t InWidth, int32_t InHeight);
+
+		int32_t GetWidth() const { return Width; }
+		int32_t GetHeight() const { return Height; }
+		int32_t GetNumCells() const { return Width * Height; }
+
+		bool IsValidCell(const FCell& Cell) const
+		{
+			return Cell.X >= 0 && Cell.Y >= 0 && Cell.X < Width && Cell.Y < Height;
+		}
+
+		int32_t ToIndex(const FCell& Cell) const { return Cell.Y * Width + Cell.X; }
+		FCell ToCell(int32_t Index) const { return FCell(Index % Width, Index / Width); }
+
+		// False for cells outside the grid
+		bool IsWalkable(const FCell& Cell) const
+		{
+			return IsValidCell(Cell) && Walkable[ToIndex(Cell)] != 0;
+		}
+
+		void SetWalkable(const FCell& Cell, bool bWalkable)
+		{
+			Walkable[ToIndex(Cell)] = bWalkable ? 1 : 0;
+		}
+
+		int32_t CountWalkable() const;
+
+	private:
+		int32_t Width = 0;
+		int32_t Height = 0;
+
+		// One byte per cell so the solvers can read it without bit twiddling
+		std::vector<uint8_t> Walkable;
+	};
+}
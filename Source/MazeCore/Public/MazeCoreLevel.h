@@ -0,0 +1,102 @@
+#pragma once
+
+#include "MazeCoreGrid.h"
+#include <vector>
+
+namespace MazeCore
+{
+	// Set of doors, one bit per door index
+	using FDoorSet = uint64_t;
+
+	// Doors a level can have, so a door set fits one word
+	constexpr int32_t MaxDoors = 64;
+
+	// Key signatures are 32-bit masks; a level has at most one key per bit
+	constexpr int32_t MaxKeys = 32;
+
+	constexpr bool IsDoorOpen(FDoorSet OpenDoors, int32_t Door)
+	{
+		return ((OpenDoors >> Door) & 1) != 0;
+	}
+
+	struct FKey
+	{
+		FCell Cell;
+		int32_t Signature = 0;
+	};
+
+	// Opened by any key whose signature shares a bit with Mask; its cells block agents until then
+	struct FDoor
+	{
+		std::vector<FCell> Cells;
+		int32_t Mask = 0;
+	};
+
+	// Parameters of a generated level
+	struct FLevelParams
+	{
+		// The grid is (2 * RoomsPerSide + 1) cells on a side: rooms on odd cells, walls and openings between them
+		int32_t RoomsPerSide = 16;
+		int32_t NumDoors = 8;
+		int32_t NumKeys = 4;
+
+		// Chance of opening each remaining wall between two rooms, adding loops to the maze
+		float LoopChance = 0.1f;
+
+		uint32_t Seed = 1;
+	};
+
+	/**
+	 * A maze level: the walkable grid (with every door open), its doors, keys, exits and the start cell
+	 *
+	 * Agents carry one key at a time. Picking up a key drops the one carried where the new key
+	 * was, and keys are not used up by opening doors, matching AMazeBlazeCharacter::PickupKey.
+	 * A door is opened from a passable cell next to one of its cells.
+	 */
+	class MAZECORE_API FLevel
+	{
+	public:
+		FGrid Grid;
+		std::vector<FKey> Keys;
+		std::vector<FDoor> Doors;
+		std::vector<FCell> Exits;
+		FCell Start;
+
+		// Map the door cells back to their doors; call after changing Doors.
+		// Fails if there are more than MaxDoors doors or a door cell is not walkable
+		bool IndexDoors();
+
+		// Door covering a cell, or NoIndex
+		int32_t GetDoorAt(const FCell& Cell) const
+		{
+			return Grid.IsValidCell(Cell) ? DoorAtCell[Grid.ToIndex(Cell)] : NoIndex;
+		}
+
+		// Whether an agent can stand on a cell while the given doors are open
+		bool IsPassable(const FCell& Cell, FDoorSet OpenDoors) const
+		{
+			if (!Grid.IsWalkable(Cell))
+			{
+				return false;
+			}
+			const int32_t Door = DoorAtCell[Grid.ToIndex(Cell)];
+			return Door == NoIndex || IsDoorOpen(OpenDoors, Door);
+		}
+
+		// Every door of the level
+		FDoorSet GetAllDoors() const
+		{
+			return Doors.size() >= 64 ? ~FDoorSet(0) : (FDoorSet(1) << Doors.size()) - 1;
+		}
+
+		// A random maze with doors on the openings between rooms, numbered by distance from the start
+		// and at least 2 * NumKeys + 3 steps away from it (fewer doors if there is no room). Key k opens the doors
+		// k, k + NumKeys, ... and lies where it can be reached once the doors before door k
+		// are open, so opening the doors in order always leads to the exit
+		static FLevel Generate(const FLevelParams& Params);
+
+	private:
+		// Door index per cell, NoIndex where there is none
+		std::vector<int8_t> DoorAtCell;
+	};
+}
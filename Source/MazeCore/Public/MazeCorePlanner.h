@@ -0,0 +1,223 @@
+#pragma once
+
+#include "MazeCoreSolvers.h"
+#include <array>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace MazeCore
+{
+	// Work done by the last FKeyDoorPlanner::Solve
+	struct FPlannerStats
+	{
+		int32_t ExpandedStates = 0;
+		int32_t StoredStates = 0;
+
+		// Shortest-path trees computed over the anchor graph, and the ones found in the cache
+		int32_t DistanceQueries = 0;
+		int32_t DistanceCacheHits = 0;
+
+		// Length of the subgoal plan bounding the search, NoIndex if it found none
+		int32_t SubgoalPlanLength = NoIndex;
+
+		// The search stopped at MaxExpandedStates before proving a plan optimal
+		bool bHitLimit = false;
+	};
+
+	/**
+	 * Shortest plan through a level's keys and doors to an exit
+	 *
+	 * A quick subgoal plan comes first: walk towards the exit and, for each closed door in the way,
+	 * fetch a key for it, reaching that key the same way when it lies behind other doors. Its length
+	 * bounds an A* search over the states (position, carried key, open doors, where each key lies),
+	 * which either finds a shorter plan, proves there is none, or runs out of MaxExpandedStates on
+	 * levels with long key chains, leaving the subgoal plan.
+	 *
+	 * Positions are limited to the anchor cells (the start, the keys, the exits and the cells next
+	 * to the doors), with the walking distances between the anchors of each region between doors
+	 * computed by Build; a search only runs Dijkstra over those anchors, cached per position and
+	 * set of open doors. A state packs into two words and the closed set is an open-addressing
+	 * hash table of them. Dropped keys move to where the new key was picked up, so where the keys
+	 * lie is part of the state, as an index into a table of the key layouts met so far; keys that
+	 * open no closed door are left out of it.
+	 *
+	 * Doors open from an anchor next to them at no cost, and a door the carried key fits is opened
+	 * whenever the agent stops next to it, as opening never makes a route longer. Picking up a key
+	 * is skipped when it opens no closed door the carried key does not open already.
+	 * Doors are assumed not to touch each other.
+	 */
+	class MAZECORE_API FKeyDoorPlanner
+	{
+	public:
+		// Build the anchor graph of a level; fails for levels with more than MaxDoors doors or MaxKeys keys.
+		// Keys on a cell outside the grid are carried by someone: they can be passed to Solve but are never found
+		bool Build(const FLevel& InLevel);
+
+		// Plan from Start for an agent carrying CarriedKey (NoIndex for none; its cell is ignored).
+		// The plan is the shortest one (bOptimal) unless the search hit MaxExpandedStates, in which
+		// case it is the subgoal plan
+		FPlan Solve(const FCell& Start, int32_t CarriedKey = NoIndex);
+
+		const FPlannerStats& GetStats() const { return Stats; }
+		int32_t GetNumAnchors() const { return static_cast<int32_t>(Anchors.size()); }
+
+		// States the search may expand before settling for the subgoal plan
+		int32_t MaxExpandedStates = 512;
+
+		// Cached shortest-path trees kept before the cache is flushed
+		int32_t MaxCachedDistances = 1 << 14;
+
+	private:
+		// Content of a key slot: the key lying there, or EmptySlot
+		static constexpr uint8_t EmptySlot = 0xFF;
+		using FKeyLayout = std::array<uint8_t, MaxKeys>;
+
+		struct FAnchorEdge
+		{
+			int32_t To = NoIndex;
+			int32_t Cost = 0;
+
+			// Door the edge crosses, NoIndex for an edge inside a region
+			int32_t Door = NoIndex;
+		};
+
+		struct FAnchor
+		{
+			FCell Cell;
+			std::vector<FAnchorEdge> Edges;
+
+			// Doors next to the anchor, which can be opened from it
+			FDoorSet AdjacentDoors = 0;
+
+			// Key slot at the anchor (the cell a key started on), or NoIndex
+			int32_t KeySlot = NoIndex;
+
+			// Exit at the anchor, or NoIndex
+			int32_t Exit = NoIndex;
+
+			// Walking distance to the nearest exit with every door open, the A* heuristic
+			int32_t ExitDistance = 0;
+		};
+
+		// A stored search state and how it was reached
+		struct FStateRecord
+		{
+			uint64_t Packed = 0;
+			FDoorSet OpenDoors = 0;
+			int32_t Cost = 0;
+			int32_t Parent = NoIndex;
+			EPlanAction Action = EPlanAction::ReachExit;
+			int32_t ActionIndex = NoIndex;
+			bool bClosed = false;
+		};
+
+		int32_t AddAnchor(const FCell& Cell);
+
+		// Link an anchor to the anchors of the built graph it can walk to without crossing a door
+		void ConnectRegion(int32_t Anchor);
+
+		// Walking distances from an anchor to every anchor with the given doors open, NoIndex if unreachable
+		const std::vector<int32_t>& GetDistances(int32_t FromAnchor, FDoorSet OpenDoors);
+
+		// Doors next to an anchor that a key opens
+		FDoorSet GetDoorsOpenedAt(int32_t Anchor, int32_t Key, FDoorSet OpenDoors) const;
+
+		int32_t InternLayout(const FKeyLayout& Layout);
+
+		// Pack a state with the keys that open no closed door left out, as they no longer matter
+		uint64_t PackCanonical(int32_t Anchor, int32_t CarriedKey, FKeyLayout Layout, FDoorSet OpenDoors);
+
+		// Add or improve a state; returns its record, or NoIndex if it was already reached at no more cost
+		int32_t AddState(uint64_t Packed, FDoorSet OpenDoors, int32_t Cost, int32_t Parent, EPlanAction Action, int32_t ActionIndex);
+
+		static uint64_t PackState(int32_t Anchor, int32_t CarriedKey, int32_t Layout)
+		{
+			return static_cast<uint64_t>(Anchor) | (static_cast<uint64_t>(CarriedKey + 1) << 16) | (static_cast<uint64_t>(Layout) << 22);
+		}
+		static int32_t GetPackedAnchor(uint64_t Packed) { return static_cast<int32_t>(Packed & 0xFFFF); }
+		static int32_t GetPackedKey(uint64_t Packed) { return static_cast<int32_t>((Packed >> 16) & 0x3F) - 1; }
+		static int32_t GetPackedLayout(uint64_t Packed) { return static_cast<int32_t>(Packed >> 22); }
+
+		FPlan MakePlan(int32_t GoalRecord) const;
+
+		// An agent following the subgoal plan
+		struct FWalker
+		{
+			int32_t Anchor = NoIndex;
+			int32_t CarriedKey = NoIndex;
+			FKeyLayout Layout;
+			FDoorSet OpenDoors = 0;
+			FPlan Plan;
+		};
+
+		FPlan SolveBySubgoals(int32_t StartAnchor, int32_t CarriedKey, const FKeyLayout& Layout);
+
+		// Walk to an anchor, opening the doors on the way; doors in AvoidDoors are not opened for it
+		bool ReachAnchor(FWalker& Walker, int32_t Target, FDoorSet AvoidDoors, int32_t Depth);
+
+		// Get a key for a door and open it
+		bool OpenDoorOnRoute(FWalker& Walker, int32_t Door, FDoorSet AvoidDoors, int32_t Depth);
+
+		// Move to an anchor and open the doors next to it that the carried key fits
+		void WalkTo(FWalker& Walker, int32_t Anchor, int32_t Distance);
+		void PickUpKey(FWalker& Walker, int32_t Slot, int32_t Distance);
+
+		// Routes from an anchor crossing the fewest closed doors, then walking the least, avoiding some doors:
+		// OutCost packs both (NoIndex if there is no route) and OutFirstDoor is the first closed door on the route
+		void FindDoorRoutes(int32_t FromAnchor, FDoorSet OpenDoors, FDoorSet AvoidDoors, std::vector<int64_t>& OutCost, std::vector<int32_t>& OutFirstDoor);
+
+		// Calls of ReachAnchor left to the subgoal planner
+		int32_t SubgoalBudget = 0;
+
+		FLevel Level;
+
+		std::vector<FAnchor> Anchors;
+		std::vector<int32_t> AnchorAtCell;
+
+		// Anchors at the start of a key slot (NoIndex for keys off the level) and at each exit, and the anchors next to each door
+		std::vector<int32_t> KeyAnchors;
+		std::vector<int32_t> ExitAnchors;
+		std::vector<std::vector<int32_t>> DoorAnchors;
+
+		// Doors each key opens
+		std::vector<FDoorSet> KeyDoors;
+
+		// Anchors of the built graph; the start of a search gets a temporary one after them
+		int32_t NumBuiltAnchors = 0;
+
+		// Shortest-path trees keyed by (anchor, open doors)
+		struct FDistanceKey
+		{
+			int32_t Anchor;
+			FDoorSet OpenDoors;
+			bool operator==(const FDistanceKey& Other) const { return Anchor == Other.Anchor && OpenDoors == Other.OpenDoors; }
+		};
+		struct FDistanceKeyHash
+		{
+			size_t operator()(const FDistanceKey& Key) const { return static_cast<size_t>(Key.OpenDoors * 0x9E3779B97F4A7C15ull) ^ static_cast<size_t>(Key.Anchor); }
+		};
+		std::unordered_map<FDistanceKey, std::vector<int32_t>, FDistanceKeyHash> DistanceCache;
+
+		// Key layouts met by the search, with an open-addressing table of their indices
+		std::vector<FKeyLayout> Layouts;
+		std::vector<int32_t> LayoutTable;
+
+		// Closed set: open addressing over the records, NoIndex for free slots
+		std::vector<FStateRecord> Records;
+		std::vector<int32_t> StateTable;
+
+		// Region between closed doors of each cell (NoIndex for walls and doors) and the number of built anchors in each region
+		std::vector<int32_t> CellRegion;
+		std::vector<int32_t> RegionAnchorCount;
+
+		// Breadth-first scratch over the grid, NoIndex for cells not reached yet
+		std::vector<int32_t> CellDistance;
+		std::vector<int32_t> CellQueue;
+
+		// Dijkstra scratch
+		std::vector<std::pair<int32_t, int32_t>> Heap;
+
+		FPlannerStats Stats;
+	};
+}
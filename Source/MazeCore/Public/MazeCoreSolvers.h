@@ -0,0 +1,66 @@
+#pragma once
+
+#include "MazeCoreLevel.h"
+#include <vector>
+
+namespace MazeCore
+{
+	/**
+	 * Breadth-first and A* searches over the passable cells of a level
+	 *
+	 * Keeps its buffers between searches; a search stamps the cells it touches with a
+	 * generation number instead of clearing them, so its cost follows the cells visited.
+	 */
+	class MAZECORE_API FGridSearch
+	{
+	public:
+		// Steps from From to every cell, NoIndex for cells that cannot be reached with the given doors open
+		void ComputeDistances(const FLevel& Level, FDoorSet OpenDoors, const FCell& From, std::vector<int32_t>& OutDistances);
+
+		// Shortest path appended to OutPath, From excluded and To included; false if To cannot be reached
+		bool FindPath(const FLevel& Level, FDoorSet OpenDoors, const FCell& From, const FCell& To, std::vector<FCell>& OutPath);
+
+	private:
+		// Start a new generation, resizing the buffers for a grid
+		void BeginSearch(int32_t NumCells);
+
+		std::vector<uint32_t> CellGeneration;
+		std::vector<int32_t> CellCost;
+		std::vector<int32_t> CellParent;
+		std::vector<int32_t> Queue;
+		uint32_t Generation = 0;
+	};
+
+	enum class EPlanAction : uint8_t
+	{
+		PickUpKey,
+		OpenDoor,
+		ReachExit
+	};
+
+	// One action of a plan: Index is the key, door or exit acted on and Cell where the agent stands
+	struct FPlanStep
+	{
+		EPlanAction Action = EPlanAction::ReachExit;
+		int32_t Index = NoIndex;
+		FCell Cell;
+	};
+
+	struct FPlan
+	{
+		bool bSolved = false;
+
+		// Proven to be the shortest plan there is
+		bool bOptimal = false;
+
+		// Cells walked from the start to the end of the plan
+		int32_t Length = 0;
+
+		std::vector<FPlanStep> Steps;
+	};
+
+	// The behaviour of the current behavior tree: head for a reachable exit, else open the nearest door
+	// the carried key fits, else pick up the nearest other key that fits a closed door.
+	// Fails when there is nothing left to do or the agent starts going round in circles
+	MAZECORE_API FPlan SolveGreedy(const FLevel& Level, FGridSearch& Search);
+}
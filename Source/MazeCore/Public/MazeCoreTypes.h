@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Set by the Unreal build; the standalone build links MazeCore statically
+#ifndef MAZECORE_API
+#define MAZECORE_API
+#endif
+
+namespace MazeCore
+{
+	// Index value for "none"
+	constexpr int32_t NoIndex = -1;
+
+	// Cell of a grid; X grows to the right, Y downwards
+	struct FCell
+	{
+		int32_t X = 0;
+		int32_t Y = 0;
+
+		constexpr FCell() = default;
+		constexpr FCell(int32_t InX, int32_t InY) : X(InX), Y(InY) {}
+
+		constexpr FCell operator+(const FCell& Other) const { return FCell(X + Other.X, Y + Other.Y); }
+		constexpr bool operator==(const FCell& Other) const { return X == Other.X && Y == Other.Y; }
+		constexpr bool operator!=(const FCell& Other) const { return !(*this == Other); }
+	};
+
+	constexpr FCell CardinalOffsets[] = { FCell(1, 0), FCell(-1, 0), FCell(0, 1), FCell(0, -1) };
+
+	constexpr int32_t ManhattanDistance(const FCell& A, const FCell& B)
+	{
+		return (A.X > B.X ? A.X - B.X : B.X - A.X) + (A.Y > B.Y ? A.Y - B.Y : B.Y - A.Y);
+	}
+
+	// A key opens a door when its signature shares a bit with the door's mask, as in AMazeGameDoor::CanBeOpenedByKey
+	constexpr bool CanKeyOpenDoor(int32_t KeySignature, int32_t DoorMask)
+	{
+		return (KeySignature & DoorMask) != 0;
+	}
+}